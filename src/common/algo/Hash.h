@@ -0,0 +1,59 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Helpers for the fixed size hash tables.
+ *
+ * Tables have a power of two number of slots and keys are reduced with
+ * Fibonacci hashing: the key is multiplied by 2^32 / phi and the slot is given
+ * by the high bits of the 32 bit product. Unlike the low bits, they depend on
+ * all the bits of the key, so keys which only differ in their high bits (like
+ * SKPath ids, which have 8 low bits of index) are spread over the table.
+ */
+
+/**
+ * Returns the number of bits of the slot numbers of a table with at least
+ * `capacity` slots (at most 32768).
+ */
+inline uint8_t hashTableBits(uint16_t capacity) {
+  uint8_t bits = 0;
+  while (bits < 15 && (1u << bits) < capacity) {
+    bits++;
+  }
+  return bits;
+}
+
+/**
+ * Returns the slot of `key` in a table of 2^bits slots.
+ */
+inline uint16_t hashSlot(uint32_t key, uint8_t bits) {
+  if (bits == 0) {
+    return 0;
+  }
+  return (uint16_t)((uint32_t)(key * 2654435761u) >> (32 - bits));
+}
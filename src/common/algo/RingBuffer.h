@@ -0,0 +1,121 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * A fixed capacity FIFO of T elements.
+ *
+ * All the storage is allocated once when the buffer is created. Elements are
+ * written and read in place: `reserve()` returns the next free slot which
+ * becomes visible to the reader after `commit()`, and `front()` returns the
+ * oldest element which is released with `pop()`. This avoids copying large
+ * objects in and out of the buffer.
+ */
+template <class T> class RingBuffer {
+  private:
+    T *_slots;
+    uint16_t _capacity;
+    uint16_t _head;
+    uint16_t _size;
+
+    // Not copyable.
+    RingBuffer(const RingBuffer&);
+    RingBuffer& operator=(const RingBuffer&);
+
+  public:
+    RingBuffer(uint16_t capacity) : _slots(new T[capacity]), _capacity(capacity), _head(0), _size(0) {};
+
+    ~RingBuffer() {
+      delete[] _slots;
+    };
+
+    uint16_t capacity() const {
+      return _capacity;
+    };
+
+    uint16_t size() const {
+      return _size;
+    };
+
+    bool isEmpty() const {
+      return _size == 0;
+    };
+
+    bool isFull() const {
+      return _size == _capacity;
+    };
+
+    /**
+     * Returns the slot where the next element should be written, or a null
+     * pointer if the buffer is full. The element is only added to the buffer
+     * once `commit()` is called.
+     */
+    T* reserve() {
+      if (isFull()) {
+        return 0;
+      }
+      return &_slots[(_head + _size) % _capacity];
+    };
+
+    /**
+     * Adds the element previously returned by `reserve()` to the buffer.
+     */
+    void commit() {
+      if (!isFull()) {
+        _size++;
+      }
+    };
+
+    /**
+     * Returns the oldest element in the buffer or a null pointer if the buffer
+     * is empty.
+     */
+    T* front() {
+      if (isEmpty()) {
+        return 0;
+      }
+      return &_slots[_head];
+    };
+
+    /**
+     * Removes the oldest element from the buffer.
+     */
+    void pop() {
+      if (!isEmpty()) {
+        _head = (_head + 1) % _capacity;
+        _size--;
+      }
+    };
+
+    /**
+     * Removes all elements from the buffer.
+     */
+    void clear() {
+      _head = 0;
+      _size = 0;
+    };
+};
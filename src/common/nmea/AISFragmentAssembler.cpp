@@ -0,0 +1,155 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <KBoxLogging.h>
+#include "common/stats/KBoxMetrics.h"
+#include "AISFragmentAssembler.h"
+#include "NMEASentenceReader.h"
+
+const uint8_t AISFragmentAssembler::maxPendingMessages;
+
+// Parses a field made of a single digit. Returns 0 if it is not.
+static uint8_t digitField(const NMEAField &f) {
+  if (f.length() != 1 || f[0] < '0' || f[0] > '9') {
+    return 0;
+  }
+  return f[0] - '0';
+}
+
+AISFragmentAssembler::AISFragmentAssembler() : _counter(0) {
+  for (uint8_t i = 0; i < maxPendingMessages; i++) {
+    _pending[i].used = false;
+  }
+}
+
+AISFragmentAssembler::Pending* AISFragmentAssembler::find(char sequence, char channel) {
+  for (uint8_t i = 0; i < maxPendingMessages; i++) {
+    Pending &p = _pending[i];
+    if (p.used && p.sequence == sequence && p.channel == channel) {
+      return &p;
+    }
+  }
+  return 0;
+}
+
+AISFragmentAssembler::Pending* AISFragmentAssembler::allocate() {
+  Pending *oldest = &_pending[0];
+  for (uint8_t i = 0; i < maxPendingMessages; i++) {
+    Pending &p = _pending[i];
+    if (!p.used) {
+      return &p;
+    }
+    if (p.lastUpdate < oldest->lastUpdate) {
+      oldest = &p;
+    }
+  }
+  drop(*oldest);
+  return oldest;
+}
+
+void AISFragmentAssembler::drop(Pending &p) {
+  DEBUG("Dropping incomplete AIS message (%i/%i fragments)", p.next - 1, p.total);
+  KBoxMetrics.event(KBoxEventAISFragmentDropped);
+  p.used = false;
+}
+
+const AISPayload* AISFragmentAssembler::add(const NMEASentenceReader &reader) {
+  _counter++;
+
+  uint8_t total = digitField(reader.getField(1));
+  uint8_t number = digitField(reader.getField(2));
+  NMEAField sequenceField = reader.getField(3);
+  NMEAField channelField = reader.getField(4);
+  NMEAField data = reader.getField(5);
+  uint8_t fillBits = digitField(reader.getField(6));
+
+  if (total == 0 || number == 0 || number > total) {
+    KBoxMetrics.event(KBoxEventAISFragmentDropped);
+    return 0;
+  }
+
+  if (total == 1) {
+    _single.clear();
+    if (!_single.append(data.data(), data.length(), fillBits)) {
+      return 0;
+    }
+    return &_single;
+  }
+
+  // Multi-sentence messages must have a sequential message id.
+  char sequence = sequenceField[0];
+  char channel = channelField[0];
+  if (sequenceField.isEmpty()) {
+    KBoxMetrics.event(KBoxEventAISFragmentDropped);
+    return 0;
+  }
+
+  Pending *p = find(sequence, channel);
+  if (number == 1) {
+    // A new message re-using the id of a message that was not completed.
+    if (p) {
+      drop(*p);
+    }
+    p = allocate();
+    p->used = true;
+    p->sequence = sequence;
+    p->channel = channel;
+    p->total = total;
+    p->next = 1;
+    p->payload.clear();
+  }
+  else if (!p) {
+    KBoxMetrics.event(KBoxEventAISFragmentDropped);
+    return 0;
+  }
+
+  if (p->total != total || p->next != number) {
+    drop(*p);
+    return 0;
+  }
+
+  // Only the last fragment has fill bits.
+  if (!p->payload.append(data.data(), data.length(), number == total ? fillBits : 0)) {
+    drop(*p);
+    return 0;
+  }
+  p->lastUpdate = _counter;
+  p->next++;
+
+  if (number == total) {
+    p->used = false;
+    return &p->payload;
+  }
+  return 0;
+}
+
+uint8_t AISFragmentAssembler::pendingCount() const {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < maxPendingMessages; i++) {
+    if (_pending[i].used) {
+      count++;
+    }
+  }
+  return count;
+}
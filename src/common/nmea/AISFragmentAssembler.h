@@ -0,0 +1,80 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "AISPayload.h"
+
+class NMEASentenceReader;
+
+/**
+ * Reassembles the payload of AIS messages which are split over multiple
+ * VDM/VDO sentences.
+ *
+ * A small fixed number of messages can be in progress at the same time
+ * (they are identified by their sequential message id and radio channel).
+ * When all the slots are used, the message that was updated least recently
+ * is dropped. Fragments received out of order are dropped with the message
+ * they belong to.
+ */
+class AISFragmentAssembler {
+  public:
+    static const uint8_t maxPendingMessages = 4;
+
+  private:
+    struct Pending {
+      AISPayload payload;
+      uint32_t lastUpdate;
+      uint8_t total;
+      uint8_t next;
+      char sequence;
+      char channel;
+      bool used;
+    };
+
+    Pending _pending[maxPendingMessages];
+    AISPayload _single;
+    uint32_t _counter;
+
+    Pending* find(char sequence, char channel);
+    Pending* allocate();
+    void drop(Pending &p);
+
+  public:
+    AISFragmentAssembler();
+
+    /**
+     * Adds one VDM/VDO sentence.
+     *
+     * @return the payload of the message when this sentence completes it, or
+     * a null pointer. The payload is only valid until the next call.
+     */
+    const AISPayload* add(const NMEASentenceReader &reader);
+
+    /**
+     * Number of messages waiting for more fragments.
+     */
+    uint8_t pendingCount() const;
+};
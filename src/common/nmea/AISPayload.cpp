@@ -0,0 +1,99 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "AISPayload.h"
+
+const uint16_t AISPayload::maxBits;
+
+bool AISPayload::append(const char *armored, uint8_t length, uint8_t fillBits) {
+  if (fillBits > 5 || _bits + length * 6 > maxBits) {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < length; i++) {
+    uint8_t c = armored[i];
+    // Valid characters are '0' to 'W' and '`' to 'w'
+    if (c < '0' || c > 'w' || (c > 'W' && c < '`')) {
+      return false;
+    }
+    c -= '0';
+    if (c > 40) {
+      c -= 8;
+    }
+
+    for (int8_t b = 5; b >= 0; b--) {
+      uint16_t byte = _bits / 8;
+      uint8_t mask = 0x80 >> (_bits % 8);
+      if (c & (1 << b)) {
+        _data[byte] |= mask;
+      }
+      else {
+        _data[byte] &= ~mask;
+      }
+      _bits++;
+    }
+  }
+
+  if (fillBits > _bits) {
+    return false;
+  }
+  _bits -= fillBits;
+  return true;
+}
+
+uint32_t AISPayload::getUnsigned(uint16_t start, uint8_t length) const {
+  uint32_t value = 0;
+  for (uint16_t bit = start; bit < start + length; bit++) {
+    value <<= 1;
+    if (bit < _bits && (_data[bit / 8] & (0x80 >> (bit % 8)))) {
+      value |= 1;
+    }
+  }
+  return value;
+}
+
+int32_t AISPayload::getSigned(uint16_t start, uint8_t length) const {
+  uint32_t value = getUnsigned(start, length);
+  if (length > 0 && length < 32 && (value & (1UL << (length - 1)))) {
+    value |= ~0UL << length;
+  }
+  return (int32_t)value;
+}
+
+void AISPayload::getText(uint16_t start, uint8_t characters, char *output) const {
+  uint8_t length = 0;
+  for (uint8_t i = 0; i < characters; i++) {
+    uint8_t c = getUnsigned(start + i * 6, 6);
+    // '@' marks the end of the text
+    if (c == 0) {
+      break;
+    }
+    output[length++] = c < 32 ? c + 64 : c;
+  }
+  while (length > 0 && output[length - 1] == ' ') {
+    length--;
+  }
+  output[length] = '\0';
+}
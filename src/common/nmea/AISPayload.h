@@ -0,0 +1,88 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * The binary payload of an AIS message.
+ *
+ * AIS sentences carry their payload "armored": every character of the data
+ * field encodes 6 bits. AISPayload decodes the characters of one or more
+ * sentences in a fixed size bit buffer and provides accessors to read the
+ * fields defined in ITU-R M.1371.
+ */
+class AISPayload {
+  public:
+    // Type 5 messages, the longest we decode, are 424 bits long and are
+    // sent in two sentences. Leave some room for longer messages.
+    static const uint16_t maxBits = 1024;
+
+  private:
+    uint8_t _data[maxBits / 8];
+    uint16_t _bits;
+
+  public:
+    AISPayload() : _bits(0) {};
+
+    void clear() {
+      _bits = 0;
+    };
+
+    /**
+     * Appends `length` armored characters. `fillBits` is the number of
+     * padding bits at the end of the data (only the last sentence of a
+     * message should have some).
+     *
+     * @return false if a character is invalid or if the payload is too long
+     * (the payload should be discarded).
+     */
+    bool append(const char *armored, uint8_t length, uint8_t fillBits = 0);
+
+    /**
+     * Number of bits in this payload.
+     */
+    uint16_t bitLength() const {
+      return _bits;
+    };
+
+    /**
+     * Read an unsigned integer of `length` bits (at most 32) starting at bit
+     * `start`. Bits after the end of the payload read as 0.
+     */
+    uint32_t getUnsigned(uint16_t start, uint8_t length) const;
+
+    /**
+     * Read a two's complement signed integer of `length` bits (at most 32).
+     */
+    int32_t getSigned(uint16_t start, uint8_t length) const;
+
+    /**
+     * Read `characters` 6-bit ASCII characters starting at bit `start` in
+     * `output`, which must be able to hold `characters + 1` bytes. The '@'
+     * padding and trailing spaces are removed.
+     */
+    void getText(uint16_t start, uint8_t characters, char *output) const;
+};
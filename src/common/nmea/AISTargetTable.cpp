@@ -0,0 +1,135 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "common/algo/Hash.h"
+#include "common/stats/KBoxMetrics.h"
+#include "AISTargetTable.h"
+
+AISTargetTable::AISTargetTable(uint16_t capacity) :
+  _entries(new Entry[capacity]), _capacity(capacity), _bucketBits(hashTableBits(capacity)), _size(0),
+  _lruHead(none), _lruTail(none) {
+  _buckets = new uint16_t[1 << _bucketBits];
+  for (uint32_t i = 0; i < (1u << _bucketBits); i++) {
+    _buckets[i] = none;
+  }
+}
+
+AISTargetTable::~AISTargetTable() {
+  delete[] _entries;
+  delete[] _buckets;
+}
+
+uint16_t AISTargetTable::bucketFor(uint32_t mmsi) const {
+  // MMSI of vessels in the same area share their first digits, so the
+  // bucket is taken from the high bits of the hash which depend on all of
+  // them.
+  return hashSlot(mmsi, _bucketBits);
+}
+
+uint16_t AISTargetTable::lookup(uint32_t mmsi) const {
+  if (_capacity == 0) {
+    return none;
+  }
+  for (uint16_t i = _buckets[bucketFor(mmsi)]; i != none; i = _entries[i].hashNext) {
+    if (_entries[i].target.mmsi == mmsi) {
+      return i;
+    }
+  }
+  return none;
+}
+
+void AISTargetTable::unlinkHash(uint16_t i) {
+  uint16_t *link = &_buckets[bucketFor(_entries[i].target.mmsi)];
+  while (*link != i) {
+    link = &_entries[*link].hashNext;
+  }
+  *link = _entries[i].hashNext;
+}
+
+void AISTargetTable::unlinkLRU(uint16_t i) {
+  Entry &e = _entries[i];
+  if (e.lruPrev != none) {
+    _entries[e.lruPrev].lruNext = e.lruNext;
+  }
+  else {
+    _lruHead = e.lruNext;
+  }
+  if (e.lruNext != none) {
+    _entries[e.lruNext].lruPrev = e.lruPrev;
+  }
+  else {
+    _lruTail = e.lruPrev;
+  }
+}
+
+void AISTargetTable::pushFront(uint16_t i) {
+  Entry &e = _entries[i];
+  e.lruPrev = none;
+  e.lruNext = _lruHead;
+  if (_lruHead != none) {
+    _entries[_lruHead].lruPrev = i;
+  }
+  _lruHead = i;
+  if (_lruTail == none) {
+    _lruTail = i;
+  }
+}
+
+AISTarget& AISTargetTable::touch(uint32_t mmsi) {
+  uint16_t i = lookup(mmsi);
+  if (i != none) {
+    if (i != _lruHead) {
+      unlinkLRU(i);
+      pushFront(i);
+    }
+    return _entries[i].target;
+  }
+
+  if (_size < _capacity) {
+    i = _size++;
+  }
+  else {
+    i = _lruTail;
+    unlinkHash(i);
+    unlinkLRU(i);
+    KBoxMetrics.event(KBoxEventAISTargetEvicted);
+  }
+
+  Entry &e = _entries[i];
+  memset(&e.target, 0, sizeof(e.target));
+  e.target.mmsi = mmsi;
+
+  uint16_t bucket = bucketFor(mmsi);
+  e.hashNext = _buckets[bucket];
+  _buckets[bucket] = i;
+  pushFront(i);
+
+  return e.target;
+}
+
+const AISTarget* AISTargetTable::find(uint32_t mmsi) const {
+  uint16_t i = lookup(mmsi);
+  return i != none ? &_entries[i].target : 0;
+}
@@ -0,0 +1,111 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * What we know about another vessel from its AIS static messages.
+ *
+ * Names, callsigns and ship types are not kept: SKValue cannot represent them
+ * so they are never published.
+ */
+struct AISTarget {
+  uint32_t mmsi;
+  // Distances in meters from the position reference point (0 if unknown)
+  uint16_t toBow;
+  uint16_t toStern;
+  uint8_t toPort;
+  uint8_t toStarboard;
+};
+
+/**
+ * A fixed capacity table of AIS targets indexed by MMSI.
+ *
+ * All the memory is allocated when the table is created. When the table is
+ * full, the target that was seen least recently is evicted to make room for
+ * the new one (and KBoxEventAISTargetEvicted is recorded). Lookups use a
+ * chained hash table (see common/algo/Hash.h) and recency is kept in a doubly linked list so that
+ * all operations are O(1).
+ */
+class AISTargetTable {
+  private:
+    static const uint16_t none = 0xFFFF;
+
+    struct Entry {
+      AISTarget target;
+      uint16_t hashNext;
+      uint16_t lruPrev;
+      uint16_t lruNext;
+    };
+
+    Entry *_entries;
+    uint16_t *_buckets;
+    uint16_t _capacity;
+    // There are 2^_bucketBits buckets.
+    uint8_t _bucketBits;
+    uint16_t _size;
+    // Most and least recently seen targets
+    uint16_t _lruHead;
+    uint16_t _lruTail;
+
+    uint16_t bucketFor(uint32_t mmsi) const;
+    uint16_t lookup(uint32_t mmsi) const;
+    void unlinkHash(uint16_t i);
+    void unlinkLRU(uint16_t i);
+    void pushFront(uint16_t i);
+
+    // Not copyable.
+    AISTargetTable(const AISTargetTable&);
+    AISTargetTable& operator=(const AISTargetTable&);
+
+  public:
+    /**
+     * Create a table that can hold up to `capacity` targets (between 1 and
+     * 65534).
+     */
+    AISTargetTable(uint16_t capacity);
+    ~AISTargetTable();
+
+    /**
+     * Returns the target with this MMSI, creating it if needed, and marks it
+     * as the most recently seen target.
+     */
+    AISTarget& touch(uint32_t mmsi);
+
+    /**
+     * Returns the target with this MMSI or a null pointer. Does not change
+     * the order of eviction.
+     */
+    const AISTarget* find(uint32_t mmsi) const;
+
+    uint16_t getSize() const {
+      return _size;
+    };
+
+    uint16_t getCapacity() const {
+      return _capacity;
+    };
+};
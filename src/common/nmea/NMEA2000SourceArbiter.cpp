@@ -0,0 +1,198 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "common/stats/KBoxMetrics.h"
+#include "NMEA2000SourceArbiter.h"
+
+NMEA2000SourceArbiter::NMEA2000SourceArbiter(const NMEA2000SourceArbiterConfig &config, uint16_t capacity) :
+  _config(config), _channels(new Channel[capacity]), _capacity(capacity), _millisecondsProvider(0),
+  _sourceStatsCount(0), _failovers(0) {
+  for (uint16_t i = 0; i < _capacity; i++) {
+    _channels[i].used = false;
+  }
+}
+
+NMEA2000SourceArbiter::~NMEA2000SourceArbiter() {
+  delete[] _channels;
+}
+
+uint32_t NMEA2000SourceArbiter::now() const {
+  if (_millisecondsProvider) {
+    return _millisecondsProvider();
+  }
+  return 0;
+}
+
+/*
+ * Position of the source in the list of preferred sources. Lower is better.
+ */
+int NMEA2000SourceArbiter::rankOf(uint8_t source) const {
+  for (int i = 0; i < _config.preferredSourcesCount; i++) {
+    if (_config.preferredSources[i] == source) {
+      return i;
+    }
+  }
+  return _config.preferredSourcesCount;
+}
+
+/*
+ * Returns the channel with this pgn and key, a new channel if it was not
+ * found, or null if the table is full.
+ */
+NMEA2000SourceArbiter::Channel* NMEA2000SourceArbiter::findChannel(uint32_t pgn, uint8_t key) {
+  Channel *unused = 0;
+  for (uint16_t i = 0; i < _capacity; i++) {
+    Channel &c = _channels[i];
+    if (!c.used) {
+      if (!unused) {
+        unused = &c;
+      }
+      continue;
+    }
+    if (c.pgn == pgn && c.key == key) {
+      return &c;
+    }
+  }
+  return unused;
+}
+
+NMEA2000SourceArbiter::SourceStats* NMEA2000SourceArbiter::statsFor(uint8_t source) {
+  for (uint8_t i = 0; i < _sourceStatsCount; i++) {
+    if (_sourceStats[i].source == source) {
+      return &_sourceStats[i];
+    }
+  }
+  if (_sourceStatsCount == maxSourceStats) {
+    return 0;
+  }
+  SourceStats &s = _sourceStats[_sourceStatsCount++];
+  s.source = source;
+  s.accepted = 0;
+  s.dropped = 0;
+  return &s;
+}
+
+const NMEA2000SourceArbiter::SourceStats* NMEA2000SourceArbiter::statsFor(uint8_t source) const {
+  for (uint8_t i = 0; i < _sourceStatsCount; i++) {
+    if (_sourceStats[i].source == source) {
+      return &_sourceStats[i];
+    }
+  }
+  return 0;
+}
+
+bool NMEA2000SourceArbiter::accept(uint32_t pgn, uint8_t key, uint8_t source) {
+  if (!_config.enabled) {
+    return true;
+  }
+
+  uint32_t t = now();
+  SourceStats *stats = statsFor(source);
+  Channel *c = findChannel(pgn, key);
+
+  if (c && !c->used) {
+    c->pgn = pgn;
+    c->key = key;
+    c->source = source;
+    c->lastSeen = t;
+    c->used = true;
+  }
+  else if (c && c->source != source) {
+    if (t - c->lastSeen > _config.failoverTimeout || rankOf(source) < rankOf(c->source)) {
+      c->source = source;
+      _failovers++;
+      KBoxMetrics.event(KBoxEventNMEA2000SourceFailover);
+    }
+    else {
+      if (stats) {
+        stats->dropped++;
+      }
+      KBoxMetrics.event(KBoxEventNMEA2000SourceDropped);
+      return false;
+    }
+  }
+
+  if (c) {
+    c->lastSeen = t;
+  }
+  if (stats) {
+    stats->accepted++;
+  }
+  return true;
+}
+
+uint8_t NMEA2000SourceArbiter::channelKey(uint32_t pgn, const unsigned char *data, int length) {
+  int offset;
+  uint8_t mask = 0xff;
+
+  switch (pgn) {
+    case 127245L: // Rudder instance
+    case 127488L: // Engine instance
+    case 127489L:
+    case 127493L:
+    case 127505L: // Fluid type and instance
+    case 127508L: // Battery instance
+      offset = 0;
+      break;
+    case 127250L: // Heading reference
+      offset = 7;
+      mask = 0x03;
+      break;
+    case 129026L: // COG reference
+      offset = 1;
+      mask = 0x03;
+      break;
+    case 130306L: // Wind reference
+      offset = 5;
+      mask = 0x07;
+      break;
+    case 130312L: // Temperature source
+    case 130314L: // Pressure source
+    case 130316L:
+      offset = 2;
+      break;
+    case 130577L: // COG reference
+      if (length < 1) {
+        return 0;
+      }
+      return (data[0] >> 4) & 0x03;
+    default:
+      return 0;
+  }
+
+  if (offset >= length) {
+    return 0;
+  }
+  return data[offset] & mask;
+}
+
+uint32_t NMEA2000SourceArbiter::getAccepted(uint8_t source) const {
+  const SourceStats *s = statsFor(source);
+  return s ? s->accepted : 0;
+}
+
+uint32_t NMEA2000SourceArbiter::getDropped(uint8_t source) const {
+  const SourceStats *s = statsFor(source);
+  return s ? s->dropped : 0;
+}
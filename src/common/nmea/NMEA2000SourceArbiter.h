@@ -0,0 +1,145 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "NMEA2000SourceArbiterConfig.h"
+
+/**
+ * Selects one source for each kind of NMEA2000 data when several devices
+ * send the same PGN (two GPS and an autopilot all sending 129025 for
+ * example), so that the values published do not flip between sources.
+ *
+ * Each channel (a PGN and, for PGNs that carry an instance or a reference,
+ * the value of that field) has a selected source. Messages from other
+ * sources are dropped until a more preferred source shows up or until the
+ * selected source has been silent for `failoverTimeout` milliseconds.
+ *
+ * Channels are kept in a fixed size table allocated when the arbiter is
+ * created. Messages of channels that do not fit in the table are always
+ * accepted.
+ */
+class NMEA2000SourceArbiter {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+    // Number of sources for which statistics are kept.
+    static const uint8_t maxSourceStats = 16;
+
+    struct SourceStats {
+      uint8_t source;
+      uint32_t accepted;
+      uint32_t dropped;
+    };
+
+  private:
+    struct Channel {
+      uint32_t pgn;
+      uint8_t key;
+      uint8_t source;
+      uint32_t lastSeen;
+      bool used;
+    };
+
+    const NMEA2000SourceArbiterConfig &_config;
+    Channel *_channels;
+    uint16_t _capacity;
+    millisecondsProvider_t _millisecondsProvider;
+    SourceStats _sourceStats[maxSourceStats];
+    uint8_t _sourceStatsCount;
+    uint32_t _failovers;
+
+    uint32_t now() const;
+    int rankOf(uint8_t source) const;
+    Channel* findChannel(uint32_t pgn, uint8_t key);
+    SourceStats* statsFor(uint8_t source);
+    const SourceStats* statsFor(uint8_t source) const;
+
+    // Not copyable.
+    NMEA2000SourceArbiter(const NMEA2000SourceArbiter&);
+    NMEA2000SourceArbiter& operator=(const NMEA2000SourceArbiter&);
+
+  public:
+    /**
+     * Create a new arbiter that can track up to `capacity` channels.
+     */
+    NMEA2000SourceArbiter(const NMEA2000SourceArbiterConfig &config, uint16_t capacity);
+    ~NMEA2000SourceArbiter();
+
+    /**
+     * Set the function used to know how many milliseconds have elapsed.
+     *
+     * If a milliseconds provider is not set, time never passes and a source
+     * is only replaced by a more preferred one.
+     */
+    void setMillisecondsProvider(millisecondsProvider_t millisecondsProvider) {
+      _millisecondsProvider = millisecondsProvider;
+    };
+
+    /**
+     * Returns true if the message with this `pgn` and channel `key` sent by
+     * `source` should be used, false if another source is preferred.
+     */
+    bool accept(uint32_t pgn, uint8_t key, uint8_t source);
+
+    /**
+     * Returns the channel key of a message: the instance or reference field
+     * of PGNs for which several sources legitimately send different data
+     * (two battery monitors, true and apparent wind, ...) and 0 for the
+     * other PGNs.
+     */
+    static uint8_t channelKey(uint32_t pgn, const unsigned char *data, int length);
+
+    /**
+     * Number of times the selected source of a channel was replaced.
+     */
+    uint32_t getFailovers() const {
+      return _failovers;
+    };
+
+    /**
+     * Number of messages accepted from `source`.
+     */
+    uint32_t getAccepted(uint8_t source) const;
+
+    /**
+     * Number of messages dropped from `source`.
+     */
+    uint32_t getDropped(uint8_t source) const;
+
+    /**
+     * Number of sources for which statistics are available.
+     */
+    uint8_t getSourceStatsCount() const {
+      return _sourceStatsCount;
+    };
+
+    /**
+     * Statistics of the `i`-th source seen by the arbiter.
+     */
+    const SourceStats& getSourceStats(uint8_t i) const {
+      return _sourceStats[i];
+    };
+};
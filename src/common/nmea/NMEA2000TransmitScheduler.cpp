@@ -0,0 +1,201 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "common/stats/KBoxMetrics.h"
+#include "NMEA2000SourceArbiter.h"
+#include "NMEA2000TransmitScheduler.h"
+
+NMEA2000TransmitScheduler::NMEA2000TransmitScheduler(SKNMEA2000Output &output, uint8_t capacity) :
+  _output(output), _slots(new Slot[capacity]), _capacity(capacity), _millisecondsProvider(0),
+  _sequence(0), _depth(0), _coalesced(0), _dropped(0), _retries(0) {
+  for (uint8_t i = 0; i < _capacity; i++) {
+    _slots[i].used = false;
+    _slots[i].pending = false;
+    _slots[i].sentAt = 0;
+  }
+}
+
+NMEA2000TransmitScheduler::~NMEA2000TransmitScheduler() {
+  delete[] _slots;
+}
+
+uint32_t NMEA2000TransmitScheduler::now() const {
+  if (_millisecondsProvider) {
+    return _millisecondsProvider();
+  }
+  return 0;
+}
+
+uint16_t NMEA2000TransmitScheduler::minIntervalOf(uint32_t pgn) {
+  // Default transmission rates of the NMEA2000 standard.
+  switch (pgn) {
+    case 127245L: // Rudder
+    case 127250L: // Vessel Heading
+    case 127251L: // Rate of Turn
+    case 129025L: // Position, Rapid Update
+    case 130306L: // Wind Data
+      return 100;
+    case 129026L: // COG & SOG, Rapid Update
+      return 250;
+    case 130310L: // Environmental Parameters
+      return 500;
+    case 126992L: // System Time
+    case 127257L: // Attitude
+    case 128259L: // Speed
+    case 128267L: // Water Depth
+    case 129029L: // GNSS Position Data
+      return 1000;
+    case 127508L: // Battery Status
+      return 1500;
+    case 130314L: // Actual Pressure
+      return 2000;
+    default:
+      return 0;
+  }
+}
+
+/*
+ * Returns the slot of this channel, or the slot where it should be stored,
+ * or null if all the slots have a message waiting to be sent.
+ */
+NMEA2000TransmitScheduler::Slot* NMEA2000TransmitScheduler::findSlot(uint32_t pgn, uint8_t key) {
+  Slot *replace = 0;
+  for (uint8_t i = 0; i < _capacity; i++) {
+    Slot &s = _slots[i];
+    if (s.used && s.pgn == pgn && s.key == key) {
+      return &s;
+    }
+
+    // Prefer a slot that was never used, then the one that sent the oldest
+    // message.
+    if (s.pending || (replace && !replace->used)) {
+      continue;
+    }
+    if (!s.used || !replace || (int32_t)(s.sentAt - replace->sentAt) < 0) {
+      replace = &s;
+    }
+  }
+  return replace;
+}
+
+/*
+ * Returns the oldest pending message whose interval has elapsed.
+ */
+NMEA2000TransmitScheduler::Slot* NMEA2000TransmitScheduler::findNext(uint32_t now) {
+  Slot *next = 0;
+  for (uint8_t i = 0; i < _capacity; i++) {
+    Slot &s = _slots[i];
+    if (!s.pending) {
+      continue;
+    }
+    if (s.sent && now - s.sentAt < minIntervalOf(s.pgn)) {
+      continue;
+    }
+    if (!next || (int32_t)(s.sequence - next->sequence) < 0) {
+      next = &s;
+    }
+  }
+  return next;
+}
+
+void NMEA2000TransmitScheduler::store(Slot &slot, const tN2kMsg &msg) {
+  slot.pgn = msg.PGN;
+  slot.priority = msg.Priority;
+  slot.source = msg.Source;
+  slot.destination = msg.Destination;
+  slot.dataLength = msg.DataLen;
+  memcpy(slot.data, msg.Data, msg.DataLen);
+}
+
+void NMEA2000TransmitScheduler::load(const Slot &slot, tN2kMsg &msg) {
+  msg.Init(slot.priority, slot.pgn, slot.source, slot.destination);
+  memcpy(msg.Data, slot.data, slot.dataLength);
+  msg.DataLen = slot.dataLength;
+}
+
+bool NMEA2000TransmitScheduler::write(const tN2kMsg &msg) {
+  if (msg.DataLen > maxDataLength) {
+    return _output.write(msg);
+  }
+
+  uint8_t key = NMEA2000SourceArbiter::channelKey(msg.PGN, msg.Data, msg.DataLen);
+  Slot *slot = findSlot(msg.PGN, key);
+
+  if (!slot) {
+    _dropped++;
+    KBoxMetrics.event(KBoxEventNMEA2000MessageDropped);
+    return false;
+  }
+
+  if (slot->used && slot->pending) {
+    // Keep the place of the message in the queue.
+    _coalesced++;
+    KBoxMetrics.event(KBoxEventNMEA2000MessageCoalesced);
+  }
+  else {
+    if (!slot->used || slot->pgn != msg.PGN || slot->key != key) {
+      slot->sent = false;
+    }
+    slot->pending = true;
+    slot->sequence = _sequence++;
+    _depth++;
+  }
+
+  store(*slot, msg);
+  slot->key = key;
+  slot->attempts = 0;
+  slot->used = true;
+  return true;
+}
+
+uint8_t NMEA2000TransmitScheduler::flush() {
+  uint32_t t = now();
+  uint8_t count = 0;
+
+  Slot *slot;
+  tN2kMsg msg;
+  while ((slot = findNext(t))) {
+    load(*slot, msg);
+    if (!_output.write(msg)) {
+      _retries++;
+      slot->attempts++;
+      if (slot->attempts >= maxAttempts) {
+        slot->pending = false;
+        _depth--;
+        _dropped++;
+        KBoxMetrics.event(KBoxEventNMEA2000MessageDropped);
+      }
+      // The output is busy, try again later.
+      break;
+    }
+
+    slot->pending = false;
+    slot->sent = true;
+    slot->sentAt = t;
+    _depth--;
+    count++;
+  }
+  return count;
+}
@@ -0,0 +1,170 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <N2kMsg.h>
+#include "common/signalk/SKNMEA2000Output.h"
+
+/**
+ * Queues the messages sent on the NMEA2000 bus and releases them no faster
+ * than the default transmission rate of their PGN.
+ *
+ * Messages are coalesced by channel (PGN and instance or reference, see
+ * NMEA2000SourceArbiter::channelKey()): a message waiting to be sent is
+ * replaced by a newer message of the same channel. A message that the
+ * output fails to send (CAN buffers full) stays in the queue and is retried
+ * on the next flush, up to `maxAttempts` times.
+ *
+ * All the memory is allocated when the scheduler is created. When all the
+ * slots hold a message waiting to be sent, new messages are dropped.
+ *
+ * A tN2kMsg reserves 223 bytes of data, so slots only keep the header and
+ * the first `maxDataLength` bytes of the message: a slot uses 64 bytes
+ * instead of about 250. Longer messages are written to the output
+ * immediately.
+ */
+class NMEA2000TransmitScheduler : public SKNMEA2000Output {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+    // Number of times the output is asked to send a message before it is
+    // dropped.
+    static const uint8_t maxAttempts = 3;
+
+    // Longest message that can be queued. This is the length of the longest
+    // message sent by KBox (129029, GNSS Position Data, without reference
+    // stations).
+    static const uint8_t maxDataLength = 43;
+
+  private:
+    struct Slot {
+      uint32_t pgn;
+      uint8_t priority;
+      uint8_t source;
+      uint8_t destination;
+      uint8_t dataLength;
+      uint8_t data[maxDataLength];
+      uint8_t key;
+      uint8_t attempts;
+      bool used;
+      bool pending;
+      bool sent;
+      uint32_t sequence;
+      uint32_t sentAt;
+    };
+
+    SKNMEA2000Output &_output;
+    Slot *_slots;
+    uint8_t _capacity;
+    millisecondsProvider_t _millisecondsProvider;
+    uint32_t _sequence;
+    uint8_t _depth;
+    uint32_t _coalesced;
+    uint32_t _dropped;
+    uint32_t _retries;
+
+    uint32_t now() const;
+    Slot* findSlot(uint32_t pgn, uint8_t key);
+    Slot* findNext(uint32_t now);
+    static void store(Slot &slot, const tN2kMsg &msg);
+    static void load(const Slot &slot, tN2kMsg &msg);
+
+    // Not copyable.
+    NMEA2000TransmitScheduler(const NMEA2000TransmitScheduler&);
+    NMEA2000TransmitScheduler& operator=(const NMEA2000TransmitScheduler&);
+
+  public:
+    /**
+     * Creates a scheduler that sends messages to `output` and can hold
+     * `capacity` channels.
+     */
+    NMEA2000TransmitScheduler(SKNMEA2000Output &output, uint8_t capacity);
+    ~NMEA2000TransmitScheduler();
+
+    /**
+     * Set the function used to know how many milliseconds have elapsed.
+     *
+     * If a milliseconds provider is not set, time never passes and only the
+     * first message of each rate limited channel is sent.
+     */
+    void setMillisecondsProvider(millisecondsProvider_t millisecondsProvider) {
+      _millisecondsProvider = millisecondsProvider;
+    };
+
+    /**
+     * Queues a copy of the message. It is sent by the next call to flush()
+     * after the interval of its PGN. Messages longer than `maxDataLength`
+     * are written to the output immediately.
+     *
+     * @return false if the message was dropped.
+     */
+    bool write(const tN2kMsg &msg) override;
+
+    /**
+     * Sends the queued messages whose interval has elapsed, oldest first,
+     * until the output fails to send one. This should be called regularly
+     * by the owner of the scheduler.
+     *
+     * @return the number of messages sent.
+     */
+    uint8_t flush();
+
+    /**
+     * Number of messages waiting to be sent.
+     */
+    uint8_t getQueueDepth() const {
+      return _depth;
+    };
+
+    /**
+     * Number of messages replaced by a newer message of the same channel
+     * before they could be sent.
+     */
+    uint32_t getCoalesced() const {
+      return _coalesced;
+    };
+
+    /**
+     * Number of messages dropped because the queue was full or because they
+     * could not be sent after `maxAttempts` attempts.
+     */
+    uint32_t getDropped() const {
+      return _dropped;
+    };
+
+    /**
+     * Number of failed attempts to send a message.
+     */
+    uint32_t getRetries() const {
+      return _retries;
+    };
+
+    /**
+     * Minimum number of milliseconds between two messages of the same
+     * channel for this PGN (0 if it is not limited).
+     */
+    static uint16_t minIntervalOf(uint32_t pgn);
+};
@@ -0,0 +1,138 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "common/stats/KBoxMetrics.h"
+#include "NMEADuplicateFilter.h"
+
+NMEADuplicateFilter::NMEADuplicateFilter(const NMEADuplicateFilterConfig &config, uint16_t capacity) :
+  _config(config), _entries(new Entry[capacity]), _capacity(capacity), _millisecondsProvider(0),
+  _hits(0), _misses(0) {
+  for (uint16_t i = 0; i < _capacity; i++) {
+    _entries[i].used = false;
+  }
+}
+
+NMEADuplicateFilter::~NMEADuplicateFilter() {
+  delete[] _entries;
+}
+
+uint32_t NMEADuplicateFilter::now() const {
+  if (_millisecondsProvider) {
+    return _millisecondsProvider();
+  }
+  return 0;
+}
+
+uint32_t NMEADuplicateFilter::hashSentence(const char *sentence) {
+  // FNV-1a of everything between the start delimiter and the checksum.
+  uint32_t h = 2166136261u;
+  const char *s = sentence;
+  if (*s == '$' || *s == '!') {
+    s++;
+  }
+  for (; *s && *s != '*' && *s != '\r' && *s != '\n'; s++) {
+    h ^= (uint8_t)*s;
+    h *= 16777619;
+  }
+  return h;
+}
+
+/*
+ * Returns the entry of this hash if it was seen during the window. `replace`
+ * is set to the entry where a new sentence should be remembered.
+ */
+NMEADuplicateFilter::Entry* NMEADuplicateFilter::lookup(uint32_t hash, uint32_t now, Entry *&replace) {
+  replace = 0;
+  bool replaceExpired = false;
+
+  for (uint16_t i = 0; i < _capacity; i++) {
+    Entry &e = _entries[i];
+    bool expired = !e.used || now - e.seenAt > _config.window;
+
+    if (!expired && e.hash == hash) {
+      replace = &e;
+      return &e;
+    }
+
+    // Prefer an entry that is not used anymore, then the oldest one.
+    if (replaceExpired) {
+      continue;
+    }
+    if (expired) {
+      replace = &e;
+      replaceExpired = true;
+    }
+    else if (!replace || e.seenAt - replace->seenAt > 0x80000000u) {
+      replace = &e;
+    }
+  }
+  return 0;
+}
+
+bool NMEADuplicateFilter::isDuplicate(const char *sentence, uint8_t origin) {
+  if (_config.scope == NMEADuplicateFilterScopeDisabled) {
+    return false;
+  }
+
+  uint32_t t = now();
+  uint32_t hash = hashSentence(sentence);
+  Entry *replace;
+  Entry *e = lookup(hash, t, replace);
+
+  if (e && (_config.scope == NMEADuplicateFilterScopeAllInputs || e->origin != origin)) {
+    _hits++;
+    KBoxMetrics.event(KBoxEventNMEADuplicateFilterHit);
+    return true;
+  }
+
+  _misses++;
+  KBoxMetrics.event(KBoxEventNMEADuplicateFilterMiss);
+  if (!replace) {
+    return false;
+  }
+  replace->hash = hash;
+  replace->seenAt = t;
+  replace->origin = origin;
+  replace->used = true;
+  return false;
+}
+
+void NMEADuplicateFilter::rememberOutput(const char *sentence) {
+  if (_config.scope == NMEADuplicateFilterScopeDisabled) {
+    return;
+  }
+
+  uint32_t t = now();
+  uint32_t hash = hashSentence(sentence);
+  Entry *replace;
+  lookup(hash, t, replace);
+  if (!replace) {
+    return;
+  }
+
+  replace->hash = hash;
+  replace->seenAt = t;
+  replace->origin = outputOrigin;
+  replace->used = true;
+}
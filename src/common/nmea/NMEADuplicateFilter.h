@@ -0,0 +1,116 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "NMEADuplicateFilterConfig.h"
+
+/**
+ * Remembers the sentences received recently so that a sentence arriving
+ * twice (the same talker connected to both inputs, or KBox output looped
+ * back into one of its inputs) is only repeated and parsed once.
+ *
+ * Only a hash of the sentence body (between the start delimiter and the
+ * checksum) is kept, in a fixed size table allocated when the filter is
+ * created. When the table is full, the oldest sentence is forgotten.
+ */
+class NMEADuplicateFilter {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+    // Origin used for the sentences sent by KBox.
+    static const uint8_t outputOrigin = 0xFF;
+
+  private:
+    struct Entry {
+      uint32_t hash;
+      uint32_t seenAt;
+      uint8_t origin;
+      bool used;
+    };
+
+    const NMEADuplicateFilterConfig &_config;
+    Entry *_entries;
+    uint16_t _capacity;
+    millisecondsProvider_t _millisecondsProvider;
+    uint32_t _hits;
+    uint32_t _misses;
+
+    uint32_t now() const;
+    Entry* lookup(uint32_t hash, uint32_t now, Entry *&replace);
+
+    // Not copyable.
+    NMEADuplicateFilter(const NMEADuplicateFilter&);
+    NMEADuplicateFilter& operator=(const NMEADuplicateFilter&);
+
+  public:
+    /**
+     * Create a new filter that can remember `capacity` sentences.
+     */
+    NMEADuplicateFilter(const NMEADuplicateFilterConfig &config, uint16_t capacity);
+    ~NMEADuplicateFilter();
+
+    /**
+     * Set the function used to know how many milliseconds have elapsed.
+     *
+     * If a milliseconds provider is not set, time never passes and sentences
+     * are remembered until they are pushed out of the table.
+     */
+    void setMillisecondsProvider(millisecondsProvider_t millisecondsProvider) {
+      _millisecondsProvider = millisecondsProvider;
+    };
+
+    /**
+     * Returns true if this sentence was already seen during the window and
+     * should be dropped. Otherwise the sentence is remembered as coming from
+     * `origin`.
+     */
+    bool isDuplicate(const char *sentence, uint8_t origin);
+
+    /**
+     * Remembers a sentence sent by KBox so that it is dropped if it comes
+     * back on one of the inputs.
+     */
+    void rememberOutput(const char *sentence);
+
+    /**
+     * Number of sentences found to be duplicates.
+     */
+    uint32_t getHits() const {
+      return _hits;
+    };
+
+    /**
+     * Number of sentences which were not duplicates.
+     */
+    uint32_t getMisses() const {
+      return _misses;
+    };
+
+    /**
+     * Hash of the body of a sentence, as used by the filter.
+     */
+    static uint32_t hashSentence(const char *sentence);
+};
@@ -0,0 +1,47 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+enum NMEADuplicateFilterScope {
+  NMEADuplicateFilterScopeDisabled,
+  // Drop a sentence that was already received on another input (or sent by
+  // KBox) during the window. Sentences repeated by the same input are kept.
+  NMEADuplicateFilterScopeOtherInputs,
+  // Drop a sentence that was already received on any input (including the
+  // same one) or sent by KBox during the window.
+  NMEADuplicateFilterScopeAllInputs
+};
+
+/**
+ * Configuration for NMEADuplicateFilter.
+ */
+struct NMEADuplicateFilterConfig {
+  enum NMEADuplicateFilterScope scope = NMEADuplicateFilterScopeOtherInputs;
+
+  // Duration in milliseconds during which a sentence is remembered.
+  uint32_t window = 500;
+};
@@ -0,0 +1,69 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+enum NMEARoutingAction {
+  NMEARoutingAllow,
+  NMEARoutingDeny
+};
+
+/**
+ * One rule deciding which messages are repeated to an output.
+ *
+ * A rule matches either NMEA0183 sentences (by talker id and sentence code)
+ * or NMEA2000 messages (by PGN and source address). Empty strings and
+ * negative numbers match everything.
+ */
+struct NMEARoutingRule {
+  enum NMEARoutingAction action;
+
+  bool nmea2000;
+
+  // Two characters talker id ("GP") and three characters sentence code
+  // ("RMC"). For proprietary and AIS sentences, these are simply the first
+  // two and the next three characters of the address ("PG" and "RME" for
+  // "$PGRME", "AI" and "VDM" for "!AIVDM").
+  char talker[3];
+  char sentence[4];
+
+  int32_t pgn;
+  int16_t source;
+};
+
+/**
+ * Routing rules of one output.
+ *
+ * A message is not repeated if it matches a deny rule. If there is at least
+ * one allow rule for its protocol, it must also match one of them. The order
+ * of the rules does not matter.
+ */
+struct NMEARoutingConfig {
+  static const int maxRules = 16;
+
+  NMEARoutingRule rules[maxRules];
+  int rulesCount = 0;
+};
@@ -0,0 +1,158 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "NMEARoutingFilter.h"
+
+// The (any, any) key is never stored in the table (it sets _all instead) so
+// it can mark the empty slots.
+static const uint64_t emptySlot = 0xFFFFFFFFFFFFFFFFull;
+
+static uint64_t makeKey(uint32_t first, uint32_t second) {
+  return ((uint64_t)first << 32) | second;
+}
+
+static uint32_t talkerKey(const char *talker) {
+  return ((uint8_t)talker[0] << 8) | (uint8_t)talker[1];
+}
+
+static uint32_t sentenceKey(const char *sentence) {
+  return ((uint8_t)sentence[0] << 16) | ((uint8_t)sentence[1] << 8) | (uint8_t)sentence[2];
+}
+
+// Index of the set of a rule in the constructor: allow/deny NMEA0183 then
+// allow/deny NMEA2000.
+static int ruleSetIndex(const NMEARoutingRule &rule) {
+  return (rule.nmea2000 ? 2 : 0) + (rule.action == NMEARoutingDeny ? 1 : 0);
+}
+
+NMEARoutingFilter::KeySet::~KeySet() {
+  delete[] _keys;
+}
+
+uint8_t NMEARoutingFilter::KeySet::slot(uint64_t key, uint8_t mask) {
+  return (uint8_t)((key * 0x9E3779B97F4A7C15ull) >> 56) & mask;
+}
+
+void NMEARoutingFilter::KeySet::allocate(uint8_t count) {
+  if (count == 0) {
+    return;
+  }
+  // Keep the table at most half full so that lookups stay short.
+  uint16_t size = 4;
+  while (size < 2 * count) {
+    size *= 2;
+  }
+  _keys = new uint64_t[size];
+  _mask = size - 1;
+  for (uint16_t i = 0; i < size; i++) {
+    _keys[i] = emptySlot;
+  }
+}
+
+void NMEARoutingFilter::KeySet::add(uint32_t first, uint32_t second) {
+  if (first == any && second == any) {
+    _all = true;
+    return;
+  }
+
+  uint64_t key = makeKey(first, second);
+  uint8_t i = slot(key, _mask);
+  while (_keys[i] != emptySlot) {
+    if (_keys[i] == key) {
+      return;
+    }
+    i = (i + 1) & _mask;
+  }
+  _keys[i] = key;
+}
+
+bool NMEARoutingFilter::KeySet::contains(uint64_t key) const {
+  if (!_keys) {
+    return false;
+  }
+  uint8_t i = slot(key, _mask);
+  while (_keys[i] != emptySlot) {
+    if (_keys[i] == key) {
+      return true;
+    }
+    i = (i + 1) & _mask;
+  }
+  return false;
+}
+
+bool NMEARoutingFilter::KeySet::matches(uint32_t first, uint32_t second) const {
+  return _all
+    || contains(makeKey(first, second))
+    || contains(makeKey(first, any))
+    || contains(makeKey(any, second));
+}
+
+NMEARoutingFilter::NMEARoutingFilter(const NMEARoutingConfig &config) {
+  uint8_t counts[4] = { 0, 0, 0, 0 };
+  KeySet *sets[4] = { &_allowNMEA, &_denyNMEA, &_allowNMEA2000, &_denyNMEA2000 };
+
+  for (int i = 0; i < config.rulesCount; i++) {
+    counts[ruleSetIndex(config.rules[i])]++;
+  }
+  for (int s = 0; s < 4; s++) {
+    sets[s]->allocate(counts[s]);
+  }
+
+  for (int i = 0; i < config.rulesCount; i++) {
+    const NMEARoutingRule &rule = config.rules[i];
+    uint32_t first, second;
+    if (rule.nmea2000) {
+      first = rule.pgn >= 0 ? (uint32_t)rule.pgn : any;
+      second = rule.source >= 0 ? (uint32_t)rule.source : any;
+    }
+    else {
+      first = rule.talker[0] ? talkerKey(rule.talker) : any;
+      second = rule.sentence[0] ? sentenceKey(rule.sentence) : any;
+    }
+    sets[ruleSetIndex(rule)]->add(first, second);
+  }
+}
+
+bool NMEARoutingFilter::accepts(const KeySet &allow, const KeySet &deny, uint32_t first, uint32_t second) {
+  if (deny.matches(first, second)) {
+    return false;
+  }
+  return allow.isEmpty() || allow.matches(first, second);
+}
+
+bool NMEARoutingFilter::accepts(const char *sentence) const {
+  // "$GPRMC" or "!AIVDM": two characters of talker id, three of sentence
+  // code. A truncated address only matches the rules that match everything.
+  uint32_t talker = 0;
+  uint32_t code = 0;
+  if (sentence[0] && sentence[1] && sentence[2] && sentence[3] && sentence[4] && sentence[5]) {
+    talker = talkerKey(sentence + 1);
+    code = sentenceKey(sentence + 3);
+  }
+  return accepts(_allowNMEA, _denyNMEA, talker, code);
+}
+
+bool NMEARoutingFilter::accepts(uint32_t pgn, uint8_t source) const {
+  return accepts(_allowNMEA2000, _denyNMEA2000, pgn, source);
+}
@@ -0,0 +1,89 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "NMEARoutingConfig.h"
+
+/**
+ * Decides if a message should be repeated to an output, following the rules
+ * of a NMEARoutingConfig.
+ *
+ * The rules are compiled when the filter is created into small hash sets so
+ * that checking a message only takes a few lookups, whatever the number of
+ * rules.
+ */
+class NMEARoutingFilter {
+  private:
+    /*
+     * Set of (first, second) keys where each part can be a wildcard.
+     * Implemented as an open addressing hash table.
+     */
+    class KeySet {
+      private:
+        uint64_t *_keys;
+        uint8_t _mask;
+        bool _all;
+
+        static uint8_t slot(uint64_t key, uint8_t mask);
+
+      public:
+        KeySet() : _keys(0), _mask(0), _all(false) {};
+        ~KeySet();
+
+        void allocate(uint8_t count);
+        void add(uint32_t first, uint32_t second);
+        bool contains(uint64_t key) const;
+        bool matches(uint32_t first, uint32_t second) const;
+        bool isEmpty() const {
+          return !_all && !_keys;
+        };
+    };
+
+    KeySet _allowNMEA, _denyNMEA;
+    KeySet _allowNMEA2000, _denyNMEA2000;
+
+    static bool accepts(const KeySet &allow, const KeySet &deny, uint32_t first, uint32_t second);
+
+    // Not copyable.
+    NMEARoutingFilter(const NMEARoutingFilter&);
+    NMEARoutingFilter& operator=(const NMEARoutingFilter&);
+
+  public:
+    // Used for the parts of a rule that match everything.
+    static const uint32_t any = 0xFFFFFFFF;
+
+    NMEARoutingFilter(const NMEARoutingConfig &config);
+
+    /**
+     * Returns true if this NMEA0183 sentence should be repeated.
+     */
+    bool accepts(const char *sentence) const;
+
+    /**
+     * Returns true if this NMEA2000 message should be repeated.
+     */
+    bool accepts(uint32_t pgn, uint8_t source) const;
+};
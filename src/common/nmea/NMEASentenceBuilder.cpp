@@ -22,57 +22,125 @@
   THE SOFTWARE.
 */
 
+#include <math.h>
+#include <stdio.h>
 #include "NMEASentenceBuilder.h"
-#include "nmea.h"
 
 static const char *hex = "0123456789ABCDEF";
 
-NMEASentenceBuilder::NMEASentenceBuilder(String talkerId, String sentenceId, int numFields) :
-  talkerId(talkerId), sentenceId(sentenceId), numFields(numFields)
-{
-  fields = new String[numFields];
+static const uint32_t powersOf10[] = {
+  1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Length of the sentence, including the "*XX" checksum. The outputs add
+// "\r\n" after it.
+static const uint8_t maxLength = NMEASentenceBuilder::maxSentenceLength - 1 - 2;
+
+NMEASentenceBuilder::NMEASentenceBuilder(const char *talkerId, const char *sentenceId, int numFields) :
+  _length(0), _checksum(0), _numFields(numFields), _currentField(0), _overflow(false), _complete(false) {
+  append('$');
+  // The '$' is not part of the checksum
+  _checksum = 0;
+  append(talkerId);
+  append(sentenceId);
 }
 
-NMEASentenceBuilder::~NMEASentenceBuilder() {
-  delete[] fields;
+void NMEASentenceBuilder::append(char c) {
+  // Always keep room for the "*XX" checksum.
+  if (_length + 1 + 3 > maxLength) {
+    _overflow = true;
+    return;
+  }
+  _buffer[_length++] = c;
+  _checksum ^= c;
 }
 
-NMEASentenceBuilder& NMEASentenceBuilder::operator=(const NMEASentenceBuilder& other) {
-  talkerId = other.talkerId;
-  sentenceId = other.sentenceId;
-  numFields = other.numFields;
-
-  delete[] fields;
+void NMEASentenceBuilder::append(const char *s) {
+  while (*s != '\0') {
+    append(*s++);
+  }
+}
 
-  fields = new String[numFields];
-  for (int i = 0; i < numFields; i++) {
-    fields[i] = other.fields[i];
+bool NMEASentenceBuilder::startField(int fieldId) {
+  if (_complete || fieldId <= _currentField || fieldId > _numFields) {
+    return false;
   }
-  return *this;
+  while (_currentField < fieldId) {
+    append(',');
+    _currentField++;
+  }
+  return true;
 }
 
-void NMEASentenceBuilder::setField(int fieldId, String v) {
-  if (fieldId > 0 && fieldId <= numFields) {
-    fields[fieldId - 1] = v;
+void NMEASentenceBuilder::setField(int fieldId, const char *s) {
+  if (startField(fieldId) && s) {
+    append(s);
   }
 }
 
 void NMEASentenceBuilder::setField(int fieldId, float v, int precision) {
-  setField(fieldId, String(v, precision));
+  if (!startField(fieldId) || isnan(v) || precision < 0 || precision > 9) {
+    return;
+  }
+
+  // Round to an integer number of 10^-precision. The single precision FPU
+  // does this in a few cycles; only values too large for 32 bits go through
+  // snprintf().
+  float scaled = fabsf(v) * powersOf10[precision] + 0.5f;
+  if (!(scaled < 4294967040.0f)) {
+    char s[48];
+    snprintf(s, sizeof(s), "%.*f", precision, (double)v);
+    append(s);
+    return;
+  }
+  uint32_t n = (uint32_t)scaled;
+
+  if (v < 0 && n > 0) {
+    append('-');
+  }
+
+  // Digits are generated from the least significant one.
+  char digits[12];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < precision; i++) {
+    digits[count++] = '0' + n % 10;
+    n /= 10;
+  }
+  do {
+    digits[count++] = '0' + n % 10;
+    n /= 10;
+  } while (n > 0);
+
+  while (count > 0) {
+    count--;
+    append(digits[count]);
+    if (count == precision && precision > 0) {
+      append('.');
+    }
+  }
 }
 
 SKNMEASentence NMEASentenceBuilder::toNMEA() {
-  SKNMEASentence nmea = SKNMEASentence("$" + talkerId + sentenceId);
-
-  for (int i = 0; i < numFields; i++) {
-    nmea += "," + fields[i];
+  if (_complete) {
+    return SKNMEASentence(_buffer, _length);
   }
+  _complete = true;
 
-  nmea += "*";
+  while (_currentField < _numFields) {
+    append(',');
+    _currentField++;
+  }
 
-  uint8_t checksum = nmea_compute_checksum(nmea.c_str());
-  nmea += hex[checksum / 16];
-  nmea += hex[checksum % 16];
+  if (_overflow) {
+    _length = 0;
+    _buffer[0] = '\0';
+    return SKNMEASentence(_buffer, 0);
+  }
 
-  return nmea;
+  // There is always room for the checksum: append() keeps it free.
+  _buffer[_length++] = '*';
+  _buffer[_length++] = hex[_checksum / 16];
+  _buffer[_length++] = hex[_checksum % 16];
+  _buffer[_length] = '\0';
+  return SKNMEASentence(_buffer, _length);
 }
@@ -22,18 +22,38 @@
   THE SOFTWARE.
 */
 
-#include <WString.h>
+#pragma once
+
+#include <stdint.h>
 #include "signalk/SKNMEASentence.h"
 
 /** A utility class to generate a properly formatted and checksum'd NMEA
  * sentence.
+ *
+ * The sentence is formatted directly in a buffer inside the builder and the
+ * checksum is updated as fields are added, so building a sentence does not
+ * allocate any memory. Fields must be set in increasing order; fields that
+ * are skipped are left empty.
  */
 class NMEASentenceBuilder {
+  public:
+    // Defined by the NMEA Standard: 82 characters (including the "\r\n" that
+    // the outputs add) plus a terminating NUL.
+    static const uint8_t maxSentenceLength = 83;
+
   private:
-    String talkerId;
-    String sentenceId;
-    int numFields = 0;
-    String *fields;
+    char _buffer[maxSentenceLength];
+    uint8_t _length;
+    uint8_t _checksum;
+    // Number of fields in the sentence and number of fields written so far
+    uint8_t _numFields;
+    uint8_t _currentField;
+    bool _overflow;
+    bool _complete;
+
+    void append(char c);
+    void append(const char *s);
+    bool startField(int fieldId);
 
   public:
     /** Creates a new instance
@@ -43,24 +63,32 @@ class NMEASentenceBuilder {
      * three upper-case letters.
      * @param largest field identifier that will be used in this sentence.
      */
-    NMEASentenceBuilder(String talkerId, String sentenceId, int numFields);
-    ~NMEASentenceBuilder();
-
-    NMEASentenceBuilder& operator=(const NMEASentenceBuilder& other);
+    NMEASentenceBuilder(const char *talkerId, const char *sentenceId, int numFields);
 
     /** Set the value of one of the field.
      * Note that fields are numbered from 1 so as to match the NMEA reference:
      * http://catb.org/gpsd/NMEA.html
      *
+     * Fields must be set in increasing order. Setting a field that is before
+     * the last field set has no effect.
+     *
      * @param fieldId the identifier of the field (between 1 and numFields
      * included)
      * @param s the new value
      */
-    void setField(int fieldId, String s);
+    void setField(int fieldId, const char *s);
+
+    /** Set the value of a field to a number with `precision` decimals
+     * (between 0 and 9). NaN is written as an empty field.
+     */
     void setField(int fieldId, float v, int precision);
 
-    /** Returns a string with a properly formatted NMEA sentence, terminated by
-     * a checksum and "\r\n\0".
+    /** Returns the properly formatted NMEA sentence, terminated by the
+     * checksum. The sentence is stored in this builder so it is only valid as
+     * long as the builder exists. If the sentence did not fit in
+     * maxSentenceLength, an empty sentence is returned.
+     *
+     * Fields cannot be changed after the sentence has been generated.
      */
     SKNMEASentence toNMEA();
 };
@@ -23,102 +23,223 @@
 */
 
 #include <math.h> // NAN
+#include <stdlib.h>
+#include <string.h>
 #include "NMEASentenceReader.h"
-#include "nmea.h"
 
-bool NMEASentenceReader::isValid() const {
-  return nmea_is_valid(_sentence.c_str());
+static int hexDigitValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'A' && c <= 'F') {
+    return 10 + (c - 'A');
+  }
+  if (c >= 'a' && c <= 'f') {
+    return 10 + (c - 'a');
+  }
+  return -1;
 }
 
-const String NMEASentenceReader::getTalkerId() const {
-  return _sentence.substring(1, 3);
+bool NMEAField::operator==(const char *s) const {
+  return s && strncmp(_data, s, _length) == 0 && s[_length] == '\0';
 }
 
-const String NMEASentenceReader::getSentenceCode() const {
-  return _sentence.substring(3, _sentence.indexOf(','));
+String NMEAField::toString() const {
+  String s;
+  s.reserve(_length);
+  for (uint8_t i = 0; i < _length; i++) {
+    s += _data[i];
+  }
+  return s;
 }
 
-int NMEASentenceReader::countFields() const {
-  const char *s = _sentence.c_str();
-  int count = 0;
+// Every power of 10 up to 1e22 is exactly representable as a double.
+static const double powersOf10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+static const uint8_t maxDecimals = sizeof(powersOf10) / sizeof(powersOf10[0]) - 1;
 
-  int i = 0;
-  while (s[i] != '\0') {
-    if (s[i] == ',') {
-      count++;
-    }
-    i++;
-  }
-  return count;
+// Integers with up to 15 digits are exactly representable as a double.
+static const uint8_t maxSignificantDigits = 15;
+
+double NMEADecimal::toDouble() const {
+  // Both operands are exact so the division is correctly rounded.
+  return (double)mantissa / powersOf10[decimals];
 }
 
-const String NMEASentenceReader::getFieldAsString(int id) const {
-  int pos = 0;
-  int index = 0;
+bool NMEAField::toDecimal(NMEADecimal &decimal) const {
+  uint8_t i = 0;
+  bool negative = false;
+  if (_length > 0 && (_data[0] == '-' || _data[0] == '+')) {
+    negative = _data[0] == '-';
+    i++;
+  }
 
-  while(index < id) {
-    pos = _sentence.indexOf(',', pos + 1);
-    if (pos == -1) {
-      break;
+  uint64_t mantissa = 0;
+  uint8_t digits = 0;
+  uint8_t significantDigits = 0;
+  uint8_t decimals = 0;
+  bool dot = false;
+
+  for (; i < _length; i++) {
+    char c = _data[i];
+    if (c == '.' && !dot) {
+      dot = true;
+      continue;
     }
-    index++;
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    digits++;
+    if (mantissa > 0 || c != '0') {
+      significantDigits++;
+    }
+    if (dot) {
+      decimals++;
+    }
+    mantissa = mantissa * 10 + (c - '0');
   }
-  if (pos == -1) {
-    return "";
+
+  if (digits == 0 || significantDigits > maxSignificantDigits || decimals > maxDecimals) {
+    return false;
   }
-  else {
-    // fields are terminated by another ',' or by '*'
-    int end = _sentence.indexOf(',', pos + 1);
-    if (end == -1) {
-      end = _sentence.indexOf('*', pos + 1);
+  decimal.mantissa = negative ? -(int64_t)mantissa : (int64_t)mantissa;
+  decimal.decimals = decimals;
+  return true;
+}
+
+void NMEASentenceReader::tokenize() {
+  _valid = false;
+  _fieldsCount = 0;
+  _indexedFields = 0;
+
+  if (_sentence == 0 || _sentence[0] == '\0') {
+    return;
+  }
+
+  // Fields are terminated by a ',' or by the '*' which starts the checksum.
+  // Field 0 starts right after the '$' or '!'.
+  uint8_t checksum = 0;
+  int fieldStart = 1;
+  int i = 1;
+  for (; _sentence[i] != '\0' && _sentence[i] != '*'; i++) {
+    if (i >= maxLength) {
+      return;
     }
-    if (end == -1) {
-      // Something went wrong here :(
-      return "";
+    checksum ^= _sentence[i];
+    if (_sentence[i] == ',') {
+      if (_indexedFields < maxFields) {
+        _fieldStart[_indexedFields] = fieldStart;
+        _fieldLength[_indexedFields] = i - fieldStart;
+        _indexedFields++;
+      }
+      _fieldsCount++;
+      fieldStart = i + 1;
     }
+  }
+
+  if (_sentence[i] != '*') {
+    return;
+  }
+  if (_indexedFields < maxFields) {
+    _fieldStart[_indexedFields] = fieldStart;
+    _fieldLength[_indexedFields] = i - fieldStart;
+    _indexedFields++;
+  }
+
+  // The checksum is one or two hexadecimal digits.
+  int expected = hexDigitValue(_sentence[i + 1]);
+  if (expected < 0) {
+    return;
+  }
+  int low = hexDigitValue(_sentence[i + 2]);
+  if (low >= 0) {
+    expected = (expected << 4) + low;
+  }
+
+  _valid = (_sentence[0] == '$' || _sentence[0] == '!') && expected == checksum;
+}
+
+NMEAField NMEASentenceReader::getField(int i) const {
+  if (i < 0 || i >= _indexedFields) {
+    return NMEAField();
+  }
+  return NMEAField(_sentence + _fieldStart[i], _fieldLength[i]);
+}
+
+const String NMEASentenceReader::getTalkerId() const {
+  NMEAField address = getField(0);
+  return NMEAField(address.data(), address.length() < 2 ? address.length() : 2).toString();
+}
 
-    return _sentence.substring(pos + 1, end);
+const String NMEASentenceReader::getSentenceCode() const {
+  NMEAField address = getField(0);
+  if (address.length() <= 2) {
+    return "";
   }
+  return NMEAField(address.data() + 2, address.length() - 2).toString();
+}
+
+const String NMEASentenceReader::getFieldAsString(int id) const {
+  return getField(id).toString();
 }
 
 char NMEASentenceReader::getFieldAsChar(int id) const {
-  String f = getFieldAsString(id);
+  NMEAField f = getField(id);
   if (f.length() != 1) {
     return '\0';
   }
   else {
-    return f.c_str()[0];
+    return f[0];
   }
 }
 
 double NMEASentenceReader::getFieldAsDouble(int id) const {
-  String f = getFieldAsString(id);
+  NMEAField f = getField(id);
 
-  if (f.length() == 0) {
+  if (f.isEmpty()) {
     return NAN;
   }
-  return strtod(f.c_str(), 0);
+
+  NMEADecimal decimal;
+  if (f.toDecimal(decimal)) {
+    // -0 is the one value that the mantissa cannot carry.
+    if (decimal.mantissa == 0 && f[0] == '-') {
+      return -0.0;
+    }
+    return decimal.toDouble();
+  }
+
+  // Anything else (exponents, very long numbers or invalid values) is
+  // rare enough to be left to strtod(). Fields are followed by ',' or '*' so
+  // strtod() will not read past the end of the field.
+  return strtod(f.data(), 0);
 }
 
 double NMEASentenceReader::getFieldAsLatLon(int id) const {
-  String value = getFieldAsString(id);
+  NMEAField value = getField(id);
   char sign = getFieldAsChar(id+1);
 
-  if (value.length() == 0 || sign == 0) {
+  NMEADecimal decimal;
+  if (sign == 0 || !value.toDecimal(decimal) || decimal.mantissa < 0) {
     return NAN;
   }
 
-  // There are normally two digits for minutes before the '.':
-  //   DDMM.MMM
-  int degreesDigits = value.indexOf('.') - 2;
-  if (degreesDigits < 0) {
-    degreesDigits = 0;
+  // The two digits before the '.' are minutes: DDMM.MMM
+  // Split them from the degrees without leaving fixed point. With more than
+  // 16 decimals, the value (at most 15 digits) is less than one minute.
+  int64_t degrees = 0;
+  NMEADecimal minutes = decimal;
+  if (decimal.decimals <= 16) {
+    int64_t degreesScale = 100;
+    for (uint8_t i = 0; i < decimal.decimals; i++) {
+      degreesScale *= 10;
+    }
+    degrees = decimal.mantissa / degreesScale;
+    minutes.mantissa -= degrees * degreesScale;
   }
-
-  String angle = value.substring(0, degreesDigits);
-  String minutes = value.substring(degreesDigits);
-
-  double latlon = angle.toInt() + strtod(minutes.c_str(), 0) / 60;
+  double latlon = degrees + minutes.toDouble() / 60;
 
   switch (sign) {
     case 'N':
@@ -131,4 +252,3 @@ double NMEASentenceReader::getFieldAsLatLon(int id) const {
       return NAN;
   }
 }
-
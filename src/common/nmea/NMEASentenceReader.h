@@ -24,32 +24,129 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <WString.h>
 
+/**
+ * A decimal number read from a NMEA field, in fixed point: the value is
+ * `mantissa / 10^decimals`. Lets callers work on integers and only convert
+ * to floating point when they need to.
+ */
+struct NMEADecimal {
+  int64_t mantissa;
+  uint8_t decimals;
+
+  /**
+   * Returns the value as a double. The conversion is correctly rounded so
+   * the result is the same as strtod() on the original text.
+   */
+  double toDouble() const;
+};
+
+/**
+ * A field of a NMEA sentence. This is a view inside the sentence passed to
+ * NMEASentenceReader: it does not own any memory and the data is not
+ * NUL-terminated.
+ */
+class NMEAField {
+  private:
+    const char *_data;
+    uint8_t _length;
+
+  public:
+    NMEAField() : _data(""), _length(0) {};
+    NMEAField(const char *data, uint8_t length) : _data(data), _length(length) {};
+
+    const char* data() const {
+      return _data;
+    };
+
+    uint8_t length() const {
+      return _length;
+    };
+
+    bool isEmpty() const {
+      return _length == 0;
+    };
+
+    char operator[](uint8_t i) const {
+      return i < _length ? _data[i] : '\0';
+    };
+
+    bool operator==(const char *s) const;
+
+    bool operator!=(const char *s) const {
+      return !(*this == s);
+    };
+
+    /**
+     * Copy the field in a new String.
+     */
+    String toString() const;
+
+    /**
+     * Parses a field made of an optional sign, digits and an optional
+     * decimal part ("-12.5", "3751.6035", "5.") without strtod().
+     *
+     * @return false if the field is empty, is not formatted like this or has
+     * more than 15 significant digits.
+     */
+    bool toDecimal(NMEADecimal &decimal) const;
+};
+
 /**
  * This class provides a set of functions to make parsing NMEA sentences easier.
  *
+ * The sentence is split in fields once, when the reader is created, and the
+ * checksum is verified in the same pass. The reader does not copy the
+ * sentence so it must stay valid as long as the reader is used.
+ *
  * All the getFieldAs...() functions have a few important things in common:
  *  - Fields are numbered starting at 1 to match the amazing NMEA reference
  *    produced by Eric S Raymond (http://www.catb.org/gpsd/NMEA.html)
- *  - If you do not pass a field id, the reader will auto-increment.
+ *  - Field 0 is the address field (talker id and sentence code).
  */
 class NMEASentenceReader {
+  public:
+    // Maximum number of fields (including the address field) that can be
+    // read. NMEA sentences are limited to 82 characters so this is enough
+    // for all standard sentences.
+    static const uint8_t maxFields = 32;
+
+    // Sentences longer than this are not valid.
+    static const uint8_t maxLength = 255;
+
   private:
-    String _sentence;
+    const char *_sentence;
+    bool _valid;
+    uint8_t _fieldsCount;
+    uint8_t _indexedFields;
+    uint8_t _fieldStart[maxFields];
+    uint8_t _fieldLength[maxFields];
+
+    void tokenize();
 
   public:
     /**
      * Creates a new instance of NMEASentenceReader to parse a NMEASentence.
      */
-    NMEASentenceReader(const String &sentence)
-      : _sentence(sentence) {
+    NMEASentenceReader(const char *sentence) : _sentence(sentence) {
+      tokenize();
+    };
+
+    NMEASentenceReader(const String &sentence) : _sentence(sentence.c_str()) {
+      tokenize();
     };
 
+    // The reader does not copy the sentence so it cannot take a temporary.
+    NMEASentenceReader(String &&sentence) = delete;
+
     /**
      * Return true if this is a valid NMEA sentence.
      */
-    bool isValid() const;
+    bool isValid() const {
+      return _valid;
+    };
 
     /**
      * Return a two characters long string identifying the talker.
@@ -65,30 +162,31 @@ class NMEASentenceReader {
      * Return the number of fields in the sentence
      * This only counts data fields, not the prefix and checksum.
      */
-    int countFields() const;
+    int countFields() const {
+      return _fieldsCount;
+    };
+
+    /**
+     * Return field i or an empty field if it does not exist.
+     */
+    NMEAField getField(int i) const;
 
     /**
      * Return the value of field i as a double or NaN if the field does not
      * exist, or is empty. If a conversion error occurs (the string is not a
      * valid number), 0 will be returned.
-     *
-     * If i is omitted, auto-incrementation will be used.
      */
     double getFieldAsDouble(int i = 0) const;
 
     /**
      * Return the value of field i as a char or '\0` if the field does not
      * exist, is empty or is longer than 1 byte.
-     *
-     * If i is omitted, auto-incrementation will be used.
      */
     char getFieldAsChar(int i = 0) const;
 
     /**
      * Return the value of field i as a String or an empty string if the field
      * does not exist or is empty.
-     *
-     * If i is omitted, auto-incrementation will be used.
      */
     const String getFieldAsString(int i = 0) const;
 
@@ -103,6 +201,3 @@ class NMEASentenceReader {
      */
     double getFieldAsLatLon(int i = 0) const;
 };
-
-
-
@@ -0,0 +1,119 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <KBoxLogging.h>
+#include "NMEASerialFramer.h"
+
+NMEASerialFramer::NMEASerialFramer(Stream &stream, uint16_t capacity, uint16_t rxBufferSize,
+                                   enum KBoxEvent rxBufferOverflowEvent, enum KBoxEvent rxOverflowEvent,
+                                   enum KBoxEvent rxErrorEvent) :
+  _stream(stream), _slots(new Slot[capacity + 1]), _slotsCount(capacity + 1), _rxBufferSize(rxBufferSize),
+  _rxBufferOverflowEvent(rxBufferOverflowEvent), _rxOverflowEvent(rxOverflowEvent), _rxErrorEvent(rxErrorEvent),
+  _readIndex(0), _writeIndex(0), _length(0), _discarding(false) {
+}
+
+NMEASerialFramer::~NMEASerialFramer() {
+  delete[] _slots;
+}
+
+void NMEASerialFramer::poll() {
+  // The Teensy receive ring buffer keeps one slot empty, so it is full when
+  // it holds rxBufferSize - 1 bytes.
+  if (_rxBufferSize > 1 && _stream.available() >= _rxBufferSize - 1) {
+    KBoxMetrics.event(_rxBufferOverflowEvent);
+    DEBUG("Found a full rx buffer - we probably lost some data");
+  }
+
+  // The slot at _writeIndex is never visible to the consumer so the sentence
+  // can be assembled in place.
+  char *sentence = _slots[_writeIndex].sentence;
+
+  while (_stream.available()) {
+    char c = (char)_stream.read();
+
+    if (c == '\r' || c == '\n') {
+      endOfLine();
+      sentence = _slots[_writeIndex].sentence;
+      continue;
+    }
+    if (_discarding) {
+      continue;
+    }
+
+    // Keep space for the terminating NUL character.
+    if (_length >= maxSentenceLength - 1) {
+      sentence[maxSentenceLength - 1] = 0;
+      DEBUG("Discarding incomplete sequence: %s", sentence);
+      KBoxMetrics.event(_rxErrorEvent);
+      _length = 0;
+      _discarding = true;
+      continue;
+    }
+    sentence[_length++] = c;
+  }
+}
+
+void NMEASerialFramer::endOfLine() {
+  if (_discarding || _length == 0) {
+    _discarding = false;
+    _length = 0;
+    return;
+  }
+
+  _slots[_writeIndex].sentence[_length] = 0;
+  _length = 0;
+
+  uint16_t next = (_writeIndex + 1) % _slotsCount;
+  if (next == _readIndex) {
+    // The consumer is not keeping up. Drop this sentence, its slot will be
+    // reused for the next one.
+    KBoxMetrics.event(_rxOverflowEvent);
+    return;
+  }
+
+  // Make sure the sentence is written before the consumer can see it.
+  __sync_synchronize();
+  _writeIndex = next;
+}
+
+const char* NMEASerialFramer::front() const {
+  if (_readIndex == _writeIndex) {
+    return 0;
+  }
+  __sync_synchronize();
+  return _slots[_readIndex].sentence;
+}
+
+void NMEASerialFramer::pop() {
+  if (_readIndex == _writeIndex) {
+    return;
+  }
+  // Make sure we are done reading the slot before the producer can reuse it.
+  __sync_synchronize();
+  _readIndex = (_readIndex + 1) % _slotsCount;
+}
+
+uint16_t NMEASerialFramer::size() const {
+  return (_writeIndex + _slotsCount - _readIndex) % _slotsCount;
+}
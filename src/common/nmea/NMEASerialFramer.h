@@ -0,0 +1,107 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <Stream.h>
+#include "common/stats/KBoxMetrics.h"
+
+/**
+ * Splits the bytes received on a serial port into NMEA sentences and queues
+ * them in a fixed ring of sentence slots.
+ *
+ * The framer is designed to be shared by exactly one producer, which calls
+ * `poll()` (typically from serialEventX()), and one consumer, which calls
+ * `front()` and `pop()` (typically from a Task loop). Each side only writes
+ * its own index so no locking is needed.
+ *
+ * Sentences are written directly in their slot and no memory is allocated
+ * after construction.
+ */
+class NMEASerialFramer {
+  public:
+    // Defined by the NMEA Standard: 82 characters plus a terminating NUL.
+    static const uint8_t maxSentenceLength = 83;
+
+  private:
+    struct Slot {
+      char sentence[maxSentenceLength];
+    };
+
+    Stream &_stream;
+    Slot *_slots;
+    // One slot is always kept free so that full and empty can be told apart.
+    uint16_t _slotsCount;
+    uint16_t _rxBufferSize;
+    enum KBoxEvent _rxBufferOverflowEvent, _rxOverflowEvent, _rxErrorEvent;
+
+    // Only modified by the consumer.
+    volatile uint16_t _readIndex;
+
+    // Only modified by the producer.
+    volatile uint16_t _writeIndex;
+    uint8_t _length;
+    bool _discarding;
+
+    // Not copyable.
+    NMEASerialFramer(const NMEASerialFramer&);
+    NMEASerialFramer& operator=(const NMEASerialFramer&);
+
+    void endOfLine();
+
+  public:
+    /**
+     * Creates a framer that can hold `capacity` sentences. `rxBufferSize` is
+     * the size of the stream receive buffer (SERIALx_RX_BUFFER_SIZE) and is
+     * used to detect when it overflowed.
+     */
+    NMEASerialFramer(Stream &stream, uint16_t capacity, uint16_t rxBufferSize,
+                     enum KBoxEvent rxBufferOverflowEvent, enum KBoxEvent rxOverflowEvent,
+                     enum KBoxEvent rxErrorEvent);
+    ~NMEASerialFramer();
+
+    /**
+     * Producer side: reads all the available bytes from the stream and queues
+     * the complete sentences.
+     */
+    void poll();
+
+    /**
+     * Consumer side: returns the oldest sentence (without the line
+     * terminator) or a null pointer if there is none. The sentence is valid
+     * until `pop()` is called.
+     */
+    const char* front() const;
+
+    /**
+     * Consumer side: releases the sentence returned by `front()`.
+     */
+    void pop();
+
+    /**
+     * Number of sentences waiting in the queue.
+     */
+    uint16_t size() const;
+};
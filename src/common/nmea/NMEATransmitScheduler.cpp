@@ -0,0 +1,316 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "NMEATransmitScheduler.h"
+
+struct SentenceType {
+  const char *code;
+  enum NMEATransmitPriority priority;
+  // Field that tells apart sentences of the same type carrying different
+  // data (0 if all the sentences of this type replace each other).
+  uint8_t discriminator;
+};
+
+static const SentenceType sentenceTypes[] = {
+  { "DBT", NMEATransmitPriorityNormal, 0 },
+  { "DPT", NMEATransmitPriorityNormal, 0 },
+  { "GGA", NMEATransmitPriorityHigh, 0 },
+  { "GLL", NMEATransmitPriorityHigh, 0 },
+  { "GNS", NMEATransmitPriorityHigh, 0 },
+  { "GSV", NMEATransmitPriorityLow, 2 },
+  { "HDG", NMEATransmitPriorityHigh, 0 },
+  { "HDM", NMEATransmitPriorityHigh, 0 },
+  { "HDT", NMEATransmitPriorityHigh, 0 },
+  { "MTW", NMEATransmitPriorityNormal, 0 },
+  { "MWD", NMEATransmitPriorityNormal, 0 },
+  { "MWV", NMEATransmitPriorityNormal, 2 },
+  { "RMC", NMEATransmitPriorityHigh, 0 },
+  { "ROT", NMEATransmitPriorityNormal, 0 },
+  { "RSA", NMEATransmitPriorityNormal, 0 },
+  { "VDM", NMEATransmitPriorityNormal, 0 },
+  { "VDO", NMEATransmitPriorityNormal, 0 },
+  { "VHW", NMEATransmitPriorityNormal, 0 },
+  { "VLW", NMEATransmitPriorityNormal, 0 },
+  { "VTG", NMEATransmitPriorityHigh, 0 },
+  { "VWR", NMEATransmitPriorityNormal, 0 },
+  { "XDR", NMEATransmitPriorityLow, 4 },
+  { "ZDA", NMEATransmitPriorityNormal, 0 },
+};
+
+static const uint8_t sentenceTypesCount = sizeof(sentenceTypes) / sizeof(sentenceTypes[0]);
+
+// Length of the address field ("GPRMC" in "$GPRMC,...").
+static size_t addressLength(const char *sentence) {
+  if (sentence[0] != '$' && sentence[0] != '!') {
+    return 0;
+  }
+  return strcspn(sentence + 1, ",*");
+}
+
+// Standard sentences have a two characters talker id followed by the
+// sentence code. Proprietary sentences ("$P...") do not have a type.
+static const SentenceType* sentenceTypeOf(const char *sentence) {
+  if (addressLength(sentence) != 5 || sentence[1] == 'P') {
+    return 0;
+  }
+  const char *code = sentence + 3;
+  for (uint8_t i = 0; i < sentenceTypesCount; i++) {
+    if (strncmp(sentenceTypes[i].code, code, 3) == 0) {
+      return &sentenceTypes[i];
+    }
+  }
+  return 0;
+}
+
+static uint32_t hash(uint32_t h, const char *s, size_t length) {
+  // FNV-1a
+  for (size_t i = 0; i < length; i++) {
+    h ^= (uint8_t)s[i];
+    h *= 16777619;
+  }
+  return h;
+}
+
+/*
+ * Computes the key of sentences which replace each other: the address and,
+ * for some types, the value of one field. AIS messages are all different and
+ * never replace each other.
+ */
+static bool coalescingKey(const char *sentence, uint32_t &key) {
+  size_t length = addressLength(sentence);
+  if (sentence[0] != '$' || length == 0) {
+    return false;
+  }
+  key = hash(2166136261u, sentence + 1, length);
+
+  const SentenceType *type = sentenceTypeOf(sentence);
+  if (type && type->discriminator > 0) {
+    const char *field = sentence + 1 + length;
+    for (uint8_t i = 0; i < type->discriminator && *field == ','; i++) {
+      field += 1 + strcspn(field + 1, ",*");
+    }
+    // field now points to the separator after the discriminator field.
+    const char *start = field;
+    while (start > sentence && *(start - 1) != ',') {
+      start--;
+    }
+    key = hash(key ^ ',', start, field - start);
+  }
+  return true;
+}
+
+NMEATransmitScheduler::NMEATransmitScheduler(uint32_t baudRate, uint8_t capacity,
+                                             enum KBoxEvent txEvent, enum KBoxEvent txOverflowEvent,
+                                             const enum KBoxEvent dropEvents[NMEATransmitPriorityCount]) :
+  _slots(new Slot[capacity]), _capacity(capacity), _bytesPerSecond(baudRate / 10), _millisecondsProvider(0),
+  _budget(0), _refilledAt(0), _sequence(0), _txEvent(txEvent), _txOverflowEvent(txOverflowEvent) {
+
+  for (uint8_t i = 0; i < _capacity; i++) {
+    _slots[i].used = false;
+  }
+  for (int p = 0; p < NMEATransmitPriorityCount; p++) {
+    _depth[p] = 0;
+    _dropped[p] = 0;
+    _coalesced[p] = 0;
+    _dropEvents[p] = dropEvents[p];
+  }
+  // Start with a full budget.
+  _budget = (maxSentenceLength - 1) * 1000;
+}
+
+NMEATransmitScheduler::~NMEATransmitScheduler() {
+  delete[] _slots;
+}
+
+uint32_t NMEATransmitScheduler::now() const {
+  if (_millisecondsProvider) {
+    return _millisecondsProvider();
+  }
+  return 0;
+}
+
+enum NMEATransmitPriority NMEATransmitScheduler::priorityOf(const char *sentence) {
+  const SentenceType *type = sentenceTypeOf(sentence);
+  if (type) {
+    return type->priority;
+  }
+  return NMEATransmitPriorityLow;
+}
+
+void NMEATransmitScheduler::refill(uint32_t now) {
+  uint32_t elapsed = now - _refilledAt;
+  _refilledAt = now;
+
+  // The budget can hold the largest sentence with its "\r\n".
+  static const uint32_t maxBudget = (maxSentenceLength - 1) * 1000;
+
+  // Avoid overflowing the multiplication, the budget is full after one
+  // second anyway.
+  if (elapsed > 1000) {
+    elapsed = 1000;
+  }
+  _budget += elapsed * _bytesPerSecond;
+  if (_budget > maxBudget) {
+    _budget = maxBudget;
+  }
+}
+
+void NMEATransmitScheduler::release(Slot &slot, bool dropped) {
+  if (dropped) {
+    _dropped[slot.priority]++;
+    KBoxMetrics.event(_dropEvents[slot.priority]);
+    KBoxMetrics.event(_txOverflowEvent);
+  }
+  _depth[slot.priority]--;
+  slot.used = false;
+}
+
+void NMEATransmitScheduler::expire(uint32_t now) {
+  for (uint8_t i = 0; i < _capacity; i++) {
+    if (_slots[i].used && now - _slots[i].queuedAt > maxQueueTime) {
+      release(_slots[i], true);
+    }
+  }
+}
+
+NMEATransmitScheduler::Slot* NMEATransmitScheduler::findSlot(uint32_t key) {
+  for (uint8_t i = 0; i < _capacity; i++) {
+    if (_slots[i].used && _slots[i].coalescable && _slots[i].key == key) {
+      return &_slots[i];
+    }
+  }
+  return 0;
+}
+
+NMEATransmitScheduler::Slot* NMEATransmitScheduler::findVictim() {
+  Slot *victim = 0;
+  for (uint8_t i = 0; i < _capacity; i++) {
+    Slot &s = _slots[i];
+    if (!victim || s.priority > victim->priority
+        || (s.priority == victim->priority && s.sequence - victim->sequence > 0x80000000u)) {
+      victim = &s;
+    }
+  }
+  return victim;
+}
+
+NMEATransmitScheduler::Slot* NMEATransmitScheduler::findNext() {
+  Slot *next = 0;
+  for (uint8_t i = 0; i < _capacity; i++) {
+    Slot &s = _slots[i];
+    if (!s.used) {
+      continue;
+    }
+    if (!next || s.priority < next->priority
+        || (s.priority == next->priority && s.sequence - next->sequence > 0x80000000u)) {
+      next = &s;
+    }
+  }
+  return next;
+}
+
+bool NMEATransmitScheduler::enqueue(const SKNMEASentence &sentence) {
+  const char *s = sentence.c_str();
+  size_t length = sentence.length();
+  enum NMEATransmitPriority priority = priorityOf(s);
+  uint32_t t = now();
+
+  if (length == 0 || length + 2 >= maxSentenceLength) {
+    _dropped[priority]++;
+    KBoxMetrics.event(_dropEvents[priority]);
+    KBoxMetrics.event(_txOverflowEvent);
+    return false;
+  }
+
+  uint32_t key = 0;
+  bool coalescable = coalescingKey(s, key);
+
+  Slot *slot = coalescable ? findSlot(key) : 0;
+  if (slot) {
+    // Keep the place of the previous sentence in the queue so that a type of
+    // sentence that is updated faster than it can be sent still goes out.
+    _coalesced[priority]++;
+  }
+  else {
+    for (uint8_t i = 0; i < _capacity && !slot; i++) {
+      if (!_slots[i].used) {
+        slot = &_slots[i];
+      }
+    }
+    if (!slot) {
+      Slot *victim = findVictim();
+      if (!victim || victim->priority < priority) {
+        _dropped[priority]++;
+        KBoxMetrics.event(_dropEvents[priority]);
+        KBoxMetrics.event(_txOverflowEvent);
+        return false;
+      }
+      release(*victim, true);
+      slot = victim;
+    }
+    slot->used = true;
+    slot->coalescable = coalescable;
+    slot->key = key;
+    slot->priority = priority;
+    slot->sequence = _sequence++;
+    _depth[priority]++;
+  }
+
+  memcpy(slot->sentence, s, length);
+  slot->sentence[length] = 0;
+  slot->length = length;
+  slot->queuedAt = t;
+  return true;
+}
+
+uint8_t NMEATransmitScheduler::drain(Print &output, int available) {
+  uint32_t t = now();
+  refill(t);
+  expire(t);
+
+  uint8_t sent = 0;
+  Slot *slot;
+  while ((slot = findNext())) {
+    uint32_t bytes = slot->length + 2;
+    if (available < (int)bytes) {
+      break;
+    }
+    if (_bytesPerSecond > 0 && _budget < bytes * 1000) {
+      break;
+    }
+
+    output.write((const uint8_t*)slot->sentence, slot->length);
+    output.write("\r\n");
+    KBoxMetrics.event(_txEvent);
+
+    available -= bytes;
+    if (_bytesPerSecond > 0) {
+      _budget -= bytes * 1000;
+    }
+    release(*slot, false);
+    sent++;
+  }
+  return sent;
+}
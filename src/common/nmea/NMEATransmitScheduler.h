@@ -0,0 +1,178 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <Print.h>
+#include "common/signalk/SKNMEASentence.h"
+#include "common/stats/KBoxMetrics.h"
+
+enum NMEATransmitPriority {
+  // Position and heading
+  NMEATransmitPriorityHigh,
+  // Wind, depth, speed through water and other navigation data
+  NMEATransmitPriorityNormal,
+  // Transducers (XDR) and everything else
+  NMEATransmitPriorityLow,
+
+  NMEATransmitPriorityCount
+};
+
+/**
+ * Queues the sentences sent on a serial port and releases them no faster
+ * than the port can transmit them.
+ *
+ * The byte budget is refilled at the rate of the port (10 bits per byte) and
+ * can hold one complete sentence, so the hardware buffer never contains
+ * more than what the port can send in the time of one sentence and the
+ * choice of the next sentence happens here.
+ *
+ * When a sentence of the same type is already waiting, it is replaced by the
+ * newer one (the sentence keeps its place in the queue). When the queue is
+ * full, the oldest sentence with the lowest priority is dropped to make room,
+ * unless the new sentence has an even lower priority.
+ *
+ * All the memory is allocated when the scheduler is created.
+ */
+class NMEATransmitScheduler {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+    // Defined by the NMEA Standard: 82 characters plus a terminating NUL.
+    static const uint8_t maxSentenceLength = 83;
+
+    // Sentences that have been waiting for longer than this are not sent.
+    static const uint16_t maxQueueTime = 2000;
+
+  private:
+    struct Slot {
+      char sentence[maxSentenceLength];
+      uint8_t length;
+      uint8_t priority;
+      bool used;
+      bool coalescable;
+      uint32_t key;
+      uint32_t sequence;
+      uint32_t queuedAt;
+    };
+
+    Slot *_slots;
+    uint8_t _capacity;
+    uint32_t _bytesPerSecond;
+    millisecondsProvider_t _millisecondsProvider;
+
+    // Budget in thousandths of a byte, so that it can be refilled every
+    // millisecond at any baud rate.
+    uint32_t _budget;
+    uint32_t _refilledAt;
+    uint32_t _sequence;
+
+    uint8_t _depth[NMEATransmitPriorityCount];
+    uint32_t _dropped[NMEATransmitPriorityCount];
+    uint32_t _coalesced[NMEATransmitPriorityCount];
+
+    enum KBoxEvent _txEvent, _txOverflowEvent;
+    enum KBoxEvent _dropEvents[NMEATransmitPriorityCount];
+
+    uint32_t now() const;
+    void refill(uint32_t now);
+    void expire(uint32_t now);
+    void release(Slot &slot, bool dropped);
+    Slot* findSlot(uint32_t key);
+    Slot* findVictim();
+    Slot* findNext();
+
+    // Not copyable.
+    NMEATransmitScheduler(const NMEATransmitScheduler&);
+    NMEATransmitScheduler& operator=(const NMEATransmitScheduler&);
+
+  public:
+    /**
+     * Creates a scheduler for a port running at `baudRate` (0 means no
+     * limit) that can hold `capacity` sentences.
+     *
+     * `txEvent` is counted for each sentence sent, `txOverflowEvent` and the
+     * event of the sentence priority in `dropEvents` for each sentence
+     * dropped.
+     */
+    NMEATransmitScheduler(uint32_t baudRate, uint8_t capacity,
+                          enum KBoxEvent txEvent, enum KBoxEvent txOverflowEvent,
+                          const enum KBoxEvent dropEvents[NMEATransmitPriorityCount]);
+    ~NMEATransmitScheduler();
+
+    /**
+     * Set the function used to know how many milliseconds have elapsed.
+     *
+     * If a milliseconds provider is not set, time never passes and the budget
+     * is never refilled.
+     */
+    void setMillisecondsProvider(millisecondsProvider_t millisecondsProvider) {
+      _millisecondsProvider = millisecondsProvider;
+    };
+
+    /**
+     * Queues a copy of the sentence (without "\r\n").
+     *
+     * @return false if the sentence was dropped.
+     */
+    bool enqueue(const SKNMEASentence &sentence);
+
+    /**
+     * Writes the queued sentences to `output`, by order of priority, as long
+     * as the budget allows it and they fit in the `available` bytes of the
+     * output buffer.
+     *
+     * @return the number of sentences written.
+     */
+    uint8_t drain(Print &output, int available);
+
+    /**
+     * Number of sentences of this priority waiting to be sent.
+     */
+    uint8_t getQueueDepth(enum NMEATransmitPriority priority) const {
+      return _depth[priority];
+    };
+
+    /**
+     * Number of sentences of this priority that were dropped because the
+     * queue was full or because they waited too long.
+     */
+    uint32_t getDropped(enum NMEATransmitPriority priority) const {
+      return _dropped[priority];
+    };
+
+    /**
+     * Number of sentences of this priority that were replaced by a newer
+     * sentence of the same type before they could be sent.
+     */
+    uint32_t getCoalesced(enum NMEATransmitPriority priority) const {
+      return _coalesced[priority];
+    };
+
+    /**
+     * Returns the priority of a sentence, based on its type.
+     */
+    static enum NMEATransmitPriority priorityOf(const char *sentence);
+};
@@ -0,0 +1,85 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "PCDINEncoder.h"
+
+static const char hexDigits[] = "0123456789ABCDEF";
+
+/*
+ * Writes the `digits` last hexadecimal digits of value and updates the
+ * checksum.
+ */
+static char* appendHex(char *s, uint32_t value, int digits, uint8_t &checksum) {
+  for (int i = digits - 1; i >= 0; i--) {
+    s[i] = hexDigits[value & 0xf];
+    checksum ^= s[i];
+    value >>= 4;
+  }
+  return s + digits;
+}
+
+static char* appendByte(char *s, uint8_t value, uint8_t &checksum) {
+  s[0] = hexDigits[value >> 4];
+  s[1] = hexDigits[value & 0xf];
+  checksum ^= s[0] ^ s[1];
+  return s + 2;
+}
+
+bool PCDINEncoder::encode(const tN2kMsg &msg, uint32_t timestamp) {
+  if (msg.DataLen < 0 || msg.DataLen > tN2kMsg::MaxDataLen) {
+    _length = 0;
+    _buffer[0] = 0;
+    return false;
+  }
+
+  // The checksum of "PCDIN," is pre-computed: it does not include the '$'.
+  static const char header[] = "$PCDIN,";
+  uint8_t checksum = 'P' ^ 'C' ^ 'D' ^ 'I' ^ 'N' ^ ',';
+
+  char *s = _buffer;
+  for (const char *h = header; *h; h++) {
+    *s++ = *h;
+  }
+
+  s = appendHex(s, msg.PGN, 6, checksum);
+  *s++ = ',';
+  checksum ^= ',';
+  s = appendHex(s, timestamp, 8, checksum);
+  *s++ = ',';
+  checksum ^= ',';
+  s = appendByte(s, msg.Source, checksum);
+  *s++ = ',';
+  checksum ^= ',';
+  for (int i = 0; i < msg.DataLen; i++) {
+    s = appendByte(s, msg.Data[i], checksum);
+  }
+
+  *s++ = '*';
+  uint8_t unused = 0;
+  s = appendByte(s, checksum, unused);
+  *s = 0;
+
+  _length = s - _buffer;
+  return true;
+}
@@ -0,0 +1,76 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <N2kMsg.h>
+#include "common/signalk/SKNMEASentence.h"
+
+/**
+ * Encodes NMEA2000 messages as Seasmart `$PCDIN` sentences:
+ *
+ *   $PCDIN,<PGN>,<timestamp>,<source>,<data>*<checksum>
+ *
+ * The output is the same as `N2kToSeasmart()` but the sentence is formatted
+ * in a buffer owned by the encoder, with a lookup table for the hexadecimal
+ * digits and the checksum computed while the sentence is written. A message
+ * can be encoded once and the sentence shared by all the outputs.
+ */
+class PCDINEncoder {
+  public:
+    // "$PCDIN," (7) + PGN (6) + "," + timestamp (8) + "," + source (2) + ","
+    // + data + "*" + checksum (2) + NUL
+    static const size_t maxSentenceLength = 30 + 2 * tN2kMsg::MaxDataLen;
+
+  private:
+    char _buffer[maxSentenceLength];
+    size_t _length;
+
+    PCDINEncoder(const PCDINEncoder&);
+    PCDINEncoder& operator=(const PCDINEncoder&);
+
+  public:
+    PCDINEncoder() : _length(0) {
+      _buffer[0] = 0;
+    };
+
+    /**
+     * Encodes a message, replacing the previous sentence.
+     *
+     * @param timestamp written in the sentence (8 hexadecimal digits).
+     * @return false if the message is too long to be encoded. The sentence is
+     * then empty.
+     */
+    bool encode(const tN2kMsg &msg, uint32_t timestamp);
+
+    /**
+     * The last sentence encoded. The view is only valid until the next call
+     * to encode().
+     */
+    SKNMEASentence getSentence() const {
+      return SKNMEASentence(_buffer, _length);
+    };
+};
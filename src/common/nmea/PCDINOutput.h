@@ -0,0 +1,49 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "common/signalk/SKNMEASentence.h"
+
+/**
+ * Outputs that repeat the NMEA2000 messages received by KBox as Seasmart
+ * `$PCDIN` sentences.
+ *
+ * The message is encoded once (see PCDINEncoder) and the same sentence is
+ * given to all the outputs.
+ */
+class PCDINOutput {
+  public:
+    virtual ~PCDINOutput() {};
+
+    /**
+     * Writes one PCDIN sentence (without the "\r\n").
+     *
+     * The sentence is only valid until this method returns.
+     *
+     * @return true if the sentence was written, or false if it could not be
+     * written.
+     */
+    virtual bool writePCDIN(const SKNMEASentence &pcdin) = 0;
+};
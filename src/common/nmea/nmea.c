@@ -21,23 +21,12 @@
   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
   THE SOFTWARE.
 */
+#include <string.h>
 #include "nmea.h"
 #include "ctype.h"
 
 bool nmea_is_valid(const char *s) {
-  if (s == 0 || s[0] == '\0' || (s[0] != '$' && s[0] != '!')) {
-    return false;
-  }
-
-  uint8_t csum = nmea_compute_checksum(s);
-  int rsum = nmea_read_checksum(s);
-
-  if (rsum != -1) {
-    return csum == rsum;
-  }
-  else {
-    return false;
-  }
+  return nmea_validate(s, 0) == NMEA_VALID;
 }
 
 uint8_t nmea_compute_checksum(const char *sentence) {
@@ -91,3 +80,159 @@ int nmea_read_checksum(const char *sentence) {
   return checksum;
 }
 
+static bool is_end_of_line(char c) {
+  return c == '\0' || c == '\r' || c == '\n';
+}
+
+/* Reads the checksum digits at `s` (right after the '*') and sets the status
+ * of `result`. `end` is the end of the buffer or NULL if `s` is
+ * NUL-terminated. Returns the number of digits read. */
+static size_t finish_validation(const char *s, const char *end, uint8_t checksum,
+                                struct nmea_validation *result) {
+  size_t digits = 0;
+  int expected = 0;
+
+  while (digits < 2 && (end == 0 || s + digits < end) && isxdigit((int)s[digits])) {
+    expected = (expected << 4) + hexCharToInt(s[digits]);
+    digits++;
+  }
+
+  if (digits == 0) {
+    result->status = NMEA_MISSING_CHECKSUM;
+  }
+  else {
+    result->status = expected == checksum ? NMEA_VALID : NMEA_INVALID_CHECKSUM;
+  }
+  return digits;
+}
+
+enum nmea_status nmea_validate(const char *s, struct nmea_validation *result) {
+  struct nmea_validation local;
+  if (result == 0) {
+    result = &local;
+  }
+  result->sentence.start = s;
+  result->sentence.length = 0;
+  result->payload.start = s;
+  result->payload.length = 0;
+
+  if (s == 0 || (s[0] != '$' && s[0] != '!')) {
+    result->status = NMEA_INVALID_START;
+    return result->status;
+  }
+
+  uint8_t checksum = 0;
+  const char *p = s + 1;
+  while (*p != '*' && !is_end_of_line(*p)) {
+    checksum ^= *p;
+    p++;
+  }
+  result->payload.start = s + 1;
+  result->payload.length = p - (s + 1);
+
+  if (*p != '*') {
+    result->status = NMEA_MISSING_CHECKSUM;
+    result->sentence.length = p - s;
+    return result->status;
+  }
+  p++;
+
+  p += finish_validation(p, 0, checksum, result);
+  result->sentence.length = p - s;
+  return result->status;
+}
+
+#define NMEA_WORD_ONES (~(uintptr_t)0 / 0xFF)
+#define NMEA_WORD_HIGHS (NMEA_WORD_ONES * 0x80)
+
+/* True if one of the bytes of `w` is equal to `c` */
+static bool word_has_byte(uintptr_t w, char c) {
+  uintptr_t x = w ^ (NMEA_WORD_ONES * (uint8_t)c);
+  return ((x - NMEA_WORD_ONES) & ~x & NMEA_WORD_HIGHS) != 0;
+}
+
+static bool word_has_delimiter(uintptr_t w) {
+  return word_has_byte(w, '*') || word_has_byte(w, '\r') || word_has_byte(w, '\n');
+}
+
+/* Validates the line starting at `line`. Returns a pointer to its line
+ * terminator or NULL if the line is not terminated before `end`. */
+static const char *validate_line(const char *line, const char *end, struct nmea_validation *result) {
+  const char *p = line + 1;
+  uintptr_t words = 0;
+
+  // XOR whole words until we get close to the '*' or the end of the line.
+  while (p + sizeof(uintptr_t) <= end) {
+    uintptr_t w;
+    memcpy(&w, p, sizeof(w));
+    if (word_has_delimiter(w)) {
+      break;
+    }
+    words ^= w;
+    p += sizeof(w);
+  }
+
+  uint8_t checksum = 0;
+  for (size_t i = 0; i < sizeof(words); i++) {
+    checksum ^= (uint8_t)(words >> (8 * i));
+  }
+  while (p < end && *p != '*' && *p != '\r' && *p != '\n') {
+    checksum ^= *p;
+    p++;
+  }
+  result->payload.start = line + 1;
+  result->payload.length = p - (line + 1);
+
+  if (p < end && *p == '*') {
+    p++;
+    p += finish_validation(p, end, checksum, result);
+  }
+  else {
+    result->status = NMEA_MISSING_CHECKSUM;
+  }
+
+  // Ignore anything after the checksum
+  while (p < end && *p != '\r' && *p != '\n') {
+    p++;
+  }
+  if (p == end) {
+    return 0;
+  }
+
+  result->sentence.start = line;
+  result->sentence.length = p - line;
+  if (line[0] != '$' && line[0] != '!') {
+    result->status = NMEA_INVALID_START;
+  }
+  return p;
+}
+
+size_t nmea_validate_lines(const char *buffer, size_t length,
+                           struct nmea_validation *results, size_t max_results,
+                           size_t *consumed) {
+  const char *p = buffer;
+  const char *end = buffer + length;
+  size_t count = 0;
+
+  while (p < end && count < max_results) {
+    if (*p == '\r' || *p == '\n') {
+      p++;
+      continue;
+    }
+
+    const char *eol = validate_line(p, end, &results[count]);
+    if (eol == 0) {
+      break;
+    }
+    count++;
+    p = eol + 1;
+    if (*eol == '\r' && p < end && *p == '\n') {
+      p++;
+    }
+  }
+
+  if (consumed) {
+    *consumed = p - buffer;
+  }
+  return count;
+}
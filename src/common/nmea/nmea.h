@@ -23,6 +23,7 @@
 */
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -44,6 +45,46 @@ int nmea_read_checksum(const char *s);
  * is valid. */
 bool nmea_is_valid(const char *s);
 
+enum nmea_status {
+  NMEA_VALID,
+  /* The sentence does not start with '$' or '!' */
+  NMEA_INVALID_START,
+  /* There is no '*' or no checksum after it */
+  NMEA_MISSING_CHECKSUM,
+  NMEA_INVALID_CHECKSUM
+};
+
+struct nmea_span {
+  const char *start;
+  size_t length;
+};
+
+struct nmea_validation {
+  enum nmea_status status;
+  /* The sentence, without line terminators */
+  struct nmea_span sentence;
+  /* The characters covered by the checksum (between the '$' and the '*') */
+  struct nmea_span payload;
+};
+
+/* Validates a sentence in a single pass. The sentence ends at the first NUL,
+ * CR or LF character. `result` can be NULL.
+ */
+enum nmea_status nmea_validate(const char *s, struct nmea_validation *result);
+
+/* Validates all the lines of `buffer` (which does not need to be
+ * NUL-terminated). Empty lines are skipped and the checksum is computed one
+ * machine word at a time.
+ *
+ * At most `max_results` lines are validated. Returns the number of results
+ * and sets `consumed` (if not NULL) to the number of bytes processed. A last
+ * line without terminator is not processed so that it can be completed by
+ * the next buffer.
+ */
+size_t nmea_validate_lines(const char *buffer, size_t length,
+                           struct nmea_validation *results, size_t max_results,
+                           size_t *consumed);
+
 #ifdef __cplusplus
 }
 #endif
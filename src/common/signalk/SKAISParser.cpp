@@ -0,0 +1,231 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <KBoxLogging.h>
+#include "common/nmea/AISPayload.h"
+#include "common/nmea/NMEASentenceReader.h"
+#include "SKAISParser.h"
+#include "SKUnits.h"
+
+// The context is created with the longest URN we use so that changing it to
+// another vessel never allocates memory.
+SKAISParser::SKAISParser(uint16_t targetCapacity) : _targets(targetCapacity), _ownVessel(),
+  _context("urn:mrn:imo:mmsi:000000000"), _update(_context) {
+}
+
+void SKAISParser::urnForMMSI(uint32_t mmsi, char *urn, size_t size) {
+  snprintf(urn, size, "urn:mrn:imo:mmsi:%09lu", (unsigned long)mmsi);
+}
+
+const SKUpdate& SKAISParser::parse(const SKSourceInput& input, const NMEASentenceReader& reader,
+                                   const SKTime& time) {
+  _update.clear();
+
+  const AISPayload *payload = _assembler.add(reader);
+  if (!payload) {
+    return _invalidSku;
+  }
+
+  uint8_t messageType = payload->getUnsigned(0, 6);
+  uint32_t mmsi = payload->getUnsigned(8, 30);
+  bool ownVessel = reader.getField(0) == "AIVDO";
+  if (mmsi == 0) {
+    return _invalidSku;
+  }
+
+  switch (messageType) {
+    case 1:
+    case 2:
+    case 3:
+    case 5:
+    case 18:
+    case 19:
+    case 24:
+      break;
+    default:
+      DEBUG("Unsupported AIS message type %i", messageType);
+      return _invalidSku;
+  }
+
+  if (ownVessel) {
+    _context.setURN(SKContextSelf.getURN().c_str());
+  }
+  else {
+    char urn[32];
+    urnForMMSI(mmsi, urn, sizeof(urn));
+    _context.setURN(urn);
+  }
+  startUpdate(input, reader, time);
+
+  // Static data of our own vessel is not kept with the other targets.
+  AISTarget &target = ownVessel ? _ownVessel : _targets.touch(mmsi);
+  target.mmsi = mmsi;
+
+  switch (messageType) {
+    case 1:
+    case 2:
+    case 3:
+      return parsePositionReport(target, *payload);
+    case 5:
+      return parseStaticAndVoyageData(target, *payload);
+    case 18:
+      return parseClassBPositionReport(target, *payload);
+    case 19:
+      return parseClassBExtendedPositionReport(target, *payload);
+    case 24:
+      return parseStaticDataReport(target, *payload);
+  }
+  return _invalidSku;
+}
+
+void SKAISParser::startUpdate(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  NMEAField address = reader.getField(0);
+  char talker[3] = { address[0], address[1], 0 };
+  char sentenceCode[4] = { address[2], address[3], address[4], 0 };
+
+  _update.setTimestamp(time);
+  _update.setSource(SKSource::sourceForNMEA0183(input, talker, sentenceCode));
+}
+
+void SKAISParser::setPosition(const AISPayload& payload, uint16_t start) {
+  // Longitude and latitude are in 1/10000 minutes. 181 and 91 degrees mean
+  // not available.
+  int32_t longitude = payload.getSigned(start, 28);
+  int32_t latitude = payload.getSigned(start + 28, 27);
+
+  if (longitude >= -108000000 && longitude <= 108000000 && latitude >= -54000000 && latitude <= 54000000) {
+    _update.setNavigationPosition(SKTypePosition(latitude / 600000.0, longitude / 600000.0, SKDoubleNAN));
+  }
+}
+
+void SKAISParser::setMotion(const AISPayload& payload, uint16_t sogStart, uint16_t cogStart, uint16_t headingStart) {
+  // 1023 (speed), 3600 (course) and 511 (heading) mean not available.
+  uint32_t sog = payload.getUnsigned(sogStart, 10);
+  uint32_t cog = payload.getUnsigned(cogStart, 12);
+  uint32_t heading = payload.getUnsigned(headingStart, 9);
+
+  if (sog < 1023) {
+    _update.setNavigationSpeedOverGround(SKKnotToMs(sog / 10.0));
+  }
+  if (cog < 3600) {
+    _update.setNavigationCourseOverGroundTrue(SKDegToRad(cog / 10.0));
+  }
+  if (heading < 360) {
+    _update.setNavigationHeadingTrue(SKDegToRad((double)heading));
+  }
+}
+
+void SKAISParser::setDimensions(AISTarget& target, const AISPayload& payload, uint16_t start) {
+  target.toBow = payload.getUnsigned(start, 9);
+  target.toStern = payload.getUnsigned(start + 9, 9);
+  target.toPort = payload.getUnsigned(start + 18, 6);
+  target.toStarboard = payload.getUnsigned(start + 24, 6);
+  addDimensions(target);
+}
+
+void SKAISParser::addDimensions(const AISTarget& target) {
+  if (target.toBow + target.toStern > 0) {
+    _update.setDesignLengthOverall(target.toBow + target.toStern);
+  }
+  if (target.toPort + target.toStarboard > 0) {
+    _update.setDesignBeam(target.toPort + target.toStarboard);
+  }
+}
+
+const SKUpdate& SKAISParser::parsePositionReport(const AISTarget& target, const AISPayload& payload) {
+  if (payload.bitLength() < 137) {
+    return _invalidSku;
+  }
+
+  // Rate of turn is encoded as 4.733 * sqrt(degrees per minute). -128 means
+  // not available and +/-127 that the vessel turns faster than 5deg/30s
+  // without a turn indicator.
+  int32_t rot = payload.getSigned(42, 8);
+  if (rot > -127 && rot < 127) {
+    double degreesPerMinute = (rot / 4.733) * (rot / 4.733);
+    if (rot < 0) {
+      degreesPerMinute = -degreesPerMinute;
+    }
+    _update.setNavigationRateOfTurn(SKDegToRad(degreesPerMinute) / 60);
+  }
+
+  setMotion(payload, 50, 116, 128);
+  setPosition(payload, 61);
+  addDimensions(target);
+  return _update;
+}
+
+const SKUpdate& SKAISParser::parseStaticAndVoyageData(AISTarget& target, const AISPayload& payload) {
+  if (payload.bitLength() < 302) {
+    return _invalidSku;
+  }
+
+  setDimensions(target, payload, 240);
+
+  // Draught is in 1/10 m, 0 means not available.
+  uint32_t draught = payload.getUnsigned(294, 8);
+  if (draught > 0) {
+    _update.setDesignDraftCurrent(draught / 10.0);
+  }
+  return _update;
+}
+
+const SKUpdate& SKAISParser::parseClassBPositionReport(const AISTarget& target, const AISPayload& payload) {
+  if (payload.bitLength() < 133) {
+    return _invalidSku;
+  }
+
+  setMotion(payload, 46, 112, 124);
+  setPosition(payload, 57);
+  addDimensions(target);
+  return _update;
+}
+
+const SKUpdate& SKAISParser::parseClassBExtendedPositionReport(AISTarget& target, const AISPayload& payload) {
+  if (payload.bitLength() < 301) {
+    return _invalidSku;
+  }
+
+  setMotion(payload, 46, 112, 124);
+  setPosition(payload, 57);
+  setDimensions(target, payload, 271);
+  return _update;
+}
+
+const SKUpdate& SKAISParser::parseStaticDataReport(AISTarget& target, const AISPayload& payload) {
+  // Part A only has the name of the vessel, which cannot be published as an
+  // SKValue. Part B has its dimensions.
+  uint32_t part = payload.getUnsigned(38, 2);
+
+  if (part == 1 && payload.bitLength() >= 162) {
+    setDimensions(target, payload, 132);
+  }
+
+  if (_update.getSize() == 0) {
+    return _invalidSku;
+  }
+  return _update;
+}
@@ -0,0 +1,106 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "common/nmea/AISFragmentAssembler.h"
+#include "common/nmea/AISTargetTable.h"
+#include "SKContext.h"
+#include "SKSource.h"
+#include "SKUpdateStatic.h"
+
+class AISPayload;
+class NMEASentenceReader;
+
+/**
+ * Parses AIS sentences (VDM for other vessels and VDO for our own vessel)
+ * into SignalK updates.
+ *
+ * Position reports (message types 1, 2, 3, 18 and 19) and static data
+ * (types 5, 19 and 24) are supported. Updates about other vessels have a
+ * context built from their MMSI. Consumers which only handle data about our
+ * own vessel must ignore the updates whose context is not SKContextSelf.
+ *
+ * All the memory is allocated when the parser is created: the fragments of
+ * multi-sentence messages are reassembled in a few fixed slots, the context
+ * of the update is rewritten in place and the dimensions of other vessels are
+ * kept in a fixed size AISTargetTable which forgets the vessels that have not
+ * been seen for the longest time.
+ *
+ * Static data is only sent every few minutes, so the dimensions of a known
+ * vessel are added to each of its position reports.
+ */
+class SKAISParser {
+  private:
+    AISFragmentAssembler _assembler;
+    AISTargetTable _targets;
+    AISTarget _ownVessel;
+
+    // The update references the context so it must be declared first.
+    SKContext _context;
+    SKUpdateStatic<8> _update;
+    SKUpdateStatic<0> _invalidSku;
+
+    void startUpdate(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    void setPosition(const AISPayload& payload, uint16_t start);
+    void setMotion(const AISPayload& payload, uint16_t sog, uint16_t cog, uint16_t heading);
+    void setDimensions(AISTarget& target, const AISPayload& payload, uint16_t start);
+    void addDimensions(const AISTarget& target);
+
+    const SKUpdate& parsePositionReport(const AISTarget& target, const AISPayload& payload);
+    const SKUpdate& parseStaticAndVoyageData(AISTarget& target, const AISPayload& payload);
+    const SKUpdate& parseClassBPositionReport(const AISTarget& target, const AISPayload& payload);
+    const SKUpdate& parseClassBExtendedPositionReport(AISTarget& target, const AISPayload& payload);
+    const SKUpdate& parseStaticDataReport(AISTarget& target, const AISPayload& payload);
+
+    // Not copyable.
+    SKAISParser(const SKAISParser&);
+    SKAISParser& operator=(const SKAISParser&);
+
+  public:
+    /**
+     * Create a parser that remembers the static data of up to
+     * `targetCapacity` vessels.
+     */
+    SKAISParser(uint16_t targetCapacity);
+
+    /**
+     * Parses a valid VDM or VDO sentence. Returns an update that is valid
+     * until the next call to `parse()`, and is empty if the sentence is only
+     * one fragment of a message or if the message is not supported.
+     */
+    const SKUpdate& parse(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+
+    /**
+     * Vessels we have received messages from.
+     */
+    const AISTargetTable& getTargets() const {
+      return _targets;
+    };
+
+    /**
+     * Builds the SignalK context of the vessel with this MMSI in `urn`.
+     */
+    static void urnForMMSI(uint32_t mmsi, char *urn, size_t size);
+};
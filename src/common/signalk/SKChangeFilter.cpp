@@ -0,0 +1,155 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <math.h>
+#include "SKChangeFilter.h"
+#include "SKHub.h"
+#include "SKUpdateStatic.h"
+#include "common/algo/Hash.h"
+#include "common/stats/KBoxMetrics.h"
+
+// Updates with more values are always republished.
+static const int filteredUpdateCapacity = 8;
+
+SKChangeFilter::SKChangeFilter(const SKChangeFilterConfig &config, SKHub &output, uint16_t capacity) :
+  _config(config), _output(output), _bits(hashTableBits(capacity)), _millisecondsProvider(nullptr) {
+  _capacity = 1 << _bits;
+  _entries = new Entry[_capacity];
+
+  for (uint16_t i = 0; i < _capacity; i++) {
+    _entries[i].used = false;
+  }
+
+  for (int p = 0; p < SKPathEnumCount; p++) {
+    _epsilon[p] = _config.epsilon;
+    _maxAge[p] = _config.maxAge;
+  }
+  for (int i = 0; i < _config.rulesCount && i < SKChangeFilterConfig::maxRules; i++) {
+    const SKChangeFilterRule &rule = _config.rules[i];
+    if (rule.path < SKPathEnumCount) {
+      _epsilon[rule.path] = rule.epsilon;
+      _maxAge[rule.path] = rule.maxAge;
+    }
+  }
+}
+
+SKChangeFilter::~SKChangeFilter() {
+  delete[] _entries;
+}
+
+double SKChangeFilter::distance(const SKValue &a, const SKValue &b) {
+  if (a.getType() != b.getType()) {
+    return INFINITY;
+  }
+
+  switch (a.getType()) {
+    case SKValue::SKValueTypeNone:
+      return 0;
+    case SKValue::SKValueTypeNumber:
+      return fabs(a.getNumberValue() - b.getNumberValue());
+    case SKValue::SKValueTypePosition: {
+      SKTypePosition pa = a.getPositionValue();
+      SKTypePosition pb = b.getPositionValue();
+      return fmax(fabs(pa.latitude - pb.latitude),
+                  fmax(fabs(pa.longitude - pb.longitude), fabs(pa.altitude - pb.altitude)));
+    }
+    case SKValue::SKValueTypeAttitude: {
+      SKTypeAttitude aa = a.getAttitudeValue();
+      SKTypeAttitude ab = b.getAttitudeValue();
+      return fmax(fabs(aa.roll - ab.roll),
+                  fmax(fabs(aa.pitch - ab.pitch), fabs(aa.yaw - ab.yaw)));
+    }
+    case SKValue::SKValueTypeTimestamp:
+      return a == b ? 0 : INFINITY;
+  }
+  return INFINITY;
+}
+
+SKChangeFilter::Entry* SKChangeFilter::findEntry(const SKPath &path, const SKSource &source) {
+  uint16_t slot = hashSlot(path.getId(), _bits);
+
+  for (uint16_t probe = 0; probe < _capacity; probe++) {
+    Entry &e = _entries[slot];
+    if (!e.used) {
+      e.path = path;
+      e.source = source;
+      return &e;
+    }
+    if (e.path == path && e.source == source) {
+      return &e;
+    }
+    slot = (slot + 1) % _capacity;
+  }
+  return 0;
+}
+
+bool SKChangeFilter::shouldSend(const Entry &e, const SKValue &value, uint32_t now) const {
+  if (!e.used) {
+    return true;
+  }
+  SKPathEnum p = e.path.getStaticPath();
+  if (now - e.sentAt >= _maxAge[p]) {
+    return true;
+  }
+  // NaN differences are never within the deadband.
+  return !(distance(e.value, value) <= _epsilon[p]);
+}
+
+void SKChangeFilter::updateReceived(const SKUpdate& update) {
+  // Other vessels (AIS targets) are not filtered so that they do not take the
+  // place of our own values in the table.
+  if (!_config.enabled || update.getContext() != SKContextSelf
+      || update.getSize() > filteredUpdateCapacity) {
+    _output.publish(update);
+    return;
+  }
+
+  uint32_t now = _millisecondsProvider ? _millisecondsProvider() : 0;
+
+  Entry *entries[filteredUpdateCapacity];
+  bool send = false;
+
+  for (int i = 0; i < update.getSize(); i++) {
+    entries[i] = findEntry(update.getPath(i), update.getSource());
+
+    // Values which cannot be remembered are always sent.
+    if (!entries[i] || shouldSend(*entries[i], update.getValue(i), now)) {
+      send = true;
+    }
+  }
+
+  if (!send) {
+    KBoxMetrics.event(KBoxEventSKChangeFilterSuppressed);
+    return;
+  }
+
+  for (int i = 0; i < update.getSize(); i++) {
+    if (entries[i]) {
+      entries[i]->used = true;
+      entries[i]->value = update.getValue(i);
+      entries[i]->sentAt = now;
+    }
+  }
+  _output.publish(update);
+}
@@ -0,0 +1,115 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKChangeFilterConfig.h"
+#include "SKPath.h"
+#include "SKSource.h"
+#include "SKSubscriber.h"
+#include "SKValue.h"
+
+class SKHub;
+
+/**
+ * Republishes the updates it receives on another SKHub, dropping the updates
+ * in which no value changed enough since it was last republished.
+ *
+ * A value changed when it moved by more than the epsilon of its path or when
+ * the last value sent for the same (path, source) is older than the maxAge of
+ * the path. With an epsilon of 0, only exact repetitions are
+ * dropped.
+ *
+ * The decision is made for the whole update: if one value changed, all the
+ * values are republished. Outputs which need values that come together (wind
+ * angle and speed, COG and SOG) always get both.
+ *
+ * For positions and attitudes the largest difference between two components
+ * is compared to epsilon. Timestamps are republished whenever they change.
+ *
+ * Each dropped update is counted with the KBoxEventSKChangeFilterSuppressed
+ * event.
+ *
+ * The last values sent are kept in a fixed size table allocated when the
+ * filter is created. Values which do not fit in the table are always
+ * republished. Only our own vessel is filtered: updates about other vessels
+ * (AIS targets) are always republished so that they cannot fill the table.
+ */
+class SKChangeFilter : public SKSubscriber {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+  private:
+    struct Entry {
+      SKPath path;
+      SKSource source;
+      SKValue value;
+      uint32_t sentAt;
+      bool used;
+    };
+
+    const SKChangeFilterConfig &_config;
+    SKHub &_output;
+    Entry *_entries;
+    uint16_t _capacity;
+    uint8_t _bits;
+    millisecondsProvider_t _millisecondsProvider;
+
+    double _epsilon[SKPathEnumCount];
+    uint32_t _maxAge[SKPathEnumCount];
+
+    Entry* findEntry(const SKPath &path, const SKSource &source);
+    bool shouldSend(const Entry &e, const SKValue &value, uint32_t now) const;
+
+    // Not copyable.
+    SKChangeFilter(const SKChangeFilter&);
+    SKChangeFilter& operator=(const SKChangeFilter&);
+
+  public:
+    /**
+     * Create a new filter that republishes on `output` and remembers up to
+     * `capacity` values. The capacity is rounded up to a power of two.
+     */
+    SKChangeFilter(const SKChangeFilterConfig &config, SKHub &output, uint16_t capacity);
+    ~SKChangeFilter();
+
+    /**
+     * Set the function used to know how many milliseconds have elapsed.
+     *
+     * If a milliseconds provider is not set, the time never changes and values
+     * are only republished when they change.
+     */
+    void setMillisecondsProvider(millisecondsProvider_t millisecondsProvider) {
+      _millisecondsProvider = millisecondsProvider;
+    };
+
+    void updateReceived(const SKUpdate& update) override;
+
+    /**
+     * Returns the largest difference between the components of two values.
+     * Values of different types are infinitely different.
+     */
+    static double distance(const SKValue &a, const SKValue &b);
+};
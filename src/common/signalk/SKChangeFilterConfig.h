@@ -0,0 +1,56 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKPathEnum.generated.h"
+
+/**
+ * Deadband and heartbeat used by SKChangeFilter for one static path.
+ */
+struct SKChangeFilterRule {
+  SKPathEnum path;
+  // Values that moved by this amount or less are not republished.
+  double epsilon;
+  // A value is always republished if the last one was sent more than
+  // `maxAge` milliseconds ago.
+  uint32_t maxAge;
+};
+
+/**
+ * Configuration for an instance of SKChangeFilter.
+ */
+struct SKChangeFilterConfig {
+  static const int maxRules = 16;
+
+  bool enabled = true;
+
+  // Applied to paths which do not have a rule.
+  double epsilon = 0;
+  uint32_t maxAge = 1000;
+
+  SKChangeFilterRule rules[maxRules];
+  int rulesCount = 0;
+};
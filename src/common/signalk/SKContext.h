@@ -47,10 +47,18 @@ class SKContext {
     /**
      * @return a unique identifier for a vessel.
      */
-    const String getURN() const {
+    const String& getURN() const {
       return _urn;
     };
 
+    /**
+     * Change the URN of this context. The memory of the current URN is
+     * reused when the new one is not longer.
+     */
+    void setURN(const char *urn) {
+      _urn = urn;
+    };
+
     /**
      * Compares two SKContext objects and returns true if they represent the same
      * context.
@@ -0,0 +1,138 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "SKDataStore.h"
+#include "SKUpdate.h"
+#include "common/algo/Hash.h"
+#include "common/stats/KBoxMetrics.h"
+
+SKDataStore::SKDataStore(uint16_t capacity) :
+  _bits(hashTableBits(capacity)), _size(0), _sequence(0) {
+  _capacity = 1 << _bits;
+  _entries = new Entry[_capacity];
+  for (uint16_t i = 0; i < _capacity; i++) {
+    _entries[i].used = false;
+  }
+}
+
+SKDataStore::~SKDataStore() {
+  delete[] _entries;
+}
+
+uint16_t SKDataStore::slotFor(const SKPath &path) const {
+  // The source is not part of the hash so that all the values of one path
+  // are found in the same probe sequence.
+  return hashSlot(path.getId(), _bits);
+}
+
+void SKDataStore::updateReceived(const SKUpdate& update) {
+  if (update.getContext() != SKContextSelf) {
+    return;
+  }
+
+  for (int i = 0; i < update.getSize(); i++) {
+    store(update.getPath(i), update.getSource(), update.getValue(i), update.getTimestamp());
+  }
+}
+
+void SKDataStore::store(const SKPath &path, const SKSource &source,
+                        const SKValue &value, const SKTime &timestamp) {
+  uint16_t slot = slotFor(path);
+
+  for (uint16_t probe = 0; probe < _capacity; probe++) {
+    Entry &e = _entries[slot];
+
+    if (!e.used) {
+      e.used = true;
+      e.path = path;
+      e.source = source;
+      _size++;
+    }
+    if (e.path == path && e.source == source) {
+      e.value = value;
+      e.timestamp = timestamp;
+      e.sequence = ++_sequence;
+      return;
+    }
+    slot = (slot + 1) % _capacity;
+  }
+
+  KBoxMetrics.event(KBoxEventSKDataStoreFull);
+}
+
+const SKDataStore::Entry* SKDataStore::get(const SKContext &context, const SKPath &path, const SKSource &source) const {
+  if (context != SKContextSelf) {
+    return 0;
+  }
+  uint16_t slot = slotFor(path);
+
+  for (uint16_t probe = 0; probe < _capacity; probe++) {
+    const Entry &e = _entries[slot];
+    if (!e.used) {
+      break;
+    }
+    if (e.path == path && e.source == source) {
+      return &e;
+    }
+    slot = (slot + 1) % _capacity;
+  }
+  return 0;
+}
+
+const SKDataStore::Entry* SKDataStore::getLatest(const SKContext &context, const SKPath &path) const {
+  if (context != SKContextSelf) {
+    return 0;
+  }
+  uint16_t slot = slotFor(path);
+  const Entry *latest = 0;
+
+  for (uint16_t probe = 0; probe < _capacity; probe++) {
+    const Entry &e = _entries[slot];
+    if (!e.used) {
+      break;
+    }
+    if (e.path == path) {
+      if (!latest || e.sequence > latest->sequence) {
+        latest = &e;
+      }
+    }
+    slot = (slot + 1) % _capacity;
+  }
+  return latest;
+}
+
+const SKValue& SKDataStore::getLatestValue(const SKContext &context, const SKPath &path) const {
+  const Entry *e = getLatest(context, path);
+  if (e) {
+    return e->value;
+  }
+  return SKValueNone;
+}
+
+const SKDataStore::Entry* SKDataStore::getEntry(uint16_t slot) const {
+  if (slot < _capacity && _entries[slot].used) {
+    return &_entries[slot];
+  }
+  return 0;
+}
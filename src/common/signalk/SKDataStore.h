@@ -0,0 +1,127 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKContext.h"
+#include "SKPath.h"
+#include "SKSource.h"
+#include "SKSubscriber.h"
+#include "SKTime.h"
+#include "SKValue.h"
+
+/**
+ * Keeps the latest value received for each (path, source) of our own boat.
+ *
+ * SKDataStore subscribes to a SKHub and lets other components (pages, new
+ * clients, etc) read the current state of the boat without waiting for the
+ * next update of each kind.
+ *
+ * Only updates for SKContextSelf are stored: the other contexts (AIS targets
+ * for example) come and go and would fill the table with values that nobody
+ * reads.
+ *
+ * Entries are stored in a fixed size open-addressed hash table allocated when
+ * the store is created (see common/algo/Hash.h). Entries are never removed; when the table is full,
+ * values for new keys are dropped and the KBoxEventSKDataStoreFull event is
+ * recorded.
+ */
+class SKDataStore : public SKSubscriber {
+  public:
+    struct Entry {
+      SKPath path;
+      SKSource source;
+      SKValue value;
+      SKTime timestamp;
+      // Incremented every time a value is stored. Used to find the most
+      // recent value for a path across all the sources.
+      uint32_t sequence;
+      bool used;
+    };
+
+  private:
+    Entry *_entries;
+    uint16_t _capacity;
+    uint8_t _bits;
+    uint16_t _size;
+    uint32_t _sequence;
+
+    uint16_t slotFor(const SKPath &path) const;
+    void store(const SKPath &path, const SKSource &source,
+               const SKValue &value, const SKTime &timestamp);
+
+    // Not copyable.
+    SKDataStore(const SKDataStore&);
+    SKDataStore& operator=(const SKDataStore&);
+
+  public:
+    /**
+     * Create a new store that can hold up to `capacity` values. The capacity
+     * is rounded up to a power of two.
+     */
+    SKDataStore(uint16_t capacity);
+    ~SKDataStore();
+
+    void updateReceived(const SKUpdate& update) override;
+
+    /**
+     * Returns the entry for this context, path and source or a null pointer
+     * if no value has been received. Always null for contexts other than
+     * SKContextSelf.
+     */
+    const Entry* get(const SKContext &context, const SKPath &path, const SKSource &source) const;
+
+    /**
+     * Returns the most recent entry for this context and path, regardless of
+     * its source, or a null pointer if no value has been received.
+     */
+    const Entry* getLatest(const SKContext &context, const SKPath &path) const;
+
+    /**
+     * Returns the most recent value for this context and path or SKValueNone.
+     */
+    const SKValue& getLatestValue(const SKContext &context, const SKPath &path) const;
+
+    /**
+     * Number of values in the store.
+     */
+    uint16_t getSize() const {
+      return _size;
+    };
+
+    /**
+     * Number of slots in the store. Use with `getEntry()` to iterate over all
+     * the values.
+     */
+    uint16_t getCapacity() const {
+      return _capacity;
+    };
+
+    /**
+     * Returns the entry in slot `slot` or a null pointer if that slot is
+     * empty.
+     */
+    const Entry* getEntry(uint16_t slot) const;
+};
@@ -25,20 +25,114 @@
 #include <KBoxLogging.h>
 #include "SKHub.h"
 #include "SKSubscriber.h"
+#include "SKUpdateStatic.h"
+#include "common/stats/KBoxMetrics.h"
 
+// Maximum number of values in an update that can be stored in the queue.
+static const uint16_t queuedUpdateCapacity = 6;
 
-SKHub::SKHub() {
+/**
+ * A slot of the publish queue. The context is copied in the slot so that the
+ * queued update does not reference memory owned by the publisher.
+ */
+struct SKHub::QueuedUpdate {
+  SKContext context;
+  SKUpdateStatic<queuedUpdateCapacity> update;
+
+  QueuedUpdate() : context(SKContextSelf), update(context) {};
+};
+
+SKHub::SKHub() : _queue(0), _processing(false) {
 }
 
 SKHub::~SKHub() {
+  delete _queue;
 }
 
 void SKHub::subscribe(SKSubscriber* subscriber) {
-  _subscribers.add(subscriber);
+  Subscription s = { subscriber, SKPathBitmask::all(), true };
+  _subscriptions.add(s);
+}
+
+void SKHub::subscribe(SKSubscriber* subscriber, const SKPathBitmask &paths) {
+  Subscription s = { subscriber, paths, false };
+  _subscriptions.add(s);
+}
+
+void SKHub::enableQueue(uint16_t length) {
+  if (_queue || length == 0) {
+    return;
+  }
+  _queue = new RingBuffer<QueuedUpdate>(length);
+}
+
+uint16_t SKHub::getQueueSize() const {
+  return _queue ? _queue->size() : 0;
 }
 
 void SKHub::publish(const SKUpdate& update) {
-  for (LinkedListIterator<SKSubscriber*> it = _subscribers.begin(); it != _subscribers.end(); it++) {
-    (*it)->updateReceived(update);
+  if (!_queue) {
+    deliver(update);
+    return;
+  }
+
+  if (update.getSize() > queuedUpdateCapacity) {
+    // Deliver the older updates first so that this one does not overtake
+    // them and leave subscribers with stale values.
+    processQueue(_queue->size());
+    deliver(update);
+    return;
+  }
+
+  QueuedUpdate *slot = _queue->reserve();
+  if (!slot) {
+    KBoxMetrics.event(KBoxEventSKHubQueueOverflow);
+    return;
+  }
+
+  slot->context = update.getContext();
+  slot->update.clear();
+  slot->update.setSource(update.getSource());
+  slot->update.setTimestamp(update.getTimestamp());
+  for (int i = 0; i < update.getSize(); i++) {
+    slot->update.setValue(update.getPath(i), update.getValue(i));
+  }
+  _queue->commit();
+}
+
+uint16_t SKHub::processQueue(uint16_t maxUpdates) {
+  uint16_t delivered = 0;
+
+  // The update at the front of the queue is being delivered: a subscriber
+  // publishing an oversize update must not deliver it a second time.
+  if (_processing) {
+    return 0;
+  }
+  _processing = true;
+
+  while (_queue && delivered < maxUpdates) {
+    QueuedUpdate *slot = _queue->front();
+    if (!slot) {
+      break;
+    }
+    // The slot is only released after delivery so that subscribers publishing
+    // new updates cannot overwrite it.
+    deliver(slot->update);
+    _queue->pop();
+    delivered++;
+  }
+  _processing = false;
+  return delivered;
+}
+
+void SKHub::deliver(const SKUpdate& update) {
+  // Only notify the subscribers who are interested in one of the paths of
+  // this update.
+  const SKPathBitmask &updatePaths = update.getPathMask();
+
+  for (LinkedListIterator<Subscription> it = _subscriptions.begin(); it != _subscriptions.end(); it++) {
+    if (it->allPaths || it->paths.intersects(updatePaths)) {
+      it->subscriber->updateReceived(update);
+    }
   }
 }
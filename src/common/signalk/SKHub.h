@@ -25,6 +25,8 @@
 #pragma once
 
 #include "common/algo/List.h"
+#include "common/algo/RingBuffer.h"
+#include "SKPathBitmask.h"
 
 class SKUpdate;
 class SKSubscriber;
@@ -33,7 +35,15 @@ class SKSubscriber;
  * them to different subscribers.
  *
  * An instance of SKSubscriber can subscribe to updates with a filter defining
- * which updates to get.
+ * which updates to get. The filter is a SKPathBitmask and a subscriber is only
+ * notified of updates that include at least one of the paths it subscribed to.
+ *
+ * By default, updates are delivered synchronously from `publish()`. When a
+ * queue is enabled with `enableQueue()`, `publish()` only copies the update in
+ * a fixed size queue and the updates are delivered to subscribers later, when
+ * `processQueue()` is called. This allows producers with tight timing
+ * constraints (NMEA2000 reception for example) to return quickly even if some
+ * subscribers are slow.
  */
 class SKHub {
   public:
@@ -46,6 +56,15 @@ class SKHub {
      */
     void subscribe(SKSubscriber* subscriber);
 
+    /**
+     * Adds a new subscriber which will only be notified of updates that
+     * contain at least one of the paths in `paths`.
+     *
+     * Subscribers that do not need to see every update should use this
+     * variant so that they are not called for updates they would ignore.
+     */
+    void subscribe(SKSubscriber* subscriber, const SKPathBitmask &paths);
+
     /**
      * Publish a new update on the hub. All the subscribers will be notified.
      * They should process the update as fast as possible and return control so
@@ -53,6 +72,54 @@ class SKHub {
      */
     void publish(const SKUpdate&);
 
+    /**
+     * Switch the hub to queued mode with room for `length` updates.
+     *
+     * All the memory for the queue is allocated here. This should be called
+     * once, before the hub is used.
+     *
+     * When the queue is full, new updates are dropped and the
+     * KBoxEventSKHubQueueOverflow event is recorded. Updates with more values
+     * than a queue slot can hold are delivered synchronously.
+     */
+    void enableQueue(uint16_t length);
+
+    /**
+     * Returns true if the hub is in queued mode.
+     */
+    bool isQueued() const {
+      return _queue != 0;
+    };
+
+    /**
+     * Returns the number of updates waiting to be delivered.
+     */
+    uint16_t getQueueSize() const;
+
+    /**
+     * Deliver at most `maxUpdates` queued updates to the subscribers.
+     *
+     * @return the number of updates delivered.
+     */
+    uint16_t processQueue(uint16_t maxUpdates);
+
   private:
-    LinkedList<SKSubscriber*> _subscribers;
+    struct Subscription {
+      SKSubscriber *subscriber;
+      SKPathBitmask paths;
+      // Subscribers who did not provide a filter also receive empty updates.
+      bool allPaths;
+    };
+
+    struct QueuedUpdate;
+
+    LinkedList<Subscription> _subscriptions;
+    RingBuffer<QueuedUpdate> *_queue;
+    bool _processing;
+
+    void deliver(const SKUpdate&);
+
+    // Not copyable.
+    SKHub(const SKHub&);
+    SKHub& operator=(const SKHub&);
 };
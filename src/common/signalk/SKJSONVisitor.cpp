@@ -68,6 +68,21 @@ void SKJSONVisitor::processSource(const SKSource &source, JsonObject &sourceObje
   }
 }
 
+const char* SKJSONVisitor::pathName(const SKPath &path) {
+  // Names of non-indexed paths are constants and ArduinoJson keeps a pointer
+  // to const char* so they do not need to be copied.
+  if (!path.isIndexed()) {
+    return path.getInfo().prefix;
+  }
+
+  size_t size = path.getLength() + 1;
+  char *name = static_cast<char*>(_jsonBuffer.alloc(size));
+  if (name) {
+    path.copyTo(name, size);
+  }
+  return name;
+}
+
 JsonObject& SKJSONVisitor::processUpdate(const SKUpdate& update) {
   JsonObject &root = _jsonBuffer.createObject();
 
@@ -97,7 +112,7 @@ JsonObject& SKJSONVisitor::processUpdate(const SKUpdate& update) {
     const SKValue &v = update.getValue(i);
 
     JsonObject &obj = values.createNestedObject();
-    obj["path"] = _jsonBuffer.strdup(p.toString().c_str());
+    obj["path"] = pathName(p);
     switch (v.getType()) {
       case SKValue::SKValueTypeNone:
         obj.createNestedObject("value");
@@ -40,6 +40,7 @@ class SKJSONVisitor {
     JsonBuffer &_jsonBuffer;
 
     void processSource(const SKSource &source, JsonObject &sourceObject);
+    const char* pathName(const SKPath &path);
 
   public:
     /**
@@ -26,11 +26,25 @@
 
 #include <N2kMsg.h>
 #include <N2kMessages.h>
+#include <string.h>
 #include "SKUpdate.h"
 #include "SKValue.h"
 #include "SKUnits.h"
 
+const uint16_t SKNMEA2000Converter::gnssCoalescingWindow;
+const uint16_t SKNMEA2000Converter::gnssMaximumFixAge;
+
 void SKNMEA2000Converter::convert(const SKUpdate& update, SKNMEA2000Output& out) {
+  // The messages we generate describe our own boat. Updates about other
+  // vessels (AIS targets) must not be sent as ours.
+  if (update.getContext() != SKContextSelf) {
+    return;
+  }
+
+  if (!update.getPathMask().intersects(getInputPaths())) {
+    return;
+  }
+
   // Trigger a call of visitSKElectricalBatteriesVoltage for every key with that path
   // (there can be more than one and we do not know how they are called)
   _currentOutput = &out;
@@ -53,13 +67,14 @@ void SKNMEA2000Converter::convert(const SKUpdate& update, SKNMEA2000Output& out)
     out.write(msg);
   }
 
-  // PGN 129026: Fast COG/SOG
-  if (update.hasNavigationSpeedOverGround() && update.hasNavigationCourseOverGroundTrue()) {
-    tN2kMsg msg;
-    SetN2kPGN129026(msg, (uint8_t)0, N2khr_true,
-        update.getNavigationCourseOverGroundTrue(),
-        update.getNavigationSpeedOverGround());
-    out.write(msg);
+  if (update.hasNavigationPosition() || update.hasNavigationDatetime()
+      || update.hasNavigationSpeedOverGround() || update.hasNavigationCourseOverGroundTrue()
+      || update.hasNavigationGnssSatellites() || update.hasNavigationGnssHorizontalDilution()
+      || update.hasNavigationGnssGeoidalSeparation()) {
+    if (_fix.open && !continuesFix(update)) {
+      sendFix(out);
+    }
+    addToFix(update);
   }
 
   if (update.hasNavigationHeadingMagnetic()) {
@@ -89,14 +104,149 @@ void SKNMEA2000Converter::convert(const SKUpdate& update, SKNMEA2000Output& out)
   }
 }
 
+SKPathBitmask SKNMEA2000Converter::getInputPaths() const {
+  return SKPathBitmask()
+    .set(SKPathElectricalBatteriesVoltage)
+    .set(SKPathEnvironmentOutsidePressure)
+    .set(SKPathNavigationAttitude)
+    .set(SKPathNavigationPosition)
+    .set(SKPathNavigationDatetime)
+    .set(SKPathNavigationGnssSatellites)
+    .set(SKPathNavigationGnssHorizontalDilution)
+    .set(SKPathNavigationGnssGeoidalSeparation)
+    .set(SKPathNavigationSpeedOverGround)
+    .set(SKPathNavigationCourseOverGroundTrue)
+    .set(SKPathNavigationHeadingMagnetic)
+    .set(SKPathEnvironmentWindAngleApparent)
+    .set(SKPathEnvironmentWindSpeedApparent)
+    .set(SKPathEnvironmentWindAngleTrueWater)
+    .set(SKPathEnvironmentWindSpeedTrue)
+    .set(SKPathEnvironmentWindAngleTrueGround)
+    .set(SKPathEnvironmentWindSpeedOverGround)
+    .set(SKPathEnvironmentWindDirectionMagnetic)
+    .set(SKPathEnvironmentWindDirectionTrue);
+}
+
+void SKNMEA2000Converter::flush(SKNMEA2000Output& out) {
+  if (!_fix.open) {
+    return;
+  }
+  uint32_t t = now();
+  if (t - _fix.updatedAt >= gnssCoalescingWindow || t - _fix.startedAt >= gnssMaximumFixAge) {
+    sendFix(out);
+  }
+}
+
+uint32_t SKNMEA2000Converter::now() const {
+  if (_millisecondsProvider) {
+    return _millisecondsProvider();
+  }
+  return 0;
+}
+
+/*
+ * Returns false if the update is for another fix than the one being
+ * collected. Sentences of the same fix (RMC and GGA for example) can repeat
+ * the same values.
+ */
+bool SKNMEA2000Converter::continuesFix(const SKUpdate &update) const {
+  if (update.hasNavigationDatetime() && _fix.hasDatetime) {
+    return update.getNavigationDatetime() == _fix.datetime;
+  }
+  return true;
+}
+
+void SKNMEA2000Converter::addToFix(const SKUpdate &update) {
+  if (!_fix.open) {
+    _fix.open = true;
+    _fix.startedAt = now();
+  }
+  _fix.updatedAt = now();
+
+  if (update.hasNavigationPosition()) {
+    SKTypePosition position = update.getNavigationPosition();
+    _fix.latitude = position.latitude;
+    _fix.longitude = position.longitude;
+    // RMC does not include the altitude but GGA does.
+    if (position.altitude != SKDoubleNAN) {
+      _fix.altitude = position.altitude;
+    }
+  }
+  if (update.hasNavigationDatetime()) {
+    _fix.hasDatetime = true;
+    _fix.datetime = update.getNavigationDatetime();
+  }
+  if (update.hasNavigationSpeedOverGround()) {
+    _fix.sog = update.getNavigationSpeedOverGround();
+  }
+  if (update.hasNavigationCourseOverGroundTrue()) {
+    _fix.cog = update.getNavigationCourseOverGroundTrue();
+  }
+  if (update.hasNavigationGnssSatellites()) {
+    _fix.satellites = update.getNavigationGnssSatellites();
+  }
+  if (update.hasNavigationGnssHorizontalDilution()) {
+    _fix.hdop = update.getNavigationGnssHorizontalDilution();
+  }
+  if (update.hasNavigationGnssGeoidalSeparation()) {
+    _fix.geoidalSeparation = update.getNavigationGnssGeoidalSeparation();
+  }
+}
+
+void SKNMEA2000Converter::sendFix(SKNMEA2000Output &out) {
+  // All the messages of the fix share the same sequence id.
+  unsigned char sid = _gnssSequence;
+  _gnssSequence = (_gnssSequence + 1) % 253;
+
+  uint16_t daysSince1970 = _fix.datetime.getTime() / 86400;
+  double secondsSinceMidnight = _fix.datetime.getTime() % 86400 + _fix.datetime.getMilliseconds() / 1000.0;
+  bool hasPosition = _fix.latitude != SKDoubleNAN && _fix.longitude != SKDoubleNAN;
+
+  tN2kMsg msg;
+  if (_fix.hasDatetime) {
+    SetN2kSystemTime(msg, sid, daysSince1970, secondsSinceMidnight, N2ktimes_GPS);
+    out.write(msg);
+  }
+
+  // PGN 129025: Position, Rapid Update
+  if (hasPosition) {
+    SetN2kLatLonRapid(msg, _fix.latitude, _fix.longitude);
+    out.write(msg);
+  }
+
+  // PGN 129026: Fast COG/SOG
+  if (_fix.cog != SKDoubleNAN && _fix.sog != SKDoubleNAN) {
+    SetN2kPGN129026(msg, sid, N2khr_true, _fix.cog, _fix.sog);
+    out.write(msg);
+  }
+
+  // PGN 129029 requires the date. Its altitude is the height above the
+  // WGS-84 ellipsoid: the altitude above the mean sea level (from GGA) plus
+  // the geoidal separation. Without the separation it is not available.
+  if (hasPosition && _fix.hasDatetime) {
+    bool hasAltitude = _fix.altitude != SKDoubleNAN && _fix.geoidalSeparation != SKDoubleNAN;
+    SetN2kGNSS(msg, sid, daysSince1970, secondsSinceMidnight,
+               _fix.latitude, _fix.longitude,
+               hasAltitude ? _fix.altitude + _fix.geoidalSeparation : N2kDoubleNA,
+               N2kGNSSt_GPS, N2kGNSSm_GNSSfix,
+               _fix.satellites == SKDoubleNAN ? N2kUInt8NA : (unsigned char)_fix.satellites,
+               _fix.hdop == SKDoubleNAN ? N2kDoubleNA : _fix.hdop,
+               N2kDoubleNA,
+               _fix.geoidalSeparation == SKDoubleNAN ? N2kDoubleNA : _fix.geoidalSeparation);
+    out.write(msg);
+  }
+
+  _fix = GNSSFix();
+}
+
 void SKNMEA2000Converter::visitSKElectricalBatteriesVoltage(const SKUpdate& u, const SKPath &p, const SKValue &v) {
   // PGN127508: Battery Status
   // FIXME: The mapping of Battery instance names to ids should be configurable
   unsigned char instance = 255;
-  if (p.getIndex() == "engine") {
+  if (strcmp(p.getIndex(), "engine") == 0) {
     instance = 0;
   }
-  else if (p.getIndex() == "house") {
+  else if (strcmp(p.getIndex(), "house") == 0) {
     instance = 1;
   }
 
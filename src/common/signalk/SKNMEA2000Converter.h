@@ -27,23 +27,83 @@
 #include <N2kMessages.h>
 #include "SKUpdate.h"
 #include "SKVisitor.generated.h"
+#include "SKPathBitmask.h"
+#include "SKUnits.h"
 #include "SKNMEA2000Output.h"
 
 /**
  * Converts one or multiple SignalK updates into a series of N2KMessages.
+ *
+ * GNSS data (position, date and time, COG/SOG and fix quality) usually comes
+ * from several NMEA sentences (RMC, GGA, VTG) for the same fix. It is
+ * collected until the fix is complete and then sent as one set of messages
+ * (126992, 129025, 129026 and 129029) sharing the same sequence id. A fix is
+ * complete when:
+ *  - an update brings another date and time (a new fix started), or
+ *  - no GNSS data was received for `gnssCoalescingWindow` ms, or the fix is
+ *    older than `gnssMaximumFixAge` ms (see flush()).
  */
 class SKNMEA2000Converter : private SKVisitor {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+    // At 4800 bauds, the sentences of one fix take a few hundred ms to be
+    // received but they are sent back to back.
+    static const uint16_t gnssCoalescingWindow = 250;
+    static const uint16_t gnssMaximumFixAge = 1000;
+
   private:
+    // Values of the GNSS fix being collected. SKDoubleNAN when not known yet.
+    struct GNSSFix {
+      bool open = false;
+      uint32_t startedAt = 0;
+      uint32_t updatedAt = 0;
+      double latitude = SKDoubleNAN;
+      double longitude = SKDoubleNAN;
+      // Above the mean sea level.
+      double altitude = SKDoubleNAN;
+      double geoidalSeparation = SKDoubleNAN;
+      double cog = SKDoubleNAN;
+      double sog = SKDoubleNAN;
+      double satellites = SKDoubleNAN;
+      double hdop = SKDoubleNAN;
+      bool hasDatetime = false;
+      SKTime datetime;
+    };
+
     SKNMEA2000Output *_currentOutput = 0;
+    millisecondsProvider_t _millisecondsProvider = 0;
+    GNSSFix _fix;
+    unsigned char _gnssSequence = 0;
 
+    uint32_t now() const;
+    bool continuesFix(const SKUpdate &update) const;
+    void addToFix(const SKUpdate &update);
+    void sendFix(SKNMEA2000Output &out);
     void generateWind(SKNMEA2000Output &out, double windAngle, double windSpeed, tN2kWindReference windReference);
 
   protected:
     void visitSKElectricalBatteriesVoltage(const SKUpdate& u, const SKPath &p, const SKValue &v) override;
 
   public:
+    /**
+     * Returns the set of paths that this converter knows how to convert to
+     * NMEA2000 messages.
+     */
+    SKPathBitmask getInputPaths() const;
+
     /**
      * Process a SKUpdate and add messages to the internal queue of messages.
      */
     void convert(const SKUpdate& update, SKNMEA2000Output& conversionOutput);
+
+    /**
+     * Sends the GNSS fix being collected if its coalescing window has
+     * expired. This should be called regularly.
+     */
+    void flush(SKNMEA2000Output& conversionOutput);
+
+    void setMillisecondsProvider(millisecondsProvider_t provider) {
+      _millisecondsProvider = provider;
+    };
 };
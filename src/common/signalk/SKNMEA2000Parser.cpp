@@ -28,63 +28,103 @@
   THE SOFTWARE.
 */
 
+#include <stdio.h>
 #include <N2kMessages.h>
 #include <KBoxLogging.h>
+#include "common/stats/KBoxMetrics.h"
 #include "SKNMEA2000Parser.h"
 #include "SKUnits.h"
 
-SKNMEA2000Parser::~SKNMEA2000Parser() {
-  if (_sku) {
-    delete(_sku);
+const uint8_t SKNMEA2000Parser::unknownPGNCapacity;
+
+const SKNMEA2000Parser::PGNHandlerEntry SKNMEA2000Parser::_handlers[] = {
+  { 126992L, &SKNMEA2000Parser::parse126992 }, // System Time / Date
+  { 127245L, &SKNMEA2000Parser::parse127245 }, // Rudder
+  { 127250L, &SKNMEA2000Parser::parse127250 }, // Vessel Heading
+  { 127251L, &SKNMEA2000Parser::parse127251 }, // Rate of Turn
+  { 127257L, &SKNMEA2000Parser::parse127257 }, // Attitude Yaw, Pitch, Roll
+  { 127258L, &SKNMEA2000Parser::parse127258 }, // Magnetic Variation
+  { 127488L, &SKNMEA2000Parser::parse127488 }, // Engine parameters rapid
+  { 127493L, &SKNMEA2000Parser::parse127493 }, // Transmission parameters: dynamic
+  { 127505L, &SKNMEA2000Parser::parse127505 }, // Fluid level
+  { 127508L, &SKNMEA2000Parser::parse127508 }, // Battery Status
+  { 128259L, &SKNMEA2000Parser::parse128259 }, // Boat speed
+  { 128267L, &SKNMEA2000Parser::parse128267 }, // Water depth
+  { 128275L, &SKNMEA2000Parser::parse128275 }, // Distance Log
+  { 129025L, &SKNMEA2000Parser::parse129025 }, // Position, Rapid Update Lat/Lon
+  { 129026L, &SKNMEA2000Parser::parse129026 }, // COG SOG rapid
+  { 129029L, &SKNMEA2000Parser::parse129029 }, // GNSS Position Data
+  { 129283L, &SKNMEA2000Parser::parse129283 }, // Cross Track Error
+  { 130306L, &SKNMEA2000Parser::parse130306 }, // Wind Speed
+  { 130312L, &SKNMEA2000Parser::parse130312 }, // Temperature
+  { 130314L, &SKNMEA2000Parser::parse130314 }, // Actual Pressure
+  { 130316L, &SKNMEA2000Parser::parse130316 }, // Temperature extended range
+  { 130577L, &SKNMEA2000Parser::parse130577 }, // Direction Data
+  { 130578L, &SKNMEA2000Parser::parse130578 }, // Vessel Speed Components
+};
+
+const uint8_t SKNMEA2000Parser::_handlersCount = sizeof(_handlers) / sizeof(_handlers[0]);
+
+const SKUpdate& SKNMEA2000Parser::parse(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  _update.clear();
+
+  const PGNHandlerEntry *entry = findHandler(msg.PGN);
+  if (!entry) {
+    countUnknownPGN(msg.PGN);
+    return _invalidSku;
   }
+  return (this->*(entry->handler))(input, msg, timestamp);
 }
 
-const SKUpdate& SKNMEA2000Parser::parse(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
-  if (_sku) {
-    delete(_sku);
-  }
-
-  switch (msg.PGN) {
-    case 126992L: // System Time / Date
-      return parse126992(input, msg, timestamp);
-    case 127245L: // Rudder
-      return parse127245(input, msg, timestamp);
-    case 127250L: // Vessel Heading
-      return parse127250(input, msg, timestamp);
-    //case 127251L: // Rate of Turn
-    case 127257L: // Attitude Yaw, Pitch, Roll
-      return parse127257(input, msg, timestamp);
-    //case 127258L:  // Magnetic Variation
-    //    return parse127258(input, msg, timestamp);
-    //  break;
-    case 128259L: // Boat speed
-      return parse128259(input, msg, timestamp);
-    case 128267L: // Water depth
-      return parse128267(input, msg, timestamp);
-    //case 128275L: // Distance Log
-    case 129025L: // Position, Rapid Update Lat/Lon
-      return parse129025(input, msg, timestamp);
-    case 129026L: // COG SOG rapid
-      return parse129026(input, msg, timestamp);
-    //case 129301L:  // Time to/from Mark
-    case 130306L: // Wind Speed
-      return parse130306(input, msg, timestamp);
-
-    //case 127488: // Engine parameters rapid
-    //case 127493: // Transmission parameters: dynamic
-    //case 127501: // Binary status report
-    //case 127505: // Fluid level
-    //case 127508: // Battery Status
-    //case 127513: // Battery Configuration Status
-    //case 129283: // Cross Track Error
-    //case 130314: // Actual Pressure
-    //case 130316: // Temperature extended range
-    //case 130577L: // Direction Data
-    //case 130578L: // Vessel Speed Components
-    default:
-      DEBUG("No known conversion for PGN %i", msg.PGN);
-      return _invalidSku;
-  } // end switch msg.PGN
+const SKNMEA2000Parser::PGNHandlerEntry* SKNMEA2000Parser::findHandler(uint32_t pgn) {
+  int low = 0;
+  int high = _handlersCount - 1;
+
+  while (low <= high) {
+    int middle = (low + high) / 2;
+    if (_handlers[middle].pgn == pgn) {
+      return &_handlers[middle];
+    }
+    if (_handlers[middle].pgn < pgn) {
+      low = middle + 1;
+    }
+    else {
+      high = middle - 1;
+    }
+  }
+  return 0;
+}
+
+bool SKNMEA2000Parser::isPGNSupported(uint32_t pgn) {
+  return findHandler(pgn) != 0;
+}
+
+void SKNMEA2000Parser::countUnknownPGN(uint32_t pgn) {
+  KBoxMetrics.event(KBoxEventNMEA2000UnknownPGN);
+
+  for (uint8_t i = 0; i < _unknownPGNsCount; i++) {
+    if (_unknownPGNs[i].pgn == pgn) {
+      _unknownPGNs[i].count++;
+      return;
+    }
+  }
+  if (_unknownPGNsCount < unknownPGNCapacity) {
+    _unknownPGNs[_unknownPGNsCount].pgn = pgn;
+    _unknownPGNs[_unknownPGNsCount].count = 1;
+    _unknownPGNsCount++;
+  }
+  else {
+    _unknownPGNOverflow++;
+  }
+}
+
+uint32_t SKNMEA2000Parser::getUnknownPGNCount(uint32_t pgn) const {
+  for (uint8_t i = 0; i < _unknownPGNsCount; i++) {
+    if (_unknownPGNs[i].pgn == pgn) {
+      return _unknownPGNs[i].count;
+    }
+  }
+  return 0;
 }
 
 // *****************************************************************************
@@ -103,13 +143,11 @@ const SKUpdate& SKNMEA2000Parser::parse126992(const SKSourceInput& input, const
   if (ParseN2kSystemTime(msg,sid,systemDate,systemTime,timeSource) ) {
     SKTime networkTime = SKTime::timeFromNMEA2000(systemDate, systemTime);
 
-    SKUpdateStatic<1> *update = new SKUpdateStatic<1>();
-    update->setTimestamp(timestamp);
+    _update.setTimestamp(timestamp);
 
-    update->setNavigationDatetime(networkTime);
+    _update.setNavigationDatetime(networkTime);
 
-    _sku = update;
-    return *_sku;
+    return _update;
   }
 
   DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
@@ -129,16 +167,14 @@ const SKUpdate& SKNMEA2000Parser::parse127245(const SKSourceInput& input, const
 
   if (ParseN2kRudder(msg,rudderPosition,instance,rudderDirectionOrder,angleOrder)) {
     if (!N2kIsNA(rudderPosition)) {
-      SKUpdateStatic<1> *update = new SKUpdateStatic<1>();
-      update->setTimestamp(timestamp);
+      _update.setTimestamp(timestamp);
 
       SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-      update->setSource(source);
+      _update.setSource(source);
       // -> Current rudder angle, +ve is rudder to Starboard
-      update->setSteeringRudderAngle(rudderPosition);
+      _update.setSteeringRudderAngle(rudderPosition);
 
-      _sku = update;
-      return *_sku;
+      return _update;
     }
   }
 
@@ -167,31 +203,27 @@ const SKUpdate& SKNMEA2000Parser::parse127250(const SKSourceInput& input, const
     if (!N2kIsNA(heading) && heading >= 0 && heading <= 2 * M_PI) {
       if (headingReference == N2khr_magnetic) {
         //TODO put 3 when updated to deviation
-        SKUpdateStatic<2> *update = new SKUpdateStatic<2>();
-        update->setTimestamp(timestamp);
+        _update.setTimestamp(timestamp);
 
         SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-        update->setSource(source);
-        update->setNavigationHeadingMagnetic(heading);
+        _update.setSource(source);
+        _update.setNavigationHeadingMagnetic(heading);
         if (!N2kIsNA(variation))
-          update->setNavigationMagneticVariation(variation);
+          _update.setNavigationMagneticVariation(variation);
           /* coming when Signal K adds deviation
           if (!N2kIsNA(deviation))
-            update->setNavigationMagneticDeviation(deviation);
+            _update.setNavigationMagneticDeviation(deviation);
           */
-        _sku = update;
-        return *_sku;
+        return _update;
       }
 
       if (headingReference == N2khr_true) {
-        SKUpdateStatic<1> *update = new SKUpdateStatic<1>();
-        update->setTimestamp(timestamp);
+        _update.setTimestamp(timestamp);
 
         SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-        update->setSource(source);
-        update->setNavigationHeadingTrue(heading);
-        _sku = update;
-        return *_sku;
+        _update.setSource(source);
+        _update.setNavigationHeadingTrue(heading);
+        return _update;
       }
     }
   }
@@ -200,6 +232,31 @@ const SKUpdate& SKNMEA2000Parser::parse127250(const SKSourceInput& input, const
   return _invalidSku;
 }
 
+// *****************************************************************************
+//  PGN 127251 Rate of Turn
+//  - RateOfTurn            Rate of turn in radians per second. Positive when
+//                          the bow turns to starboard.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse127251(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  double rateOfTurn = N2kDoubleNA;
+
+  if (ParseN2kRateOfTurn(msg, sid, rateOfTurn)) {
+    if (!N2kIsNA(rateOfTurn)) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+      _update.setNavigationRateOfTurn(rateOfTurn);
+
+      return _update;
+    }
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
 // *****************************************************************************
 // PGN 127257 Attitude Yaw, Pitch, Roll
 //  - Yaw                   Heading in radians.
@@ -213,15 +270,214 @@ const SKUpdate& SKNMEA2000Parser::parse127257(const SKSourceInput& input, const
   double roll  = N2kDoubleNA;
 
   if (ParseN2kPGN127257(msg, sid, yaw, pitch, roll)) {
-    SKUpdateStatic<1> *update = new SKUpdateStatic<1>();
-    update->setTimestamp(timestamp);
+    _update.setTimestamp(timestamp);
+
+    SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+    _update.setSource(source);
+    _update.setNavigationAttitude(SKTypeAttitude(roll, pitch, yaw));
+
+    return _update;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 127258 Magnetic Variation
+//  - Variation             Magnetic variation in radians. Positive to the East.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse127258(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  tN2kMagneticVariation variationSource;
+  uint16_t daysSince1970;
+  double variation = N2kDoubleNA;
+
+  if (ParseN2kPGN127258(msg, sid, variationSource, daysSince1970, variation)) {
+    if (!N2kIsNA(variation)) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+      _update.setNavigationMagneticVariation(variation);
+
+      return _update;
+    }
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 127488 Engine Parameters, Rapid Update
+//  - EngineSpeed           RPM
+//  - EngineBoostPressure   Pa
+//  - EngineTiltTrim        % (0 = fully down, 100 = fully up)
+//  The engine instance is used as the index of the propulsion paths.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse127488(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char engineInstance;
+  double engineSpeed = N2kDoubleNA;
+  double boostPressure = N2kDoubleNA;
+  int8_t tiltTrim = N2kInt8NA;
+
+  if (ParseN2kEngineParamRapid(msg, engineInstance, engineSpeed, boostPressure, tiltTrim)) {
+    _update.setTimestamp(timestamp);
 
     SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-    update->setSource(source);
-    update->setNavigationAttitude(SKTypeAttitude(roll, pitch, yaw));
+    _update.setSource(source);
 
-    _sku = update;
-    return *_sku;
+    char index[4];
+    snprintf(index, sizeof(index), "%u", engineInstance);
+
+    if (!N2kIsNA(engineSpeed)) {
+      _update.setPropulsionRevolutions(index, engineSpeed / 60);
+    }
+    if (!N2kIsNA(boostPressure)) {
+      _update.setPropulsionBoostPressure(index, boostPressure);
+    }
+    if (tiltTrim != N2kInt8NA) {
+      _update.setPropulsionDriveTrimState(index, tiltTrim / 100.0);
+    }
+
+    return _update;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 127493 Transmission Parameters, Dynamic
+//  - OilPressure           Pa
+//  - OilTemperature        K
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse127493(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char engineInstance;
+  tN2kTransmissionGear gear;
+  double oilPressure = N2kDoubleNA;
+  double oilTemperature = N2kDoubleNA;
+  unsigned char discreteStatus;
+
+  if (ParseN2kPGN127493(msg, engineInstance, gear, oilPressure, oilTemperature, discreteStatus)) {
+    _update.setTimestamp(timestamp);
+
+    SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+    _update.setSource(source);
+
+    char index[4];
+    snprintf(index, sizeof(index), "%u", engineInstance);
+
+    if (!N2kIsNA(oilPressure)) {
+      _update.setPropulsionTransmissionOilPressure(index, oilPressure);
+    }
+    if (!N2kIsNA(oilTemperature)) {
+      _update.setPropulsionTransmissionOilTemperature(index, oilTemperature);
+    }
+
+    return _update;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+/*
+ * SignalK name of the tanks of each fluid type or 0 if SignalK does not have
+ * a name for this type.
+ */
+static const char* tankTypeName(tN2kFluidType fluidType) {
+  switch (fluidType) {
+    case N2kft_Fuel:
+      return "fuel";
+    case N2kft_Water:
+      return "freshWater";
+    case N2kft_GrayWater:
+      return "wasteWater";
+    case N2kft_LiveWell:
+      return "liveWell";
+    case N2kft_Oil:
+      return "lubrication";
+    case N2kft_BlackWater:
+      return "blackWater";
+    default:
+      return 0;
+  }
+}
+
+// *****************************************************************************
+//  PGN 127505 Fluid Level
+//  - Level                 % of the capacity
+//  - Capacity              liters
+//  Tanks are indexed by their type and instance (for example: "fuel.0").
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse127505(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char instance;
+  tN2kFluidType fluidType;
+  double level = N2kDoubleNA;
+  double capacity = N2kDoubleNA;
+
+  if (ParseN2kFluidLevel(msg, instance, fluidType, level, capacity)) {
+    const char *typeName = tankTypeName(fluidType);
+    if (typeName) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+
+      char index[16];
+      snprintf(index, sizeof(index), "%s.%u", typeName, instance);
+
+      if (!N2kIsNA(level)) {
+        _update.setTanksCurrentLevel(index, level / 100);
+      }
+      if (!N2kIsNA(capacity)) {
+        _update.setTanksCapacity(index, capacity / 1000);
+      }
+
+      return _update;
+    }
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 127508 Battery Status
+//  - BatteryVoltage        V
+//  - BatteryCurrent        A
+//  - BatteryTemperature    K
+//  The battery instance is used as the index of the battery paths.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse127508(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char batteryInstance;
+  double voltage = N2kDoubleNA;
+  double current = N2kDoubleNA;
+  double temperature = N2kDoubleNA;
+  unsigned char sid;
+
+  if (ParseN2kDCBatStatus(msg, batteryInstance, voltage, current, temperature, sid)) {
+    _update.setTimestamp(timestamp);
+
+    SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+    _update.setSource(source);
+
+    char index[4];
+    snprintf(index, sizeof(index), "%u", batteryInstance);
+
+    if (!N2kIsNA(voltage)) {
+      _update.setElectricalBatteriesVoltage(index, voltage);
+    }
+    if (!N2kIsNA(current)) {
+      _update.setElectricalBatteriesCurrent(index, current);
+    }
+    if (!N2kIsNA(temperature)) {
+      _update.setElectricalBatteriesTemperature(index, temperature);
+    }
+
+    return _update;
   }
 
   DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
@@ -244,18 +500,16 @@ const SKUpdate& SKNMEA2000Parser::parse128259(const SKSourceInput& input, const
   tN2kSpeedWaterReferenceType swrt;
 
   if (ParseN2kBoatSpeed(msg, sid, waterSpeed, groundSpeed, swrt)) {
-    SKUpdateStatic<2> *update = new SKUpdateStatic<2>();
-    update->setTimestamp(timestamp);
+    _update.setTimestamp(timestamp);
 
     SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-    update->setSource(source);
+    _update.setSource(source);
 
     if (!N2kIsNA(waterSpeed)) {
-      update->setNavigationSpeedThroughWater(waterSpeed);
+      _update.setNavigationSpeedThroughWater(waterSpeed);
     }
 
-    _sku = update;
-    return *_sku;
+    return _update;
   }
 
   DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
@@ -274,29 +528,58 @@ const SKUpdate& SKNMEA2000Parser::parse128267(const SKSourceInput& input, const
 
   if (ParseN2kWaterDepth(msg, sid, depthBelowTransducer, offset)) {
     if (!N2kIsNA(depthBelowTransducer)) {
-      SKUpdateStatic<3> *update = new SKUpdateStatic<3>();
-      update->setTimestamp(timestamp);
+      _update.setTimestamp(timestamp);
 
       SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-      update->setSource(source);
+      _update.setSource(source);
 
-      update->setEnvironmentDepthBelowTransducer(depthBelowTransducer);
+      _update.setEnvironmentDepthBelowTransducer(depthBelowTransducer);
 
       // When offset is negative, it's the distance between transducer and keel
       if (!N2kIsNA(offset)) {
         if (offset < 0) {
-          update->setEnvironmentDepthTransducerToKeel(offset * -1);
-          update->setEnvironmentDepthBelowKeel(depthBelowTransducer + offset);
+          _update.setEnvironmentDepthTransducerToKeel(offset * -1);
+          _update.setEnvironmentDepthBelowKeel(depthBelowTransducer + offset);
         }
         else if (offset > 0) {
-          update->setEnvironmentDepthSurfaceToTransducer(offset);
-          update->setEnvironmentDepthBelowSurface(depthBelowTransducer + offset);
+          _update.setEnvironmentDepthSurfaceToTransducer(offset);
+          _update.setEnvironmentDepthBelowSurface(depthBelowTransducer + offset);
         }
       }
 
-      _sku = update;
-      return *_sku;
+      return _update;
+    }
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 128275 Distance Log
+//  - Log                   Total distance traveled in meters
+//  - TripLog               Distance traveled since last reset in meters
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse128275(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  uint16_t daysSince1970;
+  double secondsSinceMidnight;
+  uint32_t log = N2kUInt32NA;
+  uint32_t tripLog = N2kUInt32NA;
+
+  if (ParseN2kPGN128275(msg, daysSince1970, secondsSinceMidnight, log, tripLog)) {
+    _update.setTimestamp(timestamp);
+
+    SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+    _update.setSource(source);
+
+    if (!N2kIsNA(log)) {
+      _update.setNavigationLog(log);
+    }
+    if (!N2kIsNA(tripLog)) {
+      _update.setNavigationTripLog(tripLog);
     }
+
+    return _update;
   }
 
   DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
@@ -311,15 +594,14 @@ const SKUpdate& SKNMEA2000Parser::parse129025(const SKSourceInput& input, const
   double longitude;
 
   if (ParseN2kPositionRapid(msg, latitude, longitude)) {
-    SKUpdateStatic<2> *update = new SKUpdateStatic<2>();
-    update->setTimestamp(timestamp);
+    _update.setTimestamp(timestamp);
 
     SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-    update->setSource(source);
-    update->setNavigationPosition(SKTypePosition(latitude, longitude, 0));
+    _update.setSource(source);
+    // This PGN does not have the altitude.
+    _update.setNavigationPosition(SKTypePosition(latitude, longitude, SKDoubleNAN));
 
-    _sku = update;
-    return *_sku;
+    return _update;
   }
 
   DEBUG("Unable to parse NMEA2000 with PGN %i", msg.PGN);
@@ -341,22 +623,105 @@ const SKUpdate& SKNMEA2000Parser::parse129026(const SKSourceInput& input, const
   double SOG;
 
   if (ParseN2kCOGSOGRapid(msg,sid,headingReference,COG,SOG)) {
-    SKUpdateStatic<2> *update = new SKUpdateStatic<2>();
-    update->setTimestamp(timestamp);
+    _update.setTimestamp(timestamp);
 
     SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-    update->setSource(source);
-    update->setNavigationCourseOverGroundTrue(COG);
-    update->setNavigationSpeedOverGround(SOG);
+    _update.setSource(source);
+    _update.setNavigationCourseOverGroundTrue(COG);
+    _update.setNavigationSpeedOverGround(SOG);
 
-    _sku = update;
-    return *_sku;
+    return _update;
   }
 
   DEBUG("Unable to parse NMEA2000 with PGN %i", msg.PGN);
   return _invalidSku;
 }
 
+// *****************************************************************************
+//  PGN 129029 GNSS Position Data
+//  - Position, altitude, date and time of the fix
+//  - Number of satellites, HDOP, PDOP and geoidal separation
+//  The position is ignored when the receiver does not have a fix.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse129029(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  uint16_t daysSince1970 = N2kUInt16NA;
+  double secondsSinceMidnight = N2kDoubleNA;
+  double latitude = N2kDoubleNA;
+  double longitude = N2kDoubleNA;
+  double altitude = N2kDoubleNA;
+  tN2kGNSStype gnssType;
+  tN2kGNSSmethod gnssMethod;
+  unsigned char satellites = N2kUInt8NA;
+  double hdop = N2kDoubleNA;
+  double pdop = N2kDoubleNA;
+  double geoidalSeparation = N2kDoubleNA;
+  unsigned char referenceStations;
+  tN2kGNSStype referenceStationType;
+  uint16_t referenceStationId;
+  double ageOfCorrection;
+
+  if (ParseN2kGNSS(msg, sid, daysSince1970, secondsSinceMidnight, latitude, longitude, altitude,
+                   gnssType, gnssMethod, satellites, hdop, pdop, geoidalSeparation,
+                   referenceStations, referenceStationType, referenceStationId, ageOfCorrection)) {
+    _update.setTimestamp(timestamp);
+
+    SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+    _update.setSource(source);
+
+    bool hasFix = gnssMethod != N2kGNSSm_noGNSS && gnssMethod != N2kGNSSm_Error && gnssMethod != N2kGNSSm_Unavailable;
+    if (hasFix && !N2kIsNA(latitude) && !N2kIsNA(longitude)) {
+      _update.setNavigationPosition(SKTypePosition(latitude, longitude, N2kIsNA(altitude) ? SKDoubleNAN : altitude));
+    }
+    if (!N2kIsNA(daysSince1970) && !N2kIsNA(secondsSinceMidnight)) {
+      _update.setNavigationDatetime(SKTime::timeFromNMEA2000(daysSince1970, secondsSinceMidnight));
+    }
+    if (!N2kIsNA(satellites)) {
+      _update.setNavigationGnssSatellites(satellites);
+    }
+    if (!N2kIsNA(hdop)) {
+      _update.setNavigationGnssHorizontalDilution(hdop);
+    }
+    if (!N2kIsNA(pdop)) {
+      _update.setNavigationGnssPositionDilution(pdop);
+    }
+    if (!N2kIsNA(geoidalSeparation)) {
+      _update.setNavigationGnssGeoidalSeparation(geoidalSeparation);
+    }
+
+    return _update;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 129283 Cross Track Error
+//  - XTE                   Cross track error in meters
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse129283(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  tN2kXTEMode xteMode;
+  bool navigationTerminated;
+  double xte = N2kDoubleNA;
+
+  if (ParseN2kXTE(msg, sid, xteMode, navigationTerminated, xte)) {
+    if (!N2kIsNA(xte)) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+      _update.setNavigationCourseRhumblineCrossTrackError(xte);
+
+      return _update;
+    }
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
 // *****************************************************************************
 //   PGN 130306 W I N D
 // The boat referenced true wind is given by the vector sum of Apparent wind and vessel's heading and speed though the water.
@@ -376,54 +741,258 @@ const SKUpdate& SKNMEA2000Parser::parse130306(const SKSourceInput& input, const
   tN2kWindReference windReference;
 
   if (ParseN2kPGN130306(msg,sid,windSpeed,windAngle,windReference)) {
-    SKUpdateStatic<2> *update = new SKUpdateStatic<2>();
-    update->setTimestamp(timestamp);
+    _update.setTimestamp(timestamp);
 
     SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
-    update->setSource(source);
+    _update.setSource(source);
 
     if (!N2kIsNA(windAngle) && !N2kIsNA(windSpeed)) {
       switch(windReference) {
         case N2kWind_True_North:
           // Ground Wind Speed
-          update->setEnvironmentWindSpeedOverGround(windSpeed);
+          _update.setEnvironmentWindSpeedOverGround(windSpeed);
           // Ground Wind Direction
-          update->setEnvironmentWindDirectionTrue(windAngle);
+          _update.setEnvironmentWindDirectionTrue(windAngle);
         break;
         case N2kWind_Magnetic:
           // Ground Wind Speed
-          update->setEnvironmentWindSpeedOverGround(windSpeed);
+          _update.setEnvironmentWindSpeedOverGround(windSpeed);
           // Ground Wind Direction referred to magnetic north
-          update->setEnvironmentWindDirectionMagnetic(windAngle);
+          _update.setEnvironmentWindDirectionMagnetic(windAngle);
         break;
         case  N2kWind_Apparent:
           // AWS Apparent Wind Speed
-          update->setEnvironmentWindSpeedApparent(windSpeed);
+          _update.setEnvironmentWindSpeedApparent(windSpeed);
           // AWA pos coming from starboard, neg from port, relative to centerline vessel
-          update->setEnvironmentWindAngleApparent(SKNormalizeAngle(windAngle));
+          _update.setEnvironmentWindAngleApparent(SKNormalizeAngle(windAngle));
         break;
         case N2kWind_True_boat:
           // Ground Wind
-          update->setEnvironmentWindSpeedOverGround(windSpeed);
+          _update.setEnvironmentWindSpeedOverGround(windSpeed);
           // Ground Wind +/- starboard/port
-          update->setEnvironmentWindAngleTrueGround(SKNormalizeAngle(windAngle));
+          _update.setEnvironmentWindAngleTrueGround(SKNormalizeAngle(windAngle));
         break;
         case N2kWind_True_water:
           // TWS (water referred) True "Sailing" Wind
-          update->setEnvironmentWindSpeedTrue(windSpeed);
-          update->setEnvironmentWindAngleTrueWater(SKNormalizeAngle(windAngle));
+          _update.setEnvironmentWindSpeedTrue(windSpeed);
+          _update.setEnvironmentWindAngleTrueWater(SKNormalizeAngle(windAngle));
         break;
       }
     }
 
-    _sku = update;
-    return *_sku;
+    return _update;
   }
 
   DEBUG("Unable to parse NMEA2000 with PGN %i", msg.PGN);
   return _invalidSku;
 }
 
+bool SKNMEA2000Parser::setTemperature(tN2kTempSource source, double temperature) {
+  switch (source) {
+    case N2kts_SeaTemperature:
+      return _update.setEnvironmentWaterTemperature(temperature);
+    case N2kts_OutsideTemperature:
+      return _update.setEnvironmentOutsideTemperature(temperature);
+    case N2kts_InsideTemperature:
+      return _update.setEnvironmentInsideTemperature(temperature);
+    case N2kts_EngineRoomTemperature:
+      return _update.setEnvironmentInsideEngineRoomTemperature(temperature);
+    case N2kts_MainCabinTemperature:
+      return _update.setEnvironmentInsideMainCabinTemperature(temperature);
+    case N2kts_RefridgerationTemperature:
+      return _update.setEnvironmentInsideRefrigeratorTemperature(temperature);
+    case N2kts_DewPointTemperature:
+      return _update.setEnvironmentOutsideDewPointTemperature(temperature);
+    case N2kts_ApparentWindChillTemperature:
+      return _update.setEnvironmentOutsideApparentWindChillTemperature(temperature);
+    default:
+      return false;
+  }
+}
+
+// *****************************************************************************
+//  PGN 130312 Temperature
+//  - ActualTemperature     K
+//  Only the sources which have a SignalK path are converted.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse130312(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  unsigned char instance;
+  tN2kTempSource tempSource;
+  double actualTemperature = N2kDoubleNA;
+  double targetTemperature = N2kDoubleNA;
+
+  if (ParseN2kTemperature(msg, sid, instance, tempSource, actualTemperature, targetTemperature)) {
+    if (!N2kIsNA(actualTemperature) && setTemperature(tempSource, actualTemperature)) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+
+      return _update;
+    }
+    return _invalidSku;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 130314 Actual Pressure
+//  - Pressure              Pa
+//  Only the atmospheric pressure is converted.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse130314(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  unsigned char instance;
+  tN2kPressureSource pressureSource;
+  double pressure = N2kDoubleNA;
+
+  if (ParseN2kPressure(msg, sid, instance, pressureSource, pressure)) {
+    if (pressureSource == N2kps_Atmospheric && !N2kIsNA(pressure)) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+      _update.setEnvironmentOutsidePressure(pressure);
+
+      return _update;
+    }
+    return _invalidSku;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 130316 Temperature, Extended Range
+//  Same as 130312 with a larger range and a better resolution.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse130316(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  unsigned char sid;
+  unsigned char instance;
+  tN2kTempSource tempSource;
+  double actualTemperature = N2kDoubleNA;
+  double targetTemperature = N2kDoubleNA;
+
+  if (ParseN2kPGN130316(msg, sid, instance, tempSource, actualTemperature, targetTemperature)) {
+    if (!N2kIsNA(actualTemperature) && setTemperature(tempSource, actualTemperature)) {
+      _update.setTimestamp(timestamp);
+
+      SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+      _update.setSource(source);
+
+      return _update;
+    }
+    return _invalidSku;
+  }
+
+  DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+  return _invalidSku;
+}
+
+// *****************************************************************************
+//  PGN 130577 Direction Data
+//    0 Data Mode (4 bits), COG Reference (2 bits)
+//    1 Sequence ID
+//    2 COG                 rad, 0.0001
+//    4 SOG                 m/s, 0.01
+//    6 Heading             rad, 0.0001
+//    8 Speed through water m/s, 0.01
+//   10 Set                 rad, 0.0001
+//   12 Drift               m/s, 0.01
+//  The NMEA2000 library version we use does not parse this PGN.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse130577(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  if (msg.DataLen < 14) {
+    DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+    return _invalidSku;
+  }
+
+  int index = 0;
+  tN2kHeadingReference reference = (tN2kHeadingReference)((msg.GetByte(index) >> 4) & 0x03);
+  msg.GetByte(index); // sid
+  double cog = msg.Get2ByteUDouble(0.0001, index);
+  double sog = msg.Get2ByteUDouble(0.01, index);
+  double heading = msg.Get2ByteUDouble(0.0001, index);
+  double stw = msg.Get2ByteUDouble(0.01, index);
+  double set = msg.Get2ByteUDouble(0.0001, index);
+  double drift = msg.Get2ByteUDouble(0.01, index);
+
+  _update.setTimestamp(timestamp);
+
+  SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+  _update.setSource(source);
+
+  if (reference == N2khr_true) {
+    if (!N2kIsNA(cog)) {
+      _update.setNavigationCourseOverGroundTrue(cog);
+    }
+    if (!N2kIsNA(heading)) {
+      _update.setNavigationHeadingTrue(heading);
+    }
+    if (!N2kIsNA(set)) {
+      _update.setEnvironmentCurrentSetTrue(set);
+    }
+  }
+  else if (reference == N2khr_magnetic) {
+    if (!N2kIsNA(cog)) {
+      _update.setNavigationCourseOverGroundMagnetic(cog);
+    }
+    if (!N2kIsNA(heading)) {
+      _update.setNavigationHeadingMagnetic(heading);
+    }
+  }
+  if (!N2kIsNA(sog)) {
+    _update.setNavigationSpeedOverGround(sog);
+  }
+  if (!N2kIsNA(stw)) {
+    _update.setNavigationSpeedThroughWater(stw);
+  }
+  if (!N2kIsNA(drift)) {
+    _update.setEnvironmentCurrentDrift(drift);
+  }
+
+  return _update;
+}
+
+// *****************************************************************************
+//  PGN 130578 Vessel Speed Components
+//    0 Longitudinal speed, water referenced    m/s, 0.001
+//    2 Transverse speed, water referenced      m/s, 0.001
+//    4 Longitudinal speed, ground referenced   m/s, 0.001
+//    6 Transverse speed, ground referenced     m/s, 0.001
+//    8 Stern speed, water referenced           m/s, 0.001
+//   10 Stern speed, ground referenced          m/s, 0.001
+//  Only the water referenced components have a SignalK path.
+// *****************************************************************************
+const SKUpdate& SKNMEA2000Parser::parse130578(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp) {
+  if (msg.DataLen < 4) {
+    DEBUG("Unable to parse N2kMsg with PGN %i", msg.PGN);
+    return _invalidSku;
+  }
+
+  int index = 0;
+  double longitudinal = msg.Get2ByteDouble(0.001, index);
+  double transverse = msg.Get2ByteDouble(0.001, index);
+
+  _update.setTimestamp(timestamp);
+
+  SKSource source = SKSource::sourceForNMEA2000(input, msg.PGN, msg.Priority, msg.Source);
+  _update.setSource(source);
+
+  if (!N2kIsNA(longitudinal)) {
+    _update.setNavigationSpeedThroughWaterLongitudinal(longitudinal);
+  }
+  if (!N2kIsNA(transverse)) {
+    _update.setNavigationSpeedThroughWaterTransverse(transverse);
+  }
+
+  return _update;
+}
+
 // *****************************************************************************
 //    PGN 128000 Nautical Leeway Angle (new 2017)
 // https://www.nmea.org/Assets/20170204%20nmea%202000%20leeway%20pgn%20final.pdf
@@ -31,17 +31,46 @@
 #pragma once
 
 #include <N2kMsg.h>
+#include <N2kTypes.h>
 #include "SKUpdate.h"
 #include "SKUpdateStatic.h"
 
 class SKNMEA2000Parser {
+  public:
+    // Number of distinct unsupported PGNs that are counted individually.
+    // Messages with other unsupported PGNs are only counted in
+    // getUnknownPGNOverflow().
+    static const uint8_t unknownPGNCapacity = 32;
+
   private:
-    SKUpdate *_sku = 0;
+    typedef const SKUpdate& (SKNMEA2000Parser::*PGNHandler)(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+
+    struct PGNHandlerEntry {
+      uint32_t pgn;
+      PGNHandler handler;
+    };
+
+    // Supported PGNs and their handlers, sorted by PGN so that they can be
+    // found with a binary search. Keep it sorted when adding a new PGN!
+    static const PGNHandlerEntry _handlers[];
+    static const uint8_t _handlersCount;
+
+    struct UnknownPGN {
+      uint32_t pgn;
+      uint32_t count;
+    };
+
+    UnknownPGN _unknownPGNs[unknownPGNCapacity];
+    uint8_t _unknownPGNsCount;
+    uint32_t _unknownPGNOverflow;
+
+    // Parsed updates are built in this instance which is reused for every
+    // message to avoid allocating memory on the heap.
+    SKUpdateStatic<6> _update;
     SKUpdateStatic<0> _invalidSku = SKUpdateStatic<0>();
 
   public:
-    SKNMEA2000Parser() {};
-    ~SKNMEA2000Parser();
+    SKNMEA2000Parser() : _unknownPGNsCount(0), _unknownPGNOverflow(0) {};
 
     /**
      * Parse a NMEA2000 @param msg received on @param input and returns a
@@ -52,29 +81,91 @@ class SKNMEA2000Parser {
      */
     const SKUpdate& parse(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
 
+    /**
+     * Returns true if this parser has a handler for @param pgn.
+     */
+    static bool isPGNSupported(uint32_t pgn);
+
+    /**
+     * Number of messages received with the unsupported @param pgn.
+     */
+    uint32_t getUnknownPGNCount(uint32_t pgn) const;
+
+    /**
+     * Number of distinct unsupported PGNs counted so far.
+     */
+    uint8_t getUnknownPGNsCount() const {
+      return _unknownPGNsCount;
+    };
+
+    /**
+     * Returns the @param i-th unsupported PGN counted, in the order in which
+     * they were first received.
+     */
+    uint32_t getUnknownPGN(uint8_t i) const {
+      return i < _unknownPGNsCount ? _unknownPGNs[i].pgn : 0;
+    };
+
+    /**
+     * Number of messages with an unsupported PGN that could not be counted
+     * individually because the table was full.
+     */
+    uint32_t getUnknownPGNOverflow() const {
+      return _unknownPGNOverflow;
+    };
+
   private:
+    static const PGNHandlerEntry* findHandler(uint32_t pgn);
+    void countUnknownPGN(uint32_t pgn);
+
+    // Updates the temperature path matching @param source. Returns false if
+    // there is no path for this source.
+    bool setTemperature(tN2kTempSource source, double temperature);
+
     //  PGN 126992  System Time Date
     const SKUpdate& parse126992(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 127245 Rudder
     const SKUpdate& parse127245(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 127250 VESSEL HEADING RAPID
     const SKUpdate& parse127250(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 127251 Rate of Turn
+    const SKUpdate& parse127251(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 127257 Attitude Yaw, Pitch, Roll
     const SKUpdate& parse127257(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 127258 Magnetic Variation
+    const SKUpdate& parse127258(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 127488 Engine Parameters, Rapid Update
+    const SKUpdate& parse127488(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 127493 Transmission Parameters, Dynamic
+    const SKUpdate& parse127493(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 127505 Fluid Level
+    const SKUpdate& parse127505(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 127508 Battery Status
+    const SKUpdate& parse127508(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 128259 Boat Speed
     const SKUpdate& parse128259(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 128267 Water depth
     const SKUpdate& parse128267(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 128275 Distance Log
+    const SKUpdate& parse128275(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 129025 Position
     const SKUpdate& parse129025(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 129026 COG & SOG, Rapid Update
     const SKUpdate& parse129026(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 129029 GNSS Position Data
+    const SKUpdate& parse129029(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 129283 Cross Track Error
+    const SKUpdate& parse129283(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
     // PGN 130306 Wind Speed
     const SKUpdate& parse130306(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
-
-
-
-    // Magnetic variation
-    //const SKUpdate& parse127258(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
-
+    // PGN 130312 Temperature
+    const SKUpdate& parse130312(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 130314 Actual Pressure
+    const SKUpdate& parse130314(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 130316 Temperature, Extended Range
+    const SKUpdate& parse130316(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 130577 Direction Data
+    const SKUpdate& parse130577(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
+    // PGN 130578 Vessel Speed Components
+    const SKUpdate& parse130578(const SKSourceInput& input, const tN2kMsg& msg, const SKTime& timestamp);
 };
@@ -34,6 +34,16 @@
 #include "SKNMEAConverter.h"
 
 void SKNMEAConverter::convert(const SKUpdate& update, SKNMEAOutput& output) {
+  // The sentences we generate describe our own boat. Updates about other
+  // vessels (AIS targets) must not be sent as ours.
+  if (update.getContext() != SKContextSelf) {
+    return;
+  }
+
+  if (!update.getPathMask().intersects(getInputPaths())) {
+    return;
+  }
+
   // Trigger a call of visitSKElectricalBatteriesVoltage for every key with that path
   // (there can be more than one and we do not know how they are called)
   _currentOutput = &output;
@@ -123,6 +133,32 @@ void SKNMEAConverter::convert(const SKUpdate& update, SKNMEAOutput& output) {
   //  TODO!
 }
 
+SKPathBitmask SKNMEAConverter::getInputPaths() const {
+  SKPathBitmask paths;
+  if (_config.xdrBattery) {
+    paths.set(SKPathElectricalBatteriesVoltage);
+  }
+  if (_config.xdrPressure) {
+    paths.set(SKPathEnvironmentOutsidePressure);
+  }
+  if (_config.xdrAttitude) {
+    paths.set(SKPathNavigationAttitude);
+  }
+  if (_config.hdm) {
+    paths.set(SKPathNavigationHeadingMagnetic);
+  }
+  if (_config.rsa) {
+    paths.set(SKPathSteeringRudderAngle);
+  }
+  if (_config.mwv) {
+    paths.set(SKPathEnvironmentWindAngleApparent)
+      .set(SKPathEnvironmentWindSpeedApparent)
+      .set(SKPathEnvironmentWindAngleTrueWater)
+      .set(SKPathEnvironmentWindSpeedTrue);
+  }
+  return paths;
+}
+
 void SKNMEAConverter::visitSKElectricalBatteriesVoltage(const SKUpdate& u, const SKPath &p, const SKValue &v) {
   NMEASentenceBuilder sb("II", "XDR", 4);
   sb.setField(1, "V");
@@ -32,6 +32,7 @@
 
 #include <WString.h>
 #include "SKVisitor.generated.h"
+#include "SKPathBitmask.h"
 #include "SKNMEAOutput.h"
 #include "SKNMEAConverterConfig.h"
 
@@ -46,6 +47,13 @@ class SKNMEAConverter : SKVisitor {
   public:
     SKNMEAConverter(const SKNMEAConverterConfig &config) : _config(config), _currentOutput(nullptr) {};
 
+    /**
+     * Returns the set of paths that can generate a sentence with the current
+     * configuration. Updates that do not include any of these paths will not
+     * generate any output.
+     */
+    SKPathBitmask getInputPaths() const;
+
     /**
      * Process a SKUpdate and sends messages to the output.
      */
@@ -25,79 +25,124 @@
 #include <math.h>
 #include <KBoxLogging.h>
 #include "common/nmea/NMEASentenceReader.h"
+#include "SKAISParser.h"
 #include "SKUnits.h"
 #include "SKNMEAParser.h"
 
-SKNMEAParser::~SKNMEAParser() {
-  if (_sku) {
-    delete(_sku);
-  }
+/**
+ * Packs a three letters sentence code in an integer so that sentences can be
+ * dispatched with a switch.
+ */
+static constexpr uint32_t sentenceId(const char *code) {
+  return ((uint32_t)code[0] << 16) | ((uint32_t)code[1] << 8) | (uint32_t)code[2];
 }
 
 const SKUpdate& SKNMEAParser::parse(const SKSourceInput& input, const String& sentence, const SKTime& time) {
-  if (_sku) {
-    delete(_sku);
-    _sku = 0;
-  }
-
-  NMEASentenceReader reader = NMEASentenceReader(sentence);
+  NMEASentenceReader reader(sentence);
 
   if (!reader.isValid()) {
     DEBUG("%s: Invalid sentence %s", skSourceInputLabels[input].c_str(), sentence.c_str());
     return _invalidSku;
   }
+  return parse(input, reader, time);
+}
 
-  if (reader.getSentenceCode() == "RMC") {
-    return parseRMC(input, reader, time);
+const SKUpdate& SKNMEAParser::parse(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  _update.clear();
+
+  if (!reader.isValid()) {
+    return _invalidSku;
   }
-  if (reader.getSentenceCode() == "MWV") {
-    return parseMWV(input, reader, time);
+
+  // The address field is made of the talker id (2 characters) and the
+  // sentence code (3 characters).
+  NMEAField address = reader.getField(0);
+  if (address.length() == 5) {
+    switch (sentenceId(address.data() + 2)) {
+      case sentenceId("RMC"):
+        return parseRMC(input, reader, time);
+      case sentenceId("MWV"):
+        return parseMWV(input, reader, time);
+      case sentenceId("GGA"):
+        return parseGGA(input, reader, time);
+      case sentenceId("VTG"):
+        return parseVTG(input, reader, time);
+      case sentenceId("HDG"):
+        return parseHDG(input, reader, time);
+      case sentenceId("HDM"):
+        return parseHDM(input, reader, time);
+      case sentenceId("HDT"):
+        return parseHDT(input, reader, time);
+      case sentenceId("DPT"):
+        return parseDPT(input, reader, time);
+      case sentenceId("DBT"):
+        return parseDBT(input, reader, time);
+      case sentenceId("VHW"):
+        return parseVHW(input, reader, time);
+      case sentenceId("MTW"):
+        return parseMTW(input, reader, time);
+      case sentenceId("VLW"):
+        return parseVLW(input, reader, time);
+      case sentenceId("XDR"):
+        return parseXDR(input, reader, time);
+      case sentenceId("RSA"):
+        return parseRSA(input, reader, time);
+      case sentenceId("ROT"):
+        return parseROT(input, reader, time);
+      case sentenceId("VDM"):
+      case sentenceId("VDO"):
+        return parseAIS(input, reader, time);
+    }
   }
 
-  DEBUG("%s: %s%s - Unable to parse sentence", skSourceInputLabels[input].c_str(), reader.getTalkerId().c_str(), reader.getSentenceCode().c_str());
+  DEBUG("%s: %.*s - Unable to parse sentence", skSourceInputLabels[input].c_str(), address.length(), address.data());
   return _invalidSku;
 }
 
-const SKUpdate& SKNMEAParser::parseRMC(const SKSourceInput& input, NMEASentenceReader& reader, const SKTime& time) {
+void SKNMEAParser::startUpdate(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  NMEAField address = reader.getField(0);
+  char talker[3] = { address[0], address[1], 0 };
+  char sentenceCode[4] = { address[2], address[3], address[4], 0 };
+
+  _update.setTimestamp(time);
+  _update.setSource(SKSource::sourceForNMEA0183(input, talker, sentenceCode));
+}
+
+const SKUpdate& SKNMEAParser::parseRMC(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
   // We first need to make sure the data is valid.
   if (reader.getFieldAsChar(2) != 'A') {
     return _invalidSku;
   }
 
-  SKUpdateStatic<4>* rmc = new SKUpdateStatic<4>();
-  rmc->setTimestamp(time);
-
-  SKSource source = SKSource::sourceForNMEA0183(input, reader.getTalkerId(), reader.getSentenceCode());
-  rmc->setSource(source);
+  startUpdate(input, reader, time);
 
-  String utcTime = reader.getFieldAsString(1);
+  NMEAField utcTime = reader.getField(1);
   double latitude = reader.getFieldAsLatLon(3);
   double longitude = reader.getFieldAsLatLon(5);
   double sog = SKKnotToMs(reader.getFieldAsDouble(7));
   double cog = SKDegToRad(reader.getFieldAsDouble(8));
-  String date = reader.getFieldAsString(9);
+  NMEAField date = reader.getField(9);
 
   if (!isnan(latitude) && !isnan(longitude)) {
-    rmc->setValue(SKPathNavigationPosition, SKTypePosition(latitude,
-                                                           longitude,
-                                                           SKDoubleNAN));
+    _update.setValue(SKPathNavigationPosition, SKTypePosition(latitude,
+                                                              longitude,
+                                                              SKDoubleNAN));
   }
   if (!isnan(sog)) {
-    rmc->setValue(SKPathNavigationSpeedOverGround, sog);
+    _update.setValue(SKPathNavigationSpeedOverGround, sog);
   }
   if (!isnan(cog)) {
-    rmc->setValue(SKPathNavigationCourseOverGroundTrue, cog);
+    _update.setValue(SKPathNavigationCourseOverGroundTrue, cog);
   }
 
-  SKTime timestamp = SKTime::timeFromNMEAStrings(date, utcTime);
-  rmc->setNavigationDatetime(timestamp);
+  SKTime timestamp = SKTime::timeFromNMEAFields(date.data(), date.length(),
+                                                utcTime.data(), utcTime.length());
+  _update.setNavigationDatetime(timestamp);
 
-  // _sku is deleted every time a new sentence is parsed
-  _sku = rmc;
-  return *_sku;
+  return _update;
 }
 
-const SKUpdate& SKNMEAParser::parseMWV(const SKSourceInput& input, NMEASentenceReader& reader, const SKTime& time) {
+const SKUpdate& SKNMEAParser::parseMWV(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
   if (reader.getFieldAsChar(5) != 'A') {
     return _invalidSku;
   }
@@ -141,26 +186,332 @@ const SKUpdate& SKNMEAParser::parseMWV(const SKSourceInput& input, NMEASentenceR
   // angle in radian with negative values when wind coming from port
   windAngle = SKNormalizeAngle(SKDegToRad(windAngle));
 
-  SKUpdateStatic<2>* wmv = new SKUpdateStatic<2>();
-  wmv->setTimestamp(time);
-
-  SKSource source = SKSource::sourceForNMEA0183(input, reader.getTalkerId(), reader.getSentenceCode());
-  wmv->setSource(source);
+  startUpdate(input, reader, time);
 
   if (isApparentWind) {
-    wmv->setEnvironmentWindAngleApparent(windAngle);
-    wmv->setEnvironmentWindSpeedApparent(windSpeed);
+    _update.setEnvironmentWindAngleApparent(windAngle);
+    _update.setEnvironmentWindSpeedApparent(windSpeed);
   }
   else {
     // Here we are assuming that if we get a true wind, it is true relative to
     // boat speed in water.  This might be incorrect for some elaborate
     // computers that would take GPS data and provide a true wind over ground.
     // TODO: make this a configuration option
-    wmv->setEnvironmentWindAngleTrueWater(windAngle);
-    wmv->setEnvironmentWindSpeedTrue(windSpeed);
+    _update.setEnvironmentWindAngleTrueWater(windAngle);
+    _update.setEnvironmentWindSpeedTrue(windSpeed);
+  }
+
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseGGA(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  // Fix quality 0 means that there is no fix.
+  char quality = reader.getFieldAsChar(6);
+  if (quality == '\0' || quality == '0') {
+    return _invalidSku;
+  }
+
+  double latitude = reader.getFieldAsLatLon(2);
+  double longitude = reader.getFieldAsLatLon(4);
+  double satellites = reader.getFieldAsDouble(7);
+  double hdop = reader.getFieldAsDouble(8);
+  // Altitude above the mean sea level, and height of the geoid above the
+  // WGS-84 ellipsoid.
+  double altitude = reader.getFieldAsDouble(9);
+  double geoidalSeparation = reader.getFieldAsDouble(11);
+
+  if (isnan(latitude) || isnan(longitude)) {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setNavigationPosition(SKTypePosition(latitude, longitude,
+                                               isnan(altitude) ? SKDoubleNAN : altitude));
+  if (!isnan(satellites)) {
+    _update.setNavigationGnssSatellites(satellites);
+  }
+  if (!isnan(hdop)) {
+    _update.setNavigationGnssHorizontalDilution(hdop);
+  }
+  if (!isnan(geoidalSeparation)) {
+    _update.setNavigationGnssGeoidalSeparation(geoidalSeparation);
+  }
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseVTG(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  // NMEA 2.3 adds a mode indicator. N means the data is not valid.
+  if (reader.getFieldAsChar(9) == 'N') {
+    return _invalidSku;
+  }
+
+  double cogTrue = reader.getFieldAsDouble(1);
+  double cogMagnetic = reader.getFieldAsDouble(3);
+  double sog = reader.getFieldAsDouble(5);
+  if (isnan(sog)) {
+    sog = SKKmphToMs(reader.getFieldAsDouble(7));
+  }
+  else {
+    sog = SKKnotToMs(sog);
+  }
+
+  if (isnan(cogTrue) && isnan(cogMagnetic) && isnan(sog)) {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  if (!isnan(cogTrue)) {
+    _update.setNavigationCourseOverGroundTrue(SKDegToRad(cogTrue));
+  }
+  if (!isnan(cogMagnetic)) {
+    _update.setNavigationCourseOverGroundMagnetic(SKDegToRad(cogMagnetic));
+  }
+  if (!isnan(sog)) {
+    _update.setNavigationSpeedOverGround(sog);
+  }
+  return _update;
+}
+
+/**
+ * Reads an angle in degrees followed by a E/W field and returns it in radians
+ * (East is positive). Returns NaN if the angle or the direction are missing.
+ */
+static double readEastWestAngle(const NMEASentenceReader& reader, int i) {
+  double angle = reader.getFieldAsDouble(i);
+
+  switch (reader.getFieldAsChar(i + 1)) {
+    case 'E':
+      return SKDegToRad(angle);
+    case 'W':
+      return -SKDegToRad(angle);
+    default:
+      return NAN;
+  }
+}
+
+const SKUpdate& SKNMEAParser::parseHDG(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double heading = reader.getFieldAsDouble(1);
+  if (isnan(heading)) {
+    return _invalidSku;
+  }
+  heading = SKDegToRad(heading);
+
+  // The magnetic heading is the sensor heading corrected by the deviation.
+  double deviation = readEastWestAngle(reader, 2);
+  if (!isnan(deviation)) {
+    heading = SKNormalizeDirection(heading + deviation);
+  }
+  double variation = readEastWestAngle(reader, 4);
+
+  startUpdate(input, reader, time);
+  _update.setNavigationHeadingMagnetic(heading);
+  if (!isnan(variation)) {
+    _update.setNavigationMagneticVariation(variation);
+  }
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseHDM(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double heading = reader.getFieldAsDouble(1);
+  if (isnan(heading)) {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setNavigationHeadingMagnetic(SKDegToRad(heading));
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseHDT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double heading = reader.getFieldAsDouble(1);
+  if (isnan(heading)) {
+    return _invalidSku;
   }
 
-  // _sku is deleted every time a new sentence is parsed
-  _sku = wmv;
-  return *_sku;
+  startUpdate(input, reader, time);
+  _update.setNavigationHeadingTrue(SKDegToRad(heading));
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseDPT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double depthBelowTransducer = reader.getFieldAsDouble(1);
+  double offset = reader.getFieldAsDouble(2);
+  if (isnan(depthBelowTransducer)) {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setEnvironmentDepthBelowTransducer(depthBelowTransducer);
+
+  // When offset is negative, it's the distance between transducer and keel
+  if (!isnan(offset)) {
+    if (offset < 0) {
+      _update.setEnvironmentDepthTransducerToKeel(offset * -1);
+      _update.setEnvironmentDepthBelowKeel(depthBelowTransducer + offset);
+    }
+    else if (offset > 0) {
+      _update.setEnvironmentDepthSurfaceToTransducer(offset);
+      _update.setEnvironmentDepthBelowSurface(depthBelowTransducer + offset);
+    }
+  }
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseDBT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  // Depth is given in feet, meters and fathoms. Any of them can be missing.
+  double depth = reader.getFieldAsDouble(3);
+  if (isnan(depth)) {
+    depth = reader.getFieldAsDouble(1) * 0.3048;
+  }
+  if (isnan(depth)) {
+    depth = reader.getFieldAsDouble(5) * 1.8288;
+  }
+  if (isnan(depth)) {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setEnvironmentDepthBelowTransducer(depth);
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseVHW(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double headingTrue = reader.getFieldAsDouble(1);
+  double headingMagnetic = reader.getFieldAsDouble(3);
+  double speed = reader.getFieldAsDouble(5);
+  if (isnan(speed)) {
+    speed = SKKmphToMs(reader.getFieldAsDouble(7));
+  }
+  else {
+    speed = SKKnotToMs(speed);
+  }
+
+  if (isnan(headingTrue) && isnan(headingMagnetic) && isnan(speed)) {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  if (!isnan(headingTrue)) {
+    _update.setNavigationHeadingTrue(SKDegToRad(headingTrue));
+  }
+  if (!isnan(headingMagnetic)) {
+    _update.setNavigationHeadingMagnetic(SKDegToRad(headingMagnetic));
+  }
+  if (!isnan(speed)) {
+    _update.setNavigationSpeedThroughWater(speed);
+  }
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseMTW(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double temperature = reader.getFieldAsDouble(1);
+  if (isnan(temperature) || reader.getFieldAsChar(2) != 'C') {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setEnvironmentWaterTemperature(SKCelsiusToKelvin(temperature));
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseVLW(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  double log = reader.getFieldAsDouble(1);
+  double tripLog = reader.getFieldAsDouble(3);
+  if (isnan(log) && isnan(tripLog)) {
+    return _invalidSku;
+  }
+
+  // Distances are in nautical miles.
+  startUpdate(input, reader, time);
+  if (!isnan(log)) {
+    _update.setNavigationLog(log * 1852);
+  }
+  if (!isnan(tripLog)) {
+    _update.setNavigationTripLog(tripLog * 1852);
+  }
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseXDR(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  SKTypeAttitude attitude(SKDoubleNAN, SKDoubleNAN, SKDoubleNAN);
+  bool hasAttitude = false;
+
+  startUpdate(input, reader, time);
+
+  // Measurements are groups of 4 fields: type, value, unit and name. Only
+  // transducers with well-known names are reported.
+  for (int i = 1; i + 2 <= reader.countFields(); i += 4) {
+    char type = reader.getFieldAsChar(i);
+    double value = reader.getFieldAsDouble(i + 1);
+    char unit = reader.getFieldAsChar(i + 2);
+    NMEAField name = reader.getField(i + 3);
+
+    if (isnan(value)) {
+      continue;
+    }
+
+    if (type == 'C' && unit == 'C') {
+      // Wind sensors often report the air temperature without a name.
+      if (name.isEmpty() || name == "TempAir" || name == "AirTemp" || name == "ENV_OUTAIR_T" || name == "ENV_OUTSIDE_T") {
+        _update.setEnvironmentOutsideTemperature(SKCelsiusToKelvin(value));
+      }
+      else if (name == "WaterTemp" || name == "ENV_WATER_T") {
+        _update.setEnvironmentWaterTemperature(SKCelsiusToKelvin(value));
+      }
+    }
+    else if (type == 'P' && (unit == 'B' || unit == 'P')) {
+      if (name == "Barometer" || name == "AirPres" || name == "ENV_ATMOS_P") {
+        _update.setEnvironmentOutsidePressure(unit == 'B' ? SKBarToPascal(value) : value);
+      }
+    }
+    else if (type == 'A' && unit == 'D') {
+      if (name == "PTCH" || name == "PITCH") {
+        attitude.pitch = SKDegToRad(value);
+        hasAttitude = true;
+      }
+      else if (name == "ROLL") {
+        attitude.roll = SKDegToRad(value);
+        hasAttitude = true;
+      }
+    }
+  }
+
+  if (hasAttitude) {
+    _update.setNavigationAttitude(attitude);
+  }
+  if (_update.getSize() == 0) {
+    return _invalidSku;
+  }
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseRSA(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  // Starboard (or single) rudder sensor. The port rudder is ignored.
+  double angle = reader.getFieldAsDouble(1);
+  if (isnan(angle) || reader.getFieldAsChar(2) != 'A') {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setSteeringRudderAngle(SKDegToRad(angle));
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseROT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  // Rate of turn is in degrees per minute, negative when turning to port.
+  double rateOfTurn = reader.getFieldAsDouble(1);
+  if (isnan(rateOfTurn) || reader.getFieldAsChar(2) != 'A') {
+    return _invalidSku;
+  }
+
+  startUpdate(input, reader, time);
+  _update.setNavigationRateOfTurn(SKDegToRad(rateOfTurn) / 60);
+  return _update;
+}
+
+const SKUpdate& SKNMEAParser::parseAIS(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& time) {
+  if (!_ais) {
+    return _invalidSku;
+  }
+  return _ais->parse(input, reader, time);
 }
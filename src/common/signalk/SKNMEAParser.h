@@ -28,18 +28,27 @@
 #include "SKUpdateStatic.h"
 
 class NMEASentenceReader;
+class SKAISParser;
 
 /**
  * Parse NMEA sentences into SignalK updates.
  */
 class SKNMEAParser {
   private:
-    SKUpdate *_sku = 0;
+    // Parsed updates are built in this instance which is reused for every
+    // sentence to avoid allocating memory on the heap.
+    SKUpdateStatic<4> _update;
     SKUpdateStatic<0> _invalidSku = SKUpdateStatic<0>();
 
+    // Set with setAISParser(), can be shared with other parsers.
+    SKAISParser *_ais;
+
+    // Not copyable.
+    SKNMEAParser(const SKNMEAParser&);
+    SKNMEAParser& operator=(const SKNMEAParser&);
+
   public:
-    SKNMEAParser() {};
-    ~SKNMEAParser();
+    SKNMEAParser() : _ais(0) {};
 
     /**
      * Parses a NMEA0183 @param sentence received on @param input and returns a
@@ -50,8 +59,39 @@ class SKNMEAParser {
      */
     const SKUpdate& parse(const SKSourceInput& input, const String& sentence, const SKTime& timestamp);
 
+    /**
+     * Same as above but with a sentence that has already been validated and
+     * split in fields, so that callers who also need the reader do not
+     * tokenize and checksum the sentence twice.
+     */
+    const SKUpdate& parse(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+
+    /**
+     * AIS sentences are parsed by `ais`, which can be shared by the parsers
+     * of all the inputs so that the table of AIS targets exists only once.
+     * AIS sentences are ignored until an AIS parser is set.
+     */
+    void setAISParser(SKAISParser &ais) {
+      _ais = &ais;
+    };
+
   private:
-    const SKUpdate& parseRMC(const SKSourceInput& input, NMEASentenceReader& reader, const SKTime& timestamp);
-    const SKUpdate& parseMWV(const SKSourceInput& input, NMEASentenceReader& reader, const SKTime& timestamp);
-};
+    void startUpdate(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
 
+    const SKUpdate& parseRMC(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseMWV(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseGGA(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseVTG(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseHDG(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseHDM(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseHDT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseDPT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseDBT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseVHW(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseMTW(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseVLW(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseXDR(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseRSA(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseAIS(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+    const SKUpdate& parseROT(const SKSourceInput& input, const NMEASentenceReader& reader, const SKTime& timestamp);
+};
@@ -30,16 +30,45 @@
 
 #pragma once
 
-#include <WString.h>
+#include <string.h>
 #include "common/nmea/nmea.h"
 
-// FIXME: We should have a better representation of a NMEASentence that does
-// not depend on dynamic memory or Arduino strings.
-class SKNMEASentence : public String {
+/**
+ * A complete NMEA sentence, without the "\r\n".
+ *
+ * This is a view: it does not copy the sentence, which must stay valid and
+ * unchanged as long as the SKNMEASentence is used. Outputs that need to keep
+ * the sentence after `SKNMEAOutput::write()` returns must copy it.
+ */
+class SKNMEASentence {
+  private:
+    const char *_sentence;
+    size_t _length;
+
   public:
-    SKNMEASentence(const String &s) : String(s) {};
+    SKNMEASentence(const char *sentence) : _sentence(sentence), _length(strlen(sentence)) {};
+    SKNMEASentence(const char *sentence, size_t length) : _sentence(sentence), _length(length) {};
+
+    /**
+     * The sentence. It is always NUL-terminated.
+     */
+    const char* c_str() const {
+      return _sentence;
+    };
+
+    size_t length() const {
+      return _length;
+    };
 
     bool isValid() const {
-      return nmea_is_valid(this->c_str());
-    }
+      return nmea_is_valid(_sentence);
+    };
+
+    bool operator==(const char *s) const {
+      return strcmp(_sentence, s) == 0;
+    };
+
+    bool operator!=(const char *s) const {
+      return !(*this == s);
+    };
 };
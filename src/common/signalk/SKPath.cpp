@@ -28,26 +28,71 @@
   THE SOFTWARE.
 */
 
+#include <string.h>
 #include "SKPath.h"
 
 // Shared global instance
 const SKPath SKPathInvalid;
 
-bool SKPath::operator==(const SKPath &other) const {
-  if (_p < SKPathEnumIndexedPaths) {
-    return _p == other._p;
+size_t SKPath::getLength() const {
+  const SKPathInfo &info = getInfo();
+  if (!isIndexed()) {
+    return info.prefixLength;
   }
-  else {
-    // If it is an indexed path, compare the indexes too
-    if (_p == other._p && _index == other._index) {
-      return true;
-    }
-    else {
-      return false;
+  return info.prefixLength + strlen(getIndex()) + info.suffixLength;
+}
+
+size_t SKPath::copyTo(char *buffer, size_t size) const {
+  const SKPathInfo &info = getInfo();
+  const char *parts[] = { info.prefix, isIndexed() ? getIndex() : "", info.suffix };
+
+  size_t length = 0;
+  for (const char *part : parts) {
+    size_t partLength = strlen(part);
+    if (length < size) {
+      size_t available = size - 1 - length;
+      memcpy(buffer + length, part, partLength < available ? partLength : available);
     }
+    length += partLength;
   }
+  if (size > 0) {
+    buffer[length < size ? length : size - 1] = 0;
+  }
+  return length;
 }
 
-bool SKPath::operator!=(const SKPath &other) const {
-  return ! (*this == other);
+String SKPath::toString() const {
+  const SKPathInfo &info = getInfo();
+  String path;
+
+  path.reserve(getLength());
+  path += info.prefix;
+  if (isIndexed()) {
+    path += getIndex();
+    path += info.suffix;
+  }
+  return path;
+}
+
+SKPathEnum SKPath::staticPathFromString(const char *name) {
+  if (!name) {
+    return SKPathInvalidPath;
+  }
+
+  for (int i = SKPathInvalidPath + 1; i < SKPathEnumCount; i++) {
+    const SKPathInfo &info = SKPathInfoTable[i];
+    if (i == SKPathEnumIndexedPaths) {
+      continue;
+    }
+    if (i < SKPathEnumIndexedPaths) {
+      if (strcmp(name, info.prefix) == 0) {
+        return info.path;
+      }
+    }
+    else if (strncmp(name, info.prefix, info.prefixLength) == 0 && name[info.prefixLength] == '*'
+        && strcmp(name + info.prefixLength + 1, info.suffix) == 0) {
+      return info.path;
+    }
+  }
+  return SKPathInvalidPath;
 }
@@ -34,32 +34,69 @@
 
 // This file includes an enum with all the SKPath values. It is generated.
 #include "SKPathEnum.generated.h"
+#include "SKPathIndexTable.h"
+#include "SKPathInfo.h"
 
 class SKPath;
 extern const SKPath SKPathInvalid;
 
+/**
+ * Identifies a SignalK path. Indexed paths keep the id of their index in the
+ * SKPathIndexTable so that SKPath is a small object that can be copied and
+ * compared cheaply.
+ */
 class SKPath {
   private:
-    SKPathEnum _p;
-    String _index;
+    uint8_t _p;
+    uint8_t _index;
 
-  public:
-    SKPath() : _p(SKPathInvalidPath) {};
-    SKPath(SKPathEnum p) : _p(p) {
-      if (p >= SKPathEnumIndexedPaths) {
+    void validateIndex() {
+      if (_p <= SKPathEnumIndexedPaths || _index == SKPathIndexTable::noIndex
+          || _index == SKPathIndexTable::overflowIndex) {
         _p = SKPathInvalidPath;
+        _index = SKPathIndexTable::noIndex;
       }
     };
 
-    SKPath(SKPathEnum p, String index) : _p(p), _index(index) {
-      if (p <= SKPathEnumIndexedPaths) {
+    static_assert(SKPathEnumCount <= 256, "SKPathEnum values must fit in a uint8_t");
+
+  public:
+    SKPath() : _p(SKPathInvalidPath), _index(SKPathIndexTable::noIndex) {};
+    SKPath(SKPathEnum p) : _p(p), _index(SKPathIndexTable::noIndex) {
+      if (p >= SKPathEnumIndexedPaths) {
         _p = SKPathInvalidPath;
-        _index = String();
       }
     };
 
-    bool operator==(const SKPath &other) const;
-    bool operator!=(const SKPath &other) const;
+    /**
+     * Creates an indexed path, adding the index to the SKPathIndexTable if
+     * needed. The path is invalid if the index table is full or the index is
+     * too long.
+     */
+    SKPath(SKPathEnum p, const char *index) : _p(p), _index(SKPathIndexTable::intern(index)) {
+      validateIndex();
+    };
+
+    /**
+     * Returns the indexed path to read a value. The index is not added to
+     * the SKPathIndexTable: the path is invalid if the index is not known
+     * (no value can have been stored with it).
+     */
+    static SKPath find(SKPathEnum p, const char *index) {
+      SKPath path;
+      path._p = p;
+      path._index = SKPathIndexTable::find(index);
+      path.validateIndex();
+      return path;
+    };
+
+    bool operator==(const SKPath &other) const {
+      return _p == other._p && _index == other._index;
+    };
+
+    bool operator!=(const SKPath &other) const {
+      return ! (*this == other);
+    };
 
     /**
      * Static path is the path without the index.
@@ -67,7 +104,15 @@ class SKPath {
      * as the path.
      */
     SKPathEnum getStaticPath() const {
-      return _p;
+      return (SKPathEnum)_p;
+    };
+
+    /**
+     * Returns a number that uniquely identifies this path (including its
+     * index). Useful to hash paths.
+     */
+    uint16_t getId() const {
+      return (_p << 8) | _index;
     };
 
     /**
@@ -78,20 +123,42 @@ class SKPath {
     };
 
     /**
-     * Returns the index associated with the path.
+     * Returns the index associated with the path or an empty string if the
+     * path is not indexed.
      */
-    const String& getIndex() const {
-      if (isIndexed()) {
-        return _index;
-      }
-      else {
-        return SKPathInvalid._index;
-      }
+    const char* getIndex() const {
+      return SKPathIndexTable::lookup(_index);
     };
 
+    /**
+     * Static description of this path (name, unit and type).
+     */
+    const SKPathInfo& getInfo() const {
+      return SKPathInfoTable[_p];
+    };
+
+    /**
+     * Length of the full path, with index if required.
+     */
+    size_t getLength() const;
+
+    /**
+     * Writes the full path in buffer without allocating any memory. The
+     * output is always NUL-terminated and truncated if buffer is too small.
+     *
+     * @return the length of the full path (like strlcpy).
+     */
+    size_t copyTo(char *buffer, size_t size) const;
+
     /**
      * Return the full path, with index if required.
      */
     String toString() const;
-};
 
+    /**
+     * Returns the static path with this SignalK name or SKPathInvalidPath.
+     * The index of indexed paths is written as `*` (for example:
+     * `electrical.batteries.*.voltage`).
+     */
+    static SKPathEnum staticPathFromString(const char *name);
+};
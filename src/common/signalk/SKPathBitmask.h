@@ -0,0 +1,131 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKPathEnum.generated.h"
+
+/**
+ * A set of SKPathEnum values stored as a bitmap.
+ *
+ * Indexed paths are represented by their static path: all the batteries
+ * share the SKPathElectricalBatteriesVoltage bit for example.
+ */
+class SKPathBitmask {
+  private:
+    static const int wordCount = (SKPathEnumCount + 31) / 32;
+    uint32_t _words[wordCount];
+
+  public:
+    /**
+     * Create an empty bitmask.
+     */
+    SKPathBitmask() {
+      clear();
+    };
+
+    /**
+     * Returns a bitmask with all the paths set.
+     */
+    static SKPathBitmask all() {
+      SKPathBitmask mask;
+      for (int i = 0; i < SKPathEnumCount; i++) {
+        mask.set(static_cast<SKPathEnum>(i));
+      }
+      return mask;
+    };
+
+    void clear() {
+      for (int i = 0; i < wordCount; i++) {
+        _words[i] = 0;
+      }
+    };
+
+    /**
+     * Adds a path to this set. Returns a reference to this object so that
+     * calls can be chained.
+     */
+    SKPathBitmask& set(SKPathEnum p) {
+      if (p < SKPathEnumCount) {
+        _words[p / 32] |= (1ul << (p % 32));
+      }
+      return *this;
+    };
+
+    SKPathBitmask& unset(SKPathEnum p) {
+      if (p < SKPathEnumCount) {
+        _words[p / 32] &= ~(1ul << (p % 32));
+      }
+      return *this;
+    };
+
+    bool test(SKPathEnum p) const {
+      if (p < SKPathEnumCount) {
+        return (_words[p / 32] & (1ul << (p % 32))) != 0;
+      }
+      return false;
+    };
+
+    /**
+     * Returns true if at least one path is present in both sets.
+     */
+    bool intersects(const SKPathBitmask &other) const {
+      for (int i = 0; i < wordCount; i++) {
+        if (_words[i] & other._words[i]) {
+          return true;
+        }
+      }
+      return false;
+    };
+
+    bool isEmpty() const {
+      for (int i = 0; i < wordCount; i++) {
+        if (_words[i]) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    SKPathBitmask& operator|=(const SKPathBitmask &other) {
+      for (int i = 0; i < wordCount; i++) {
+        _words[i] |= other._words[i];
+      }
+      return *this;
+    };
+
+    bool operator==(const SKPathBitmask &other) const {
+      for (int i = 0; i < wordCount; i++) {
+        if (_words[i] != other._words[i]) {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    bool operator!=(const SKPathBitmask &other) const {
+      return !(*this == other);
+    };
+};
@@ -1,7 +1,9 @@
 // This file was automatically generated by sk-code-generator.py
 // DO NOT MODIFY! YOUR CHANGES WOULD BE OVERWRITTEN
 // Look at src/common/signalk/SKPathEnum.h.tmpl instead or modify the script
-// Generated on 2018-04-26 11:11:15.603207
+// Generated on 2026-10-18 07:53:14.203278
+
+#pragma once
 
 typedef enum {
   SKPathInvalidPath,
@@ -14,6 +16,14 @@ typedef enum {
   SKPathEnvironmentWaterTemperature,
   SKPathEnvironmentOutsideApparentWindChillTemperature,
   SKPathEnvironmentOutsidePressure,
+  SKPathEnvironmentOutsideTemperature,
+  SKPathEnvironmentOutsideDewPointTemperature,
+  SKPathEnvironmentInsideTemperature,
+  SKPathEnvironmentInsideEngineRoomTemperature,
+  SKPathEnvironmentInsideMainCabinTemperature,
+  SKPathEnvironmentInsideRefrigeratorTemperature,
+  SKPathEnvironmentCurrentSetTrue,
+  SKPathEnvironmentCurrentDrift,
   SKPathEnvironmentWindAngleApparent,
   SKPathEnvironmentWindAngleTrueGround,
   SKPathEnvironmentWindAngleTrueWater,
@@ -23,23 +33,46 @@ typedef enum {
   SKPathEnvironmentWindSpeedOverGround,
   SKPathEnvironmentWindSpeedApparent,
   SKPathNavigationAttitude,
-  SKPathNavigationDatetime,
   SKPathNavigationCourseOverGroundTrue,
+  SKPathNavigationCourseOverGroundMagnetic,
+  SKPathNavigationCourseRhumblineCrossTrackError,
+  SKPathNavigationDatetime,
+  SKPathNavigationGnssSatellites,
+  SKPathNavigationGnssHorizontalDilution,
+  SKPathNavigationGnssPositionDilution,
+  SKPathNavigationGnssGeoidalSeparation,
   SKPathNavigationHeadingMagnetic,
   SKPathNavigationHeadingTrue,
   SKPathNavigationLog,
   SKPathNavigationMagneticVariation,
   SKPathNavigationPosition,
+  SKPathNavigationRateOfTurn,
   SKPathNavigationSpeedOverGround,
   SKPathNavigationSpeedThroughWater,
+  SKPathNavigationSpeedThroughWaterTransverse,
+  SKPathNavigationSpeedThroughWaterLongitudinal,
   SKPathNavigationTripLog,
   SKPathSteeringRudderAngle,
   SKPathSteeringRudderAngleTarget,
   SKPathPerformanceLeeway,
+  SKPathDesignLengthOverall,
+  SKPathDesignBeam,
+  SKPathDesignDraftCurrent,
 
   // Marker value - Every path below requires an index.
   SKPathEnumIndexedPaths,
 
   SKPathElectricalBatteriesVoltage,
+  SKPathElectricalBatteriesCurrent,
+  SKPathElectricalBatteriesTemperature,
+  SKPathPropulsionRevolutions,
+  SKPathPropulsionBoostPressure,
+  SKPathPropulsionDriveTrimState,
+  SKPathPropulsionTransmissionOilPressure,
+  SKPathPropulsionTransmissionOilTemperature,
+  SKPathTanksCurrentLevel,
+  SKPathTanksCapacity,
 
+  // Marker value - Number of values in this enum.
+  SKPathEnumCount
 } SKPathEnum;
@@ -0,0 +1,90 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <KBoxLogging.h>
+#include "SKPathIndexTable.h"
+
+const uint8_t SKPathIndexTable::noIndex;
+const uint8_t SKPathIndexTable::overflowIndex;
+const uint8_t SKPathIndexTable::capacity;
+const uint8_t SKPathIndexTable::maxIndexLength;
+
+static char indexNames[SKPathIndexTable::capacity][SKPathIndexTable::maxIndexLength + 1];
+static uint8_t indexCount = 0;
+
+uint8_t SKPathIndexTable::find(const char *index) {
+  if (index == 0 || index[0] == 0) {
+    return noIndex;
+  }
+
+  for (uint8_t i = 0; i < indexCount; i++) {
+    if (strcmp(indexNames[i], index) == 0) {
+      return i + 1;
+    }
+  }
+  return noIndex;
+}
+
+uint8_t SKPathIndexTable::intern(const char *index) {
+  if (index == 0 || index[0] == 0) {
+    return noIndex;
+  }
+
+  uint8_t id = find(index);
+  if (id != noIndex) {
+    return id;
+  }
+
+  // Truncating would give the same id to different indexes which share a
+  // prefix and their values would overwrite each other.
+  if (strlen(index) > maxIndexLength) {
+    ERROR("SKPath index is too long - Unable to add %s", index);
+    return overflowIndex;
+  }
+
+  if (indexCount >= capacity) {
+    ERROR("SKPath index table is full - Unable to add %s", index);
+    return overflowIndex;
+  }
+
+  strcpy(indexNames[indexCount], index);
+  indexCount++;
+  return indexCount;
+}
+
+const char* SKPathIndexTable::lookup(uint8_t id) {
+  if (id == noIndex || id > indexCount) {
+    return "";
+  }
+  return indexNames[id - 1];
+}
+
+uint8_t SKPathIndexTable::size() {
+  return indexCount;
+}
+
+void SKPathIndexTable::clear() {
+  indexCount = 0;
+}
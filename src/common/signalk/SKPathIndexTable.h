@@ -0,0 +1,84 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Global table of the indexes used in indexed SKPath (for example "house" in
+ * "electrical.batteries.house.voltage").
+ *
+ * Each index is stored once in a statically allocated table and SKPath only
+ * keeps its id. This makes SKPath a small POD which can be copied and compared
+ * without touching the heap.
+ */
+class SKPathIndexTable {
+  public:
+    // Id used for paths that do not have an index.
+    static const uint8_t noIndex = 0;
+
+    // Id returned when the index cannot be stored, because the table is full
+    // or the index is too long. It is never a valid index: paths created with
+    // it are invalid (see SKPath).
+    static const uint8_t overflowIndex = 255;
+
+    // Maximum number of distinct indexes.
+    static const uint8_t capacity = 32;
+
+    // Maximum length of an index. Longer indexes are rejected.
+    static const uint8_t maxIndexLength = 23;
+
+    /**
+     * Returns the id of `index`, adding it to the table if needed.
+     *
+     * @return noIndex if index is null or empty, overflowIndex if the table
+     * is full.
+     */
+    static uint8_t intern(const char *index);
+
+    /**
+     * Returns the id of `index` without adding it to the table.
+     *
+     * @return noIndex if index is null, empty, too long or not in the table.
+     */
+    static uint8_t find(const char *index);
+
+    /**
+     * Returns the index string for `id`, or an empty string for noIndex and
+     * unknown ids.
+     */
+    static const char* lookup(uint8_t id);
+
+    /**
+     * Number of indexes currently in the table.
+     */
+    static uint8_t size();
+
+    /**
+     * Removes all the indexes. Paths created before become invalid. This is
+     * only meant for unit tests.
+     */
+    static void clear();
+};
@@ -0,0 +1,80 @@
+// This file was automatically generated by sk-code-generator.py
+// DO NOT MODIFY! YOUR CHANGES WOULD BE OVERWRITTEN
+// Look at src/common/signalk/SKPathInfo.cpp.tmpl instead or modify the script
+// Generated on 2026-10-18 07:53:14.203741
+
+#include "SKPathInfo.h"
+
+#define SKPathInfoEntry(path, prefix, suffix, unit, type) \
+  { path, prefix, sizeof(prefix) - 1, suffix, sizeof(suffix) - 1, unit, SKValue::type }
+
+constexpr SKPathInfo SKPathInfoTable[SKPathEnumCount] = {
+  SKPathInfoEntry(SKPathInvalidPath, "invalid", "", "", SKValueTypeNone),
+  SKPathInfoEntry(SKPathEnvironmentDepthBelowKeel, "environment.depth.belowKeel", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentDepthBelowTransducer, "environment.depth.belowTransducer", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentDepthBelowSurface, "environment.depth.belowSurface", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentDepthTransducerToKeel, "environment.depth.transducerToKeel", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentDepthSurfaceToTransducer, "environment.depth.surfaceToTransducer", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWaterTemperature, "environment.water.temperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentOutsideApparentWindChillTemperature, "environment.outside.apparentWindChillTemperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentOutsidePressure, "environment.outside.pressure", "", "Pa", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentOutsideTemperature, "environment.outside.temperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentOutsideDewPointTemperature, "environment.outside.dewPointTemperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentInsideTemperature, "environment.inside.temperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentInsideEngineRoomTemperature, "environment.inside.engineRoom.temperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentInsideMainCabinTemperature, "environment.inside.mainCabin.temperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentInsideRefrigeratorTemperature, "environment.inside.refrigerator.temperature", "", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentCurrentSetTrue, "environment.current.setTrue", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentCurrentDrift, "environment.current.drift", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindAngleApparent, "environment.wind.angleApparent", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindAngleTrueGround, "environment.wind.angleTrueGround", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindAngleTrueWater, "environment.wind.angleTrueWater", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindDirectionTrue, "environment.wind.directionTrue", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindDirectionMagnetic, "environment.wind.directionMagnetic", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindSpeedTrue, "environment.wind.speedTrue", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindSpeedOverGround, "environment.wind.speedOverGround", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnvironmentWindSpeedApparent, "environment.wind.speedApparent", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationAttitude, "navigation.attitude", "", "", SKValueTypeAttitude),
+  SKPathInfoEntry(SKPathNavigationCourseOverGroundTrue, "navigation.courseOverGroundTrue", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationCourseOverGroundMagnetic, "navigation.courseOverGroundMagnetic", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationCourseRhumblineCrossTrackError, "navigation.courseRhumbline.crossTrackError", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationDatetime, "navigation.datetime", "", "", SKValueTypeTimestamp),
+  SKPathInfoEntry(SKPathNavigationGnssSatellites, "navigation.gnss.satellites", "", "", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationGnssHorizontalDilution, "navigation.gnss.horizontalDilution", "", "", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationGnssPositionDilution, "navigation.gnss.positionDilution", "", "", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationGnssGeoidalSeparation, "navigation.gnss.geoidalSeparation", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationHeadingMagnetic, "navigation.headingMagnetic", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationHeadingTrue, "navigation.headingTrue", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationLog, "navigation.log", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationMagneticVariation, "navigation.magneticVariation", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationPosition, "navigation.position", "", "", SKValueTypePosition),
+  SKPathInfoEntry(SKPathNavigationRateOfTurn, "navigation.rateOfTurn", "", "rad/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationSpeedOverGround, "navigation.speedOverGround", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationSpeedThroughWater, "navigation.speedThroughWater", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationSpeedThroughWaterTransverse, "navigation.speedThroughWaterTransverse", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationSpeedThroughWaterLongitudinal, "navigation.speedThroughWaterLongitudinal", "", "m/s", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathNavigationTripLog, "navigation.trip.log", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathSteeringRudderAngle, "steering.rudderAngle", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathSteeringRudderAngleTarget, "steering.rudderAngleTarget", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathPerformanceLeeway, "performance.leeway", "", "rad", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathDesignLengthOverall, "design.length.overall", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathDesignBeam, "design.beam", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathDesignDraftCurrent, "design.draft.current", "", "m", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathEnumIndexedPaths, "invalid", "", "", SKValueTypeNone),
+  SKPathInfoEntry(SKPathElectricalBatteriesVoltage, "electrical.batteries.", ".voltage", "V", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathElectricalBatteriesCurrent, "electrical.batteries.", ".current", "A", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathElectricalBatteriesTemperature, "electrical.batteries.", ".temperature", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathPropulsionRevolutions, "propulsion.", ".revolutions", "Hz", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathPropulsionBoostPressure, "propulsion.", ".boostPressure", "Pa", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathPropulsionDriveTrimState, "propulsion.", ".drive.trimState", "ratio", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathPropulsionTransmissionOilPressure, "propulsion.", ".transmission.oilPressure", "Pa", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathPropulsionTransmissionOilTemperature, "propulsion.", ".transmission.oilTemperature", "K", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathTanksCurrentLevel, "tanks.", ".currentLevel", "ratio", SKValueTypeNumber),
+  SKPathInfoEntry(SKPathTanksCapacity, "tanks.", ".capacity", "m3", SKValueTypeNumber),
+};
+
+static constexpr bool SKPathInfoTableIsOrdered(int i = 0) {
+  return i == SKPathEnumCount || (SKPathInfoTable[i].path == i && SKPathInfoTableIsOrdered(i + 1));
+}
+
+static_assert(SKPathInfoTableIsOrdered(), "SKPathInfoTable must follow the order of SKPathEnum");
@@ -0,0 +1,62 @@
+/*
+     __  __     ______     ______     __  __
+    /\ \/ /    /\  == \   /\  __ \   /\_\_\_\
+    \ \  _"-.  \ \  __<   \ \ \/\ \  \/_/\_\/_
+     \ \_\ \_\  \ \_____\  \ \_____\   /\_\/\_\
+       \/_/\/_/   \/_____/   \/_____/   \/_/\/_/
+
+  The MIT License
+
+  Copyright (c) 2017 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKPathEnum.generated.h"
+#include "SKValue.h"
+
+/**
+ * Static description of a SignalK path.
+ *
+ * The name of indexed paths is split around the index: the full name is
+ * prefix + index + suffix (for example "electrical.batteries." + "house" +
+ * ".voltage"). For other paths, prefix is the full name and suffix is empty.
+ */
+struct SKPathInfo {
+  SKPathEnum path;
+  const char *prefix;
+  uint8_t prefixLength;
+  const char *suffix;
+  uint8_t suffixLength;
+
+  // SignalK unit of the values of this path, or an empty string.
+  const char *unit;
+
+  // Type of the values of this path.
+  SKValue::SKValueType type;
+};
+
+/**
+ * One entry per SKPathEnum value, in the order of the enum. This table is
+ * generated by sk-code-generator.py and lives in flash.
+ */
+extern const SKPathInfo SKPathInfoTable[SKPathEnumCount];
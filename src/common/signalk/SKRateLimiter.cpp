@@ -0,0 +1,293 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "SKRateLimiter.h"
+#include "SKUnits.h"
+#include "SKUpdateStatic.h"
+#include "common/algo/Hash.h"
+
+// Maximum number of values in an update that can be held. Bigger updates are
+// forwarded without limit.
+static const int forwardedUpdateCapacity = 8;
+
+SKRateLimiter::SKRateLimiter(const SKRateLimiterConfig &config, SKSubscriber &subscriber, uint16_t capacity) :
+  _subscriber(subscriber), _bits(hashTableBits(capacity)), _millisecondsProvider(nullptr) {
+  _capacity = 1 << _bits;
+  _entries = new Entry[_capacity];
+
+  for (int p = 0; p < SKPathEnumCount; p++) {
+    _minInterval[p] = 0;
+    _mode[p] = SKRateLimitLatest;
+  }
+  for (int i = 0; i < config.rulesCount && i < SKRateLimiterConfig::maxRules; i++) {
+    const SKRateLimitRule &rule = config.rules[i];
+    if (rule.path < SKPathEnumCount && rule.minInterval > 0) {
+      _limitedPaths.set(rule.path);
+      _minInterval[rule.path] = rule.minInterval;
+      _mode[rule.path] = rule.mode;
+      if (strcmp(SKPathInfoTable[rule.path].unit, "rad") == 0) {
+        _anglePaths.set(rule.path);
+      }
+    }
+  }
+}
+
+SKRateLimiter::~SKRateLimiter() {
+  delete[] _entries;
+}
+
+uint32_t SKRateLimiter::now() const {
+  return _millisecondsProvider ? _millisecondsProvider() : 0;
+}
+
+SKRateLimiter::Entry* SKRateLimiter::findEntry(const SKPath &path, const SKSource &source) {
+  uint16_t slot = hashSlot(path.getId(), _bits);
+
+  for (uint16_t probe = 0; probe < _capacity; probe++) {
+    Entry &e = _entries[slot];
+    if (!e.used) {
+      e.used = true;
+      e.path = path;
+      e.source = source;
+      e.count = 0;
+      // The first value is always forwarded immediately.
+      e.sentAt = now() - _minInterval[path.getStaticPath()];
+      return &e;
+    }
+    if (e.path == path && e.source == source) {
+      return &e;
+    }
+    slot = (slot + 1) % _capacity;
+  }
+  return 0;
+}
+
+bool SKRateLimiter::isDue(const Entry &e, uint32_t now) const {
+  return now - e.sentAt >= _minInterval[e.path.getStaticPath()];
+}
+
+void SKRateLimiter::accumulate(Entry &e, const SKValue &value) {
+  if (_mode[e.path.getStaticPath()] == SKRateLimitLatest
+      || (e.count > 0 && e.value.getType() != value.getType())) {
+    e.value = value;
+    e.count = 1;
+    return;
+  }
+
+  if (e.count == 0) {
+    e.value = value;
+    e.sum[0] = e.sum[1] = e.sum[2] = 0;
+    e.sumCos[0] = e.sumCos[1] = e.sumCos[2] = 0;
+    e.negativeAngles = 0;
+  }
+
+  switch (value.getType()) {
+    case SKValue::SKValueTypeNumber:
+      if (_anglePaths.test(e.path.getStaticPath())) {
+        accumulateAngle(e, 0, value.getNumberValue());
+      }
+      else {
+        e.sum[0] += value.getNumberValue();
+      }
+      break;
+    case SKValue::SKValueTypePosition: {
+      SKTypePosition p = value.getPositionValue();
+      e.sum[0] += p.latitude;
+      // Longitudes on both sides of the antimeridian must not average to 0.
+      accumulateAngle(e, 1, SKDegToRad(p.longitude));
+      e.sum[2] += p.altitude;
+      break;
+    }
+    case SKValue::SKValueTypeAttitude: {
+      SKTypeAttitude a = value.getAttitudeValue();
+      accumulateAngle(e, 0, a.roll);
+      accumulateAngle(e, 1, a.pitch);
+      accumulateAngle(e, 2, a.yaw);
+      break;
+    }
+    case SKValue::SKValueTypeNone:
+    case SKValue::SKValueTypeTimestamp:
+      // Cannot be averaged. Keep the latest one.
+      e.value = value;
+      break;
+  }
+  e.count++;
+}
+
+void SKRateLimiter::accumulateAngle(Entry &e, int component, double angle) {
+  // Angles are averaged with their sines and cosines so that 359 and 1
+  // degrees give 0 and not 180.
+  if (angle == SKDoubleNAN) {
+    return;
+  }
+  e.sum[component] += sin(angle);
+  e.sumCos[component] += cos(angle);
+  if (angle < 0) {
+    e.negativeAngles |= 1 << component;
+  }
+}
+
+double SKRateLimiter::meanAngle(const Entry &e, int component) {
+  if (e.sum[component] == 0 && e.sumCos[component] == 0) {
+    return SKDoubleNAN;
+  }
+  double mean = atan2(e.sum[component], e.sumCos[component]);
+  // Keep the mean between 0 and 2*PI for paths which never received a
+  // negative value (headings for example).
+  if (mean < 0 && !(e.negativeAngles & (1 << component))) {
+    mean += 2 * M_PI;
+  }
+  return mean;
+}
+
+SKValue SKRateLimiter::coalescedValue(const Entry &e) const {
+  if (_mode[e.path.getStaticPath()] == SKRateLimitLatest || e.count <= 1) {
+    return e.value;
+  }
+
+  switch (e.value.getType()) {
+    case SKValue::SKValueTypeNumber:
+      if (_anglePaths.test(e.path.getStaticPath())) {
+        return SKValue(meanAngle(e, 0));
+      }
+      return SKValue(e.sum[0] / e.count);
+    case SKValue::SKValueTypePosition: {
+      double longitude = SKRadToDeg(meanAngle(e, 1));
+      if (longitude > 180) {
+        longitude -= 360;
+      }
+      return SKValue(SKTypePosition(e.sum[0] / e.count, longitude, e.sum[2] / e.count));
+    }
+    case SKValue::SKValueTypeAttitude:
+      return SKValue(SKTypeAttitude(meanAngle(e, 0), meanAngle(e, 1), meanAngle(e, 2)));
+    default:
+      return e.value;
+  }
+}
+
+void SKRateLimiter::markSent(Entry &e, uint32_t now) {
+  e.count = 0;
+  e.sentAt = now;
+  unlinkHeld(e);
+}
+
+void SKRateLimiter::unlinkHeld(Entry &e) {
+  if (e.prevHeld != noEntry) {
+    _entries[e.prevHeld].nextHeld = e.nextHeld;
+  }
+  if (e.nextHeld != noEntry) {
+    _entries[e.nextHeld].prevHeld = e.prevHeld;
+  }
+  e.prevHeld = noEntry;
+  e.nextHeld = noEntry;
+}
+
+void SKRateLimiter::updateReceived(const SKUpdate& update) {
+  if (!update.getPathMask().intersects(_limitedPaths) || update.getContext() != SKContextSelf
+      || update.getSize() > forwardedUpdateCapacity) {
+    _subscriber.updateReceived(update);
+    return;
+  }
+
+  // All the values of the update are tracked, with or without a rule, so
+  // that a held update can be rebuilt completely by flush().
+  Entry *entries[forwardedUpdateCapacity];
+  for (int i = 0; i < update.getSize(); i++) {
+    entries[i] = findEntry(update.getPath(i), update.getSource());
+    if (!entries[i]) {
+      _subscriber.updateReceived(update);
+      return;
+    }
+  }
+
+  uint32_t t = now();
+  bool due = true;
+  for (int i = 0; i < update.getSize(); i++) {
+    Entry &e = *entries[i];
+    accumulate(e, update.getValue(i));
+    e.timestamp = update.getTimestamp();
+    if (!isDue(e, t)) {
+      due = false;
+    }
+  }
+  if (!due) {
+    // The values now belong to this update only: they are removed from the
+    // updates they were held with before and linked together.
+    for (int i = 0; i < update.getSize(); i++) {
+      unlinkHeld(*entries[i]);
+    }
+    for (int i = 1; i < update.getSize(); i++) {
+      entries[i - 1]->nextHeld = entries[i] - _entries;
+      entries[i]->prevHeld = entries[i - 1] - _entries;
+    }
+    return;
+  }
+
+  SKUpdateStatic<forwardedUpdateCapacity> forwarded;
+  forwarded.setSource(update.getSource());
+  forwarded.setTimestamp(update.getTimestamp());
+  for (int i = 0; i < update.getSize(); i++) {
+    forwarded.setValue(update.getPath(i), coalescedValue(*entries[i]));
+    markSent(*entries[i], t);
+  }
+  _subscriber.updateReceived(forwarded);
+}
+
+void SKRateLimiter::flush() {
+  uint32_t t = now();
+
+  // Each held update is visited from its first value, so every value is
+  // looked at once or twice.
+  for (uint16_t i = 0; i < _capacity; i++) {
+    Entry &e = _entries[i];
+    if (!e.used || e.count == 0 || e.prevHeld != noEntry) {
+      continue;
+    }
+
+    // Values held with this one are sent together, when they are all due.
+    bool due = true;
+    for (uint16_t j = i; j != noEntry; j = _entries[j].nextHeld) {
+      if (!isDue(_entries[j], t)) {
+        due = false;
+        break;
+      }
+    }
+    if (!due) {
+      continue;
+    }
+
+    SKUpdateStatic<forwardedUpdateCapacity> update;
+    update.setSource(e.source);
+    update.setTimestamp(e.timestamp);
+    uint16_t j = i;
+    while (j != noEntry) {
+      Entry &held = _entries[j];
+      j = held.nextHeld;
+      update.setValue(held.path, coalescedValue(held));
+      markSent(held, t);
+    }
+    _subscriber.updateReceived(update);
+  }
+}
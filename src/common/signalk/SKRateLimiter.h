@@ -0,0 +1,139 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKPath.h"
+#include "SKPathBitmask.h"
+#include "SKRateLimiterConfig.h"
+#include "SKSource.h"
+#include "SKSubscriber.h"
+#include "SKTime.h"
+#include "SKValue.h"
+
+/**
+ * Limits the rate at which updates containing some paths are delivered to a
+ * subscriber.
+ *
+ * SKRateLimiter is subscribed to a hub in place of the subscriber it
+ * protects. Updates without a limited path, and updates about other vessels
+ * (AIS targets), are forwarded immediately. Other updates are limited as a
+ * whole so that values which go together (COG and SOG for example) are never
+ * separated: an update is forwarded when the interval of all its limited
+ * (path, source) has elapsed and is held otherwise. The values received in
+ * between are coalesced according to the mode of the rule of their path, or
+ * replaced by the latest value for paths without a rule.
+ *
+ * Held values are forwarded with the next update that arrives after the
+ * interval or by `flush()`, which should be called regularly by the owner of
+ * the subscriber. `flush()` rebuilds the last update held, with the
+ * coalesced values.
+ *
+ * The state of each value is kept in a fixed size hash table allocated when
+ * the limiter is created. Updates which do not fit in the table are forwarded
+ * immediately. `flush()` goes once over the table.
+ */
+class SKRateLimiter : public SKSubscriber {
+  public:
+    typedef uint32_t (*millisecondsProvider_t)();
+
+  private:
+    struct Entry {
+      SKPath path;
+      SKSource source;
+      SKTime timestamp;
+      // Last value received, or first value of the interval in mean mode.
+      SKValue value;
+      // Sum of the values received during the interval in mean mode. For
+      // angles and longitudes, sums of their sines and cosines.
+      double sum[3];
+      double sumCos[3];
+      // Angles which received a negative value, one bit per component.
+      uint8_t negativeAngles;
+      uint16_t count;
+      // The values of a held update are linked together so that flush() can
+      // find them without searching the table. Only held values are linked.
+      uint16_t prevHeld;
+      uint16_t nextHeld;
+      uint32_t sentAt;
+      bool used;
+
+      Entry() : negativeAngles(0), count(0), prevHeld(noEntry), nextHeld(noEntry), sentAt(0), used(false) {};
+    };
+
+    static const uint16_t noEntry = 0xFFFF;
+
+    SKSubscriber &_subscriber;
+    Entry *_entries;
+    uint16_t _capacity;
+    uint8_t _bits;
+    millisecondsProvider_t _millisecondsProvider;
+
+    SKPathBitmask _limitedPaths;
+    // Paths which are averaged as angles in mean mode.
+    SKPathBitmask _anglePaths;
+    uint32_t _minInterval[SKPathEnumCount];
+    enum SKRateLimitMode _mode[SKPathEnumCount];
+
+    uint32_t now() const;
+    Entry* findEntry(const SKPath &path, const SKSource &source);
+    bool isDue(const Entry &e, uint32_t now) const;
+    void accumulate(Entry &e, const SKValue &value);
+    static void accumulateAngle(Entry &e, int component, double angle);
+    static double meanAngle(const Entry &e, int component);
+    SKValue coalescedValue(const Entry &e) const;
+    void markSent(Entry &e, uint32_t now);
+    void unlinkHeld(Entry &e);
+
+    // Not copyable.
+    SKRateLimiter(const SKRateLimiter&);
+    SKRateLimiter& operator=(const SKRateLimiter&);
+
+  public:
+    /**
+     * Create a new limiter that forwards updates to `subscriber` and can
+     * track up to `capacity` values. The capacity is rounded up to a power of
+     * two.
+     */
+    SKRateLimiter(const SKRateLimiterConfig &config, SKSubscriber &subscriber, uint16_t capacity);
+    ~SKRateLimiter();
+
+    /**
+     * Set the function used to know how many milliseconds have elapsed.
+     *
+     * If a milliseconds provider is not set, time never passes and only the
+     * first update of each limited path is forwarded.
+     */
+    void setMillisecondsProvider(millisecondsProvider_t millisecondsProvider) {
+      _millisecondsProvider = millisecondsProvider;
+    };
+
+    void updateReceived(const SKUpdate& update) override;
+
+    /**
+     * Forward the held updates whose interval has elapsed.
+     */
+    void flush();
+};
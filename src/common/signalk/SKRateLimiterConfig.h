@@ -0,0 +1,57 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "SKPathEnum.generated.h"
+
+enum SKRateLimitMode {
+  // Send the last value received during the interval.
+  SKRateLimitLatest,
+  // Send the average of the values received during the interval. Attitudes
+  // and paths in radians (headings for example) are averaged as angles.
+  SKRateLimitMean
+};
+
+/**
+ * Maximum output rate of one static path.
+ */
+struct SKRateLimitRule {
+  SKPathEnum path;
+  // Minimum number of milliseconds between two values of this path.
+  uint32_t minInterval;
+  enum SKRateLimitMode mode;
+};
+
+/**
+ * Configuration for an instance of SKRateLimiter. Paths without a rule are
+ * not limited.
+ */
+struct SKRateLimiterConfig {
+  static const int maxRules = 8;
+
+  SKRateLimitRule rules[maxRules];
+  int rulesCount = 0;
+};
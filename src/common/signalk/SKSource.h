@@ -72,7 +72,7 @@ class SKSource {
     /**
      * Returns a source instance for the given NMEA0183 source info.
      */
-    static SKSource sourceForNMEA0183(const SKSourceInput input, const String& _talker, const String& _sentence);
+    static SKSource sourceForNMEA0183(const SKSourceInput input, const char *talker, const char *sentence);
 
     /**
      * Returns a source instance for the given NMEA2000 source info.
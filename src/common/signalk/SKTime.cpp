@@ -172,33 +172,54 @@ uint32_t makeTime(const tmElements_t &tm){
 }
 
 SKTime SKTime::timeFromNMEAStrings(String dateString, String timeString) {
+  return timeFromNMEAFields(dateString.c_str(), dateString.length(),
+                            timeString.c_str(), timeString.length());
+}
+
+/*
+ * Reads the number written with (at most) `count` digits starting at `start`.
+ * Like String::toInt(), stops at the first character that is not a digit.
+ */
+static int readDigits(const char *s, size_t length, size_t start, size_t count) {
+  int value = 0;
+  for (size_t i = start; i < start + count && i < length; i++) {
+    if (s[i] < '0' || s[i] > '9') {
+      break;
+    }
+    value = value * 10 + (s[i] - '0');
+  }
+  return value;
+}
+
+SKTime SKTime::timeFromNMEAFields(const char *date, size_t dateLength,
+                                  const char *time, size_t timeLength) {
   tmElements_t tm;
 
-  tm.Day = dateString.substring(0, 2).toInt();
-  tm.Month = dateString.substring(2, 4).toInt();
+  tm.Day = readDigits(date, dateLength, 0, 2);
+  tm.Month = readDigits(date, dateLength, 2, 2);
   // Year 2070 bug incoming ...
-  int year = dateString.substring(4, 6).toInt();
+  int year = readDigits(date, dateLength, 4, 2);
   if (year < 70) {
     tm.Year = year + 30;
   }
   else {
     tm.Year = year - 70;
   }
-  tm.Hour = timeString.substring(0, 2).toInt();
-  tm.Minute = timeString.substring(2, 4).toInt();
-  tm.Second = timeString.substring(4, 6).toInt();
+  tm.Hour = readDigits(time, timeLength, 0, 2);
+  tm.Minute = readDigits(time, timeLength, 2, 2);
+  tm.Second = readDigits(time, timeLength, 4, 2);
 
   uint32_t timestamp = makeTime(tm);
   uint32_t milliseconds = unknownMilliseconds;
 
-  if (timeString.length() > 7) {
-    String ms = timeString.substring(7, 10);
-    int millis = ms.toInt();
+  if (timeLength > 7) {
+    size_t msLength = timeLength - 7 < 3 ? timeLength - 7 : 3;
+    int millis = readDigits(time, timeLength, 7, msLength);
 
-    if (ms.length() == 1) {
+    if (msLength == 1) {
       millis *= 100;
     }
-    if (ms.length() == 2) {
+    if (msLength == 2) {
       millis *= 10;
     }
 
@@ -65,6 +65,14 @@ class SKTime {
      */
     static SKTime timeFromNMEAStrings(String date, String time);
 
+    /**
+     * Same as timeFromNMEAStrings() but reads the characters of the fields
+     * directly, without allocating memory. The fields do not need to be
+     * NUL-terminated.
+     */
+    static SKTime timeFromNMEAFields(const char *date, size_t dateLength,
+                                     const char *time, size_t timeLength);
+
     /**
      * SKTime object from number of days and number of seconds (NMEA2000).
      * @param daysSince1970 number of days since 1970
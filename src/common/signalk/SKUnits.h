@@ -39,6 +39,14 @@ inline double SKPascalToBar(double x) {
   return x / 1e5;
 }
 
+inline double SKBarToPascal(double x) {
+  return x * 1e5;
+}
+
+inline double SKCelsiusToKelvin(double x) {
+  return x + 273.15;
+}
+
 /**
  * Normalizes any angle in radians to the range [0,2*M_PI)
  */
@@ -28,6 +28,7 @@
 #include "SKSource.h"
 #include "SKContext.h"
 #include "SKPath.h"
+#include "SKPathBitmask.h"
 #include "SKValue.h"
 #include "SKTime.h"
 
@@ -93,6 +94,14 @@ class SKUpdate {
      */
     virtual bool hasPath(const SKPath &path) const = 0;
 
+    /**
+     * Returns the set of static paths present in this update.
+     *
+     * Use this to quickly check if an update contains any path of interest
+     * before looking at individual values.
+     */
+    virtual const SKPathBitmask& getPathMask() const = 0;
+
     /**
      * Add a new SKValue to this update. This will fail if the list is full.
      *
@@ -31,18 +31,49 @@
 /**
  * Implements a statically allocated SKUpdate. The capacity of the update is
  * defined when instantiating the object.
+ *
+ * A bitmask of the static paths present in the update and the position of
+ * each non-indexed path make `hasPath()` and `operator[]` O(1) for
+ * non-indexed paths. Indexed paths are found with a linear scan, which is
+ * only done if the mask says that the static path is present.
  */
 template <uint16_t capacity> class SKUpdateStatic : public SKUpdate {
   private:
+    static_assert(capacity < 255, "SKUpdateStatic positions must fit in a uint8_t");
+
     SKSource _source = SKSourceUnknown;
     SKTime _timestamp;
     const SKContext& _context;
 
-    // Very simple hash-type data structure
     SKPath _paths[capacity];
     SKValue _values[capacity];
     uint16_t _size = 0;
 
+    // Static paths present in this update
+    SKPathBitmask _pathMask;
+    // Position of non-indexed paths in _paths/_values. Only valid if the
+    // corresponding bit is set in _pathMask.
+    uint8_t _positions[SKPathEnumIndexedPaths];
+
+    int findIndexedPath(const SKPath &p) const {
+      for (uint16_t i = 0; i < _size; i++) {
+        if (_paths[i] == p) {
+          return i;
+        }
+      }
+      return -1;
+    };
+
+    int find(const SKPath &p) const {
+      if (!_pathMask.test(p.getStaticPath())) {
+        return -1;
+      }
+      if (p.isIndexed()) {
+        return findIndexedPath(p);
+      }
+      return _positions[p.getStaticPath()];
+    };
+
   public:
     /**
      * Create a new SKUpdate object, with the context 'self' and  with an empty
@@ -58,25 +89,38 @@ template <uint16_t capacity> class SKUpdateStatic : public SKUpdate {
 
     ~SKUpdateStatic() {};
 
+    /**
+     * Remove all values and reset the source and timestamp of this update so
+     * that it can be reused.
+     */
+    void clear() {
+      _source = SKSourceUnknown;
+      _timestamp = SKTime();
+      _size = 0;
+      _pathMask.clear();
+    };
+
     virtual bool hasPath(const SKPath &p) const override {
-      for (uint16_t i = 0; i < _size; i++) {
-        if (_paths[i] == p) {
-          return true;
-        }
-      }
-      return false;
+      return find(p) >= 0;
     };
 
     virtual bool setValue(const SKPath p, const SKValue v) override {
+      // Paths with an index that could not be stored are invalid.
+      if (p.getStaticPath() == SKPathInvalidPath) {
+        return false;
+      }
       // Update?
-      for (uint16_t i = 0; i < _size && i < capacity; i++) {
-        if (_paths[i] == p) {
-          _values[i] = v;
-          return true;
-        }
+      int i = find(p);
+      if (i >= 0) {
+        _values[i] = v;
+        return true;
       }
       // Add?
       if (_size < capacity) {
+        if (!p.isIndexed()) {
+          _positions[p.getStaticPath()] = _size;
+        }
+        _pathMask.set(p.getStaticPath());
         _paths[_size] = p;
         _values[_size] = v;
         _size++;
@@ -85,6 +129,10 @@ template <uint16_t capacity> class SKUpdateStatic : public SKUpdate {
       return false;
     };
 
+    const SKPathBitmask& getPathMask() const override {
+      return _pathMask;
+    };
+
     /**
      * Returns the source of the values in this update.
      */
@@ -118,10 +166,9 @@ template <uint16_t capacity> class SKUpdateStatic : public SKUpdate {
     };
 
     const SKValue& operator[] (const SKPath& path) const override {
-      for (int i = 0; i < _size; i++) {
-        if (_paths[i] == path) {
-          return _values[i];
-        }
+      int i = find(path);
+      if (i >= 0) {
+        return _values[i];
       }
       return SKValueNone;
     }
@@ -151,6 +198,9 @@ template <uint16_t capacity> class SKUpdateStatic : public SKUpdate {
     }
 
     virtual void accept(SKVisitor& visitor, SKPathEnum staticPath) const override {
+      if (!_pathMask.test(staticPath)) {
+        return;
+      }
       for (int i = 0; i < getSize(); i++) {
         if (getPath(i).getStaticPath() == staticPath) {
           visitor.visit(*this, getPath(i), getValue(i));
@@ -1,7 +1,7 @@
 // This file was automatically generated by sk-code-generator.py
 // DO NOT MODIFY! YOUR CHANGES WOULD BE OVERWRITTEN
 // Look at src/common/signalk/SKUpdateSyntacticSugar.h.tmpl instead or modify the script
-// Generated on 2018-04-26 11:11:15.605553
+// Generated on 2026-10-18 08:21:08.958333
 
 bool hasEnvironmentDepthBelowKeel() const {
   return hasPath(SKPathEnvironmentDepthBelowKeel);
@@ -75,6 +75,78 @@ double getEnvironmentOutsidePressure() const {
 bool setEnvironmentOutsidePressure(double newValue) {
   return setValue(SKPathEnvironmentOutsidePressure, newValue);
 };
+bool hasEnvironmentOutsideTemperature() const {
+  return hasPath(SKPathEnvironmentOutsideTemperature);
+};
+double getEnvironmentOutsideTemperature() const {
+  return this->operator[](SKPathEnvironmentOutsideTemperature).getNumberValue();
+};
+bool setEnvironmentOutsideTemperature(double newValue) {
+  return setValue(SKPathEnvironmentOutsideTemperature, newValue);
+};
+bool hasEnvironmentOutsideDewPointTemperature() const {
+  return hasPath(SKPathEnvironmentOutsideDewPointTemperature);
+};
+double getEnvironmentOutsideDewPointTemperature() const {
+  return this->operator[](SKPathEnvironmentOutsideDewPointTemperature).getNumberValue();
+};
+bool setEnvironmentOutsideDewPointTemperature(double newValue) {
+  return setValue(SKPathEnvironmentOutsideDewPointTemperature, newValue);
+};
+bool hasEnvironmentInsideTemperature() const {
+  return hasPath(SKPathEnvironmentInsideTemperature);
+};
+double getEnvironmentInsideTemperature() const {
+  return this->operator[](SKPathEnvironmentInsideTemperature).getNumberValue();
+};
+bool setEnvironmentInsideTemperature(double newValue) {
+  return setValue(SKPathEnvironmentInsideTemperature, newValue);
+};
+bool hasEnvironmentInsideEngineRoomTemperature() const {
+  return hasPath(SKPathEnvironmentInsideEngineRoomTemperature);
+};
+double getEnvironmentInsideEngineRoomTemperature() const {
+  return this->operator[](SKPathEnvironmentInsideEngineRoomTemperature).getNumberValue();
+};
+bool setEnvironmentInsideEngineRoomTemperature(double newValue) {
+  return setValue(SKPathEnvironmentInsideEngineRoomTemperature, newValue);
+};
+bool hasEnvironmentInsideMainCabinTemperature() const {
+  return hasPath(SKPathEnvironmentInsideMainCabinTemperature);
+};
+double getEnvironmentInsideMainCabinTemperature() const {
+  return this->operator[](SKPathEnvironmentInsideMainCabinTemperature).getNumberValue();
+};
+bool setEnvironmentInsideMainCabinTemperature(double newValue) {
+  return setValue(SKPathEnvironmentInsideMainCabinTemperature, newValue);
+};
+bool hasEnvironmentInsideRefrigeratorTemperature() const {
+  return hasPath(SKPathEnvironmentInsideRefrigeratorTemperature);
+};
+double getEnvironmentInsideRefrigeratorTemperature() const {
+  return this->operator[](SKPathEnvironmentInsideRefrigeratorTemperature).getNumberValue();
+};
+bool setEnvironmentInsideRefrigeratorTemperature(double newValue) {
+  return setValue(SKPathEnvironmentInsideRefrigeratorTemperature, newValue);
+};
+bool hasEnvironmentCurrentSetTrue() const {
+  return hasPath(SKPathEnvironmentCurrentSetTrue);
+};
+double getEnvironmentCurrentSetTrue() const {
+  return this->operator[](SKPathEnvironmentCurrentSetTrue).getNumberValue();
+};
+bool setEnvironmentCurrentSetTrue(double newValue) {
+  return setValue(SKPathEnvironmentCurrentSetTrue, newValue);
+};
+bool hasEnvironmentCurrentDrift() const {
+  return hasPath(SKPathEnvironmentCurrentDrift);
+};
+double getEnvironmentCurrentDrift() const {
+  return this->operator[](SKPathEnvironmentCurrentDrift).getNumberValue();
+};
+bool setEnvironmentCurrentDrift(double newValue) {
+  return setValue(SKPathEnvironmentCurrentDrift, newValue);
+};
 bool hasEnvironmentWindAngleApparent() const {
   return hasPath(SKPathEnvironmentWindAngleApparent);
 };
@@ -147,15 +219,96 @@ double getEnvironmentWindSpeedApparent() const {
 bool setEnvironmentWindSpeedApparent(double newValue) {
   return setValue(SKPathEnvironmentWindSpeedApparent, newValue);
 };
-bool hasElectricalBatteriesVoltage(String index) const {
-  return hasPath(SKPath(SKPathElectricalBatteriesVoltage, index));
+bool hasElectricalBatteriesVoltage(const char *index) const {
+  return hasPath(SKPath::find(SKPathElectricalBatteriesVoltage, index));
 };
-double getElectricalBatteriesVoltage(String index) const {
-  return this->operator[](SKPath(SKPathElectricalBatteriesVoltage, index)).getNumberValue();
+double getElectricalBatteriesVoltage(const char *index) const {
+  return this->operator[](SKPath::find(SKPathElectricalBatteriesVoltage, index)).getNumberValue();
 };
-bool setElectricalBatteriesVoltage(String index, double newValue) {
+bool setElectricalBatteriesVoltage(const char *index, double newValue) {
   return setValue(SKPath(SKPathElectricalBatteriesVoltage, index), newValue);
 };
+bool hasElectricalBatteriesCurrent(const char *index) const {
+  return hasPath(SKPath::find(SKPathElectricalBatteriesCurrent, index));
+};
+double getElectricalBatteriesCurrent(const char *index) const {
+  return this->operator[](SKPath::find(SKPathElectricalBatteriesCurrent, index)).getNumberValue();
+};
+bool setElectricalBatteriesCurrent(const char *index, double newValue) {
+  return setValue(SKPath(SKPathElectricalBatteriesCurrent, index), newValue);
+};
+bool hasElectricalBatteriesTemperature(const char *index) const {
+  return hasPath(SKPath::find(SKPathElectricalBatteriesTemperature, index));
+};
+double getElectricalBatteriesTemperature(const char *index) const {
+  return this->operator[](SKPath::find(SKPathElectricalBatteriesTemperature, index)).getNumberValue();
+};
+bool setElectricalBatteriesTemperature(const char *index, double newValue) {
+  return setValue(SKPath(SKPathElectricalBatteriesTemperature, index), newValue);
+};
+bool hasPropulsionRevolutions(const char *index) const {
+  return hasPath(SKPath::find(SKPathPropulsionRevolutions, index));
+};
+double getPropulsionRevolutions(const char *index) const {
+  return this->operator[](SKPath::find(SKPathPropulsionRevolutions, index)).getNumberValue();
+};
+bool setPropulsionRevolutions(const char *index, double newValue) {
+  return setValue(SKPath(SKPathPropulsionRevolutions, index), newValue);
+};
+bool hasPropulsionBoostPressure(const char *index) const {
+  return hasPath(SKPath::find(SKPathPropulsionBoostPressure, index));
+};
+double getPropulsionBoostPressure(const char *index) const {
+  return this->operator[](SKPath::find(SKPathPropulsionBoostPressure, index)).getNumberValue();
+};
+bool setPropulsionBoostPressure(const char *index, double newValue) {
+  return setValue(SKPath(SKPathPropulsionBoostPressure, index), newValue);
+};
+bool hasPropulsionDriveTrimState(const char *index) const {
+  return hasPath(SKPath::find(SKPathPropulsionDriveTrimState, index));
+};
+double getPropulsionDriveTrimState(const char *index) const {
+  return this->operator[](SKPath::find(SKPathPropulsionDriveTrimState, index)).getNumberValue();
+};
+bool setPropulsionDriveTrimState(const char *index, double newValue) {
+  return setValue(SKPath(SKPathPropulsionDriveTrimState, index), newValue);
+};
+bool hasPropulsionTransmissionOilPressure(const char *index) const {
+  return hasPath(SKPath::find(SKPathPropulsionTransmissionOilPressure, index));
+};
+double getPropulsionTransmissionOilPressure(const char *index) const {
+  return this->operator[](SKPath::find(SKPathPropulsionTransmissionOilPressure, index)).getNumberValue();
+};
+bool setPropulsionTransmissionOilPressure(const char *index, double newValue) {
+  return setValue(SKPath(SKPathPropulsionTransmissionOilPressure, index), newValue);
+};
+bool hasPropulsionTransmissionOilTemperature(const char *index) const {
+  return hasPath(SKPath::find(SKPathPropulsionTransmissionOilTemperature, index));
+};
+double getPropulsionTransmissionOilTemperature(const char *index) const {
+  return this->operator[](SKPath::find(SKPathPropulsionTransmissionOilTemperature, index)).getNumberValue();
+};
+bool setPropulsionTransmissionOilTemperature(const char *index, double newValue) {
+  return setValue(SKPath(SKPathPropulsionTransmissionOilTemperature, index), newValue);
+};
+bool hasTanksCurrentLevel(const char *index) const {
+  return hasPath(SKPath::find(SKPathTanksCurrentLevel, index));
+};
+double getTanksCurrentLevel(const char *index) const {
+  return this->operator[](SKPath::find(SKPathTanksCurrentLevel, index)).getNumberValue();
+};
+bool setTanksCurrentLevel(const char *index, double newValue) {
+  return setValue(SKPath(SKPathTanksCurrentLevel, index), newValue);
+};
+bool hasTanksCapacity(const char *index) const {
+  return hasPath(SKPath::find(SKPathTanksCapacity, index));
+};
+double getTanksCapacity(const char *index) const {
+  return this->operator[](SKPath::find(SKPathTanksCapacity, index)).getNumberValue();
+};
+bool setTanksCapacity(const char *index, double newValue) {
+  return setValue(SKPath(SKPathTanksCapacity, index), newValue);
+};
 bool hasNavigationAttitude() const {
   return hasPath(SKPathNavigationAttitude);
 };
@@ -165,6 +318,33 @@ SKTypeAttitude getNavigationAttitude() const {
 bool setNavigationAttitude(SKTypeAttitude newValue) {
   return setValue(SKPathNavigationAttitude, newValue);
 };
+bool hasNavigationCourseOverGroundTrue() const {
+  return hasPath(SKPathNavigationCourseOverGroundTrue);
+};
+double getNavigationCourseOverGroundTrue() const {
+  return this->operator[](SKPathNavigationCourseOverGroundTrue).getNumberValue();
+};
+bool setNavigationCourseOverGroundTrue(double newValue) {
+  return setValue(SKPathNavigationCourseOverGroundTrue, newValue);
+};
+bool hasNavigationCourseOverGroundMagnetic() const {
+  return hasPath(SKPathNavigationCourseOverGroundMagnetic);
+};
+double getNavigationCourseOverGroundMagnetic() const {
+  return this->operator[](SKPathNavigationCourseOverGroundMagnetic).getNumberValue();
+};
+bool setNavigationCourseOverGroundMagnetic(double newValue) {
+  return setValue(SKPathNavigationCourseOverGroundMagnetic, newValue);
+};
+bool hasNavigationCourseRhumblineCrossTrackError() const {
+  return hasPath(SKPathNavigationCourseRhumblineCrossTrackError);
+};
+double getNavigationCourseRhumblineCrossTrackError() const {
+  return this->operator[](SKPathNavigationCourseRhumblineCrossTrackError).getNumberValue();
+};
+bool setNavigationCourseRhumblineCrossTrackError(double newValue) {
+  return setValue(SKPathNavigationCourseRhumblineCrossTrackError, newValue);
+};
 bool hasNavigationDatetime() const {
   return hasPath(SKPathNavigationDatetime);
 };
@@ -174,14 +354,41 @@ SKTime getNavigationDatetime() const {
 bool setNavigationDatetime(SKTime newValue) {
   return setValue(SKPathNavigationDatetime, newValue);
 };
-bool hasNavigationCourseOverGroundTrue() const {
-  return hasPath(SKPathNavigationCourseOverGroundTrue);
+bool hasNavigationGnssSatellites() const {
+  return hasPath(SKPathNavigationGnssSatellites);
 };
-double getNavigationCourseOverGroundTrue() const {
-  return this->operator[](SKPathNavigationCourseOverGroundTrue).getNumberValue();
+double getNavigationGnssSatellites() const {
+  return this->operator[](SKPathNavigationGnssSatellites).getNumberValue();
 };
-bool setNavigationCourseOverGroundTrue(double newValue) {
-  return setValue(SKPathNavigationCourseOverGroundTrue, newValue);
+bool setNavigationGnssSatellites(double newValue) {
+  return setValue(SKPathNavigationGnssSatellites, newValue);
+};
+bool hasNavigationGnssHorizontalDilution() const {
+  return hasPath(SKPathNavigationGnssHorizontalDilution);
+};
+double getNavigationGnssHorizontalDilution() const {
+  return this->operator[](SKPathNavigationGnssHorizontalDilution).getNumberValue();
+};
+bool setNavigationGnssHorizontalDilution(double newValue) {
+  return setValue(SKPathNavigationGnssHorizontalDilution, newValue);
+};
+bool hasNavigationGnssPositionDilution() const {
+  return hasPath(SKPathNavigationGnssPositionDilution);
+};
+double getNavigationGnssPositionDilution() const {
+  return this->operator[](SKPathNavigationGnssPositionDilution).getNumberValue();
+};
+bool setNavigationGnssPositionDilution(double newValue) {
+  return setValue(SKPathNavigationGnssPositionDilution, newValue);
+};
+bool hasNavigationGnssGeoidalSeparation() const {
+  return hasPath(SKPathNavigationGnssGeoidalSeparation);
+};
+double getNavigationGnssGeoidalSeparation() const {
+  return this->operator[](SKPathNavigationGnssGeoidalSeparation).getNumberValue();
+};
+bool setNavigationGnssGeoidalSeparation(double newValue) {
+  return setValue(SKPathNavigationGnssGeoidalSeparation, newValue);
 };
 bool hasNavigationHeadingMagnetic() const {
   return hasPath(SKPathNavigationHeadingMagnetic);
@@ -228,6 +435,15 @@ SKTypePosition getNavigationPosition() const {
 bool setNavigationPosition(SKTypePosition newValue) {
   return setValue(SKPathNavigationPosition, newValue);
 };
+bool hasNavigationRateOfTurn() const {
+  return hasPath(SKPathNavigationRateOfTurn);
+};
+double getNavigationRateOfTurn() const {
+  return this->operator[](SKPathNavigationRateOfTurn).getNumberValue();
+};
+bool setNavigationRateOfTurn(double newValue) {
+  return setValue(SKPathNavigationRateOfTurn, newValue);
+};
 bool hasNavigationSpeedOverGround() const {
   return hasPath(SKPathNavigationSpeedOverGround);
 };
@@ -246,6 +462,24 @@ double getNavigationSpeedThroughWater() const {
 bool setNavigationSpeedThroughWater(double newValue) {
   return setValue(SKPathNavigationSpeedThroughWater, newValue);
 };
+bool hasNavigationSpeedThroughWaterTransverse() const {
+  return hasPath(SKPathNavigationSpeedThroughWaterTransverse);
+};
+double getNavigationSpeedThroughWaterTransverse() const {
+  return this->operator[](SKPathNavigationSpeedThroughWaterTransverse).getNumberValue();
+};
+bool setNavigationSpeedThroughWaterTransverse(double newValue) {
+  return setValue(SKPathNavigationSpeedThroughWaterTransverse, newValue);
+};
+bool hasNavigationSpeedThroughWaterLongitudinal() const {
+  return hasPath(SKPathNavigationSpeedThroughWaterLongitudinal);
+};
+double getNavigationSpeedThroughWaterLongitudinal() const {
+  return this->operator[](SKPathNavigationSpeedThroughWaterLongitudinal).getNumberValue();
+};
+bool setNavigationSpeedThroughWaterLongitudinal(double newValue) {
+  return setValue(SKPathNavigationSpeedThroughWaterLongitudinal, newValue);
+};
 bool hasNavigationTripLog() const {
   return hasPath(SKPathNavigationTripLog);
 };
@@ -282,3 +516,30 @@ double getPerformanceLeeway() const {
 bool setPerformanceLeeway(double newValue) {
   return setValue(SKPathPerformanceLeeway, newValue);
 };
+bool hasDesignLengthOverall() const {
+  return hasPath(SKPathDesignLengthOverall);
+};
+double getDesignLengthOverall() const {
+  return this->operator[](SKPathDesignLengthOverall).getNumberValue();
+};
+bool setDesignLengthOverall(double newValue) {
+  return setValue(SKPathDesignLengthOverall, newValue);
+};
+bool hasDesignBeam() const {
+  return hasPath(SKPathDesignBeam);
+};
+double getDesignBeam() const {
+  return this->operator[](SKPathDesignBeam).getNumberValue();
+};
+bool setDesignBeam(double newValue) {
+  return setValue(SKPathDesignBeam, newValue);
+};
+bool hasDesignDraftCurrent() const {
+  return hasPath(SKPathDesignDraftCurrent);
+};
+double getDesignDraftCurrent() const {
+  return this->operator[](SKPathDesignDraftCurrent).getNumberValue();
+};
+bool setDesignDraftCurrent(double newValue) {
+  return setValue(SKPathDesignDraftCurrent, newValue);
+};
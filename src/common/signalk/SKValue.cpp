@@ -22,10 +22,39 @@
   THE SOFTWARE.
 */
 
+#include <math.h>
 #include "SKValue.h"
 
+#ifdef SKVALUE_COMPACT
+static_assert(sizeof(SKValue) <= 16, "Compact SKValue should fit in 16 bytes");
+#endif
+
 const SKValue SKValueNone = SKValue();
 
+// Used to store NaN in a fixed point angle.
+static const int32_t compactDegreesNaN = INT32_MIN;
+
+int32_t SKCompactPosition::encodeDegrees(double degrees) {
+  if (isnan(degrees)) {
+    return compactDegreesNaN;
+  }
+  double fixed = round(degrees * 1e7);
+  if (fixed >= INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (fixed <= -INT32_MAX) {
+    return -INT32_MAX;
+  }
+  return (int32_t)fixed;
+}
+
+double SKCompactPosition::decodeDegrees(int32_t fixed) {
+  if (fixed == compactDegreesNaN) {
+    return NAN;
+  }
+  return fixed / 1e7;
+}
+
 bool SKValue::operator==(const SKValue& other) const {
   if (_type == other._type) {
     switch (_type) {
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <stdint.h>
 #include <WString.h>
 #include "SKTime.h"
 
@@ -64,6 +65,57 @@ typedef struct SKTypeAttitude {
   double yaw;
 } SKTypeAttitude;
 
+/*
+ * Compact storage of a position: latitude and longitude are stored in
+ * 1e-7 degree fixed point (about 1cm) and the altitude as a float.
+ *
+ * Used by SKValue when SKVALUE_COMPACT is defined.
+ */
+struct SKCompactPosition {
+  SKCompactPosition(const SKTypePosition &p) :
+    latitude(encodeDegrees(p.latitude)), longitude(encodeDegrees(p.longitude)),
+    altitude(p.altitude) {};
+
+  operator SKTypePosition() const {
+    return SKTypePosition(decodeDegrees(latitude), decodeDegrees(longitude), altitude);
+  };
+
+  /**
+   * Converts degrees to 1e-7 degree fixed point. Values out of the
+   * [-214, 214] range are clamped and NaN is preserved.
+   */
+  static int32_t encodeDegrees(double degrees);
+  static double decodeDegrees(int32_t fixed);
+
+  int32_t latitude;
+  int32_t longitude;
+  float altitude;
+};
+
+/*
+ * Compact storage of an attitude with floats.
+ *
+ * Used by SKValue when SKVALUE_COMPACT is defined.
+ */
+struct SKCompactAttitude {
+  SKCompactAttitude(const SKTypeAttitude &a) :
+    roll(a.roll), pitch(a.pitch), yaw(a.yaw) {};
+
+  operator SKTypeAttitude() const {
+    return SKTypeAttitude(roll, pitch, yaw);
+  };
+
+  float roll;
+  float pitch;
+  float yaw;
+};
+
+#ifdef SKVALUE_COMPACT
+// A double which only needs to be aligned on 4 bytes so that it does not
+// make the SKValue union bigger than the compact position.
+typedef double SKValueDouble __attribute__((aligned(4)));
+#endif
+
 /**
  * In memory representation of a SignalK value.
  *
@@ -74,6 +126,10 @@ typedef struct SKTypeAttitude {
  * string-values and when using more rarely used attributes (like the meta
  * characteristics).
  *
+ * When SKVALUE_COMPACT is defined, positions and attitudes are stored with
+ * SKCompactPosition and SKCompactAttitude which halves the size of an SKValue
+ * (16 bytes instead of 32). Latitudes and longitudes are then rounded to
+ * 1e-7 degrees and attitudes and altitudes to the precision of a float.
  */
 class SKValue {
   public:
@@ -86,6 +142,24 @@ class SKValue {
     };
 
   private:
+#ifdef SKVALUE_COMPACT
+    // Storage of the actual value in an union. Positions and attitudes are
+    // stored with a reduced precision to keep SKValue at 16 bytes.
+    union value {
+      value(double n) : numberValue(n) {};
+      value(SKTypePosition p) : position(p) {};
+      value(SKTypeAttitude a) : attitude(a) {};
+      value(SKTime ts) : timestamp(ts) {};
+
+      SKValueDouble numberValue;
+      SKCompactPosition position;
+      SKCompactAttitude attitude;
+      SKTime timestamp;
+    } _value;
+
+    // Type of the data in this SKValue (an SKValueType)
+    uint8_t _type;
+#else
     // Type of the data in this SKValue
     enum SKValueType _type;
 
@@ -106,13 +180,22 @@ class SKValue {
       // datetimevalue
       // etc
     } _value;
+#endif
 
   public:
+#ifdef SKVALUE_COMPACT
+    SKValue() : _value(0), _type(SKValueTypeNone) {};
+    SKValue(double v) : _value(v), _type(SKValueTypeNumber) {};
+    SKValue(SKTypePosition p) : _value(p), _type(SKValueTypePosition) {};
+    SKValue(SKTypeAttitude a) : _value(a), _type(SKValueTypeAttitude) {};
+    SKValue(SKTime ts) : _value(ts), _type(SKValueTypeTimestamp) {};
+#else
     SKValue() : _type(SKValueTypeNone), _value(0) {};
     SKValue(double v) : _type(SKValueTypeNumber), _value(v) {};
     SKValue(SKTypePosition p) : _type(SKValueTypePosition), _value(p) {};
     SKValue(SKTypeAttitude a) : _type(SKValueTypeAttitude), _value(a) {};
     SKValue(SKTime ts) : _type(SKValueTypeTimestamp), _value(ts) {};
+#endif
 
     /**
      * Returns true if the two SKValues compared have the same value.
@@ -127,7 +210,7 @@ class SKValue {
     SKTime getTimestampValue() const;
 
     enum SKValueType getType() const {
-      return _type;
+      return (enum SKValueType)_type;
     };
 };
 
@@ -1,7 +1,7 @@
 // This file was automatically generated by sk-code-generator.py
 // DO NOT MODIFY! YOUR CHANGES WOULD BE OVERWRITTEN
 // Look at src/common/signalk/SKVisitor.cpp.tmpl instead or modify the script
-// Generated on 2018-04-26 11:11:15.606293
+// Generated on 2026-10-18 07:53:14.205558
 
 /*
      __  __     ______     ______     __  __
@@ -61,6 +61,30 @@ void SKVisitor::visit(const SKUpdate& u, const SKPath &p, const SKValue &v) {
   if (p.getStaticPath() == SKPathEnvironmentOutsidePressure) {
     visitSKEnvironmentOutsidePressure(u, p, v);
   }
+  if (p.getStaticPath() == SKPathEnvironmentOutsideTemperature) {
+    visitSKEnvironmentOutsideTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentOutsideDewPointTemperature) {
+    visitSKEnvironmentOutsideDewPointTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentInsideTemperature) {
+    visitSKEnvironmentInsideTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentInsideEngineRoomTemperature) {
+    visitSKEnvironmentInsideEngineRoomTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentInsideMainCabinTemperature) {
+    visitSKEnvironmentInsideMainCabinTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentInsideRefrigeratorTemperature) {
+    visitSKEnvironmentInsideRefrigeratorTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentCurrentSetTrue) {
+    visitSKEnvironmentCurrentSetTrue(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathEnvironmentCurrentDrift) {
+    visitSKEnvironmentCurrentDrift(u, p, v);
+  }
   if (p.getStaticPath() == SKPathEnvironmentWindAngleApparent) {
     visitSKEnvironmentWindAngleApparent(u, p, v);
   }
@@ -88,14 +112,59 @@ void SKVisitor::visit(const SKUpdate& u, const SKPath &p, const SKValue &v) {
   if (p.getStaticPath() == SKPathElectricalBatteriesVoltage) {
     visitSKElectricalBatteriesVoltage(u, p, v);
   }
+  if (p.getStaticPath() == SKPathElectricalBatteriesCurrent) {
+    visitSKElectricalBatteriesCurrent(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathElectricalBatteriesTemperature) {
+    visitSKElectricalBatteriesTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathPropulsionRevolutions) {
+    visitSKPropulsionRevolutions(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathPropulsionBoostPressure) {
+    visitSKPropulsionBoostPressure(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathPropulsionDriveTrimState) {
+    visitSKPropulsionDriveTrimState(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathPropulsionTransmissionOilPressure) {
+    visitSKPropulsionTransmissionOilPressure(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathPropulsionTransmissionOilTemperature) {
+    visitSKPropulsionTransmissionOilTemperature(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathTanksCurrentLevel) {
+    visitSKTanksCurrentLevel(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathTanksCapacity) {
+    visitSKTanksCapacity(u, p, v);
+  }
   if (p.getStaticPath() == SKPathNavigationAttitude) {
     visitSKNavigationAttitude(u, p, v);
   }
+  if (p.getStaticPath() == SKPathNavigationCourseOverGroundTrue) {
+    visitSKNavigationCourseOverGroundTrue(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathNavigationCourseOverGroundMagnetic) {
+    visitSKNavigationCourseOverGroundMagnetic(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathNavigationCourseRhumblineCrossTrackError) {
+    visitSKNavigationCourseRhumblineCrossTrackError(u, p, v);
+  }
   if (p.getStaticPath() == SKPathNavigationDatetime) {
     visitSKNavigationDatetime(u, p, v);
   }
-  if (p.getStaticPath() == SKPathNavigationCourseOverGroundTrue) {
-    visitSKNavigationCourseOverGroundTrue(u, p, v);
+  if (p.getStaticPath() == SKPathNavigationGnssSatellites) {
+    visitSKNavigationGnssSatellites(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathNavigationGnssHorizontalDilution) {
+    visitSKNavigationGnssHorizontalDilution(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathNavigationGnssPositionDilution) {
+    visitSKNavigationGnssPositionDilution(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathNavigationGnssGeoidalSeparation) {
+    visitSKNavigationGnssGeoidalSeparation(u, p, v);
   }
   if (p.getStaticPath() == SKPathNavigationHeadingMagnetic) {
     visitSKNavigationHeadingMagnetic(u, p, v);
@@ -112,12 +181,21 @@ void SKVisitor::visit(const SKUpdate& u, const SKPath &p, const SKValue &v) {
   if (p.getStaticPath() == SKPathNavigationPosition) {
     visitSKNavigationPosition(u, p, v);
   }
+  if (p.getStaticPath() == SKPathNavigationRateOfTurn) {
+    visitSKNavigationRateOfTurn(u, p, v);
+  }
   if (p.getStaticPath() == SKPathNavigationSpeedOverGround) {
     visitSKNavigationSpeedOverGround(u, p, v);
   }
   if (p.getStaticPath() == SKPathNavigationSpeedThroughWater) {
     visitSKNavigationSpeedThroughWater(u, p, v);
   }
+  if (p.getStaticPath() == SKPathNavigationSpeedThroughWaterTransverse) {
+    visitSKNavigationSpeedThroughWaterTransverse(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathNavigationSpeedThroughWaterLongitudinal) {
+    visitSKNavigationSpeedThroughWaterLongitudinal(u, p, v);
+  }
   if (p.getStaticPath() == SKPathNavigationTripLog) {
     visitSKNavigationTripLog(u, p, v);
   }
@@ -130,5 +208,14 @@ void SKVisitor::visit(const SKUpdate& u, const SKPath &p, const SKValue &v) {
   if (p.getStaticPath() == SKPathPerformanceLeeway) {
     visitSKPerformanceLeeway(u, p, v);
   }
+  if (p.getStaticPath() == SKPathDesignLengthOverall) {
+    visitSKDesignLengthOverall(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathDesignBeam) {
+    visitSKDesignBeam(u, p, v);
+  }
+  if (p.getStaticPath() == SKPathDesignDraftCurrent) {
+    visitSKDesignDraftCurrent(u, p, v);
+  }
 }
 
@@ -41,7 +41,9 @@ class SKModel(object):
         vesselKeysJson = json['vesselKeys']
         for keyJson in vesselKeysJson:
             unit = None
-            if 'unit' in keyJson:
+            if 'units' in keyJson:
+                unit = keyJson['units']
+            elif 'unit' in keyJson:
                 unit = keyJson['unit']
             key = SKKey(keyJson['path'], keyJson['type'], unit, keyJson['description'])
             model.keys.append(key)
@@ -100,6 +102,17 @@ class SKKey(object):
             return 'SKTime'
         raise ValueError("Invalid SignalK type {}".format(self.skType))
 
+    def valueType(self):
+        if self.skType == 'numberValue':
+            return 'SKValueTypeNumber'
+        if self.skType == 'attitudeValue':
+            return 'SKValueTypeAttitude'
+        if self.skType == 'positionValue':
+            return 'SKValueTypePosition'
+        if self.skType == 'timestampValue':
+            return 'SKValueTypeTimestamp'
+        raise ValueError("Invalid SignalK type {}".format(self.skType))
+
     def cTypeAccessor(self):
         if self.skType == 'numberValue':
             return 'getNumberValue'
@@ -162,16 +175,28 @@ class SKPathEnumGenerator(TemplateGenerator):
         return data
 
 
-class SKPathToStringGenerator(TemplateGenerator):
+class SKPathInfoGenerator(TemplateGenerator):
+    def beginTemplate(self, data):
+        self.nonIndexedKeys = ""
+        self.indexedKeys = ""
+        return data
+
     def generateForKey(self, k):
-        self.indentLevel = 4;
-        self.p("case " + k.enumKey() + ":")
-        if not k.isIndexed():
-            self.p("  path = \"" + k.getPath() + "\";")
-        else:
+        if k.isIndexed():
             (prefix, suffix) = k.getPath().split('%%')
-            self.p("  path = \"" + prefix + "\" + _index + \"" + suffix + "\";")
-        self.p("  break;")
+        else:
+            (prefix, suffix) = (k.getPath(), "")
+
+        entry = "  SKPathInfoEntry({}, \"{}\", \"{}\", \"{}\", {}),\n".format(k.enumKey(), prefix, suffix, k.getUnit() or "", k.valueType())
+        if k.isIndexed():
+            self.indexedKeys += entry
+        else:
+            self.nonIndexedKeys += entry
+
+    def finalizeTemplate(self, data):
+        data = data.replace("  // Insert Non-Indexed Keys Here\n", self.nonIndexedKeys)
+        data = data.replace("  // Insert Indexed Keys Here\n", self.indexedKeys)
+        return data
 
 
 class SKUpdateSyntacticSugarGenerator(TemplateGenerator):
@@ -189,15 +214,15 @@ class SKUpdateSyntacticSugarGenerator(TemplateGenerator):
             self.p("  return setValue({}, newValue);".format(k.enumKey()))
             self.p("};")
         else:
-            self.p("bool has{}(String index) const {{".format(k.camelCasedPath()))
-            self.p("  return hasPath(SKPath(" + k.enumKey() + ", index));")
+            self.p("bool has{}(const char *index) const {{".format(k.camelCasedPath()))
+            self.p("  return hasPath(SKPath::find(" + k.enumKey() + ", index));")
             self.p("};")
 
-            self.p("{} get{}(String index) const {{".format(k.cType(), k.camelCasedPath()))
-            self.p("  return this->operator[](SKPath({}, index)).{}();".format(k.enumKey(), k.cTypeAccessor()))
+            self.p("{} get{}(const char *index) const {{".format(k.cType(), k.camelCasedPath()))
+            self.p("  return this->operator[](SKPath::find({}, index)).{}();".format(k.enumKey(), k.cTypeAccessor()))
             self.p("};")
 
-            self.p("bool set{}(String index, {} newValue) {{".format(k.camelCasedPath(), k.cType()))
+            self.p("bool set{}(const char *index, {} newValue) {{".format(k.camelCasedPath(), k.cType()))
             self.p("  return setValue(SKPath({}, index), newValue);".format(k.enumKey()))
             self.p("};")
 
@@ -233,7 +258,7 @@ def main():
     outputPath = workPath
 
     SKPathEnumGenerator(os.path.join(templatePath, 'SKPathEnum.h.tmpl')).generate(model, open(os.path.join(outputPath, 'SKPathEnum.generated.h'), 'w'))
-    SKPathToStringGenerator(os.path.join(templatePath, 'SKPathToString.cpp.tmpl')).generate(model, open(os.path.join(outputPath, 'SKPathToString.generated.cpp'), 'w'))
+    SKPathInfoGenerator(os.path.join(templatePath, 'SKPathInfo.cpp.tmpl')).generate(model, open(os.path.join(outputPath, 'SKPathInfo.generated.cpp'), 'w'))
     SKUpdateSyntacticSugarGenerator(os.path.join(templatePath, 'SKUpdateSyntacticSugar.h.tmpl')).generate(model, open(os.path.join(outputPath, 'SKUpdateSyntacticSugar.generated.h'), 'w'))
     SKVisitorHeaderGenerator(os.path.join(templatePath, 'SKVisitor.h.tmpl')).generate(model, open(os.path.join(outputPath, 'SKVisitor.generated.h'), 'w'))
     SKVisitorImplGenerator(os.path.join(templatePath, 'SKVisitor.cpp.tmpl')).generate(model, open(os.path.join(outputPath, 'SKVisitor.generated.cpp'), 'w'))
@@ -31,11 +31,15 @@ enum KBoxEvent {
   // Happens when the serial buffer is overflowed
   KBoxEventNMEA1RXBufferOverflow,
   // Happens when sentences are received too fast and exceed the max queue length
-  // FIXME: Not implemented yet.
   KBoxEventNMEA1RXOverflow,
   KBoxEventNMEA1RXError,
   KBoxEventNMEA1TX,
   KBoxEventNMEA1TXOverflow,
+  // Happen when a sentence waiting to be sent is dropped because the transmit
+  // queue is full or because it waited too long (also counted as TXOverflow)
+  KBoxEventNMEA1TXDropHighPriority,
+  KBoxEventNMEA1TXDropNormalPriority,
+  KBoxEventNMEA1TXDropLowPriority,
 
   KBoxEventNMEA2RX,
   KBoxEventNMEA2RXBufferOverflow,
@@ -43,10 +47,34 @@ enum KBoxEvent {
   KBoxEventNMEA2RXError,
   KBoxEventNMEA2TX,
   KBoxEventNMEA2TXOverflow,
+  // Happen when a sentence waiting to be sent is dropped because the transmit
+  // queue is full or because it waited too long (also counted as TXOverflow)
+  KBoxEventNMEA2TXDropHighPriority,
+  KBoxEventNMEA2TXDropNormalPriority,
+  KBoxEventNMEA2TXDropLowPriority,
+
+  // Happens when a sentence received on a serial port is dropped because it
+  // was already received (or sent) recently
+  KBoxEventNMEADuplicateFilterHit,
+  // Happens when a sentence received on a serial port was not seen recently
+  KBoxEventNMEADuplicateFilterMiss,
 
   KBoxEventNMEA2000MessageReceived,
   KBoxEventNMEA2000MessageSent,
   KBoxEventNMEA2000MessageSendError,
+  // Happens when a message is received with a PGN that KBox does not parse
+  KBoxEventNMEA2000UnknownPGN,
+  // Happens when a received message is not used because another source of
+  // the same data is preferred
+  KBoxEventNMEA2000SourceDropped,
+  // Happens when the source selected for some data changes
+  KBoxEventNMEA2000SourceFailover,
+  // Happens when a message waiting to be sent on the bus is replaced by a
+  // newer message of the same PGN and instance
+  KBoxEventNMEA2000MessageCoalesced,
+  // Happens when a message is not sent on the bus because the transmit queue
+  // is full or because sending it failed too many times
+  KBoxEventNMEA2000MessageDropped,
 
   KBoxEventUSBValidKommand,
   KBoxEventUSBInvalidKommand,
@@ -56,6 +84,19 @@ enum KBoxEvent {
   KBoxEventWiFiTxFrame,
   KBoxEventWiFiRxErrorFrame,
 
+  // Happens when the SKHub publish queue is full and an update is dropped
+  KBoxEventSKHubQueueOverflow,
+  // Happens when the SKDataStore is full and a new value cannot be stored
+  KBoxEventSKDataStoreFull,
+  // Happens when the SKChangeFilter does not republish a value because it
+  // did not change enough
+  KBoxEventSKChangeFilterSuppressed,
+
+  // Happens when an incomplete multi-sentence AIS message is discarded
+  KBoxEventAISFragmentDropped,
+  // Happens when the AIS target table is full and the least recently seen
+  // target is forgotten
+  KBoxEventAISTargetEvicted,
 
   // Events used by the ESP module
   KBoxEventESPValidKommand,
@@ -74,6 +115,18 @@ enum KBoxMetric {
   // Average time in us it takes to run through all the system tasks.
   KBoxMetricTaskManagerLoopUS,
 
+  // Number of sentences of each priority waiting to be sent on the NMEA
+  // serial ports.
+  KBoxMetricNMEA1TXQueueHighPrioritySentences,
+  KBoxMetricNMEA1TXQueueNormalPrioritySentences,
+  KBoxMetricNMEA1TXQueueLowPrioritySentences,
+  KBoxMetricNMEA2TXQueueHighPrioritySentences,
+  KBoxMetricNMEA2TXQueueNormalPrioritySentences,
+  KBoxMetricNMEA2TXQueueLowPrioritySentences,
+
+  // Number of messages waiting to be sent on the NMEA2000 bus.
+  KBoxMetricNMEA2000TXQueueMessages,
+
   // Used to get a count of the number of metrics
   KBoxMetricCountDistinctMetrics
 };
@@ -36,6 +36,9 @@
 #include "BarometerConfig.h"
 #include "WiFiConfig.h"
 #include "SDLoggingConfig.h"
+#include "USBConfig.h"
+#include <signalk/SKChangeFilterConfig.h>
+#include <nmea/NMEADuplicateFilterConfig.h>
 
 /**
  * A KBox configuration in memory
@@ -48,4 +51,7 @@ struct KBoxConfig {
   BarometerConfig barometerConfig;
   WiFiConfig wifiConfig;
   SDLoggingConfig sdLoggingConfig;
+  USBConfig usbConfig;
+  SKChangeFilterConfig outputFilterConfig;
+  NMEADuplicateFilterConfig nmeaDuplicateFilterConfig;
 };
@@ -28,6 +28,9 @@
   THE SOFTWARE.
 */
 
+#include <string.h>
+#include <common/util/bsd-string.h>
+#include <signalk/SKPath.h>
 #include "KBoxConfigParser.h"
 
 #define READ_VALUE_WITH_TYPE(name, type) if (json[#name].is<type>()) { \
@@ -44,6 +47,8 @@
                                                   json[#name] .as<int>(); \
                                               }
 
+#define READ_DOUBLE_VALUE(name) READ_VALUE_WITH_TYPE(name, double)
+
 #define READ_STRING_VALUE(name) if (json[#name].is<const char *>()) {\
                                   config.name = \
                                     String(json[#name].as<const char*>()); \
@@ -67,8 +72,21 @@ void KBoxConfigParser::defaultConfig(KBoxConfig &config) {
   config.serial2Config.nmeaConverter.xdrBattery = false;
   config.serial2Config.nmeaConverter.xdrPressure = false;
 
+  // Do not send the attitude faster than the serial ports can handle.
+  config.serial1Config.rateLimit.rules[0] = { SKPathNavigationAttitude, 200, SKRateLimitMean };
+  config.serial1Config.rateLimit.rulesCount = 1;
+  config.serial2Config.rateLimit.rules[0] = { SKPathNavigationAttitude, 1000, SKRateLimitMean };
+  config.serial2Config.rateLimit.rules[1] = { SKPathNavigationHeadingMagnetic, 500, SKRateLimitLatest };
+  config.serial2Config.rateLimit.rulesCount = 2;
+
   config.nmea2000Config.txEnabled = true;
   config.nmea2000Config.rxEnabled = true;
+  config.nmea2000Config.rateLimit.rulesCount = 0;
+  config.nmea2000Config.sourceArbitration.enabled = true;
+  config.nmea2000Config.sourceArbitration.failoverTimeout = 3000;
+  config.nmea2000Config.sourceArbitration.preferredSourcesCount = 0;
+
+  config.usbConfig.rateLimit.rulesCount = 0;
 
   config.imuConfig.enabled = true;
   config.imuConfig.frequency = 20;
@@ -81,6 +99,7 @@ void KBoxConfigParser::defaultConfig(KBoxConfig &config) {
   config.barometerConfig.frequency = 1;
 
   config.wifiConfig.enabled = true;
+  config.wifiConfig.rateLimit.rulesCount = 0;
 
   config.wifiConfig.vesselURN = _defaultVesselURN;
 
@@ -100,6 +119,20 @@ void KBoxConfigParser::defaultConfig(KBoxConfig &config) {
   config.sdLoggingConfig.logSignalKGeneratedFromNMEA = false;
   config.sdLoggingConfig.logSignalKGeneratedFromNMEA2000 = false;
   config.sdLoggingConfig.logSignalKGeneratedByKBoxSensors = true;
+
+  // Only drop exact repetitions by default, except for the battery voltages
+  // and the attitude which are measured by KBox and always move a little.
+  config.outputFilterConfig.enabled = true;
+  config.outputFilterConfig.epsilon = 0;
+  config.outputFilterConfig.maxAge = 1000;
+  config.outputFilterConfig.rules[0] = { SKPathElectricalBatteriesVoltage, 0.05, 10000 };
+  config.outputFilterConfig.rules[1] = { SKPathNavigationAttitude, 0.002, 1000 };
+  config.outputFilterConfig.rulesCount = 2;
+
+  // Drop the sentences received on both serial ports (or sent by KBox and
+  // looped back) within half a second.
+  config.nmeaDuplicateFilterConfig.scope = NMEADuplicateFilterScopeOtherInputs;
+  config.nmeaDuplicateFilterConfig.window = 500;
 }
 
 void KBoxConfigParser::parseKBoxConfig(const JsonObject &json, KBoxConfig &config) {
@@ -112,6 +145,9 @@ void KBoxConfigParser::parseKBoxConfig(const JsonObject &json, KBoxConfig &confi
   parseWiFiConfig(json["wifi"], config.wifiConfig);
   parseNMEA2000Config(json["nmea2000"], config.nmea2000Config);
   parseSDLoggingConfig(json["logging"], config.sdLoggingConfig);
+  parseUSBConfig(json["usb"], config.usbConfig);
+  parseOutputFilterConfig(json["outputFilter"], config.outputFilterConfig);
+  parseNMEADuplicateFilterConfig(json["nmeaDuplicateFilter"], config.nmeaDuplicateFilterConfig);
 }
 
 void KBoxConfigParser::parseIMUConfig(const JsonObject &json, IMUConfig &config) {
@@ -137,12 +173,24 @@ void KBoxConfigParser::parseSerialConfig(const JsonObject &json, SerialConfig &c
   READ_ENUM_VALUE(outputMode, convertSerialMode);
 
   parseNMEAConverterConfig(json["nmeaConverter"], config.nmeaConverter);
+  parseRateLimiterConfig(json["rateLimit"], config.rateLimit);
 }
 
 void KBoxConfigParser::parseNMEA2000Config(const JsonObject &json,
                                            NMEA2000Config &config) {
   READ_BOOL_VALUE(rxEnabled);
   READ_BOOL_VALUE(txEnabled);
+  parseRateLimiterConfig(json["rateLimit"], config.rateLimit);
+  parseNMEA2000SourceArbiterConfig(json["sourceArbitration"], config.sourceArbitration);
+}
+
+void KBoxConfigParser::parseUSBConfig(const JsonObject &json, USBConfig &config) {
+  if (json == JsonObject::invalid()) {
+    return;
+  }
+
+  parseRateLimiterConfig(json["rateLimit"], config.rateLimit);
+  parseRoutingConfig(json["routing"], config.routing);
 }
 
 void KBoxConfigParser::parseWiFiConfig(const JsonObject &json, WiFiConfig &config) {
@@ -158,6 +206,8 @@ void KBoxConfigParser::parseWiFiConfig(const JsonObject &json, WiFiConfig &confi
   parseWiFiNetworkConfig(json["client"], config.client);
   parseWiFiNetworkConfig(json["accessPoint"], config.accessPoint);
   parseNMEAConverterConfig(json["nmeaConverter"], config.nmeaConverter);
+  parseRateLimiterConfig(json["rateLimit"], config.rateLimit);
+  parseRoutingConfig(json["routing"], config.routing);
 }
 
 void KBoxConfigParser::parseSDLoggingConfig(const JsonObject &json, SDLoggingConfig &config) {
@@ -174,6 +224,7 @@ void KBoxConfigParser::parseSDLoggingConfig(const JsonObject &json, SDLoggingCon
   READ_BOOL_VALUE(logSignalKGeneratedFromNMEA);
   READ_BOOL_VALUE(logSignalKGeneratedFromNMEA2000);
   READ_BOOL_VALUE(logSignalKGeneratedByKBoxSensors);
+  parseRoutingConfig(json["routing"], config.routing);
 }
 
 void KBoxConfigParser::parseNMEAConverterConfig(const JsonObject &json, SKNMEAConverterConfig &config) {
@@ -189,6 +240,187 @@ void KBoxConfigParser::parseNMEAConverterConfig(const JsonObject &json, SKNMEACo
   READ_BOOL_VALUE(mwv);
 }
 
+void KBoxConfigParser::parseRateLimiterConfig(const JsonArray &json,
+                                              SKRateLimiterConfig &config) {
+  if (json == JsonArray::invalid()) {
+    return;
+  }
+
+  // Rules given in the configuration replace the default ones.
+  config.rulesCount = 0;
+  for (size_t i = 0; i < json.size() && config.rulesCount < SKRateLimiterConfig::maxRules; i++) {
+    if (parseRateLimitRule(json[i], config.rules[config.rulesCount])) {
+      config.rulesCount++;
+    }
+  }
+}
+
+bool KBoxConfigParser::parseRateLimitRule(const JsonObject &json,
+                                          SKRateLimitRule &config) {
+  if (json == JsonObject::invalid() || !json["path"].is<const char*>()
+      || !json["maxRate"].is<double>() || json["maxRate"].as<double>() <= 0) {
+    return false;
+  }
+
+  config.path = SKPath::staticPathFromString(json["path"].as<const char*>());
+  if (config.path == SKPathInvalidPath) {
+    return false;
+  }
+
+  // maxRate is in Hz
+  config.minInterval = 1000 / json["maxRate"].as<double>();
+  config.mode = SKRateLimitLatest;
+  READ_ENUM_VALUE(mode, convertRateLimitMode);
+  return true;
+}
+
+void KBoxConfigParser::parseRoutingConfig(const JsonArray &json,
+                                          NMEARoutingConfig &config) {
+  if (json == JsonArray::invalid()) {
+    return;
+  }
+
+  config.rulesCount = 0;
+  for (size_t i = 0; i < json.size() && config.rulesCount < NMEARoutingConfig::maxRules; i++) {
+    if (parseRoutingRule(json[i], config.rules[config.rulesCount])) {
+      config.rulesCount++;
+    }
+  }
+}
+
+bool KBoxConfigParser::parseRoutingRule(const JsonObject &json,
+                                        NMEARoutingRule &config) {
+  if (json == JsonObject::invalid() || !json["action"].is<const char*>()) {
+    return false;
+  }
+
+  String action = json["action"].as<const char*>();
+  if (action == "allow") {
+    config.action = NMEARoutingAllow;
+  }
+  else if (action == "deny") {
+    config.action = NMEARoutingDeny;
+  }
+  else {
+    return false;
+  }
+
+  // A rule is either about NMEA0183 sentences or about NMEA2000 messages.
+  bool nmea0183 = json["talker"].is<const char*>() || json["sentence"].is<const char*>();
+  bool nmea2000 = json["pgn"].is<int>() || json["source"].is<int>();
+  if (nmea0183 == nmea2000) {
+    return false;
+  }
+
+  config.nmea2000 = nmea2000;
+  config.talker[0] = 0;
+  config.sentence[0] = 0;
+  config.pgn = -1;
+  config.source = -1;
+
+  if (json["talker"].is<const char*>()) {
+    const char *talker = json["talker"].as<const char*>();
+    if (strlen(talker) != 2) {
+      return false;
+    }
+    strlcpy(config.talker, talker, sizeof(config.talker));
+  }
+  if (json["sentence"].is<const char*>()) {
+    const char *sentence = json["sentence"].as<const char*>();
+    if (strlen(sentence) != 3) {
+      return false;
+    }
+    strlcpy(config.sentence, sentence, sizeof(config.sentence));
+  }
+  if (json["pgn"].is<int>()) {
+    if (json["pgn"].as<int>() < 0 || json["pgn"].as<int>() > 0x1FFFF) {
+      return false;
+    }
+    config.pgn = json["pgn"].as<int>();
+  }
+  if (json["source"].is<int>()) {
+    if (json["source"].as<int>() < 0 || json["source"].as<int>() > 255) {
+      return false;
+    }
+    config.source = json["source"].as<int>();
+  }
+  return true;
+}
+
+void KBoxConfigParser::parseOutputFilterConfig(const JsonObject &json,
+                                               SKChangeFilterConfig &config) {
+  if (json == JsonObject::invalid()) {
+    return;
+  }
+
+  READ_BOOL_VALUE(enabled);
+  READ_DOUBLE_VALUE(epsilon);
+  READ_INT_VALUE_WRANGE(maxAge, 0, 3600000);
+
+  // Rules given in the configuration replace the default ones.
+  if (json["rules"].is<JsonArray>()) {
+    const JsonArray &rules = json["rules"];
+    config.rulesCount = 0;
+    for (size_t i = 0; i < rules.size() && config.rulesCount < SKChangeFilterConfig::maxRules; i++) {
+      SKChangeFilterRule &rule = config.rules[config.rulesCount];
+      rule.epsilon = config.epsilon;
+      rule.maxAge = config.maxAge;
+      if (parseOutputFilterRule(rules[i], rule)) {
+        config.rulesCount++;
+      }
+    }
+  }
+}
+
+bool KBoxConfigParser::parseOutputFilterRule(const JsonObject &json,
+                                             SKChangeFilterRule &config) {
+  if (json == JsonObject::invalid() || !json["path"].is<const char*>()) {
+    return false;
+  }
+
+  config.path = SKPath::staticPathFromString(json["path"].as<const char*>());
+  if (config.path == SKPathInvalidPath) {
+    return false;
+  }
+
+  READ_DOUBLE_VALUE(epsilon);
+  READ_INT_VALUE_WRANGE(maxAge, 0, 3600000);
+  return true;
+}
+
+void KBoxConfigParser::parseNMEADuplicateFilterConfig(const JsonObject &json,
+                                                      NMEADuplicateFilterConfig &config) {
+  if (json == JsonObject::invalid()) {
+    return;
+  }
+
+  READ_ENUM_VALUE(scope, convertDuplicateFilterScope);
+  READ_INT_VALUE_WRANGE(window, 0, 60000);
+}
+
+void KBoxConfigParser::parseNMEA2000SourceArbiterConfig(const JsonObject &json,
+                                                        NMEA2000SourceArbiterConfig &config) {
+  if (json == JsonObject::invalid()) {
+    return;
+  }
+
+  READ_BOOL_VALUE(enabled);
+  READ_INT_VALUE_WRANGE(failoverTimeout, 100, 60000);
+
+  JsonArray &sources = json["preferredSources"].as<JsonArray>();
+  if (sources == JsonArray::invalid()) {
+    return;
+  }
+  config.preferredSourcesCount = 0;
+  for (size_t i = 0; i < sources.size()
+         && config.preferredSourcesCount < NMEA2000SourceArbiterConfig::maxPreferredSources; i++) {
+    // 254 and 255 are the null and global addresses.
+    if (sources[i].is<int>() && sources[i] >= 0 && sources[i] <= 253) {
+      config.preferredSources[config.preferredSourcesCount++] = sources[i].as<int>();
+    }
+  }
+}
+
 void KBoxConfigParser::parseWiFiNetworkConfig(const JsonObject &json,
                                               WiFiNetworkConfig &config) {
   READ_BOOL_VALUE(enabled);
@@ -222,3 +454,20 @@ enum IMUMounting KBoxConfigParser::convertIMUMounting(const String &s) {
   // default
   return VerticalPortHull;
 }
+
+enum SKRateLimitMode KBoxConfigParser::convertRateLimitMode(const String &s) {
+  if (s == "mean") {
+    return SKRateLimitMean;
+  }
+  return SKRateLimitLatest;
+}
+
+enum NMEADuplicateFilterScope KBoxConfigParser::convertDuplicateFilterScope(const String &s) {
+  if (s == "otherInputs") {
+    return NMEADuplicateFilterScopeOtherInputs;
+  }
+  if (s == "allInputs") {
+    return NMEADuplicateFilterScopeAllInputs;
+  }
+  return NMEADuplicateFilterScopeDisabled;
+}
@@ -43,6 +43,8 @@ class KBoxConfigParser {
     String _defaultVesselURN;
     SerialMode convertSerialMode(const String &s);
     IMUMounting convertIMUMounting(const String &s);
+    SKRateLimitMode convertRateLimitMode(const String &s);
+    NMEADuplicateFilterScope convertDuplicateFilterScope(const String &s);
 
   public:
     KBoxConfigParser(const String &defaultVesselURN) : _defaultVesselURN(defaultVesselURN) {};
@@ -70,4 +72,18 @@ class KBoxConfigParser {
                                 WiFiNetworkConfig &config);
     void parseNMEAConverterConfig(const JsonObject &json,
                                   SKNMEAConverterConfig &config);
+    void parseUSBConfig(const JsonObject &json, USBConfig &config);
+    void parseRateLimiterConfig(const JsonArray &json,
+                                SKRateLimiterConfig &config);
+    bool parseRateLimitRule(const JsonObject &json, SKRateLimitRule &config);
+    void parseOutputFilterConfig(const JsonObject &json,
+                                 SKChangeFilterConfig &config);
+    bool parseOutputFilterRule(const JsonObject &json,
+                               SKChangeFilterRule &config);
+    void parseRoutingConfig(const JsonArray &json, NMEARoutingConfig &config);
+    bool parseRoutingRule(const JsonObject &json, NMEARoutingRule &config);
+    void parseNMEADuplicateFilterConfig(const JsonObject &json,
+                                        NMEADuplicateFilterConfig &config);
+    void parseNMEA2000SourceArbiterConfig(const JsonObject &json,
+                                          NMEA2000SourceArbiterConfig &config);
 };
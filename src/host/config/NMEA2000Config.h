@@ -30,7 +30,12 @@
 
 #pragma once
 
+#include "common/nmea/NMEA2000SourceArbiterConfig.h"
+#include "common/signalk/SKRateLimiterConfig.h"
+
 struct  NMEA2000Config {
   bool rxEnabled;
   bool txEnabled;
+  SKRateLimiterConfig rateLimit;
+  NMEA2000SourceArbiterConfig sourceArbitration;
 };
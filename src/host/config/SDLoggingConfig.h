@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include "common/nmea/NMEARoutingConfig.h"
+
 struct SDLoggingConfig {
   bool enabled;
   bool logWithoutTime;
@@ -40,4 +42,5 @@ struct SDLoggingConfig {
   bool logSignalKGeneratedFromNMEA2000;
   bool logSignalKGeneratedByKBoxSensors;
   bool logSystemMessages;
+  NMEARoutingConfig routing;
 };
\ No newline at end of file
@@ -31,6 +31,8 @@
 #pragma once
 
 #include "common/signalk/SKNMEAConverterConfig.h"
+#include "common/signalk/SKRateLimiterConfig.h"
+#include "common/nmea/NMEARoutingConfig.h"
 
 struct WiFiNetworkConfig {
   bool enabled;
@@ -41,6 +43,8 @@ struct WiFiNetworkConfig {
 struct WiFiConfig {
   bool enabled;
   SKNMEAConverterConfig nmeaConverter;
+  SKRateLimiterConfig rateLimit;
+  NMEARoutingConfig routing;
 
   String vesselURN;
   WiFiNetworkConfig client;
@@ -24,6 +24,11 @@
 
 #include <KBoxHardware.h>
 #include <KBoxLoggerMultiplexer.h>
+#include "common/nmea/NMEADuplicateFilter.h"
+#include "common/nmea/NMEARoutingFilter.h"
+#include "common/signalk/SKAISParser.h"
+#include "common/signalk/SKChangeFilter.h"
+#include "common/signalk/SKDataStore.h"
 #include "common/signalk/SKHub.h"
 #include "common/time/WallClock.h"
 #include "host/config/KBoxConfig.h"
@@ -39,6 +44,7 @@
 #include "host/pages/IMUMonitorPage.h"
 #include "host/services/NMEA2000Service.h"
 #include "host/services/SerialService.h"
+#include "host/services/SKHubService.h"
 #include "host/services/RunningLightService.h"
 #include "host/services/SDLoggingService.h"
 #include "host/services/TimeService.h"
@@ -51,9 +57,12 @@ ILI9341GC gc(KBox.getDisplay(), Size(320, 240));
 MFD mfd(gc, KBox.getEncoder(), KBox.getButton());
 TaskManager taskManager;
 SKHub skHub;
+// Output services subscribe to this hub which only gets the values that
+// changed since they were last sent.
+SKHub outputHub;
 KBoxConfig config;
 
-USBService usbService(gc, skHub);
+USBService usbService(config.usbConfig, gc, outputHub);
 SDLoggingService sdLoggingService(config.sdLoggingConfig, skHub);
 KBoxLoggerMultiplexer loggerMultiplexer(usbService, sdLoggingService);
 
@@ -108,28 +117,64 @@ void setup() {
   }
 
 
+  // Publishing on the hub only queues the updates. They are delivered to
+  // subscribers by the SKHubService so that producers are not slowed down by
+  // subscribers.
+  skHub.enableQueue(16);
+
+  // Keep the latest value of every path of our boat so that pages can read
+  // the current state of the boat.
+  SKDataStore *dataStore = new SKDataStore(64);
+  skHub.subscribe(dataStore);
+
+  SKChangeFilter *outputFilter = new SKChangeFilter(config.outputFilterConfig, outputHub, 64);
+  outputFilter->setMillisecondsProvider(millis);
+  skHub.subscribe(outputFilter);
+
   // Instantiate all our services
-  WiFiService *wifi = new WiFiService(config.wifiConfig, skHub, gc);
+  WiFiService *wifi = new WiFiService(config.wifiConfig, outputHub, gc);
 
   ADCService *adcService = new ADCService(skHub, KBox.getADC());
   BarometerService *baroService = new BarometerService(skHub);
   IMUService *imuService = new IMUService(config.imuConfig, skHub);
 
-  NMEA2000Service *n2kService = new NMEA2000Service(config.nmea2000Config,
-                                                    skHub);
-  n2kService->addSentenceRepeater(*wifi);
-  n2kService->addSentenceRepeater(usbService);
+  // The routing rules of each output are compiled once and shared by all the
+  // services repeating messages to it.
+  NMEARoutingFilter *wifiRouting = new NMEARoutingFilter(config.wifiConfig.routing);
+  NMEARoutingFilter *usbRouting = new NMEARoutingFilter(config.usbConfig.routing);
+  NMEARoutingFilter *sdLoggingRouting = new NMEARoutingFilter(config.sdLoggingConfig.routing);
 
-  SerialService *reader1 = new SerialService(config.serial1Config, skHub, NMEA1_SERIAL);
-  SerialService *reader2 = new SerialService(config.serial2Config, skHub, NMEA2_SERIAL);
-  reader1->addRepeater(*wifi);
-  reader2->addRepeater(*wifi);
-  reader1->addRepeater(usbService);
-  reader2->addRepeater(usbService);
+  NMEA2000Service *n2kService = new NMEA2000Service(config.nmea2000Config,
+                                                    skHub, outputHub);
+  n2kService->addSentenceRepeater(*wifi, *wifiRouting);
+  n2kService->addSentenceRepeater(usbService, *usbRouting);
+
+  SerialService *reader1 = new SerialService(config.serial1Config, skHub, outputHub, NMEA1_SERIAL);
+  SerialService *reader2 = new SerialService(config.serial2Config, skHub, outputHub, NMEA2_SERIAL);
+  reader1->addRepeater(*wifi, *wifiRouting);
+  reader2->addRepeater(*wifi, *wifiRouting);
+  reader1->addRepeater(usbService, *usbRouting);
+  reader2->addRepeater(usbService, *usbRouting);
+
+  reader1->addRepeater(sdLoggingService, *sdLoggingRouting);
+  reader2->addRepeater(sdLoggingService, *sdLoggingRouting);
+  n2kService->addSentenceRepeater(sdLoggingService, *sdLoggingRouting);
+
+  // Sentences received on both ports (or sent and received back) are only
+  // repeated and parsed once.
+  if (config.nmeaDuplicateFilterConfig.scope != NMEADuplicateFilterScopeDisabled) {
+    NMEADuplicateFilter *duplicateFilter = new NMEADuplicateFilter(config.nmeaDuplicateFilterConfig, 32);
+    duplicateFilter->setMillisecondsProvider(millis);
+    reader1->setDuplicateFilter(*duplicateFilter);
+    reader2->setDuplicateFilter(*duplicateFilter);
+  }
 
-  reader1->addRepeater(sdLoggingService);
-  reader2->addRepeater(sdLoggingService);
-  n2kService->addSentenceRepeater(sdLoggingService);
+  // AIS sentences from both ports share one table of targets. Each target
+  // uses 22 bytes (20 for its entry and 2 for its bucket), so 256 targets
+  // cost about 5.5 KB of RAM.
+  SKAISParser *aisParser = new SKAISParser(256);
+  reader1->setAISParser(*aisParser);
+  reader2->setAISParser(*aisParser);
 
   // Tell the wallClock how to get the number of ms elapsed since boot.
   wallClock.setMillisecondsProvider(millis);
@@ -151,6 +196,7 @@ void setup() {
   taskManager.addTask(n2kService);
   taskManager.addTask(reader1);
   taskManager.addTask(reader2);
+  taskManager.addTask(new SKHubService(skHub));
   taskManager.addTask(wifi);
   taskManager.addTask(&sdLoggingService);
   taskManager.addTask(&usbService);
@@ -166,7 +212,7 @@ void setup() {
     mfd.addPage(imuPage);
   }
 
-  BatteryMonitorPage *batPage = new BatteryMonitorPage(skHub);
+  BatteryMonitorPage *batPage = new BatteryMonitorPage(*dataStore);
   mfd.addPage(batPage);
 
   taskManager.setup();
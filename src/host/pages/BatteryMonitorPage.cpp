@@ -24,10 +24,9 @@
 
 #include <stdio.h>
 #include <common/time/WallClock.h>
-#include "common/signalk/SKUpdate.h"
 #include "BatteryMonitorPage.h"
 
-BatteryMonitorPage::BatteryMonitorPage(SKHub& hub) {
+BatteryMonitorPage::BatteryMonitorPage(const SKDataStore& dataStore) : _dataStore(dataStore) {
   static const int col1 = 5;
   static const int col2 = 200;
   static const int row1 = 26;
@@ -52,8 +51,6 @@ BatteryMonitorPage::BatteryMonitorPage(SKHub& hub) {
   addLayer(houseCurrent);
   addLayer(engineVoltage);
   addLayer(supplyVoltage);
-
-  hub.subscribe(this);
 }
 
 Color BatteryMonitorPage::colorForVoltage(float v) {
@@ -77,25 +74,19 @@ String BatteryMonitorPage::formatMeasurement(float measure, const char *unit) {
   return String(s);
 }
 
-void BatteryMonitorPage::updateReceived(const SKUpdate& up) {
-  if (up.hasElectricalBatteriesVoltage("house")) {
-    const SKValue& vm = up.getElectricalBatteriesVoltage("house");
-    houseVoltage->setText(formatMeasurement(vm.getNumberValue(), "V"));
-    houseVoltage->setColor(colorForVoltage(vm.getNumberValue()));
-  }
-  if (up.hasElectricalBatteriesVoltage("engine")) {
-    const SKValue& vm = up.getElectricalBatteriesVoltage("engine");
-    engineVoltage->setText(formatMeasurement(vm.getNumberValue(), "V"));
-    engineVoltage->setColor(colorForVoltage(vm.getNumberValue()));
-  }
-  if (up.hasElectricalBatteriesVoltage("kbox-supply")) {
-    const SKValue& vm = up.getElectricalBatteriesVoltage("kbox-supply");
-    supplyVoltage->setText(formatMeasurement(vm.getNumberValue(), "V"));
-    supplyVoltage->setColor(colorForVoltage(vm.getNumberValue()));
+void BatteryMonitorPage::updateVoltage(TextLayer *layer, const char *battery) {
+  const SKValue& vm = _dataStore.getLatestValue(SKContextSelf, SKPath::find(SKPathElectricalBatteriesVoltage, battery));
+  if (vm != SKValueNone) {
+    layer->setText(formatMeasurement(vm.getNumberValue(), "V"));
+    layer->setColor(colorForVoltage(vm.getNumberValue()));
   }
 }
 
 bool BatteryMonitorPage::processEvent(const TickEvent &e) {
+  updateVoltage(houseVoltage, "house");
+  updateVoltage(engineVoltage, "engine");
+  updateVoltage(supplyVoltage, "kbox-supply");
+
   // Update the time if a time is available
   SKTime now = wallClock.now();
   String timeDisplay = now.iso8601date();
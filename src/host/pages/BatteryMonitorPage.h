@@ -24,21 +24,20 @@
 
 #include "common/ui/Page.h"
 #include "common/ui/TextLayer.h"
-#include "common/signalk/SKHub.h"
-#include "common/signalk/SKSubscriber.h"
+#include "common/signalk/SKDataStore.h"
 
-class BatteryMonitorPage : public Page, public SKSubscriber {
+class BatteryMonitorPage : public Page {
   private:
+    const SKDataStore &_dataStore;
     TextLayer *clockLayer;
     TextLayer *houseVoltage, *houseCurrent, *engineVoltage, *supplyVoltage;
 
     Color colorForVoltage(float v);
     String formatMeasurement(float measure, const char *unit);
+    void updateVoltage(TextLayer *layer, const char *battery);
 
   public:
-    BatteryMonitorPage(SKHub& hub);
-
-    virtual void updateReceived(const SKUpdate& up);
+    BatteryMonitorPage(const SKDataStore& dataStore);
 
     bool processEvent(const TickEvent &e) override;
 };
@@ -162,7 +162,9 @@ bool StatsPage::processEvent(const TickEvent &e) {
                                                   KBoxMetrics.countEvent(KBoxEventNMEA2TXOverflow)));
 
 
-  canRx->setText(String(KBoxMetrics.countEvent(KBoxEventNMEA2000MessageReceived)));
+  // Messages with a PGN that we do not parse are shown in parentheses.
+  canRx->setText(formatCounterWithEventualError(KBoxMetrics.countEvent(KBoxEventNMEA2000MessageReceived),
+                                                KBoxMetrics.countEvent(KBoxEventNMEA2000UnknownPGN)));
   canTx->setText(formatCounterWithEventualError(KBoxMetrics.countEvent(KBoxEventNMEA2000MessageSent),
                                                 KBoxMetrics.countEvent(KBoxEventNMEA2000MessageSendError)));
 
@@ -44,14 +44,32 @@ void NMEA2000Service::publishN2kMessage(const tN2kMsg& msg) {
   if (_config.rxEnabled) {
     KBoxMetrics.event(KBoxEventNMEA2000MessageReceived);
 
-    DEBUG("Received N2K Message with pgn: %i", msg.PGN);
-
+    // The message is encoded when the first repeater accepts it and the
+    // same sentence (and timestamp) is given to all the repeaters.
+    bool encoded = false;
     for (auto it = _sentenceRepeaters.begin(); it != _sentenceRepeaters.end(); it++) {
-      (*it)->write(msg);
+      if (it->filter && !it->filter->accepts(msg.PGN, msg.Source)) {
+        continue;
+      }
+      if (!encoded) {
+        if (!_pcdinEncoder.encode(msg, millis())) {
+          break;
+        }
+        encoded = true;
+      }
+      it->output->writePCDIN(_pcdinEncoder.getSentence());
+    }
+
+    // Messages from a source that is not the preferred one for this data
+    // are still repeated but they are not parsed.
+    if (SKNMEA2000Parser::isPGNSupported(msg.PGN)) {
+      uint8_t key = NMEA2000SourceArbiter::channelKey(msg.PGN, msg.Data, msg.DataLen);
+      if (!_arbiter.accept(msg.PGN, key, msg.Source)) {
+        return;
+      }
     }
 
-    SKNMEA2000Parser p;
-    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, wallClock.now());
+    const SKUpdate &update = _parser.parse(SKSourceInputNMEA2000, msg, wallClock.now());
     if (update.getSize() > 0) {
       _hub.publish(update);
     }
@@ -72,7 +90,9 @@ void NMEA2000Service::setup() {
       initializeNMEA2000forReceiveOnly();
     }
   }
-  _hub.subscribe(this);
+  if (_config.txEnabled) {
+    _outputHub.subscribe(&_rateLimiter, _converter.getInputPaths());
+  }
 }
 
 bool NMEA2000Service::write(const tN2kMsg& msg) {
@@ -101,17 +121,40 @@ void NMEA2000Service::loop() {
   // call ParseMessages() at least every 10ms.
   NMEA2000.ParseMessages();
 
+  _rateLimiter.flush();
+  if (_config.txEnabled) {
+    _converter.flush(_txScheduler);
+  }
+  _txScheduler.flush();
+  KBoxMetrics.metric(KBoxMetricNMEA2000TXQueueMessages, _txScheduler.getQueueDepth());
+
   if (timeSinceLastParametersSave > 1000) {
     saveNMEA2000Parameters();
     timeSinceLastParametersSave = 0;
   }
+
+  if (timeSinceLastUnknownPGNsLog > 60000) {
+    logUnknownPGNs();
+    timeSinceLastUnknownPGNsLog = 0;
+  }
+}
+
+void NMEA2000Service::logUnknownPGNs() {
+  for (uint8_t i = 0; i < _parser.getUnknownPGNsCount(); i++) {
+    uint32_t pgn = _parser.getUnknownPGN(i);
+    DEBUG("Received %lu N2K messages with unsupported pgn %lu", (unsigned long)_parser.getUnknownPGNCount(pgn),
+          (unsigned long)pgn);
+  }
+  if (_parser.getUnknownPGNOverflow() > 0) {
+    DEBUG("Received %lu N2K messages with other unsupported pgns",
+          (unsigned long)_parser.getUnknownPGNOverflow());
+  }
 }
 
 void NMEA2000Service::updateReceived(const SKUpdate& update) {
   if (_config.txEnabled) {
     if (update.getSource().getInput() != SKSourceInputNMEA2000) {
-      SKNMEA2000Converter converter;
-      converter.convert(update, *this);
+      _converter.convert(update, _txScheduler);
     }
   }
 }
@@ -189,6 +232,12 @@ void NMEA2000Service::saveNMEA2000Parameters() {
   }
 }
 
-void NMEA2000Service::addSentenceRepeater(SKNMEA2000Output &repeater) {
-  _sentenceRepeaters.add(&repeater);
+void NMEA2000Service::addSentenceRepeater(PCDINOutput &repeater) {
+  Repeater r = { &repeater, 0 };
+  _sentenceRepeaters.add(r);
+}
+
+void NMEA2000Service::addSentenceRepeater(PCDINOutput &repeater, const NMEARoutingFilter &filter) {
+  Repeater r = { &repeater, &filter };
+  _sentenceRepeaters.add(r);
 }
\ No newline at end of file
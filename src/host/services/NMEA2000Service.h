@@ -30,16 +30,37 @@
 #include "common/signalk/SKHub.h"
 #include "common/signalk/SKSubscriber.h"
 #include "common/signalk/SKNMEA2000Converter.h"
+#include "common/signalk/SKNMEA2000Parser.h"
+#include "common/signalk/SKRateLimiter.h"
+#include "common/nmea/NMEA2000SourceArbiter.h"
+#include "common/nmea/NMEA2000TransmitScheduler.h"
+#include "common/nmea/NMEARoutingFilter.h"
+#include "common/nmea/PCDINEncoder.h"
+#include "common/nmea/PCDINOutput.h"
 #include "host/config/NMEA2000Config.h"
 
 class NMEA2000Service : public Task, public SKSubscriber,
   SKNMEA2000Output {
   private:
+    struct Repeater {
+      PCDINOutput *output;
+      const NMEARoutingFilter *filter;
+    };
+
     const NMEA2000Config &_config;
     SKHub &_hub;
+    SKHub &_outputHub;
     tNMEA2000_teensy NMEA2000;
     unsigned int _imuSequence;
-    LinkedList<SKNMEA2000Output*> _sentenceRepeaters;
+    LinkedList<Repeater> _sentenceRepeaters;
+    NMEA2000SourceArbiter _arbiter;
+    SKNMEA2000Parser _parser;
+    SKNMEA2000Converter _converter;
+    SKRateLimiter _rateLimiter;
+    // One slot per channel sent by the converter (10 PGNs, some with a few
+    // instances). Each slot uses 64 bytes: 768 bytes of RAM for 12 slots.
+    NMEA2000TransmitScheduler _txScheduler;
+    PCDINEncoder _pcdinEncoder;
 
     void sendN2kMessage(const tN2kMsg& msg);
 
@@ -63,9 +84,28 @@ class NMEA2000Service : public Task, public SKSubscriber,
 
     elapsedMillis timeSinceLastParametersSave;
 
+    /**
+     * Logs how many messages were received with each PGN that the parser
+     * does not support. Called once a minute.
+     */
+    void logUnknownPGNs();
+
+    elapsedMillis timeSinceLastUnknownPGNsLog;
+
   public:
-    NMEA2000Service(NMEA2000Config &config, SKHub &hub) :
-      Task("NMEA2000"), _config(config), _hub(hub), _imuSequence(0) {};
+    /**
+     * Received messages are published on `hub` and the messages sent on the
+     * bus are generated from the updates of `outputHub`.
+     */
+    NMEA2000Service(NMEA2000Config &config, SKHub &hub, SKHub &outputHub) :
+      Task("NMEA2000"), _config(config), _hub(hub), _outputHub(outputHub), _imuSequence(0),
+      _arbiter(config.sourceArbitration, 32), _rateLimiter(config.rateLimit, *this, 16),
+      _txScheduler(*this, 12) {
+      _arbiter.setMillisecondsProvider(millis);
+      _rateLimiter.setMillisecondsProvider(millis);
+      _txScheduler.setMillisecondsProvider(millis);
+      _converter.setMillisecondsProvider(millis);
+    };
 
     void setup();
     void loop();
@@ -73,15 +113,29 @@ class NMEA2000Service : public Task, public SKSubscriber,
     // Helper for the handler who is not a part of this class
     void publishN2kMessage(const tN2kMsg& msg);
 
-    // SKNMEA2000Output
+    // SKNMEA2000Output: sends the message on the bus immediately. Messages
+    // generated by KBox go through the transmit scheduler first.
     bool write(const tN2kMsg&) override;
 
     void updateReceived(const SKUpdate& update);
 
     /**
-     * All incoming NMEA2000 messages will be repeated to repeaters.
+     * All incoming NMEA2000 messages will be repeated to repeaters as PCDIN
+     * sentences. Each message is only encoded once for all the repeaters.
      *
-     * @param repeater A reference to an object that implements SKNMEA2000Output.
+     * @param repeater A reference to an object that implements PCDINOutput.
+     */
+    void addSentenceRepeater(PCDINOutput &repeater);
+
+    /**
+     * Only the messages accepted by `filter` are repeated to `repeater`.
+     */
+    void addSentenceRepeater(PCDINOutput &repeater, const NMEARoutingFilter &filter);
+
+    /**
+     * Selects the source used for each kind of data received on the bus.
      */
-    void addSentenceRepeater(SKNMEA2000Output &repeater);
+    const NMEA2000SourceArbiter& getSourceArbiter() const {
+      return _arbiter;
+    };
 };
@@ -27,7 +27,6 @@
 
 #include <KBoxLogging.h>
 #include <KBoxHardware.h>
-#include <Seasmart.h>
 #include <ArduinoJson.h>
 #include "common/time/WallClock.h"
 #include "common/time/WallClock.h"
@@ -190,26 +189,17 @@ bool SDLoggingService::write(const SKNMEASentence &nmeaSentence) {
     return true;
   }
 
-  receivedMessages.add(Loggable("N", nmeaSentence, wallClock.now()));
+  receivedMessages.add(Loggable("N", nmeaSentence.c_str(), wallClock.now()));
   return true;
 }
 
-bool SDLoggingService::write(const tN2kMsg &msg) {
+bool SDLoggingService::writePCDIN(const SKNMEASentence &pcdin) {
   if (!isLogging() || !_config.logNMEA2000) {
     return true;
   }
 
-  if (msg.DataLen > 500) {
-    return false;
-  }
-
-  char pcdin[30 + msg.DataLen * 2];
-  if (N2kToSeasmart(msg, wallClock.now().getTime(), pcdin, sizeof(pcdin)) < sizeof(pcdin)) {
-    receivedMessages.add(Loggable("P", pcdin, wallClock.now()));
-    return true;
-  } else {
-    return false;
-  }
+  receivedMessages.add(Loggable("P", pcdin.c_str(), wallClock.now()));
+  return true;
 }
 
 void SDLoggingService::updateReceived(const SKUpdate &update) {
@@ -27,7 +27,7 @@
 #include <SdFat.h>
 #include <KBoxLogging.h>
 #include "common/signalk/SKNMEAOutput.h"
-#include "common/signalk/SKNMEA2000Output.h"
+#include "common/nmea/PCDINOutput.h"
 #include "common/signalk/SKSubscriber.h"
 #include "common/signalk/SKHub.h"
 #include "common/signalk/SKTime.h"
@@ -43,7 +43,7 @@ class Loggable {
     SKTime _timestamp;
 };
 
-class SDLoggingService : public Task, public SKNMEAOutput, public SKNMEA2000Output, public SKSubscriber,
+class SDLoggingService : public Task, public SKNMEAOutput, public PCDINOutput, public SKSubscriber,
   public KBoxLogger {
   private:
     uint64_t _freeSpaceAtBoot;
@@ -77,7 +77,7 @@ class SDLoggingService : public Task, public SKNMEAOutput, public SKNMEA2000Outp
     String getLogFileName();
 
     bool write(const SKNMEASentence &nmeaSentence) override;
-    bool write(const tN2kMsg &m) override;
+    bool writePCDIN(const SKNMEASentence &pcdin) override;
     void updateReceived(const SKUpdate &update) override;
 
     void startLogging();
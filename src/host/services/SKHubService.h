@@ -0,0 +1,45 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "common/signalk/SKHub.h"
+#include "host/os/Task.h"
+
+/**
+ * Delivers the updates queued in a SKHub to its subscribers.
+ *
+ * The hub queue is processed until it is empty or until the time budget for
+ * this loop has been used. Remaining updates are delivered on the next loop.
+ */
+class SKHubService : public Task {
+  private:
+    SKHub &_hub;
+    uint32_t _budgetMicros;
+
+  public:
+    SKHubService(SKHub &hub, uint32_t budgetMicros = 2000) : Task("SKHub"), _hub(hub), _budgetMicros(budgetMicros) {};
+
+    void loop();
+};
@@ -28,122 +28,75 @@
 #include <Arduino.h>
 #include <KBoxHardware.h>
 #include "common/signalk/SKNMEAConverter.h"
+#include "common/nmea/NMEASentenceReader.h"
 #include "common/signalk/SKNMEAParser.h"
 
 
-// Linked list used to buffer messages
-static LinkedList<SKNMEASentence> *received2 = 0;
-static LinkedList<SKNMEASentence> *received3 = 0;
+// Size of the receive buffers of the serial ports (defined in
+// platformio.ini or by the teensy3 framework).
+#ifndef SERIAL2_RX_BUFFER_SIZE
+#define SERIAL2_RX_BUFFER_SIZE 64
+#endif
+#ifndef SERIAL3_RX_BUFFER_SIZE
+#define SERIAL3_RX_BUFFER_SIZE 64
+#endif
 
-// This is called by yield() whenever data is available.
-// We move received data into a linked list of NMEA sentences.
-void serialEvent2() {
-  static uint8_t buffer[MAX_NMEA_SENTENCE_LENGTH];
-  static int index = 0;
+// Number of sentences that can wait for SerialService::loop().
+static const uint16_t receiveQueueLength = 16;
 
-  if (received2 == 0) {
-    return;
-  }
+// Number of sentences that can wait to be sent.
+static const uint8_t transmitQueueLength = 8;
 
-  // 64 is the RX_BUFFER_SIZE defined in serial2.c (teensy3 framework)
-  if (Serial2.available() == 64) {
-    KBoxMetrics.event(KBoxEventNMEA1RXBufferOverflow);
-    DEBUG("serialEvent2 found a full rx buffer - we probably lost some data");
-  }
-
-  while (Serial2.available()) {
-    buffer[index++]= (uint8_t) Serial2.read();
+static NMEASerialFramer *framer2 = 0;
+static NMEASerialFramer *framer3 = 0;
 
-    // Check if we are at the end of the buffer
-    // The -1 is because we need space to add a terminating NULL character.
-    if (index >= MAX_NMEA_SENTENCE_LENGTH - 1) {
-      buffer[MAX_NMEA_SENTENCE_LENGTH - 1] = 0;
-      DEBUG("Discarding incomplete sequence: %s", buffer);
-      index = 0;
-      KBoxMetrics.event(KBoxEventNMEA1RXError);
-    }
-    else {
-      // Check if we have reached end of sentence
-      if (buffer[index-1] == '\r' || buffer[index-1] == '\n') {
-        if (index > 1) {
-          // Only send message if it's greater than 0 bytes.
-          // And we know that index is < MAX_NMEA_SENTENCE_LENGTH
-          // because we tested buffer.
-          buffer[index-1] = 0;
-          SKNMEASentence s((char*)buffer);
-          received2->add(s);
-        }
-        // Start again from scratch
-        index = 0;
-      }
-    }
+// This is called by yield() whenever data is available.
+// Complete sentences are queued in the framer and read by SerialService::loop().
+void serialEvent2() {
+  if (framer2) {
+    framer2->poll();
   }
 }
 
 void serialEvent3() {
-  static uint8_t buffer[MAX_NMEA_SENTENCE_LENGTH];
-  static int index = 0;
-
-  if (received3 == 0) {
-    return;
-  }
-
-  // 64 is the RX_BUFFER_SIZE defined in serial3.c (teensy3 framework)
-  if (Serial3.available() == 64) {
-    KBoxMetrics.event(KBoxEventNMEA2RXBufferOverflow);
-    DEBUG("serialEvent3 found a full rx buffer - we probably lost some data");
-  }
-
-  while (Serial3.available()) {
-    buffer[index++]= (uint8_t) Serial3.read();
-
-    // Check if we are at the end of the buffer
-    // The -1 is because we need space to add a terminating NULL character.
-    if (index >= MAX_NMEA_SENTENCE_LENGTH - 1) {
-      buffer[MAX_NMEA_SENTENCE_LENGTH - 1] = 0;
-      DEBUG("Discarding incomplete sequence: %s", buffer);
-      index = 0;
-      KBoxMetrics.event(KBoxEventNMEA2RXError);
-    }
-    else {
-      // Check if we have reached end of sentence
-      if (buffer[index-1] == '\r' || buffer[index-1] == '\n') {
-        if (index > 1) {
-          // Only send message if it's greater than 0 bytes.
-          // And we know that index is < MAX_NMEA_SENTENCE_LENGTH
-          // because we tested buffer.
-          buffer[index-1] = 0;
-          SKNMEASentence s((char*)buffer);
-          received3->add(s);
-        }
-        // Start again from scratch
-        index = 0;
-      }
-    }
+  if (framer3) {
+    framer3->poll();
   }
 }
 
-SerialService::SerialService(SerialConfig &config, SKHub &hub, HardwareSerial &s) : Task("NMEA Service"), _config(config), _hub(hub), stream(s) {
+SerialService::SerialService(SerialConfig &config, SKHub &hub, SKHub &outputHub, HardwareSerial &s) :
+  Task("NMEA Service"), _config(config), _hub(hub), _outputHub(outputHub), stream(s), _framer(0),
+  _scheduler(0), _duplicateFilter(0), _rateLimiter(0) {
   if (&s == &Serial2) {
-    if (_config.inputMode == SerialModeNMEA) {
-      received2 = &receiveQueue;
-    }
     _taskName = "Serial Service 1";
     _rxValidEvent = KBoxEventNMEA1RX;
     _rxErrorEvent = KBoxEventNMEA1RXError;
+    _rxBufferOverflowEvent = KBoxEventNMEA1RXBufferOverflow;
+    _rxOverflowEvent = KBoxEventNMEA1RXOverflow;
     _txValidEvent = KBoxEventNMEA1TX;
     _txOverflowEvent = KBoxEventNMEA1TXOverflow;
+    _txDropEvents[NMEATransmitPriorityHigh] = KBoxEventNMEA1TXDropHighPriority;
+    _txDropEvents[NMEATransmitPriorityNormal] = KBoxEventNMEA1TXDropNormalPriority;
+    _txDropEvents[NMEATransmitPriorityLow] = KBoxEventNMEA1TXDropLowPriority;
+    _txQueueMetrics[NMEATransmitPriorityHigh] = KBoxMetricNMEA1TXQueueHighPrioritySentences;
+    _txQueueMetrics[NMEATransmitPriorityNormal] = KBoxMetricNMEA1TXQueueNormalPrioritySentences;
+    _txQueueMetrics[NMEATransmitPriorityLow] = KBoxMetricNMEA1TXQueueLowPrioritySentences;
     _skSourceInput = SKSourceInputNMEA0183_1;
   }
   if (&s == &Serial3) {
-    if (_config.inputMode == SerialModeNMEA) {
-      received3 = &receiveQueue;
-    }
     _taskName = "Serial Service 2";
     _rxValidEvent = KBoxEventNMEA2RX;
     _rxErrorEvent = KBoxEventNMEA2RXError;
+    _rxBufferOverflowEvent = KBoxEventNMEA2RXBufferOverflow;
+    _rxOverflowEvent = KBoxEventNMEA2RXOverflow;
     _txValidEvent = KBoxEventNMEA2TX;
     _txOverflowEvent = KBoxEventNMEA2TXOverflow;
+    _txDropEvents[NMEATransmitPriorityHigh] = KBoxEventNMEA2TXDropHighPriority;
+    _txDropEvents[NMEATransmitPriorityNormal] = KBoxEventNMEA2TXDropNormalPriority;
+    _txDropEvents[NMEATransmitPriorityLow] = KBoxEventNMEA2TXDropLowPriority;
+    _txQueueMetrics[NMEATransmitPriorityHigh] = KBoxMetricNMEA2TXQueueHighPrioritySentences;
+    _txQueueMetrics[NMEATransmitPriorityNormal] = KBoxMetricNMEA2TXQueueNormalPrioritySentences;
+    _txQueueMetrics[NMEATransmitPriorityLow] = KBoxMetricNMEA2TXQueueLowPrioritySentences;
     _skSourceInput = SKSourceInputNMEA0183_2;
   }
 }
@@ -153,6 +106,11 @@ void SerialService::setup() {
     NMEA1_SERIAL.begin(_config.baudRate);
     NMEA1_SERIAL.setTimeout(0);
     digitalWrite(nmea1_out_enable, _config.outputMode != SerialModeDisabled);
+    if (_config.inputMode == SerialModeNMEA) {
+      _framer = new NMEASerialFramer(stream, receiveQueueLength, SERIAL2_RX_BUFFER_SIZE,
+                                     _rxBufferOverflowEvent, _rxOverflowEvent, _rxErrorEvent);
+      framer2 = _framer;
+    }
     DEBUG("SerialService[1] Baudrate: %i Input: %s Output: %s",
           _config.baudRate,
           _config.inputMode == SerialModeNMEA ? "true" : "false",
@@ -162,48 +120,83 @@ void SerialService::setup() {
     NMEA2_SERIAL.begin(_config.baudRate);
     NMEA2_SERIAL.setTimeout(0);
     digitalWrite(nmea2_out_enable, _config.outputMode != SerialModeDisabled);
+    if (_config.inputMode == SerialModeNMEA) {
+      _framer = new NMEASerialFramer(stream, receiveQueueLength, SERIAL3_RX_BUFFER_SIZE,
+                                     _rxBufferOverflowEvent, _rxOverflowEvent, _rxErrorEvent);
+      framer3 = _framer;
+    }
     DEBUG("SerialService[2] Baudrate: %i Input: %s Output: %s",
           _config.baudRate,
           _config.inputMode == SerialModeNMEA ? "true" : "false",
           _config.outputMode == SerialModeNMEA ? "true" : "false");
   }
 
-  _hub.subscribe(this);
+  // Nothing is sent on the port when NMEA output is disabled, so the transmit
+  // queue and the rate limiter are only created when it is enabled.
+  if (_config.outputMode == SerialModeNMEA) {
+    _scheduler = new NMEATransmitScheduler(_config.baudRate, transmitQueueLength,
+                                           _txValidEvent, _txOverflowEvent, _txDropEvents);
+    _scheduler->setMillisecondsProvider(millis);
+
+    _rateLimiter = new SKRateLimiter(_config.rateLimit, *this, 16);
+    _rateLimiter->setMillisecondsProvider(millis);
+
+    SKNMEAConverter nmeaConverter(_config.nmeaConverter);
+    _outputHub.subscribe(_rateLimiter, nmeaConverter.getInputPaths());
+  }
 }
 
 void SerialService::loop() {
-  if (receiveQueue.size() == 0) {
+  if (_scheduler) {
+    _rateLimiter->flush();
+    _scheduler->drain(stream, stream.availableForWrite());
+    for (int p = 0; p < NMEATransmitPriorityCount; p++) {
+      KBoxMetrics.metric(_txQueueMetrics[p], _scheduler->getQueueDepth((enum NMEATransmitPriority)p));
+    }
+  }
+
+  if (!_framer) {
     return;
   }
-  // Send all queue sentences
-  DEBUG("Serial[%i]: Found %i sentences waiting",
-        _skSourceInput == SKSourceInputNMEA0183_1 ? 1 : 2,
-        receiveQueue.size());
-  for (auto it = receiveQueue.begin(); it != receiveQueue.end(); it++) {
-    if (it->isValid()) {
+
+  // Only process the sentences that are already queued. New sentences can
+  // be added by serialEventX() while we are running.
+  for (uint16_t count = _framer->size(); count > 0; count--) {
+    // The sentence is read in place so the slot is only released once we
+    // are done with it.
+    SKNMEASentence sentence(_framer->front());
+
+    // The reader validates the checksum while splitting the sentence so it
+    // is only done once for the repeaters and the parser.
+    NMEASentenceReader reader(sentence.c_str());
+    if (reader.isValid()) {
       KBoxMetrics.event(_rxValidEvent);
 
+      // Already repeated and parsed when it was first received.
+      if (_duplicateFilter && _duplicateFilter->isDuplicate(sentence.c_str(), _skSourceInput)) {
+        _framer->pop();
+        continue;
+      }
+
       // Repeat the sentence to all registered repeaters.
       for (auto repeater = _repeaters.begin(); repeater != _repeaters.end(); repeater++) {
-        (*repeater)->write(*it);
+        if (!repeater->filter || repeater->filter->accepts(sentence.c_str())) {
+          repeater->output->write(sentence);
+        }
       }
 
-      SKNMEAParser p;
       //FIXME: Get the time properly here!
-      const SKUpdate &update = p.parse(_skSourceInput, *it, SKTime(0));
+      const SKUpdate &update = _parser.parse(_skSourceInput, reader, SKTime(0));
       if (update.getSize() > 0) {
         _hub.publish(update);
       }
     }
     else {
-      DEBUG("Invalid NMEA sentence: %s", (*it).c_str());
+      DEBUG("Invalid NMEA sentence: %s", sentence.c_str());
       KBoxMetrics.event(_rxErrorEvent);
     }
+    _framer->pop();
   }
-  // FIXME: the current linked list implementation would probably continue to
-  // work if some data is added while we are running this loop but it would be
-  // best if we had a clearer contract or a better way to manage this.
-  receiveQueue.clear();
 }
 
 void SerialService::updateReceived(const SKUpdate &update) {
@@ -217,18 +210,29 @@ bool SerialService::write(const SKNMEASentence &nmeaSentence) {
   DEBUG("Writing NMEA to Serial[%i] output: %s",
         _skSourceInput == SKSourceInputNMEA0183_1 ? 1 : 2,
         nmeaSentence.c_str());
-  if ((size_t)stream.availableForWrite() >= nmeaSentence.length() + 2) {
-    stream.write(nmeaSentence.c_str());
-    stream.write("\r\n");
-    KBoxMetrics.event(_txValidEvent);
-    return true;
-  }
-  else {
-    KBoxMetrics.event(_txOverflowEvent);
-    return false;
+  // Sentences only come from updateReceived(), through the rate limiter,
+  // so the scheduler exists.
+  if (_duplicateFilter) {
+    _duplicateFilter->rememberOutput(nmeaSentence.c_str());
   }
+  // The sentence is sent by loop() when the port has time for it.
+  return _scheduler->enqueue(nmeaSentence);
 }
 
 void SerialService::addRepeater(SKNMEAOutput &repeater) {
-  _repeaters.add(&repeater);
-}
\ No newline at end of file
+  Repeater r = { &repeater, 0 };
+  _repeaters.add(r);
+}
+
+void SerialService::addRepeater(SKNMEAOutput &repeater, const NMEARoutingFilter &filter) {
+  Repeater r = { &repeater, &filter };
+  _repeaters.add(r);
+}
+
+void SerialService::setDuplicateFilter(NMEADuplicateFilter &filter) {
+  _duplicateFilter = &filter;
+}
+
+void SerialService::setAISParser(SKAISParser &parser) {
+  _parser.setAISParser(parser);
+}
@@ -24,36 +24,75 @@
 #pragma once
 
 #include "common/algo/List.h"
+#include "common/nmea/NMEADuplicateFilter.h"
+#include "common/nmea/NMEARoutingFilter.h"
+#include "common/nmea/NMEASerialFramer.h"
+#include "common/nmea/NMEATransmitScheduler.h"
 #include "common/signalk/SKSubscriber.h"
 #include "common/signalk/SKNMEAOutput.h"
 #include "common/stats/KBoxMetrics.h"
 #include "common/signalk/SKSource.h"
 #include "common/signalk/SKHub.h"
+#include "common/signalk/SKNMEAParser.h"
+#include "common/signalk/SKRateLimiter.h"
 #include "host/os/Task.h"
 #include "host/config/SerialConfig.h"
 
-// Defined by the NMEA Standard
-#define MAX_NMEA_SENTENCE_LENGTH 83
-
 class HardwareSerial;
 
 class SerialService : public Task, public SKSubscriber, private SKNMEAOutput {
   private:
+    struct Repeater {
+      SKNMEAOutput *output;
+      const NMEARoutingFilter *filter;
+    };
+
     SerialConfig &_config;
     SKHub &_hub;
+    SKHub &_outputHub;
     HardwareSerial& stream;
-    LinkedList<SKNMEASentence> receiveQueue;
+    NMEASerialFramer *_framer;
+    // Only created when NMEA output is enabled.
+    NMEATransmitScheduler *_scheduler;
+    NMEADuplicateFilter *_duplicateFilter;
     enum KBoxEvent _rxValidEvent, _rxErrorEvent, _txValidEvent, _txOverflowEvent;
+    enum KBoxEvent _rxBufferOverflowEvent, _rxOverflowEvent;
+    enum KBoxEvent _txDropEvents[NMEATransmitPriorityCount];
+    enum KBoxMetric _txQueueMetrics[NMEATransmitPriorityCount];
     SKSourceInput _skSourceInput;
-    LinkedList<SKNMEAOutput*> _repeaters;
+    LinkedList<Repeater> _repeaters;
+    SKNMEAParser _parser;
+    // Only created when NMEA output is enabled, like _scheduler.
+    SKRateLimiter *_rateLimiter;
 
   public:
-    SerialService(SerialConfig &_config, SKHub &hub, HardwareSerial&s);
+    /**
+     * Parsed sentences are published on `hub` and the sentences sent on the
+     * serial port are generated from the updates of `outputHub`.
+     */
+    SerialService(SerialConfig &_config, SKHub &hub, SKHub &outputHub, HardwareSerial&s);
 
     void setup();
     void loop();
     void updateReceived(const SKUpdate&) override;
     bool write(const SKNMEASentence& nmeaSentence) override;
     void addRepeater(SKNMEAOutput &repeater);
+
+    /**
+     * Only the sentences accepted by `filter` are repeated to `repeater`.
+     */
+    void addRepeater(SKNMEAOutput &repeater, const NMEARoutingFilter &filter);
+
+    /**
+     * Sentences found to be duplicates by `filter` are not repeated nor
+     * parsed. The filter can be shared with other services.
+     */
+    void setDuplicateFilter(NMEADuplicateFilter &filter);
+
+    /**
+     * AIS sentences are parsed by `parser`, which should be shared by all
+     * the services. They are ignored when no AIS parser is set.
+     */
+    void setAISParser(SKAISParser &parser);
 };
 
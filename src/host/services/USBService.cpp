@@ -25,7 +25,6 @@
 #include <Arduino.h>
 #include <KBoxLogging.h>
 #include <KBoxHardware.h>
-#include <Seasmart.h>
 #include "common/comms/Kommand.h"
 #include "common/stats/KBoxMetrics.h"
 #include "common/signalk/SKNMEAConverter.h"
@@ -36,9 +35,10 @@
 #include "USBService.h"
 
 
-USBService::USBService(GC &gc, SKHub &hub) : Task("USBService"), _slip(Serial, 2048),
+USBService::USBService(const USBConfig &config, GC &gc, SKHub &hub) :
+                                 Task("USBService"), _config(config), _slip(Serial, 2048),
                                  _streamLogger(KBoxLoggerStream(Serial)),
-                                 _skHub(hub),
+                                 _skHub(hub), _rateLimiter(0),
                                  _pingHandler(), _screenshotHandler(gc),
                                  _state(ConnectedDebug) {
 
@@ -46,7 +46,13 @@ USBService::USBService(GC &gc, SKHub &hub) : Task("USBService"), _slip(Serial, 2
 
 void USBService::setup() {
   Serial.setTimeout(0);
-  _skHub.subscribe(this);
+  // Only NMEA interface mode uses the updates and it always uses the default
+  // converter configuration.
+  SKNMEAConverterConfig config;
+  SKNMEAConverter nmeaConverter(config);
+  _rateLimiter = new SKRateLimiter(_config.rateLimit, *this, 16);
+  _rateLimiter->setMillisecondsProvider(millis);
+  _skHub.subscribe(_rateLimiter, nmeaConverter.getInputPaths());
 }
 
 void USBService::log(enum KBoxLoggingLevel level, const char *fname, int lineno, const char *fmt, va_list fmtargs) {
@@ -67,6 +73,10 @@ void USBService::log(enum KBoxLoggingLevel level, const char *fname, int lineno,
 }
 
 void USBService::loop() {
+  if (_rateLimiter) {
+    _rateLimiter->flush();
+  }
+
   /* Switching serial port to 230400 on computer signals that the host
    * wants to go into default debugging mode.
    */
@@ -221,21 +231,12 @@ bool USBService::write(const SKNMEASentence &nmeaSentence) {
   return true;
 }
 
-bool USBService::write(const tN2kMsg &msg) {
+bool USBService::writePCDIN(const SKNMEASentence &pcdin) {
   if (_state != ConnectedNMEAInterface) {
     return true;
   }
 
-  if (msg.DataLen > 500) {
-    return false;
-  }
-
-  char pcdin[30 + msg.DataLen * 2];
-  if (N2kToSeasmart(msg, millis(), pcdin, sizeof(pcdin)) < sizeof(pcdin)) {
-    Serial.println(pcdin);
-    return true;
-  } else {
-    return false;
-  }
+  Serial.println(pcdin.c_str());
+  return true;
 }
 
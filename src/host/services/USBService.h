@@ -26,28 +26,34 @@
 
 #include <KBoxLogging.h>
 #include <KBoxLoggerStream.h>
-#include <common/signalk/SKNMEA2000Output.h>
 #include "common/comms/SlipStream.h"
 #include "common/ui/GC.h"
 #include "common/comms/SlipStream.h"
 #include "common/comms/KommandHandlerPing.h"
 #include "common/comms/KommandHandlerScreenshot.h"
 #include "common/signalk/SKHub.h"
+#include "common/signalk/SKRateLimiter.h"
 #include "common/signalk/SKSubscriber.h"
 #include "common/signalk/SKNMEAOutput.h"
+#include "common/nmea/PCDINOutput.h"
 #include "host/os/Task.h"
+#include "host/config/USBConfig.h"
 #include "host/comms/KommandHandlerFileRead.h"
 #include "host/comms/KommandHandlerFileWrite.h"
 #include "host/comms/KommandHandlerReboot.h"
 
 class USBService : public Task, public KBoxLogger, public SKSubscriber,
-                   public SKNMEAOutput, public SKNMEA2000Output {
+                   public SKNMEAOutput, public PCDINOutput {
   private:
     static const size_t MaxLogFrameSize = 256;
 
+    const USBConfig &_config;
     SlipStream _slip;
     KBoxLoggerStream _streamLogger;
     SKHub &_skHub;
+    // Created in setup() because USBService is created before the
+    // configuration is loaded.
+    SKRateLimiter *_rateLimiter;
     KommandHandlerPing _pingHandler;
     KommandHandlerScreenshot _screenshotHandler;
     KommandHandlerFileRead _fileReadHandler;
@@ -70,8 +76,10 @@ class USBService : public Task, public KBoxLogger, public SKSubscriber,
                       const char *fmt, va_list fmtargs);
 
   public:
-    USBService(GC &gc, SKHub &hub);
-    ~USBService() {};
+    USBService(const USBConfig &config, GC &gc, SKHub &hub);
+    ~USBService() {
+      delete _rateLimiter;
+    };
 
     void setup();
     void loop();
@@ -80,5 +88,5 @@ class USBService : public Task, public KBoxLogger, public SKSubscriber,
     void updateReceived(const SKUpdate& u);
 
     bool write(const SKNMEASentence &nmeaSentence);
-    bool write(const tN2kMsg&);
+    bool writePCDIN(const SKNMEASentence &pcdin);
 };
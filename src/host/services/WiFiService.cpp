@@ -26,15 +26,16 @@
 
 #include <KBoxLogging.h>
 #include <KBoxHardware.h>
-#include <Seasmart.h>
 #include "common/signalk/SKNMEAConverter.h"
 #include "common/signalk/SKJSONVisitor.h"
 #include "common/stats/KBoxMetrics.h"
 
 WiFiService::WiFiService(const WiFiConfig &config, SKHub &skHub, GC &gc) :
   Task("WiFi"), _config(config), _hub(skHub), _slip(WiFiSerial, 2048),
-  _wifiStatusHandler(*this), _espState(ESPState::ESPStarting), _dhcpClients(0)
+  _wifiStatusHandler(*this), _espState(ESPState::ESPStarting),
+  _rateLimiter(config.rateLimit, *this, 16), _dhcpClients(0)
 {
+  _rateLimiter.setMillisecondsProvider(millis);
   // We will need gc at some point to be able to take screenshot
 }
 
@@ -46,10 +47,12 @@ void WiFiService::setup() {
     KBox.espRebootInProgram();
   }
 
-  _hub.subscribe(this);
+  _hub.subscribe(&_rateLimiter);
 }
 
 void WiFiService::loop() {
+  _rateLimiter.flush();
+
   if (_slip.available()) {
     uint8_t *frame;
     size_t len = _slip.peekFrame(&frame);
@@ -133,22 +136,12 @@ bool WiFiService::write(const SKNMEASentence& sentence) {
   return true;
 }
 
-bool WiFiService::write(const tN2kMsg& msg) {
-  // PCDIN sentences should have a similar size as NMEA sentences.
+bool WiFiService::writePCDIN(const SKNMEASentence& pcdin) {
+  // Large enough for the longest PCDIN sentence (a 223 bytes fast-packet).
   FixedSizeKommand<500> k(KommandNMEASentence);
-
-  if (msg.DataLen > 500) {
-    return false;
-  }
-
-  char pcdin[30 + msg.DataLen * 2];
-  if (N2kToSeasmart(msg, millis(), pcdin, sizeof(pcdin)) < 500) {
-    k.appendNullTerminatedString(pcdin);
-    sendKommand(k);
-    return true;
-  } else {
-    return false;
-  }
+  k.appendNullTerminatedString(pcdin.c_str());
+  sendKommand(k);
+  return true;
 }
 
 void WiFiService::wiFiStatusUpdated(const ESPState &state, uint16_t dhcpClients,
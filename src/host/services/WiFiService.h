@@ -25,9 +25,10 @@
 
 #include "common/ui/GC.h"
 #include "common/signalk/SKNMEAOutput.h"
-#include "common/signalk/SKNMEA2000Output.h"
 #include "common/signalk/SKHub.h"
+#include "common/signalk/SKRateLimiter.h"
 #include "common/signalk/SKSubscriber.h"
+#include "common/nmea/PCDINOutput.h"
 #include "common/comms/Kommand.h"
 #include "common/comms/SlipStream.h"
 #include "common/comms/KommandHandlerPing.h"
@@ -40,7 +41,7 @@
  * Manages connection to the ESP module.
  */
 class WiFiService : public Task, public SKSubscriber,
-                    public SKNMEAOutput, public SKNMEA2000Output,
+                    public SKNMEAOutput, public PCDINOutput,
                     private WiFiStatusObserver {
   private:
     const WiFiConfig &_config;
@@ -50,6 +51,7 @@ class WiFiService : public Task, public SKSubscriber,
     KommandHandlerWiFiLog _wifiLogHandler;
     KommandHandlerWiFiStatus _wifiStatusHandler;
     ESPState _espState;
+    SKRateLimiter _rateLimiter;
 
     IPAddress _clientAddress;
     uint16_t _dhcpClients;
@@ -62,7 +64,7 @@ class WiFiService : public Task, public SKSubscriber,
     void updateReceived(const SKUpdate&) override;
 
     bool write(const SKNMEASentence& s) override;
-    bool write(const tN2kMsg& m) override;
+    bool writePCDIN(const SKNMEASentence& pcdin) override;
 
     const bool clientInterfaceEnabled() const;
     const String clientInterfaceNetworkName() const;
@@ -33,10 +33,12 @@
 #include <WString.h>
 #include <ArduinoJson.h>
 #include <Seasmart.h>
+#include "common/signalk/SKAISParser.h"
 #include "common/signalk/SKNMEAParser.h"
 #include "common/signalk/SKNMEA2000Parser.h"
 #include "common/signalk/SKJSONVisitor.h"
 
+SKAISParser aisParser(128);
 SKNMEAParser nmeaParser = SKNMEAParser();
 SKNMEA2000Parser nmea2000Parser = SKNMEA2000Parser();
 
@@ -56,6 +58,7 @@ const SKUpdate& parseInputLine(std::string line) {
     }
   }
   else {
+    nmeaParser.setAISParser(aisParser);
     return nmeaParser.parse(SKSourceInputNMEA0183_1, String(line.c_str()), SKTime(time(0)));
   }
 }
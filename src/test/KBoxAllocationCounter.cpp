@@ -0,0 +1,117 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <new>
+#include <stdlib.h>
+#include "KBoxAllocationCounter.h"
+
+static uint32_t allocationCount = 0;
+
+// AddressSanitizer replaces the allocation functions itself. Replacing them
+// again would break it so nothing is counted in sanitized builds.
+#if defined(__SANITIZE_ADDRESS__)
+#define KBOX_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define KBOX_ASAN 1
+#endif
+#endif
+
+#if defined(__GLIBC__) && !defined(KBOX_ASAN)
+#define KBOX_COUNT_MALLOC 1
+#endif
+
+#ifdef KBOX_COUNT_MALLOC
+// With the GNU C library, the program can replace the allocation functions
+// and forward to the implementation of the library. This catches memory
+// allocated directly with malloc() or realloc() (by String for example).
+extern "C" {
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t count, size_t size);
+  void* __libc_realloc(void *p, size_t size);
+
+  void* malloc(size_t size) {
+    allocationCount++;
+    return __libc_malloc(size);
+  }
+
+  void* calloc(size_t count, size_t size) {
+    allocationCount++;
+    return __libc_calloc(count, size);
+  }
+
+  void* realloc(void *p, size_t size) {
+    if (size > 0) {
+      allocationCount++;
+    }
+    return __libc_realloc(p, size);
+  }
+}
+#endif
+
+#ifndef KBOX_ASAN
+void* operator new(size_t size) {
+#ifndef KBOX_COUNT_MALLOC
+  // Otherwise malloc() counts the allocation.
+  allocationCount++;
+#endif
+  void *p = malloc(size > 0 ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+void operator delete[](void *p) noexcept {
+  free(p);
+}
+#endif
+
+bool KBoxAllocationCounter::countsAllAllocations() {
+#ifdef KBOX_COUNT_MALLOC
+  return true;
+#else
+  return false;
+#endif
+}
+
+KBoxAllocationCounter::KBoxAllocationCounter() {
+  reset();
+}
+
+uint32_t KBoxAllocationCounter::count() const {
+  return allocationCount - _start;
+}
+
+void KBoxAllocationCounter::reset() {
+  _start = allocationCount;
+}
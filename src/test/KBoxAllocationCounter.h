@@ -0,0 +1,68 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Counts the number of heap allocations made since this object was created.
+ *
+ * The test program replaces the global `operator new` to keep track of all
+ * allocations. With the GNU C library, it also replaces `malloc()`,
+ * `calloc()` and `realloc()` so that memory allocated by String is counted
+ * too. On other platforms, only `new` is counted, and nothing is counted
+ * when the program is built with AddressSanitizer.
+ *
+ * Tests that check that no memory is allocated must start with
+ * KBOX_REQUIRE_ALLOCATION_COUNTER() so that they are skipped with a warning,
+ * instead of passing without checking anything, when not all allocations
+ * can be counted.
+ */
+class KBoxAllocationCounter {
+  private:
+    uint32_t _start;
+
+  public:
+    KBoxAllocationCounter();
+
+    /**
+     * Number of allocations since this counter was created or reset.
+     */
+    uint32_t count() const;
+
+    void reset();
+
+    /**
+     * Returns true if memory allocated with `malloc()` (by String for
+     * example) is counted.
+     */
+    static bool countsAllAllocations();
+};
+
+#define KBOX_REQUIRE_ALLOCATION_COUNTER() \
+  if (!KBoxAllocationCounter::countsAllAllocations()) { \
+    WARN("Skipped: malloc() allocations cannot be counted in this build"); \
+    return; \
+  }
@@ -0,0 +1,50 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+
+/**
+ * Runs `operation` `iterations` times and returns the average duration of one
+ * run in nanoseconds.
+ *
+ * Benchmarks are tagged with "[.][benchmark]" so that they do not run with
+ * the normal tests. Run them with `make benchmark`. The test environment is
+ * compiled without optimization so only compare numbers with each other.
+ */
+template <typename Operation> double benchmarkNanoseconds(int iterations, Operation operation) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    operation();
+  }
+  auto duration = std::chrono::steady_clock::now() - start;
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / (double)iterations;
+}
+
+inline void benchmarkReport(const char *name, double nanoseconds) {
+  fprintf(stdout, "BENCHMARK %-50s %12.1f ns/op\n", name, nanoseconds);
+}
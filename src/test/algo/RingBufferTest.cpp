@@ -0,0 +1,88 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "algo/RingBuffer.h"
+
+TEST_CASE("RingBuffer") {
+  RingBuffer<int> buffer(3);
+
+  WHEN("the buffer is empty") {
+    CHECK( buffer.isEmpty() );
+    CHECK( !buffer.isFull() );
+    CHECK( buffer.size() == 0 );
+    CHECK( buffer.capacity() == 3 );
+    CHECK( buffer.front() == 0 );
+  }
+
+  WHEN("an element is reserved but not committed") {
+    *buffer.reserve() = 42;
+    CHECK( buffer.isEmpty() );
+    CHECK( buffer.front() == 0 );
+  }
+
+  WHEN("the buffer is filled") {
+    for (int i = 0; i < 3; i++) {
+      int *slot = buffer.reserve();
+      REQUIRE( slot != 0 );
+      *slot = i;
+      buffer.commit();
+    }
+
+    CHECK( buffer.isFull() );
+    CHECK( buffer.reserve() == 0 );
+
+    THEN("elements come out in order") {
+      for (int i = 0; i < 3; i++) {
+        REQUIRE( buffer.front() != 0 );
+        CHECK( *buffer.front() == i );
+        buffer.pop();
+      }
+      CHECK( buffer.isEmpty() );
+    }
+  }
+
+  WHEN("the buffer wraps around") {
+    for (int i = 0; i < 10; i++) {
+      *buffer.reserve() = i;
+      buffer.commit();
+      *buffer.reserve() = i * 10;
+      buffer.commit();
+
+      CHECK( *buffer.front() == i );
+      buffer.pop();
+      CHECK( *buffer.front() == i * 10 );
+      buffer.pop();
+    }
+    CHECK( buffer.isEmpty() );
+  }
+
+  WHEN("the buffer is cleared") {
+    *buffer.reserve() = 1;
+    buffer.commit();
+    buffer.clear();
+    CHECK( buffer.isEmpty() );
+    CHECK( buffer.front() == 0 );
+  }
+}
@@ -31,6 +31,7 @@
 #include <ArduinoJson.h>
 #include <host/config/SDLoggingConfig.h>
 #include "../KBoxTest.h"
+#include "common/nmea/NMEARoutingFilter.h"
 #include "host/config/KBoxConfigParser.h"
 
 TEST_CASE("KBoxConfigParser") {
@@ -53,6 +54,13 @@ TEST_CASE("KBoxConfigParser") {
     CHECK( config.wifiConfig.vesselURN == "urn:mrn:kbox:unit-testing" );
     CHECK( config.sdLoggingConfig.enabled == true );
     CHECK( config.sdLoggingConfig.logWithoutTime == false );
+    CHECK( config.outputFilterConfig.enabled == true );
+    CHECK( config.outputFilterConfig.rulesCount == 2 );
+    CHECK( config.nmeaDuplicateFilterConfig.scope == NMEADuplicateFilterScopeOtherInputs );
+    CHECK( config.nmeaDuplicateFilterConfig.window == 500 );
+    CHECK( config.nmea2000Config.sourceArbitration.enabled == true );
+    CHECK( config.nmea2000Config.sourceArbitration.failoverTimeout == 3000 );
+    CHECK( config.nmea2000Config.sourceArbitration.preferredSourcesCount == 0 );
   }
 
   SECTION("No input") {
@@ -174,4 +182,140 @@ TEST_CASE("KBoxConfigParser") {
     CHECK(!sdLoggingConfig.enabled);
     CHECK(sdLoggingConfig.logWithoutTime);
   }
+
+  SECTION("Output filter config") {
+    const char *jsonConfig = "{ 'outputFilter': { 'enabled': true, 'epsilon': 0.5, 'maxAge': 2000, 'rules': ["
+      "  { 'path': 'navigation.attitude', 'epsilon': 0.01 },"
+      "  { 'path': 'electrical.batteries.*.voltage', 'epsilon': 0.1, 'maxAge': 30000 },"
+      "  { 'path': 'not.a.path', 'epsilon': 1 }"
+      "] } }";
+    JsonObject &root = jsonBuffer.parseObject(jsonConfig);
+    CHECK( root.success() );
+
+    kboxConfigParser.parseKBoxConfig(root, config);
+
+    CHECK( config.outputFilterConfig.enabled );
+    CHECK( config.outputFilterConfig.epsilon == 0.5 );
+    CHECK( config.outputFilterConfig.maxAge == 2000 );
+    REQUIRE( config.outputFilterConfig.rulesCount == 2 );
+    CHECK( config.outputFilterConfig.rules[0].path == SKPathNavigationAttitude );
+    CHECK( config.outputFilterConfig.rules[0].epsilon == 0.01 );
+    CHECK( config.outputFilterConfig.rules[0].maxAge == 2000 );
+    CHECK( config.outputFilterConfig.rules[1].path == SKPathElectricalBatteriesVoltage );
+    CHECK( config.outputFilterConfig.rules[1].maxAge == 30000 );
+  }
+
+  SECTION("Rate limit config") {
+    const char *jsonConfig = "{ 'serial2': { 'rateLimit': ["
+      "  { 'path': 'navigation.attitude', 'maxRate': 2, 'mode': 'mean' },"
+      "  { 'path': 'navigation.headingMagnetic', 'maxRate': 0.5 },"
+      "  { 'path': 'navigation.position' }"
+      "] }, 'usb': { 'rateLimit': [ { 'path': 'navigation.attitude', 'maxRate': 10 } ] } }";
+    JsonObject &root = jsonBuffer.parseObject(jsonConfig);
+    CHECK( root.success() );
+
+    kboxConfigParser.parseKBoxConfig(root, config);
+
+    REQUIRE( config.serial2Config.rateLimit.rulesCount == 2 );
+    CHECK( config.serial2Config.rateLimit.rules[0].path == SKPathNavigationAttitude );
+    CHECK( config.serial2Config.rateLimit.rules[0].minInterval == 500 );
+    CHECK( config.serial2Config.rateLimit.rules[0].mode == SKRateLimitMean );
+    CHECK( config.serial2Config.rateLimit.rules[1].path == SKPathNavigationHeadingMagnetic );
+    CHECK( config.serial2Config.rateLimit.rules[1].minInterval == 2000 );
+    CHECK( config.serial2Config.rateLimit.rules[1].mode == SKRateLimitLatest );
+
+    // Default rules are kept when the configuration does not have any.
+    CHECK( config.serial1Config.rateLimit.rulesCount == 1 );
+    CHECK( config.nmea2000Config.rateLimit.rulesCount == 0 );
+
+    REQUIRE( config.usbConfig.rateLimit.rulesCount == 1 );
+    CHECK( config.usbConfig.rateLimit.rules[0].minInterval == 100 );
+  }
+
+  SECTION("NMEA duplicate filter config") {
+    const char *jsonConfig = "{ 'nmeaDuplicateFilter': { 'scope': 'allInputs', 'window': 200 } }";
+    JsonObject &root = jsonBuffer.parseObject(jsonConfig);
+    CHECK( root.success() );
+
+    kboxConfigParser.parseKBoxConfig(root, config);
+
+    CHECK( config.nmeaDuplicateFilterConfig.scope == NMEADuplicateFilterScopeAllInputs );
+    CHECK( config.nmeaDuplicateFilterConfig.window == 200 );
+
+    JsonObject &disabled = jsonBuffer.parseObject("{ 'nmeaDuplicateFilter': { 'scope': 'disabled', 'window': -1 } }");
+    kboxConfigParser.parseKBoxConfig(disabled, config);
+
+    CHECK( config.nmeaDuplicateFilterConfig.scope == NMEADuplicateFilterScopeDisabled );
+    // Out of range, the default is used.
+    CHECK( config.nmeaDuplicateFilterConfig.window == 500 );
+  }
+
+  SECTION("NMEA2000 source arbitration config") {
+    const char *jsonConfig = "{ 'nmea2000': { 'sourceArbitration': { 'enabled': true, 'failoverTimeout': 5000,"
+      " 'preferredSources': [ 12, 'gps', 254, 35 ] } } }";
+    JsonObject &root = jsonBuffer.parseObject(jsonConfig);
+    CHECK( root.success() );
+
+    kboxConfigParser.parseKBoxConfig(root, config);
+
+    const NMEA2000SourceArbiterConfig &arbitration = config.nmea2000Config.sourceArbitration;
+    CHECK( arbitration.enabled );
+    CHECK( arbitration.failoverTimeout == 5000 );
+    REQUIRE( arbitration.preferredSourcesCount == 2 );
+    CHECK( arbitration.preferredSources[0] == 12 );
+    CHECK( arbitration.preferredSources[1] == 35 );
+
+    JsonObject &disabled = jsonBuffer.parseObject("{ 'nmea2000': { 'sourceArbitration': { 'enabled': false, 'failoverTimeout': 10 } } }");
+    kboxConfigParser.parseKBoxConfig(disabled, config);
+
+    CHECK( !config.nmea2000Config.sourceArbitration.enabled );
+    // Out of range, the default is used.
+    CHECK( config.nmea2000Config.sourceArbitration.failoverTimeout == 3000 );
+  }
+
+  SECTION("Routing config") {
+    const char *jsonConfig = "{ 'wifi': { 'routing': ["
+      "  { 'action': 'deny', 'sentence': 'GSV' },"
+      "  { 'action': 'allow', 'talker': 'GP', 'sentence': 'RMC' },"
+      "  { 'action': 'deny', 'pgn': 129540 },"
+      "  { 'action': 'deny', 'pgn': 127250, 'source': 12 },"
+      "  { 'action': 'deny', 'talker': 'GPS' },"
+      "  { 'action': 'deny', 'talker': 'GP', 'pgn': 129025 },"
+      "  { 'action': 'maybe', 'sentence': 'RMC' },"
+      "  { 'action': 'deny' }"
+      "] }, 'logging': { 'routing': [ { 'action': 'allow', 'source': 1 } ] } }";
+    JsonObject &root = jsonBuffer.parseObject(jsonConfig);
+    CHECK( root.success() );
+
+    kboxConfigParser.parseKBoxConfig(root, config);
+
+    REQUIRE( config.wifiConfig.routing.rulesCount == 4 );
+    const NMEARoutingRule *rules = config.wifiConfig.routing.rules;
+    CHECK( rules[0].action == NMEARoutingDeny );
+    CHECK( !rules[0].nmea2000 );
+    CHECK( String(rules[0].talker) == "" );
+    CHECK( String(rules[0].sentence) == "GSV" );
+    CHECK( rules[1].action == NMEARoutingAllow );
+    CHECK( String(rules[1].talker) == "GP" );
+    CHECK( String(rules[1].sentence) == "RMC" );
+    CHECK( rules[2].nmea2000 );
+    CHECK( rules[2].pgn == 129540 );
+    CHECK( rules[2].source == -1 );
+    CHECK( rules[3].pgn == 127250 );
+    CHECK( rules[3].source == 12 );
+
+    REQUIRE( config.sdLoggingConfig.routing.rulesCount == 1 );
+    CHECK( config.sdLoggingConfig.routing.rules[0].pgn == -1 );
+    CHECK( config.sdLoggingConfig.routing.rules[0].source == 1 );
+    CHECK( config.usbConfig.routing.rulesCount == 0 );
+
+    // And the rules compile to a filter.
+    NMEARoutingFilter filter(config.wifiConfig.routing);
+    CHECK( filter.accepts("$GPRMC,") );
+    CHECK( !filter.accepts("$GPGSV,") );
+    CHECK( !filter.accepts("$IIMWV,") );
+    CHECK( !filter.accepts(129540, 1) );
+    CHECK( !filter.accepts(127250, 12) );
+    CHECK( filter.accepts(127250, 13) );
+  }
 }
@@ -0,0 +1,105 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include "../KBoxTest.h"
+#include "common/nmea/AISFragmentAssembler.h"
+#include "common/nmea/NMEASentenceReader.h"
+#include "common/stats/KBoxMetrics.h"
+
+static const char *part1 = "!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C";
+static const char *part2 = "!AIVDM,2,2,1,A,88888888880,2*25";
+
+static const AISPayload* add(AISFragmentAssembler &assembler, const char *sentence) {
+  NMEASentenceReader reader(sentence);
+  REQUIRE( reader.isValid() );
+  return assembler.add(reader);
+}
+
+TEST_CASE("AISFragmentAssembler") {
+  AISFragmentAssembler assembler;
+
+  SECTION("Single sentence message") {
+    const AISPayload *p = add(assembler, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C");
+    REQUIRE( p );
+    CHECK( p->bitLength() == 168 );
+    CHECK( assembler.pendingCount() == 0 );
+  }
+
+  SECTION("Two sentences message") {
+    CHECK( add(assembler, part1) == 0 );
+    CHECK( assembler.pendingCount() == 1 );
+
+    const AISPayload *p = add(assembler, part2);
+    REQUIRE( p );
+    CHECK( p->bitLength() == 424 );
+    CHECK( p->getUnsigned(0, 6) == 5 );
+    CHECK( p->getUnsigned(8, 30) == 351759000 );
+    CHECK( assembler.pendingCount() == 0 );
+  }
+
+  SECTION("Interleaved messages") {
+    CHECK( add(assembler, part1) == 0 );
+    CHECK( add(assembler, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C") != 0 );
+    CHECK( add(assembler, "!AIVDM,2,1,2,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1F") == 0 );
+    CHECK( assembler.pendingCount() == 2 );
+
+    const AISPayload *p = add(assembler, part2);
+    REQUIRE( p );
+    CHECK( p->bitLength() == 424 );
+    CHECK( assembler.pendingCount() == 1 );
+  }
+
+  SECTION("Missing first fragment") {
+    uint32_t dropped = KBoxMetrics.countEvent(KBoxEventAISFragmentDropped);
+    CHECK( add(assembler, part2) == 0 );
+    uint32_t droppedAfter = KBoxMetrics.countEvent(KBoxEventAISFragmentDropped);
+    CHECK( droppedAfter == dropped + 1 );
+    CHECK( assembler.pendingCount() == 0 );
+  }
+
+  SECTION("Repeated fragment") {
+    CHECK( add(assembler, part1) == 0 );
+    CHECK( add(assembler, part1) == 0 );
+    CHECK( assembler.pendingCount() == 1 );
+    CHECK( add(assembler, part2) != 0 );
+  }
+
+  SECTION("Oldest incomplete message is dropped when all slots are used") {
+    uint32_t dropped = KBoxMetrics.countEvent(KBoxEventAISFragmentDropped);
+    char sentence[100];
+    for (int i = 0; i <= AISFragmentAssembler::maxPendingMessages; i++) {
+      snprintf(sentence, sizeof(sentence), "!AIVDM,2,1,%i,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*", i);
+      NMEASentenceReader reader(sentence);
+      CHECK( assembler.add(reader) == 0 );
+    }
+    uint32_t droppedAfter = KBoxMetrics.countEvent(KBoxEventAISFragmentDropped);
+    CHECK( droppedAfter == dropped + 1 );
+    CHECK( assembler.pendingCount() == AISFragmentAssembler::maxPendingMessages );
+
+    // Message 0 was dropped
+    CHECK( add(assembler, "!AIVDM,2,2,0,A,88888888880,2*24") == 0 );
+    CHECK( add(assembler, part2) != 0 );
+  }
+}
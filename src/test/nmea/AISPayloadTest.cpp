@@ -0,0 +1,92 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "../KBoxTest.h"
+#include "common/nmea/AISPayload.h"
+
+TEST_CASE("AISPayload") {
+  AISPayload p;
+
+  SECTION("Decode armored characters") {
+    // '0' is 0, 'W' is 39, '`' is 40 and 'w' is 63.
+    REQUIRE( p.append("0W`w", 4) );
+    CHECK( p.bitLength() == 24 );
+    CHECK( p.getUnsigned(0, 6) == 0 );
+    CHECK( p.getUnsigned(6, 6) == 39 );
+    CHECK( p.getUnsigned(12, 6) == 40 );
+    CHECK( p.getUnsigned(18, 6) == 63 );
+  }
+
+  SECTION("Reject invalid characters") {
+    CHECK( !p.append("1X", 2) );
+    p.clear();
+    CHECK( !p.append("1/", 2) );
+    p.clear();
+    CHECK( !p.append("1x", 2) );
+  }
+
+  SECTION("Remove fill bits") {
+    REQUIRE( p.append("w", 1, 2) );
+    CHECK( p.bitLength() == 4 );
+    CHECK( p.getUnsigned(0, 6) == 0x3C );
+    CHECK( !p.append("w", 1, 6) );
+  }
+
+  SECTION("Read fields across bytes") {
+    REQUIRE( p.append("177KQJ5000G?tO`K>RA1wUbN0TKH", 28) );
+    CHECK( p.bitLength() == 168 );
+    CHECK( p.getUnsigned(0, 6) == 1 );
+    CHECK( p.getUnsigned(8, 30) == 477553000 );
+    CHECK( p.getSigned(61, 28) == -73407500 );
+    CHECK( p.getSigned(89, 27) == 28549700 );
+  }
+
+  SECTION("Signed values") {
+    REQUIRE( p.append("w0", 2) );
+    CHECK( p.getSigned(0, 6) == -1 );
+    CHECK( p.getSigned(0, 7) == -2 );
+    CHECK( p.getSigned(6, 6) == 0 );
+  }
+
+  SECTION("Bits after the end read as 0") {
+    REQUIRE( p.append("w", 1) );
+    CHECK( p.getUnsigned(0, 12) == 0xFC0 );
+  }
+
+  SECTION("Text") {
+    // "EVER DIADEM" followed by '@' padding
+    REQUIRE( p.append("5F5BP49145=00", 13) );
+    char text[21];
+    p.getText(0, 13, text);
+    CHECK( String(text) == "EVER DIADEM" );
+  }
+
+  SECTION("Payload too long") {
+    char data[AISPayload::maxBits / 6 + 2];
+    memset(data, '0', sizeof(data));
+    CHECK( p.append(data, AISPayload::maxBits / 6) );
+    CHECK( !p.append(data, 1) );
+  }
+}
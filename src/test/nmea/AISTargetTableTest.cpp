@@ -0,0 +1,88 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "common/nmea/AISTargetTable.h"
+#include "common/stats/KBoxMetrics.h"
+
+TEST_CASE("AISTargetTable") {
+  AISTargetTable table(3);
+
+  SECTION("Empty table") {
+    CHECK( table.getSize() == 0 );
+    CHECK( table.getCapacity() == 3 );
+    CHECK( table.find(123456789) == 0 );
+  }
+
+  SECTION("Add and find targets") {
+    AISTarget &t = table.touch(123456789);
+    CHECK( t.mmsi == 123456789 );
+    CHECK( t.toBow == 0 );
+    t.toBow = 12;
+
+    table.touch(987654321);
+    CHECK( table.getSize() == 2 );
+
+    const AISTarget *found = table.find(123456789);
+    REQUIRE( found );
+    CHECK( found->toBow == 12 );
+    CHECK( &table.touch(123456789) == found );
+    CHECK( table.getSize() == 2 );
+  }
+
+  SECTION("Least recently seen target is evicted") {
+    table.touch(1);
+    table.touch(2);
+    table.touch(3);
+    table.touch(1);
+
+    uint32_t evicted = KBoxMetrics.countEvent(KBoxEventAISTargetEvicted);
+    AISTarget &t = table.touch(4);
+    uint32_t evictedAfter = KBoxMetrics.countEvent(KBoxEventAISTargetEvicted);
+
+    CHECK( evictedAfter == evicted + 1 );
+    CHECK( t.mmsi == 4 );
+    CHECK( table.getSize() == 3 );
+    CHECK( table.find(2) == 0 );
+    CHECK( table.find(1) != 0 );
+    CHECK( table.find(3) != 0 );
+    CHECK( table.find(4) != 0 );
+  }
+
+  SECTION("Busy harbour") {
+    AISTargetTable harbour(200);
+    for (uint32_t round = 0; round < 5; round++) {
+      for (uint32_t i = 0; i < 500; i++) {
+        AISTarget &t = harbour.touch(227000000 + i);
+        REQUIRE( t.mmsi == 227000000 + i );
+      }
+    }
+    CHECK( harbour.getSize() == 200 );
+    // The last 200 targets are in the table.
+    CHECK( harbour.find(227000299) == 0 );
+    for (uint32_t i = 300; i < 500; i++) {
+      REQUIRE( harbour.find(227000000 + i) != 0 );
+    }
+  }
+}
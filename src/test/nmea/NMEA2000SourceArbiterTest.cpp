@@ -0,0 +1,144 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "common/nmea/NMEA2000SourceArbiter.h"
+#include "common/stats/KBoxMetrics.h"
+
+static uint32_t arbiterMillis = 0;
+static uint32_t arbiterMillisProvider() {
+  return arbiterMillis;
+}
+
+static const uint8_t gps1 = 10;
+static const uint8_t gps2 = 20;
+static const uint8_t autopilot = 30;
+
+TEST_CASE("NMEA2000SourceArbiter") {
+  KBoxMetrics.reset();
+  arbiterMillis = 0;
+  NMEA2000SourceArbiterConfig config;
+  config.failoverTimeout = 3000;
+
+  SECTION("first source is kept while it is alive") {
+    NMEA2000SourceArbiter arbiter(config, 8);
+    arbiter.setMillisecondsProvider(arbiterMillisProvider);
+
+    CHECK( arbiter.accept(129025, 0, gps1) );
+    CHECK( !arbiter.accept(129025, 0, gps2) );
+    CHECK( !arbiter.accept(129025, 0, autopilot) );
+
+    // Other PGNs are arbitrated separately.
+    CHECK( arbiter.accept(129026, 0, gps2) );
+
+    arbiterMillis = 2000;
+    CHECK( arbiter.accept(129025, 0, gps1) );
+    arbiterMillis = 4000;
+    CHECK( !arbiter.accept(129025, 0, gps2) );
+
+    CHECK( arbiter.getAccepted(gps1) == 2 );
+    CHECK( arbiter.getDropped(gps1) == 0 );
+    CHECK( arbiter.getAccepted(gps2) == 1 );
+    CHECK( arbiter.getDropped(gps2) == 2 );
+    CHECK( arbiter.getDropped(autopilot) == 1 );
+    CHECK( arbiter.getSourceStatsCount() == 3 );
+    CHECK( arbiter.getFailovers() == 0 );
+
+    uint32_t dropped = KBoxMetrics.countEvent(KBoxEventNMEA2000SourceDropped);
+    CHECK( dropped == 3 );
+  }
+
+  SECTION("failover when the selected source goes silent") {
+    NMEA2000SourceArbiter arbiter(config, 8);
+    arbiter.setMillisecondsProvider(arbiterMillisProvider);
+
+    CHECK( arbiter.accept(129025, 0, gps1) );
+    arbiterMillis = 3000;
+    CHECK( !arbiter.accept(129025, 0, gps2) );
+    arbiterMillis = 3001;
+    CHECK( arbiter.accept(129025, 0, gps2) );
+
+    // gps1 is now the one that has to wait.
+    CHECK( !arbiter.accept(129025, 0, gps1) );
+    CHECK( arbiter.getFailovers() == 1 );
+    uint32_t failovers = KBoxMetrics.countEvent(KBoxEventNMEA2000SourceFailover);
+    CHECK( failovers == 1 );
+  }
+
+  SECTION("preferred sources take over immediately") {
+    config.preferredSources[0] = gps2;
+    config.preferredSources[1] = autopilot;
+    config.preferredSourcesCount = 2;
+    NMEA2000SourceArbiter arbiter(config, 8);
+    arbiter.setMillisecondsProvider(arbiterMillisProvider);
+
+    CHECK( arbiter.accept(129025, 0, gps1) );
+    CHECK( arbiter.accept(129025, 0, autopilot) );
+    CHECK( !arbiter.accept(129025, 0, gps1) );
+    CHECK( arbiter.accept(129025, 0, gps2) );
+    CHECK( !arbiter.accept(129025, 0, autopilot) );
+
+    // When the preferred source stops, the next one is used.
+    arbiterMillis = 5000;
+    CHECK( arbiter.accept(129025, 0, autopilot) );
+    // And the preferred one takes over again when it comes back.
+    CHECK( arbiter.accept(129025, 0, gps2) );
+    CHECK( arbiter.getFailovers() == 4 );
+  }
+
+  SECTION("channel key") {
+    NMEA2000SourceArbiter arbiter(config, 8);
+
+    // Two battery monitors sending different instances are both used.
+    CHECK( arbiter.accept(127508, 0, gps1) );
+    CHECK( arbiter.accept(127508, 1, gps2) );
+    CHECK( !arbiter.accept(127508, 1, gps1) );
+
+    const unsigned char battery[] = { 0x01, 0x10, 0x05 };
+    CHECK( NMEA2000SourceArbiter::channelKey(127508, battery, sizeof(battery)) == 1 );
+
+    // Apparent wind (reference 2) in the low 3 bits of byte 5.
+    const unsigned char wind[] = { 0x00, 0x10, 0x00, 0x20, 0x00, 0xfa, 0xff, 0xff };
+    CHECK( NMEA2000SourceArbiter::channelKey(130306, wind, sizeof(wind)) == 2 );
+    CHECK( NMEA2000SourceArbiter::channelKey(130306, wind, 4) == 0 );
+    CHECK( NMEA2000SourceArbiter::channelKey(129025, wind, sizeof(wind)) == 0 );
+  }
+
+  SECTION("channels which do not fit are not arbitrated") {
+    NMEA2000SourceArbiter arbiter(config, 1);
+
+    CHECK( arbiter.accept(129025, 0, gps1) );
+    CHECK( arbiter.accept(129026, 0, gps1) );
+    CHECK( arbiter.accept(129026, 0, gps2) );
+    CHECK( !arbiter.accept(129025, 0, gps2) );
+  }
+
+  SECTION("disabled") {
+    config.enabled = false;
+    NMEA2000SourceArbiter arbiter(config, 8);
+
+    CHECK( arbiter.accept(129025, 0, gps1) );
+    CHECK( arbiter.accept(129025, 0, gps2) );
+  }
+}
@@ -0,0 +1,184 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <N2kMsg.h>
+#include "../KBoxTest.h"
+#include "common/algo/List.h"
+#include "common/nmea/NMEA2000TransmitScheduler.h"
+#include "common/stats/KBoxMetrics.h"
+
+static uint32_t n2kSchedulerMillis = 0;
+static uint32_t n2kSchedulerMillisProvider() {
+  return n2kSchedulerMillis;
+}
+
+class N2kBus : public LinkedList<tN2kMsg>, public SKNMEA2000Output {
+  public:
+    bool busy = false;
+
+    bool write(const tN2kMsg& m) override {
+      if (busy) {
+        return false;
+      }
+      add(m);
+      return true;
+    };
+};
+
+static tN2kMsg message(uint32_t pgn, unsigned char instance, unsigned char value) {
+  tN2kMsg msg;
+  msg.SetPGN(pgn);
+  msg.AddByte(instance);
+  msg.AddByte(value);
+  return msg;
+}
+
+TEST_CASE("NMEA2000TransmitScheduler") {
+  KBoxMetrics.reset();
+  n2kSchedulerMillis = 0;
+  N2kBus bus;
+  NMEA2000TransmitScheduler scheduler(bus, 4);
+  scheduler.setMillisecondsProvider(n2kSchedulerMillisProvider);
+
+  SECTION("messages are rate limited and coalesced") {
+    // 127508 (Battery status) is sent every 1500ms.
+    CHECK( scheduler.write(message(127508, 1, 10)) );
+    CHECK( scheduler.getQueueDepth() == 1 );
+    CHECK( scheduler.flush() == 1 );
+    CHECK( scheduler.write(message(127508, 1, 11)) );
+    CHECK( scheduler.write(message(127508, 1, 12)) );
+    CHECK( scheduler.flush() == 0 );
+    CHECK( bus.size() == 1 );
+    CHECK( scheduler.getQueueDepth() == 1 );
+    CHECK( scheduler.getCoalesced() == 1 );
+
+    // Another instance is another channel.
+    CHECK( scheduler.write(message(127508, 2, 20)) );
+    CHECK( scheduler.flush() == 1 );
+    CHECK( bus.size() == 2 );
+
+    n2kSchedulerMillis = 1499;
+    CHECK( scheduler.flush() == 0 );
+    n2kSchedulerMillis = 1500;
+    CHECK( scheduler.flush() == 1 );
+    REQUIRE( bus.size() == 3 );
+    auto it = bus.begin();
+    CHECK( it->Data[1] == 10 );
+    it++;
+    it++;
+    CHECK( it->Data[1] == 12 );
+    CHECK( scheduler.getQueueDepth() == 0 );
+
+    uint32_t coalesced = KBoxMetrics.countEvent(KBoxEventNMEA2000MessageCoalesced);
+    CHECK( coalesced == 1 );
+  }
+
+  SECTION("queued messages are sent unchanged") {
+    tN2kMsg msg;
+    msg.Init(3, 129029, 22, 7);
+    for (unsigned char i = 0; i < NMEA2000TransmitScheduler::maxDataLength; i++) {
+      msg.AddByte(i);
+    }
+    CHECK( scheduler.write(msg) );
+    CHECK( bus.size() == 0 );
+    CHECK( scheduler.flush() == 1 );
+    REQUIRE( bus.size() == 1 );
+
+    const tN2kMsg &sent = *bus.begin();
+    CHECK( sent.Priority == 3 );
+    CHECK( sent.PGN == 129029 );
+    CHECK( sent.Source == 22 );
+    CHECK( sent.Destination == 7 );
+    CHECK( sent.DataLen == msg.DataLen );
+    CHECK( memcmp(sent.Data, msg.Data, msg.DataLen) == 0 );
+  }
+
+  SECTION("long messages are sent immediately") {
+    tN2kMsg msg;
+    msg.SetPGN(129029);
+    for (unsigned char i = 0; i <= NMEA2000TransmitScheduler::maxDataLength; i++) {
+      msg.AddByte(i);
+    }
+    CHECK( scheduler.write(msg) );
+    CHECK( bus.size() == 1 );
+    CHECK( scheduler.getQueueDepth() == 0 );
+  }
+
+  SECTION("PGNs without a default rate are not limited") {
+    CHECK( NMEA2000TransmitScheduler::minIntervalOf(65280) == 0 );
+    scheduler.write(message(65280, 0, 1));
+    scheduler.flush();
+    scheduler.write(message(65280, 0, 2));
+    scheduler.flush();
+    CHECK( bus.size() == 2 );
+  }
+
+  SECTION("retry when the bus is busy") {
+    bus.busy = true;
+    CHECK( scheduler.write(message(127508, 1, 10)) );
+    CHECK( scheduler.write(message(127250, 0, 10)) );
+    CHECK( scheduler.flush() == 0 );
+    CHECK( scheduler.getQueueDepth() == 2 );
+
+    bus.busy = false;
+    CHECK( scheduler.flush() == 2 );
+    REQUIRE( bus.size() == 2 );
+    // Oldest first.
+    CHECK( bus.begin()->PGN == 127508 );
+    CHECK( scheduler.getRetries() == 1 );
+    CHECK( scheduler.getDropped() == 0 );
+  }
+
+  SECTION("drop after too many attempts") {
+    bus.busy = true;
+    scheduler.write(message(127508, 1, 10));
+    for (int i = 0; i < NMEA2000TransmitScheduler::maxAttempts; i++) {
+      CHECK( scheduler.flush() == 0 );
+    }
+    CHECK( scheduler.getRetries() == 3 );
+    CHECK( scheduler.getDropped() == 1 );
+    CHECK( scheduler.getQueueDepth() == 0 );
+
+    bus.busy = false;
+    CHECK( scheduler.flush() == 0 );
+    CHECK( bus.size() == 0 );
+  }
+
+  SECTION("drop when the queue is full") {
+    for (unsigned char i = 0; i < 4; i++) {
+      CHECK( scheduler.write(message(127508, i, 0)) );
+    }
+    CHECK( !scheduler.write(message(127508, 5, 0)) );
+    // Coalesced messages still fit.
+    CHECK( scheduler.write(message(127508, 1, 1)) );
+    CHECK( scheduler.getDropped() == 1 );
+    uint32_t dropped = KBoxMetrics.countEvent(KBoxEventNMEA2000MessageDropped);
+    CHECK( dropped == 1 );
+
+    // Once sent, the slots can be used by other channels.
+    CHECK( scheduler.flush() == 4 );
+    CHECK( scheduler.write(message(127508, 5, 0)) );
+  }
+}
@@ -0,0 +1,126 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "common/nmea/NMEADuplicateFilter.h"
+#include "common/stats/KBoxMetrics.h"
+
+static uint32_t duplicateFilterMillis = 0;
+static uint32_t duplicateFilterMillisProvider() {
+  return duplicateFilterMillis;
+}
+
+static const uint8_t input1 = 1;
+static const uint8_t input2 = 2;
+
+static const char *rmc = "$GPRMC,003516.000,A,3751.6035,N,12228.8065,W,0.01,0.00,030416,,,D*79";
+static const char *rmc2 = "$GPRMC,003517.000,A,3751.6036,N,12228.8065,W,0.01,0.00,030416,,,D*7B";
+static const char *mwv = "$IIMWV,45.0,R,12.0,N,A*3F";
+
+TEST_CASE("NMEADuplicateFilter") {
+  KBoxMetrics.reset();
+  duplicateFilterMillis = 0;
+  NMEADuplicateFilterConfig config;
+  config.window = 500;
+
+  SECTION("hash ignores the checksum and the line terminator") {
+    CHECK( NMEADuplicateFilter::hashSentence("$IIMWV,45.0,R,12.0,N,A*3F")
+           == NMEADuplicateFilter::hashSentence("$IIMWV,45.0,R,12.0,N,A*00\r\n") );
+    CHECK( NMEADuplicateFilter::hashSentence(rmc) != NMEADuplicateFilter::hashSentence(rmc2) );
+  }
+
+  SECTION("sentences received on both inputs") {
+    NMEADuplicateFilter filter(config, 8);
+    filter.setMillisecondsProvider(duplicateFilterMillisProvider);
+
+    CHECK( !filter.isDuplicate(rmc, input1) );
+    duplicateFilterMillis = 10;
+    CHECK( filter.isDuplicate(rmc, input2) );
+    CHECK( !filter.isDuplicate(rmc2, input2) );
+
+    // The same input can repeat a sentence.
+    duplicateFilterMillis = 300;
+    CHECK( !filter.isDuplicate(rmc, input1) );
+
+    // Which makes the window start again.
+    duplicateFilterMillis = 700;
+    CHECK( filter.isDuplicate(rmc, input2) );
+
+    // After the window, the sentence is accepted again.
+    duplicateFilterMillis = 801;
+    CHECK( !filter.isDuplicate(rmc, input2) );
+
+    CHECK( filter.getHits() == 2 );
+    CHECK( filter.getMisses() == 4 );
+    uint32_t hits = KBoxMetrics.countEvent(KBoxEventNMEADuplicateFilterHit);
+    uint32_t misses = KBoxMetrics.countEvent(KBoxEventNMEADuplicateFilterMiss);
+    CHECK( hits == 2 );
+    CHECK( misses == 4 );
+  }
+
+  SECTION("sentences repeated by the same input") {
+    config.scope = NMEADuplicateFilterScopeAllInputs;
+    NMEADuplicateFilter filter(config, 8);
+    filter.setMillisecondsProvider(duplicateFilterMillisProvider);
+
+    CHECK( !filter.isDuplicate(mwv, input1) );
+    duplicateFilterMillis = 100;
+    CHECK( filter.isDuplicate(mwv, input1) );
+    CHECK( filter.isDuplicate(mwv, input2) );
+    duplicateFilterMillis = 501;
+    CHECK( !filter.isDuplicate(mwv, input1) );
+  }
+
+  SECTION("sentences sent by KBox and received back") {
+    NMEADuplicateFilter filter(config, 8);
+    filter.setMillisecondsProvider(duplicateFilterMillisProvider);
+
+    filter.rememberOutput(mwv);
+    CHECK( filter.isDuplicate(mwv, input2) );
+    CHECK( filter.getMisses() == 0 );
+  }
+
+  SECTION("disabled filter") {
+    config.scope = NMEADuplicateFilterScopeDisabled;
+    NMEADuplicateFilter filter(config, 8);
+
+    CHECK( !filter.isDuplicate(mwv, input1) );
+    CHECK( !filter.isDuplicate(mwv, input2) );
+    CHECK( filter.getMisses() == 0 );
+  }
+
+  SECTION("the oldest sentence is forgotten when the table is full") {
+    NMEADuplicateFilter filter(config, 2);
+    filter.setMillisecondsProvider(duplicateFilterMillisProvider);
+
+    CHECK( !filter.isDuplicate(rmc, input1) );
+    duplicateFilterMillis = 1;
+    CHECK( !filter.isDuplicate(rmc2, input1) );
+    duplicateFilterMillis = 2;
+    CHECK( !filter.isDuplicate(mwv, input1) );
+
+    CHECK( !filter.isDuplicate(rmc, input2) );
+    CHECK( filter.isDuplicate(mwv, input2) );
+  }
+}
@@ -0,0 +1,151 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include "../KBoxTest.h"
+#include "common/nmea/NMEARoutingFilter.h"
+
+static void addNMEARule(NMEARoutingConfig &config, enum NMEARoutingAction action,
+                        const char *talker, const char *sentence) {
+  NMEARoutingRule &rule = config.rules[config.rulesCount++];
+  rule.action = action;
+  rule.nmea2000 = false;
+  strcpy(rule.talker, talker);
+  strcpy(rule.sentence, sentence);
+  rule.pgn = -1;
+  rule.source = -1;
+}
+
+static void addNMEA2000Rule(NMEARoutingConfig &config, enum NMEARoutingAction action,
+                            int32_t pgn, int16_t source) {
+  NMEARoutingRule &rule = config.rules[config.rulesCount++];
+  rule.action = action;
+  rule.nmea2000 = true;
+  rule.talker[0] = 0;
+  rule.sentence[0] = 0;
+  rule.pgn = pgn;
+  rule.source = source;
+}
+
+static const char *gprmc = "$GPRMC,003516.000,A,3751.6035,N,12228.8065,W,0.01,0.00,030416,,,D*79";
+static const char *gpgsv = "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74";
+static const char *glgsv = "$GLGSV,1,1,02,65,23,300,38,66,54,042,41*6F";
+static const char *iimwv = "$IIMWV,45.0,R,12.0,N,A*3F";
+static const char *aivdm = "!AIVDM,1,1,,B,15MgK45P3@G?fl0E`JbR0OwT0@MS,0*4D";
+
+TEST_CASE("NMEARoutingFilter") {
+  NMEARoutingConfig config;
+
+  SECTION("no rules") {
+    NMEARoutingFilter filter(config);
+
+    CHECK( filter.accepts(gprmc) );
+    CHECK( filter.accepts(aivdm) );
+    CHECK( filter.accepts(129025, 12) );
+  }
+
+  SECTION("deny a sentence code from all talkers") {
+    addNMEARule(config, NMEARoutingDeny, "", "GSV");
+    NMEARoutingFilter filter(config);
+
+    CHECK( !filter.accepts(gpgsv) );
+    CHECK( !filter.accepts(glgsv) );
+    CHECK( filter.accepts(gprmc) );
+    CHECK( filter.accepts(iimwv) );
+
+    // NMEA2000 messages are not affected.
+    CHECK( filter.accepts(129540, 12) );
+  }
+
+  SECTION("only allow some talkers and sentences") {
+    addNMEARule(config, NMEARoutingAllow, "GP", "");
+    addNMEARule(config, NMEARoutingAllow, "AI", "VDM");
+    addNMEARule(config, NMEARoutingDeny, "GP", "GSV");
+    NMEARoutingFilter filter(config);
+
+    CHECK( filter.accepts(gprmc) );
+    CHECK( filter.accepts(aivdm) );
+    // Deny rules win over allow rules.
+    CHECK( !filter.accepts(gpgsv) );
+    CHECK( !filter.accepts(glgsv) );
+    CHECK( !filter.accepts(iimwv) );
+    CHECK( !filter.accepts("garbage") );
+    CHECK( !filter.accepts("") );
+
+    // Allow rules only restrict their own protocol.
+    CHECK( filter.accepts(129025, 12) );
+  }
+
+  SECTION("deny everything") {
+    addNMEARule(config, NMEARoutingDeny, "", "");
+    addNMEA2000Rule(config, NMEARoutingDeny, -1, -1);
+    NMEARoutingFilter filter(config);
+
+    CHECK( !filter.accepts(gprmc) );
+    CHECK( !filter.accepts("") );
+    CHECK( !filter.accepts(129025, 12) );
+  }
+
+  SECTION("NMEA2000 rules by PGN and by source") {
+    addNMEA2000Rule(config, NMEARoutingDeny, 129540, -1);
+    addNMEA2000Rule(config, NMEARoutingDeny, -1, 35);
+    addNMEA2000Rule(config, NMEARoutingDeny, 127250, 12);
+    NMEARoutingFilter filter(config);
+
+    CHECK( !filter.accepts(129540, 12) );
+    CHECK( !filter.accepts(129025, 35) );
+    CHECK( !filter.accepts(127250, 12) );
+    CHECK( filter.accepts(127250, 13) );
+    CHECK( filter.accepts(129025, 12) );
+    CHECK( filter.accepts(0, 0) );
+    CHECK( filter.accepts(gpgsv) );
+  }
+
+  SECTION("only allow some PGNs") {
+    addNMEA2000Rule(config, NMEARoutingAllow, 129025, -1);
+    addNMEA2000Rule(config, NMEARoutingAllow, 129026, -1);
+    NMEARoutingFilter filter(config);
+
+    CHECK( filter.accepts(129025, 1) );
+    CHECK( filter.accepts(129026, 200) );
+    CHECK( !filter.accepts(129029, 1) );
+  }
+
+  SECTION("all the rules are compiled") {
+    // More rules than there are buckets in the smallest table.
+    const char *codes[] = { "GSV", "GSA", "GLL", "VTG", "ZDA", "GBS", "GRS", "GST", "TXT", "RTE", "WPL", "BOD",
+                            "XTE", "APB", "RMB", "AAM" };
+    for (int i = 0; i < NMEARoutingConfig::maxRules; i++) {
+      addNMEARule(config, NMEARoutingDeny, "GP", codes[i]);
+    }
+    NMEARoutingFilter filter(config);
+
+    char sentence[] = "$GPXXX,";
+    for (int i = 0; i < NMEARoutingConfig::maxRules; i++) {
+      memcpy(sentence + 3, codes[i], 3);
+      CHECK( !filter.accepts(sentence) );
+    }
+    CHECK( filter.accepts(gprmc) );
+  }
+}
@@ -22,6 +22,8 @@
   THE SOFTWARE.
 */
 
+#include <math.h>
+#include <string.h>
 #include "../KBoxTest.h"
 #include "common/nmea/NMEASentenceBuilder.h"
 
@@ -56,3 +58,83 @@ TEST_CASE("test a real nmea sentence to make sure the checksum is properly gener
 
   REQUIRE( sb.toNMEA() == "$GPRMC,003516.000,A,3751.6035,N,12228.8065,W,0.01,0.00,030416,,,D*79" );
 }
+
+TEST_CASE("NMEASentenceBuilder number formatting") {
+  SECTION("rounding and negative numbers") {
+    NMEASentenceBuilder sb("II", "TST", 6);
+    sb.setField(1, 12.42, 2);
+    sb.setField(2, -3.14159, 3);
+    sb.setField(3, 0.05, 1);
+    sb.setField(4, -0.04, 1);
+    sb.setField(5, 359.96, 1);
+    sb.setField(6, 42.4, 0);
+
+    CHECK( String(sb.toNMEA().c_str()) == "$IITST,12.42,-3.142,0.1,0.0,360.0,42*53" );
+  }
+
+  SECTION("NaN is an empty field") {
+    NMEASentenceBuilder sb("II", "TST", 2);
+    sb.setField(1, NAN, 1);
+    sb.setField(2, "A");
+
+    CHECK( sb.toNMEA() == "$IITST,,A*12" );
+  }
+
+  SECTION("large numbers") {
+    NMEASentenceBuilder sb("II", "TST", 1);
+    sb.setField(1, 123456.5, 5);
+
+    CHECK( String(sb.toNMEA().c_str()) == "$IITST,123456.50000*63" );
+  }
+}
+
+TEST_CASE("NMEASentenceBuilder fields") {
+  SECTION("skipped fields are empty") {
+    NMEASentenceBuilder sb("II", "RSA", 4);
+    sb.setField(1, 12.3, 1);
+    sb.setField(2, "A");
+
+    CHECK( sb.toNMEA() == "$IIRSA,12.3,A,,*1F" );
+  }
+
+  SECTION("fields cannot be set out of order") {
+    NMEASentenceBuilder sb("II", "TST", 3);
+    sb.setField(2, "B");
+    sb.setField(1, "A");
+    sb.setField(4, "D");
+
+    CHECK( sb.toNMEA() == "$IITST,,B,*3D" );
+  }
+
+  SECTION("toNMEA() can be called more than once") {
+    NMEASentenceBuilder sb("II", "HDM", 2);
+    sb.setField(1, 42.0, 1);
+    sb.setField(2, "M");
+
+    SKNMEASentence first = sb.toNMEA();
+    sb.setField(3, "X");
+    SKNMEASentence second = sb.toNMEA();
+    CHECK( second == first.c_str() );
+    CHECK( second.length() == first.length() );
+    CHECK( second.isValid() );
+  }
+
+  SECTION("sentences are limited to 82 characters") {
+    char field[80];
+    memset(field, 'X', sizeof(field));
+
+    // 77 characters and the checksum
+    field[77 - 7] = '\0';
+    NMEASentenceBuilder sb("II", "TST", 1);
+    sb.setField(1, field);
+    CHECK( sb.toNMEA().length() == 80 );
+    CHECK( sb.toNMEA().isValid() );
+
+    field[77 - 7] = 'X';
+    field[78 - 7] = '\0';
+    NMEASentenceBuilder tooLong("II", "TST", 1);
+    tooLong.setField(1, field);
+    CHECK( tooLong.toNMEA().length() == 0 );
+    CHECK( tooLong.toNMEA() == "" );
+  }
+}
@@ -0,0 +1,276 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <cmath>
+#include <fstream>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "../KBoxTest.h"
+#include "../KBoxBenchmark.h"
+#include "common/nmea/NMEASentenceReader.h"
+#include "common/nmea/nmea.h"
+
+/*
+ * The String based reader that NMEASentenceReader replaced. Every field access
+ * scans the sentence from the beginning and allocates a substring.
+ */
+class StringNMEASentenceReader {
+  private:
+    String _sentence;
+
+  public:
+    StringNMEASentenceReader(const String &sentence) : _sentence(sentence) {};
+
+    bool isValid() const {
+      return nmea_is_valid(_sentence.c_str());
+    };
+
+    int countFields() const {
+      int count = 0;
+      for (const char *s = _sentence.c_str(); *s != '\0'; s++) {
+        if (*s == ',') {
+          count++;
+        }
+      }
+      return count;
+    };
+
+    const String getFieldAsString(int id) const {
+      int pos = 0;
+      for (int index = 0; index < id; index++) {
+        pos = _sentence.indexOf(',', pos + 1);
+        if (pos == -1) {
+          return "";
+        }
+      }
+      int end = _sentence.indexOf(',', pos + 1);
+      if (end == -1) {
+        end = _sentence.indexOf('*', pos + 1);
+      }
+      if (end == -1) {
+        return "";
+      }
+      return _sentence.substring(pos + 1, end);
+    };
+
+    double getFieldAsDouble(int id) const {
+      String f = getFieldAsString(id);
+      if (f.length() == 0) {
+        return NAN;
+      }
+      return strtod(f.c_str(), 0);
+    };
+};
+
+/*
+ * The strtod() based latitude/longitude parsing that NMEADecimal replaced.
+ */
+static double strtodLatLon(const NMEAField &value, char sign) {
+  const char *dot = static_cast<const char*>(memchr(value.data(), '.', value.length()));
+  int degreesDigits = dot ? dot - value.data() - 2 : 0;
+  if (degreesDigits < 0) {
+    degreesDigits = 0;
+  }
+
+  int degrees = 0;
+  for (int i = 0; i < degreesDigits && value[i] >= '0' && value[i] <= '9'; i++) {
+    degrees = degrees * 10 + (value[i] - '0');
+  }
+  double latlon = degrees + strtod(value.data() + degreesDigits, 0) / 60;
+  return sign == 'S' || sign == 'W' ? -latlon : latlon;
+}
+
+static std::vector<std::string> loadSampleSentences() {
+  // Each line of the log is "<millis>:<data>" and some sentences are split
+  // over multiple lines. Keep everything that looks like a sentence, invalid
+  // ones included.
+  std::vector<std::string> sentences;
+  std::ifstream log("tools/nmea-tester/nmea-sample.log");
+  std::string line;
+
+  while (std::getline(log, line)) {
+    size_t colon = line.find(':');
+    std::string data = colon == std::string::npos ? line : line.substr(colon + 1);
+    if (data.size() > 0 && (data[0] == '$' || data[0] == '!') && data.find('*') != std::string::npos) {
+      sentences.push_back(data);
+    }
+  }
+  return sentences;
+}
+
+TEST_CASE("NMEASentenceReader benchmark", "[.][benchmark]") {
+  std::vector<std::string> sentences = loadSampleSentences();
+  if (sentences.size() == 0) {
+    WARN("Run the benchmark from the root of the repository to load tools/nmea-tester/nmea-sample.log");
+    return;
+  }
+
+  std::vector<String> strings;
+  for (const std::string &s : sentences) {
+    strings.push_back(String(s.c_str()));
+  }
+
+  const int iterations = 200;
+  int stringValid = 0;
+  double stringSum = 0;
+  double stringNs = benchmarkNanoseconds(iterations, [&]() {
+    for (const String &s : strings) {
+      StringNMEASentenceReader r(s);
+      if (r.isValid()) {
+        stringValid++;
+        for (int i = 1; i <= r.countFields(); i++) {
+          double v = r.getFieldAsDouble(i);
+          stringSum += std::isnan(v) ? 0 : v;
+        }
+      }
+    }
+  });
+
+  int readerValid = 0;
+  double readerSum = 0;
+  double readerNs = benchmarkNanoseconds(iterations, [&]() {
+    for (const String &s : strings) {
+      NMEASentenceReader r(s);
+      if (r.isValid()) {
+        readerValid++;
+        for (int i = 1; i <= r.countFields(); i++) {
+          double v = r.getFieldAsDouble(i);
+          readerSum += std::isnan(v) ? 0 : v;
+        }
+      }
+    }
+  });
+
+  benchmarkReport("NMEA sample log - String reader (per sentence)", stringNs / strings.size());
+  benchmarkReport("NMEA sample log - NMEASentenceReader (per sentence)", readerNs / strings.size());
+
+  CHECK( readerValid == stringValid );
+  CHECK( readerSum == stringSum );
+}
+
+TEST_CASE("nmea_validate_lines benchmark", "[.][benchmark]") {
+  std::vector<std::string> sentences = loadSampleSentences();
+  if (sentences.size() == 0) {
+    WARN("Run the benchmark from the root of the repository to load tools/nmea-tester/nmea-sample.log");
+    return;
+  }
+
+  std::string buffer;
+  for (const std::string &s : sentences) {
+    buffer += s + "\r\n";
+  }
+
+  const int iterations = 200;
+  int lineValid = 0;
+  double lineNs = benchmarkNanoseconds(iterations, [&]() {
+    for (const std::string &s : sentences) {
+      if (nmea_is_valid(s.c_str())) {
+        lineValid++;
+      }
+    }
+  });
+
+  int batchValid = 0;
+  struct nmea_validation results[32];
+  double batchNs = benchmarkNanoseconds(iterations, [&]() {
+    const char *p = buffer.data();
+    size_t remaining = buffer.size();
+    size_t consumed;
+    size_t count;
+    while ((count = nmea_validate_lines(p, remaining, results, 32, &consumed)) > 0) {
+      for (size_t i = 0; i < count; i++) {
+        if (results[i].status == NMEA_VALID) {
+          batchValid++;
+        }
+      }
+      p += consumed;
+      remaining -= consumed;
+    }
+  });
+
+  benchmarkReport("NMEA sample log - nmea_is_valid (per sentence)", lineNs / sentences.size());
+  benchmarkReport("NMEA sample log - nmea_validate_lines (per sentence)", batchNs / sentences.size());
+
+  CHECK( batchValid == lineValid );
+}
+
+TEST_CASE("NMEA numeric fields benchmark", "[.][benchmark]") {
+  std::vector<std::string> sentences = loadSampleSentences();
+  if (sentences.size() == 0) {
+    WARN("Run the benchmark from the root of the repository to load tools/nmea-tester/nmea-sample.log");
+    return;
+  }
+
+  // Collect all the numeric fields of the log, each one NUL-terminated so
+  // that it can also be given to strtod().
+  std::vector<std::string> fields;
+  for (const std::string &s : sentences) {
+    NMEASentenceReader r(s.c_str());
+    for (int i = 1; i <= r.countFields(); i++) {
+      NMEAField f = r.getField(i);
+      NMEADecimal d;
+      if (f.toDecimal(d)) {
+        fields.push_back(std::string(f.data(), f.length()));
+      }
+    }
+  }
+
+  const int iterations = 200;
+  double strtodSum = 0;
+  double strtodNs = benchmarkNanoseconds(iterations, [&]() {
+    for (const std::string &f : fields) {
+      strtodSum += strtod(f.c_str(), 0);
+    }
+  });
+
+  double decimalSum = 0;
+  double decimalNs = benchmarkNanoseconds(iterations, [&]() {
+    for (const std::string &f : fields) {
+      NMEADecimal d;
+      NMEAField(f.c_str(), f.length()).toDecimal(d);
+      decimalSum += d.toDouble();
+    }
+  });
+
+  NMEASentenceReader gga("$GPGGA,003516.000,3751.6035,N,12228.8065,W,2,10,0.91,3.4,M,-25.2,M,0000,0000*5A");
+  double strtodLatLonSum = 0;
+  double strtodLatLonNs = benchmarkNanoseconds(iterations * 100, [&]() {
+    strtodLatLonSum += strtodLatLon(gga.getField(2), gga.getFieldAsChar(3)) +
+      strtodLatLon(gga.getField(4), gga.getFieldAsChar(5));
+  });
+
+  double latLonSum = 0;
+  double latLonNs = benchmarkNanoseconds(iterations * 100, [&]() {
+    latLonSum += gga.getFieldAsLatLon(2) + gga.getFieldAsLatLon(4);
+  });
+
+  benchmarkReport("NMEA numeric fields - strtod (per field)", strtodNs / fields.size());
+  benchmarkReport("NMEA numeric fields - NMEADecimal (per field)", decimalNs / fields.size());
+  benchmarkReport("NMEA GGA position - strtod (per position)", strtodLatLonNs);
+  benchmarkReport("NMEA GGA position - NMEADecimal (per position)", latLonNs);
+
+  CHECK( decimalSum == strtodSum );
+  CHECK( latLonSum == strtodLatLonSum );
+}
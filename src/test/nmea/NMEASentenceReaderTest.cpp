@@ -25,6 +25,9 @@
 #include "common/nmea/NMEASentenceReader.h"
 #include "../KBoxTest.h"
 #include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // We have a conflict here between KBox which uses math.h and Catch which uses cmath
 #define isnan(x) std::isnan(x)
@@ -125,3 +128,183 @@ TEST_CASE("NMEASentenceReader") {
   }
 }
 
+
+TEST_CASE("NMEASentenceReader fields") {
+  SECTION("fields are views inside the sentence") {
+    const char *sentence = "$GPRMC,144629.20,A,5156.91111,N,00434.80385,E,0.295,,011113,,,A*78";
+    NMEASentenceReader r(sentence);
+
+    NMEAField f = r.getField(1);
+    CHECK( f.data() == sentence + 7 );
+    CHECK( f.length() == 9 );
+    CHECK( f == "144629.20" );
+    CHECK( f != "144629.2" );
+    CHECK( f != "144629.200" );
+
+    CHECK( r.getField(0) == "GPRMC" );
+    CHECK( r.getField(8).isEmpty() );
+    CHECK( r.getField(12) == "A" );
+    CHECK( r.getField(13).isEmpty() );
+    CHECK( r.getField(-1).isEmpty() );
+  }
+
+  SECTION("checksum with lower case and single digit") {
+    CHECK( NMEASentenceReader("$GPRMC,144629.20,A,5156.91111,N,00434.80385,E,0.295,,011113,,,A*78").isValid() );
+    CHECK( NMEASentenceReader("$IIXDR,C,19.52,C,TempAir*19").isValid() );
+    CHECK( NMEASentenceReader("$AB,C*6c").isValid() );
+    CHECK( NMEASentenceReader("$TST,x*7").isValid() );
+    CHECK( ! NMEASentenceReader("$TST,x*8").isValid() );
+    CHECK( ! NMEASentenceReader("$TST,x*").isValid() );
+    CHECK( ! NMEASentenceReader("TST,x*07").isValid() );
+  }
+
+  SECTION("last field without terminator cannot be read") {
+    NMEASentenceReader r("$GPRMC,144629.20,A,5156.91");
+
+    CHECK( ! r.isValid() );
+    CHECK( r.countFields() == 3 );
+    CHECK( r.getFieldAsChar(2) == 'A' );
+    CHECK( r.getFieldAsString(3) == "" );
+  }
+
+  SECTION("sentences with more fields than the reader can index") {
+    String sentence = "$XXABC";
+    for (int i = 0; i < NMEASentenceReader::maxFields + 4; i++) {
+      sentence += ",1";
+    }
+    sentence += "*";
+    NMEASentenceReader r(sentence);
+
+    CHECK( r.countFields() == NMEASentenceReader::maxFields + 4 );
+    CHECK( r.getFieldAsDouble(NMEASentenceReader::maxFields - 1) == 1 );
+    CHECK( isnan(r.getFieldAsDouble(NMEASentenceReader::maxFields)) );
+  }
+}
+
+static bool sameDouble(double a, double b) {
+  return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static bool decimalMatchesStrtod(const char *s) {
+  NMEADecimal d;
+  if (!NMEAField(s, strlen(s)).toDecimal(d)) {
+    return false;
+  }
+  double value = d.toDouble();
+  if (d.mantissa == 0 && s[0] == '-') {
+    value = -0.0;
+  }
+  return sameDouble(value, strtod(s, 0));
+}
+
+TEST_CASE("NMEASentenceReader numbers") {
+  SECTION("fixed point decimals") {
+    NMEADecimal d;
+
+    REQUIRE( NMEAField("3751.6035", 9).toDecimal(d) );
+    CHECK( d.mantissa == 37516035 );
+    CHECK( d.decimals == 4 );
+
+    REQUIRE( NMEAField("-12.50", 6).toDecimal(d) );
+    CHECK( d.mantissa == -1250 );
+    CHECK( d.decimals == 2 );
+
+    REQUIRE( NMEAField("+7", 2).toDecimal(d) );
+    CHECK( d.mantissa == 7 );
+    CHECK( d.decimals == 0 );
+
+    REQUIRE( NMEAField("5.", 2).toDecimal(d) );
+    CHECK( d.mantissa == 5 );
+    REQUIRE( NMEAField(".5", 2).toDecimal(d) );
+    CHECK( d.mantissa == 5 );
+    CHECK( d.decimals == 1 );
+
+    // Leading zeros are not significant digits
+    REQUIRE( NMEAField("0000000000000000001.5", 21).toDecimal(d) );
+    CHECK( d.mantissa == 15 );
+
+    CHECK( !NMEAField("", 0).toDecimal(d) );
+    CHECK( !NMEAField("-", 1).toDecimal(d) );
+    CHECK( !NMEAField(".", 1).toDecimal(d) );
+    CHECK( !NMEAField("1.2.3", 5).toDecimal(d) );
+    CHECK( !NMEAField("1e5", 3).toDecimal(d) );
+    CHECK( !NMEAField("12a", 3).toDecimal(d) );
+    CHECK( !NMEAField(" 12", 3).toDecimal(d) );
+    CHECK( !NMEAField("1234567890123456", 16).toDecimal(d) );
+  }
+
+  SECTION("getFieldAsDouble keeps the strtod() behavior for other numbers") {
+    NMEASentenceReader r("$TST,1e3,abc,-0.0,1234567890.1234567,0x10*");
+
+    CHECK( r.getFieldAsDouble(1) == 1000 );
+    CHECK( r.getFieldAsDouble(2) == 0 );
+    CHECK( sameDouble(r.getFieldAsDouble(3), -0.0) );
+    CHECK( r.getFieldAsDouble(4) == 1234567890.1234567 );
+    CHECK( r.getFieldAsDouble(5) == 16 );
+  }
+
+  SECTION("all numbers with up to 5 digits match strtod") {
+    char s[16];
+    int mismatches = 0;
+    for (int n = 0; n < 100000; n++) {
+      for (int dot = 0; dot <= 5; dot++) {
+        char digits[8];
+        snprintf(digits, sizeof(digits), "%05i", n);
+        snprintf(s, sizeof(s), "%s%.*s.%s", n % 2 ? "-" : "", dot, digits, digits + dot);
+        if (!decimalMatchesStrtod(s)) {
+          mismatches++;
+        }
+      }
+    }
+    CHECK( mismatches == 0 );
+  }
+
+  SECTION("long numbers match strtod") {
+    // Deterministic pseudo-random numbers with 6 to 15 digits.
+    uint32_t seed = 42;
+    char s[20];
+    int mismatches = 0;
+    for (int i = 0; i < 100000; i++) {
+      int length = 6 + i % 10;
+      for (int j = 0; j < length; j++) {
+        seed = seed * 1664525 + 1013904223;
+        s[j] = '0' + (seed >> 24) % 10;
+      }
+      int dot = (seed >> 8) % (length + 1);
+      memmove(s + dot + 1, s + dot, length - dot);
+      s[dot] = '.';
+      s[length + 1] = '\0';
+      if (!decimalMatchesStrtod(s)) {
+        mismatches++;
+      }
+    }
+    CHECK( mismatches == 0 );
+  }
+
+  SECTION("latitudes and longitudes match the strtod() computation") {
+    char s[16];
+    char sentence[40];
+    int mismatches = 0;
+    for (int degrees = 0; degrees <= 180; degrees += 7) {
+      for (int minutes = 0; minutes < 600000; minutes += 937) {
+        snprintf(s, sizeof(s), "%03i%02i.%04i", degrees, minutes / 10000, minutes % 10000);
+        snprintf(sentence, sizeof(sentence), "$TST,%s,W*", s);
+        NMEASentenceReader r(sentence);
+
+        double expected = -(degrees + strtod(s + 3, 0) / 60);
+        if (!sameDouble(r.getFieldAsLatLon(1), expected)) {
+          mismatches++;
+        }
+      }
+    }
+    CHECK( mismatches == 0 );
+  }
+
+  SECTION("latitude without decimals") {
+    NMEASentenceReader r("$TST,2832,N,-2832.5,S,28x2.5,N*");
+
+    CHECK( r.getFieldAsLatLon(1) == Approx(28.533333) );
+    CHECK( isnan(r.getFieldAsLatLon(3)) );
+    CHECK( isnan(r.getFieldAsLatLon(5)) );
+  }
+}
@@ -0,0 +1,169 @@
+/*
+  The MIT License
+
+  Copyright (c) 2017 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string>
+#include "../KBoxTest.h"
+#include "common/nmea/NMEASerialFramer.h"
+
+/*
+ * A Stream that returns the bytes given to `receive()`.
+ */
+class MockStream : public Stream {
+  private:
+    std::string _rx;
+    size_t _position = 0;
+
+  public:
+    void receive(const char *data) {
+      _rx += data;
+    };
+
+    int available() override {
+      return _rx.size() - _position;
+    };
+
+    int read() override {
+      if (_position >= _rx.size()) {
+        return -1;
+      }
+      return (uint8_t)_rx[_position++];
+    };
+
+    int peek() override {
+      if (_position >= _rx.size()) {
+        return -1;
+      }
+      return (uint8_t)_rx[_position];
+    };
+
+    void flush() override {};
+
+    size_t write(uint8_t b) override {
+      return 1;
+    };
+};
+
+TEST_CASE("NMEASerialFramer") {
+  MockStream stream;
+  NMEASerialFramer framer(stream, 3, 64, KBoxEventNMEA1RXBufferOverflow, KBoxEventNMEA1RXOverflow,
+                          KBoxEventNMEA1RXError);
+
+  SECTION("empty stream") {
+    framer.poll();
+    CHECK( framer.size() == 0 );
+    CHECK( framer.front() == 0 );
+  }
+
+  SECTION("sentences split over multiple reads") {
+    stream.receive("$GPRMC,144629.20,A,5156.91111,N,0043");
+    framer.poll();
+    CHECK( framer.size() == 0 );
+
+    stream.receive("4.80385,E,0.295,,011113,,,A*78\r\n$IIMWV,056,R,5.19,N,A*1D\r\n$IIMWV");
+    framer.poll();
+    CHECK( framer.size() == 2 );
+    CHECK( String(framer.front()) == "$GPRMC,144629.20,A,5156.91111,N,00434.80385,E,0.295,,011113,,,A*78" );
+    framer.pop();
+    CHECK( String(framer.front()) == "$IIMWV,056,R,5.19,N,A*1D" );
+    framer.pop();
+    CHECK( framer.front() == 0 );
+
+    stream.receive(",027,T,3.82,N,A*19\n");
+    framer.poll();
+    CHECK( String(framer.front()) == "$IIMWV,027,T,3.82,N,A*19" );
+  }
+
+  SECTION("empty lines are ignored") {
+    stream.receive("\r\n\n\r$A\n\n");
+    framer.poll();
+    CHECK( framer.size() == 1 );
+    CHECK( String(framer.front()) == "$A" );
+  }
+
+  SECTION("queue overflow") {
+    uint32_t overflows = KBoxMetrics.countEvent(KBoxEventNMEA1RXOverflow);
+    stream.receive("$1\r\n$2\r\n$3\r\n$4\r\n");
+    framer.poll();
+
+    uint32_t newOverflows = KBoxMetrics.countEvent(KBoxEventNMEA1RXOverflow) - overflows;
+    CHECK( newOverflows == 1 );
+    CHECK( framer.size() == 3 );
+
+    // Slots are reused once the consumer catches up
+    framer.pop();
+    stream.receive("$5\r\n");
+    framer.poll();
+    CHECK( framer.size() == 3 );
+    CHECK( String(framer.front()) == "$2" );
+    framer.pop();
+    framer.pop();
+    CHECK( String(framer.front()) == "$5" );
+  }
+
+  SECTION("sentences that are too long are discarded") {
+    uint32_t errors = KBoxMetrics.countEvent(KBoxEventNMEA1RXError);
+
+    std::string tooLong = "$";
+    tooLong.append(NMEASerialFramer::maxSentenceLength, 'X');
+    stream.receive(tooLong.c_str());
+    stream.receive("\r\n$OK\r\n");
+    framer.poll();
+
+    uint32_t newErrors = KBoxMetrics.countEvent(KBoxEventNMEA1RXError) - errors;
+    CHECK( newErrors == 1 );
+    CHECK( framer.size() == 1 );
+    CHECK( String(framer.front()) == "$OK" );
+  }
+
+  SECTION("longest valid sentence") {
+    std::string longest = "$";
+    longest.append(NMEASerialFramer::maxSentenceLength - 2, 'X');
+    stream.receive(longest.c_str());
+    stream.receive("\r\n");
+    framer.poll();
+
+    CHECK( framer.size() == 1 );
+    CHECK( strlen(framer.front()) == NMEASerialFramer::maxSentenceLength - 1 );
+  }
+
+  SECTION("full receive buffer") {
+    uint32_t bufferOverflows = KBoxMetrics.countEvent(KBoxEventNMEA1RXBufferOverflow);
+    // A full receive buffer of 64 bytes holds 63 bytes.
+    std::string data(63, 'X');
+    stream.receive(data.c_str());
+    framer.poll();
+
+    uint32_t newBufferOverflows = KBoxMetrics.countEvent(KBoxEventNMEA1RXBufferOverflow) - bufferOverflows;
+    CHECK( newBufferOverflows == 1 );
+  }
+
+  SECTION("receive buffer not full") {
+    uint32_t bufferOverflows = KBoxMetrics.countEvent(KBoxEventNMEA1RXBufferOverflow);
+    std::string data(62, 'X');
+    stream.receive(data.c_str());
+    framer.poll();
+
+    CHECK( KBoxMetrics.countEvent(KBoxEventNMEA1RXBufferOverflow) == bufferOverflows );
+  }
+}
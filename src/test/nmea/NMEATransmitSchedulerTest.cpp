@@ -0,0 +1,216 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string>
+#include "../KBoxTest.h"
+#include "common/nmea/NMEATransmitScheduler.h"
+
+/*
+ * A Print that keeps everything written to it.
+ */
+class MockOutput : public Print {
+  public:
+    std::string written;
+
+    size_t write(uint8_t b) override {
+      written += (char)b;
+      return 1;
+    };
+};
+
+static uint32_t schedulerMillis = 0;
+static uint32_t schedulerMillisProvider() {
+  return schedulerMillis;
+}
+
+static const enum KBoxEvent dropEvents[NMEATransmitPriorityCount] = {
+  KBoxEventNMEA1TXDropHighPriority, KBoxEventNMEA1TXDropNormalPriority, KBoxEventNMEA1TXDropLowPriority
+};
+
+static const char *rmc = "$GPRMC,003516.000,A,3751.6035,N,12228.8065,W,0.01,0.00,030416,,,D*79";
+static const char *hdm = "$IIHDM,123.4,M*26";
+static const char *mwvApparent = "$IIMWV,45.0,R,12.0,N,A*3F";
+static const char *mwvApparent2 = "$IIMWV,46.0,R,12.5,N,A*39";
+static const char *mwvTrue = "$IIMWV,60.0,T,10.0,N,A*3C";
+static const char *xdrAttitude = "$IIXDR,A,-2.0,D,PTCH,A,5.0,D,ROLL*76";
+static const char *xdrAttitude2 = "$IIXDR,A,-2.5,D,PTCH,A,4.0,D,ROLL*72";
+static const char *xdrVoltage = "$IIXDR,U,12.60,V,house*02";
+static const char *vdm = "!AIVDM,1,1,,B,15MgK45P3@G?fl0E`JbR0OwT0@MS,0*4D";
+
+TEST_CASE("NMEATransmitScheduler") {
+  KBoxMetrics.reset();
+  schedulerMillis = 0;
+  MockOutput output;
+
+  SECTION("priority of sentences") {
+    CHECK( NMEATransmitScheduler::priorityOf(rmc) == NMEATransmitPriorityHigh );
+    CHECK( NMEATransmitScheduler::priorityOf(hdm) == NMEATransmitPriorityHigh );
+    CHECK( NMEATransmitScheduler::priorityOf(mwvTrue) == NMEATransmitPriorityNormal );
+    CHECK( NMEATransmitScheduler::priorityOf(vdm) == NMEATransmitPriorityNormal );
+    CHECK( NMEATransmitScheduler::priorityOf(xdrAttitude) == NMEATransmitPriorityLow );
+    CHECK( NMEATransmitScheduler::priorityOf("$PGRME,15.0,M,45.0,M,25.0,M*1C") == NMEATransmitPriorityLow );
+    CHECK( NMEATransmitScheduler::priorityOf("garbage") == NMEATransmitPriorityLow );
+  }
+
+  SECTION("sentences are sent by priority and then in order") {
+    NMEATransmitScheduler scheduler(0, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+
+    CHECK( scheduler.enqueue(xdrAttitude) );
+    CHECK( scheduler.enqueue(mwvApparent) );
+    CHECK( scheduler.enqueue(rmc) );
+    CHECK( scheduler.enqueue(mwvTrue) );
+    CHECK( scheduler.enqueue(hdm) );
+
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityHigh) == 2 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityNormal) == 2 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityLow) == 1 );
+
+    CHECK( scheduler.drain(output, 1000) == 5 );
+    std::string expected = std::string(rmc) + "\r\n" + hdm + "\r\n" + mwvApparent + "\r\n"
+      + mwvTrue + "\r\n" + xdrAttitude + "\r\n";
+    CHECK( output.written == expected );
+
+    uint32_t sent = KBoxMetrics.countEvent(KBoxEventNMEA1TX);
+    CHECK( sent == 5 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityHigh) == 0 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityNormal) == 0 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityLow) == 0 );
+  }
+
+  SECTION("sentences of the same type replace each other") {
+    NMEATransmitScheduler scheduler(0, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+
+    CHECK( scheduler.enqueue(xdrAttitude) );
+    CHECK( scheduler.enqueue(mwvApparent) );
+    CHECK( scheduler.enqueue(xdrVoltage) );
+    CHECK( scheduler.enqueue(mwvTrue) );
+    CHECK( scheduler.enqueue(xdrAttitude2) );
+    CHECK( scheduler.enqueue(mwvApparent2) );
+
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityNormal) == 2 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityLow) == 2 );
+    CHECK( scheduler.getCoalesced(NMEATransmitPriorityNormal) == 1 );
+    CHECK( scheduler.getCoalesced(NMEATransmitPriorityLow) == 1 );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityLow) == 0 );
+
+    // The newest sentence takes the place of the one it replaced.
+    scheduler.drain(output, 1000);
+    std::string expected = std::string(mwvApparent2) + "\r\n" + mwvTrue + "\r\n"
+      + xdrAttitude2 + "\r\n" + xdrVoltage + "\r\n";
+    CHECK( output.written == expected );
+  }
+
+  SECTION("AIS messages are never replaced") {
+    NMEATransmitScheduler scheduler(0, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+
+    CHECK( scheduler.enqueue(vdm) );
+    CHECK( scheduler.enqueue(vdm) );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityNormal) == 2 );
+    CHECK( scheduler.getCoalesced(NMEATransmitPriorityNormal) == 0 );
+  }
+
+  SECTION("sentences are sent at the speed of the port") {
+    // 4800 bauds is 480 bytes per second and the budget holds 82 bytes.
+    NMEATransmitScheduler scheduler(4800, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+    scheduler.setMillisecondsProvider(schedulerMillisProvider);
+
+    // 71 bytes and 19 bytes with "\r\n".
+    scheduler.enqueue(rmc);
+    scheduler.enqueue(hdm);
+
+    CHECK( scheduler.drain(output, 1000) == 1 );
+    CHECK( output.written == std::string(rmc) + "\r\n" );
+
+    // 11 + 4.8 bytes
+    schedulerMillis = 10;
+    CHECK( scheduler.drain(output, 1000) == 0 );
+
+    // 11 + 9.6 bytes
+    schedulerMillis = 20;
+    CHECK( scheduler.drain(output, 1000) == 1 );
+    CHECK( output.written == std::string(rmc) + "\r\n" + hdm + "\r\n" );
+  }
+
+  SECTION("sentences are only written if they fit in the output buffer") {
+    NMEATransmitScheduler scheduler(0, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+
+    scheduler.enqueue(hdm);
+    CHECK( scheduler.drain(output, 18) == 0 );
+    CHECK( scheduler.drain(output, 19) == 1 );
+    CHECK( output.written == std::string(hdm) + "\r\n" );
+  }
+
+  SECTION("lower priority sentences are dropped when the queue is full") {
+    NMEATransmitScheduler scheduler(0, 2, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+
+    CHECK( scheduler.enqueue(xdrAttitude) );
+    CHECK( scheduler.enqueue(xdrVoltage) );
+
+    // The oldest transducer sentence makes room for the position.
+    CHECK( scheduler.enqueue(rmc) );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityLow) == 1 );
+
+    // And the other one for the heading.
+    CHECK( scheduler.enqueue(hdm) );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityLow) == 2 );
+
+    // Wind cannot replace the position or the heading.
+    CHECK( !scheduler.enqueue(mwvTrue) );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityNormal) == 1 );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityHigh) == 0 );
+
+    uint32_t droppedLow = KBoxMetrics.countEvent(KBoxEventNMEA1TXDropLowPriority);
+    uint32_t droppedNormal = KBoxMetrics.countEvent(KBoxEventNMEA1TXDropNormalPriority);
+    uint32_t overflow = KBoxMetrics.countEvent(KBoxEventNMEA1TXOverflow);
+    CHECK( droppedLow == 2 );
+    CHECK( droppedNormal == 1 );
+    CHECK( overflow == 3 );
+
+    scheduler.drain(output, 1000);
+    CHECK( output.written == std::string(rmc) + "\r\n" + hdm + "\r\n" );
+  }
+
+  SECTION("sentences which waited too long are dropped") {
+    NMEATransmitScheduler scheduler(4800, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+    scheduler.setMillisecondsProvider(schedulerMillisProvider);
+
+    scheduler.enqueue(hdm);
+    schedulerMillis = 1000;
+    scheduler.enqueue(mwvTrue);
+
+    schedulerMillis = 2001;
+    CHECK( scheduler.drain(output, 1000) == 1 );
+    CHECK( output.written == std::string(mwvTrue) + "\r\n" );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityHigh) == 1 );
+    CHECK( scheduler.getQueueDepth(NMEATransmitPriorityHigh) == 0 );
+  }
+
+  SECTION("sentences that are too long are dropped") {
+    NMEATransmitScheduler scheduler(0, 8, KBoxEventNMEA1TX, KBoxEventNMEA1TXOverflow, dropEvents);
+
+    std::string tooLong = "$IIXDR," + std::string(80, 'A');
+    CHECK( !scheduler.enqueue(SKNMEASentence(tooLong.c_str())) );
+    CHECK( scheduler.getDropped(NMEATransmitPriorityLow) == 1 );
+  }
+}
@@ -0,0 +1,89 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <string.h>
+#include <N2kMsg.h>
+#include "../KBoxTest.h"
+#include "common/nmea/PCDINEncoder.h"
+
+static void setData(tN2kMsg &msg, const unsigned char *data, int length) {
+  for (int i = 0; i < length; i++) {
+    msg.Data[i] = data[i];
+  }
+  msg.DataLen = length;
+}
+
+TEST_CASE("PCDINEncoder") {
+  PCDINEncoder encoder;
+  tN2kMsg msg;
+
+  SECTION("empty encoder") {
+    CHECK( encoder.getSentence() == "" );
+    CHECK( encoder.getSentence().length() == 0 );
+  }
+
+  SECTION("heading message") {
+    const unsigned char data[] = { 0xff, 0x8c, 0x1c, 0x00, 0x00, 0xff, 0x7f, 0xfd };
+    msg.PGN = 127250;
+    msg.Source = 0x23;
+    setData(msg, data, sizeof(data));
+
+    REQUIRE( encoder.encode(msg, 0x12AB34CD) );
+    SKNMEASentence s = encoder.getSentence();
+    CHECK( s == "$PCDIN,01F112,12AB34CD,23,FF8C1C0000FF7FFD*5E" );
+    CHECK( s.length() == strlen(s.c_str()) );
+    CHECK( s.isValid() );
+  }
+
+  SECTION("short message and null values") {
+    const unsigned char data[] = { 0x14, 0xf0, 0x01 };
+    msg.PGN = 59904;
+    msg.Source = 0;
+    setData(msg, data, sizeof(data));
+
+    REQUIRE( encoder.encode(msg, 0) );
+    CHECK( encoder.getSentence() == "$PCDIN,00EA00,00000000,00,14F001*26" );
+  }
+
+  SECTION("longest message fits in the buffer") {
+    msg.PGN = 126996;
+    msg.Source = 1;
+    for (int i = 0; i < tN2kMsg::MaxDataLen; i++) {
+      msg.Data[i] = i;
+    }
+    msg.DataLen = tN2kMsg::MaxDataLen;
+
+    REQUIRE( encoder.encode(msg, 1000) );
+    CHECK( encoder.getSentence().length() == PCDINEncoder::maxSentenceLength - 1 );
+    CHECK( encoder.getSentence().isValid() );
+  }
+
+  SECTION("invalid length") {
+    msg.PGN = 127250;
+    msg.DataLen = tN2kMsg::MaxDataLen + 1;
+
+    CHECK( !encoder.encode(msg, 0) );
+    CHECK( encoder.getSentence().length() == 0 );
+  }
+}
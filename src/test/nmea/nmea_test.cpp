@@ -22,6 +22,8 @@
   THE SOFTWARE.
 */
 
+#include <stdio.h>
+#include <string.h>
 #include "../KBoxTest.h"
 #include "common/nmea/nmea.h"
 
@@ -62,3 +64,119 @@ TEST_CASE("nmea basic") {
     REQUIRE( !nmea_is_valid("$IIRMB,V,,%çÿÝÕ_£ÿíÿuóÜ;»Õ·_ÖÿW5ÿÙ") );
   }
 }
+
+TEST_CASE("nmea_validate") {
+  struct nmea_validation v;
+
+  WHEN("sentence is valid") {
+    const char *s = "$IIMTW,8.0,C*2B\r\n";
+    REQUIRE( nmea_validate(s, &v) == NMEA_VALID );
+    CHECK( v.status == NMEA_VALID );
+    CHECK( v.sentence.start == s );
+    CHECK( v.sentence.length == 15 );
+    CHECK( v.payload.start == s + 1 );
+    CHECK( v.payload.length == 11 );
+  }
+
+  WHEN("the checksum only has one digit") {
+    CHECK( nmea_validate("$IIMTW,8.0,C*2B", 0) == NMEA_VALID );
+    CHECK( nmea_validate("$A*1", 0) == NMEA_INVALID_CHECKSUM );
+    CHECK( nmea_validate("$A*41", 0) == NMEA_VALID );
+    CHECK( nmea_validate("$AB*3", 0) == NMEA_VALID );
+  }
+
+  WHEN("sentence does not start with $ or !") {
+    CHECK( nmea_validate("IIMTW,8.0,C*2B", &v) == NMEA_INVALID_START );
+    CHECK( nmea_validate("", 0) == NMEA_INVALID_START );
+    CHECK( nmea_validate(0, 0) == NMEA_INVALID_START );
+  }
+
+  WHEN("checksum is missing") {
+    CHECK( nmea_validate("$IIMTW,8", &v) == NMEA_MISSING_CHECKSUM );
+    CHECK( v.payload.length == 7 );
+    CHECK( nmea_validate("$IIMTW,8*", 0) == NMEA_MISSING_CHECKSUM );
+    CHECK( nmea_validate("$IIMTW,8\r\n*2B", 0) == NMEA_MISSING_CHECKSUM );
+  }
+
+  WHEN("checksum is wrong") {
+    CHECK( nmea_validate("$IIMTW,8.0,C*2C", &v) == NMEA_INVALID_CHECKSUM );
+    CHECK( v.sentence.length == 15 );
+  }
+}
+
+TEST_CASE("nmea_validate_lines") {
+  struct nmea_validation results[8];
+  size_t consumed;
+
+  WHEN("buffer contains multiple lines") {
+    const char *buffer =
+      "$GPGGA,003516.000,3751.6035,N,12228.8065,W,2,10,0.91,3.4,M,-25.2,M,0000,0000*5A\r\n"
+      "\r\n"
+      "$IIMTW,8.0,C*2C\n"
+      "GPGGA,xxxx,*00\r\n"
+      "!AIVDM,1,1,,B,ENkb9I9I7@@@@@@@@@@@@@@@@@@;V4=v:nv;h00003vP000,2*54\r\n"
+      "$IIMTW,8\r\n"
+      "$IIMTW,8.0,C*2B\r\n";
+
+    size_t count = nmea_validate_lines(buffer, strlen(buffer), results, 8, &consumed);
+
+    REQUIRE( count == 6 );
+    CHECK( consumed == strlen(buffer) );
+    CHECK( results[0].status == NMEA_VALID );
+    CHECK( results[0].sentence.start == buffer );
+    CHECK( results[0].sentence.length == 79 );
+    CHECK( results[1].status == NMEA_INVALID_CHECKSUM );
+    CHECK( results[2].status == NMEA_INVALID_START );
+    CHECK( results[3].status == NMEA_VALID );
+    CHECK( results[4].status == NMEA_MISSING_CHECKSUM );
+    CHECK( results[5].status == NMEA_VALID );
+    CHECK( results[5].payload.length == 11 );
+  }
+
+  WHEN("the last line is not terminated") {
+    const char *buffer = "$IIMTW,8.0,C*2B\r\n$GPGGA,003516.000,3751.6035,N,12228.8065,W,2,10,0.91,3.4,M,-25";
+
+    size_t count = nmea_validate_lines(buffer, strlen(buffer), results, 8, &consumed);
+
+    REQUIRE( count == 1 );
+    CHECK( results[0].status == NMEA_VALID );
+    CHECK( consumed == 17 );
+  }
+
+  WHEN("there are more lines than results") {
+    const char *buffer = "$IIMTW,8.0,C*2B\r\n$IIMTW,8.0,C*2B\r\n$IIMTW,8.0,C*2B\r\n";
+
+    size_t count = nmea_validate_lines(buffer, strlen(buffer), results, 2, &consumed);
+
+    CHECK( count == 2 );
+    CHECK( consumed == 34 );
+  }
+
+  WHEN("results match nmea_validate for every length and alignment") {
+    // Exercise the word-at-a-time loop with the '*' at every position of a
+    // word and with the line starting at every offset of a word.
+    char sentence[40];
+    char buffer[64];
+    for (int length = 0; length < 20; length++) {
+      sentence[0] = '$';
+      for (int i = 0; i < length; i++) {
+        sentence[1 + i] = 'A' + i;
+      }
+      sentence[1 + length] = '*';
+      uint8_t checksum = nmea_compute_checksum(sentence);
+      snprintf(sentence + 2 + length, sizeof(sentence) - 2 - length, "%02X", checksum);
+
+      for (int offset = 0; offset < 8; offset++) {
+        memset(buffer, '\n', offset);
+        snprintf(buffer + offset, sizeof(buffer) - offset, "%s\r\n", sentence);
+
+        size_t count = nmea_validate_lines(buffer, strlen(buffer), results, 8, &consumed);
+        REQUIRE( count == 1 );
+        CHECK( results[0].status == NMEA_VALID );
+        CHECK( results[0].payload.length == (size_t)length );
+        CHECK( results[0].sentence.length == strlen(sentence) );
+        CHECK( consumed == strlen(buffer) );
+      }
+    }
+  }
+}
@@ -0,0 +1,191 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "../KBoxAllocationCounter.h"
+#include "common/signalk/SKAISParser.h"
+#include "common/signalk/SKNMEAParser.h"
+#include "common/signalk/SKUnits.h"
+#include "util.h"
+
+static SKContext contextForMMSI(uint32_t mmsi) {
+  char urn[32];
+  SKAISParser::urnForMMSI(mmsi, urn, sizeof(urn));
+  return SKContext(urn);
+}
+
+TEST_CASE("SKAISParser") {
+  SKAISParser ais(32);
+  SKNMEAParser p;
+  p.setAISParser(ais);
+
+  SECTION("AIS sentences are ignored without an AIS parser") {
+    SKNMEAParser withoutAIS;
+    const SKUpdate& update = withoutAIS.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C", SKTime(0));
+    CHECK( update.getSize() == 0 );
+  }
+
+  SECTION("AIS parser is shared by the NMEA parsers") {
+    SKNMEAParser other;
+    other.setAISParser(ais);
+    const SKUpdate& update = other.parse(SKSourceInputNMEA0183_2, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C", SKTime(0));
+    CHECK( update.getSize() == 5 );
+    CHECK( update.getSource().getLabel() == "kbox.nmea0183.2" );
+    CHECK( ais.getTargets().find(477553000) != 0 );
+  }
+
+  SECTION("Class A position report") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C", SKTime(0));
+
+    CHECK( update.getSize() == 5 );
+    CHECK( update.getContext().getURN() == "urn:mrn:imo:mmsi:477553000" );
+    CHECK( update.getContext() == contextForMMSI(477553000) );
+    CHECK( update.getSource().getLabel() == "kbox.nmea0183.1" );
+    CHECK( update.getNavigationPosition().latitude == ApproxDegrees(28549700 / 600000.0) );
+    CHECK( update.getNavigationPosition().longitude == ApproxDegrees(-73407500 / 600000.0) );
+    CHECK( update.getNavigationSpeedOverGround() == 0 );
+    CHECK( update.getNavigationCourseOverGroundTrue() == SKDegToRad(51.0) );
+    CHECK( update.getNavigationHeadingTrue() == SKDegToRad(181.0) );
+    CHECK( update.getNavigationRateOfTurn() == 0 );
+
+    const AISTarget *target = ais.getTargets().find(477553000);
+    REQUIRE( target );
+    CHECK( target->toBow == 0 );
+  }
+
+  SECTION("Position reports do not allocate memory") {
+    KBOX_REQUIRE_ALLOCATION_COUNTER();
+    String sentence1("!AIVDM,1,1,,B,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5C");
+    String sentence2("!AIVDM,1,1,,A,B5NJ;PP005l4ot5Isbl03wsUkP06,0*76");
+    String own("!AIVDO,1,1,,,177KQJ5000G?tO`K>RA1wUbN0TKH,0*1C");
+    KBoxAllocationCounter allocations;
+    const SKUpdate& u1 = p.parse(SKSourceInputNMEA0183_1, sentence1, SKTime(0));
+    uint32_t size1 = u1.getSize();
+    const SKUpdate& u2 = p.parse(SKSourceInputNMEA0183_1, sentence2, SKTime(0));
+    uint32_t size2 = u2.getSize();
+    const SKUpdate& u3 = p.parse(SKSourceInputNMEA0183_1, own, SKTime(0));
+    uint32_t size3 = u3.getSize();
+    // Catch allocates memory in CHECK() so we need to read the counter first.
+    uint32_t allocationCount = allocations.count();
+
+    CHECK( allocationCount == 0 );
+    CHECK( size1 == 5 );
+    CHECK( size2 == 3 );
+    CHECK( size3 == 5 );
+  }
+
+  SECTION("Static and voyage data") {
+    const SKUpdate& first = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,2,1,1,A,55?MbV02;H;s<HtKR20EHE:0@T4@Dn2222222216L961O5Gf0NSQEp6ClRp8,0*1C", SKTime(0));
+    CHECK( first.getSize() == 0 );
+
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,2,2,1,A,88888888880,2*25", SKTime(0));
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getContext() == contextForMMSI(351759000) );
+    CHECK( update.getDesignLengthOverall() == 295 );
+    CHECK( update.getDesignBeam() == 32 );
+    CHECK( update.getDesignDraftCurrent() == 12.2 );
+
+    const AISTarget *target = ais.getTargets().find(351759000);
+    REQUIRE( target );
+    CHECK( target->toBow == 225 );
+    CHECK( target->toStern == 70 );
+    CHECK( target->toPort == 1 );
+    CHECK( target->toStarboard == 31 );
+  }
+
+  SECTION("Class B position report") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,A,B5NJ;PP005l4ot5Isbl03wsUkP06,0*76", SKTime(0));
+
+    // Heading is not available
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getContext() == contextForMMSI(367430530) );
+    CHECK( update.getNavigationPosition().latitude == ApproxDegrees(22671021 / 600000.0) );
+    CHECK( update.getNavigationPosition().longitude == ApproxDegrees(-73360392 / 600000.0) );
+    CHECK( update.getNavigationSpeedOverGround() == 0 );
+    CHECK( update.getNavigationCourseOverGroundTrue() == 0 );
+    CHECK( !update.hasNavigationHeadingTrue() );
+  }
+
+  SECTION("Class B extended position report") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,B,C5N3SRgPEnJGEBT>NhWAwwo862PaLELTBJ:V00000000S0D:R220,0*0B", SKTime(0));
+
+    CHECK( update.getSize() == 5 );
+    CHECK( update.getContext() == contextForMMSI(367059850) );
+    CHECK( update.getNavigationSpeedOverGround() == SKKnotToMs(8.7) );
+    CHECK( update.getNavigationCourseOverGroundTrue() == SKDegToRad(335.9) );
+    CHECK( update.getDesignLengthOverall() == 26 );
+    CHECK( update.getDesignBeam() == 8 );
+
+    const AISTarget *target = ais.getTargets().find(367059850);
+    REQUIRE( target );
+    CHECK( target->toBow + target->toStern == 26 );
+  }
+
+  SECTION("Position reports include the known dimensions") {
+    const SKUpdate& unknown = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,A,B5NJ;PP005l4ot5Isbl03wsUkP06,0*76", SKTime(0));
+    CHECK( unknown.getSize() == 3 );
+    CHECK( !unknown.hasDesignLengthOverall() );
+
+    const SKUpdate& partB = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,A,H5NJ;PTU000000000000001@5230,0*40", SKTime(0));
+    CHECK( partB.getDesignLengthOverall() == 15 );
+    CHECK( partB.getDesignBeam() == 5 );
+
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,A,B5NJ;PP005l4ot5Isbl03wsUkP06,0*76", SKTime(0));
+    CHECK( update.getSize() == 5 );
+    CHECK( update.getContext() == contextForMMSI(367430530) );
+    CHECK( update.getNavigationSpeedOverGround() == 0 );
+    CHECK( update.getDesignLengthOverall() == 15 );
+    CHECK( update.getDesignBeam() == 5 );
+  }
+
+  SECTION("Static data report") {
+    const SKUpdate& partA = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,A,H42O55i18tMET00000000000000,2*6D", SKTime(0));
+    CHECK( partA.getSize() == 0 );
+
+    const SKUpdate& partB = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,A,H42O55lti4hhhilD3nink000?050,0*40", SKTime(0));
+    CHECK( partB.getSize() == 2 );
+    CHECK( partB.getContext() == contextForMMSI(271041815) );
+    CHECK( partB.getDesignLengthOverall() == 15 );
+    CHECK( partB.getDesignBeam() == 5 );
+
+    const AISTarget *target = ais.getTargets().find(271041815);
+    REQUIRE( target );
+    CHECK( target->toBow + target->toStern == 15 );
+  }
+
+  SECTION("Own vessel report") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDO,1,1,,,177KQJ5000G?tO`K>RA1wUbN0TKH,0*1C", SKTime(0));
+
+    CHECK( update.getSize() == 5 );
+    CHECK( update.getContext() == SKContextSelf );
+    CHECK( ais.getTargets().getSize() == 0 );
+  }
+
+  SECTION("Unsupported message type") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "!AIVDM,1,1,,B,477KQJ5000G?tO`K>RA1wUbN0TKH,0*59", SKTime(0));
+
+    CHECK( update.getSize() == 0 );
+    CHECK( ais.getTargets().getSize() == 0 );
+  }
+}
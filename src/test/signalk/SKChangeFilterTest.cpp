@@ -0,0 +1,255 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "../KBoxTest.h"
+#include "common/signalk/SKChangeFilter.h"
+#include "common/signalk/SKHub.h"
+#include "common/signalk/SKNMEAConverter.h"
+#include "common/signalk/SKSubscriber.h"
+#include "common/signalk/SKUpdateStatic.h"
+#include "common/stats/KBoxMetrics.h"
+
+class ChangeFilterSubscriber : public SKSubscriber {
+  public:
+    int count = 0;
+    int lastSize = 0;
+    bool lastHadSOG = false;
+    bool lastHadCOG = false;
+
+    void updateReceived(const SKUpdate& u) {
+      count++;
+      lastSize = u.getSize();
+      lastHadSOG = u.hasNavigationSpeedOverGround();
+      lastHadCOG = u.hasNavigationCourseOverGroundTrue();
+    };
+};
+
+class ChangeFilterNMEAOutput : public SKNMEAOutput {
+  public:
+    int mwvCount = 0;
+
+    bool write(const SKNMEASentence& s) override {
+      if (strncmp(s.c_str() + 3, "MWV", 3) == 0) {
+        mwvCount++;
+      }
+      return true;
+    };
+};
+
+class NMEAConverterSubscriber : public SKSubscriber {
+  private:
+    SKNMEAConverter &_converter;
+    SKNMEAOutput &_output;
+
+  public:
+    NMEAConverterSubscriber(SKNMEAConverter &converter, SKNMEAOutput &output) :
+      _converter(converter), _output(output) {};
+
+    void updateReceived(const SKUpdate& u) {
+      _converter.convert(u, _output);
+    };
+};
+
+static uint32_t fakeMillis = 0;
+static uint32_t fakeMillisProvider() {
+  return fakeMillis;
+}
+
+TEST_CASE("SKChangeFilter") {
+  SKChangeFilterConfig config;
+  config.epsilon = 0;
+  config.maxAge = 1000;
+  config.rules[0] = { SKPathNavigationSpeedOverGround, 0.1, 5000 };
+  config.rules[1] = { SKPathElectricalBatteriesVoltage, 0.05, 10000 };
+  config.rulesCount = 2;
+
+  SKHub output;
+  ChangeFilterSubscriber sub;
+  output.subscribe(&sub);
+
+  fakeMillis = 0;
+  SKChangeFilter filter(config, output, 16);
+  filter.setMillisecondsProvider(fakeMillisProvider);
+
+  SECTION("first value is always sent") {
+    SKUpdateStatic<1> u;
+    u.setNavigationSpeedOverGround(4.2);
+    filter.updateReceived(u);
+
+    CHECK( sub.count == 1 );
+  }
+
+  SECTION("values within epsilon are suppressed") {
+    uint32_t suppressed = KBoxMetrics.countEvent(KBoxEventSKChangeFilterSuppressed);
+
+    SKUpdateStatic<1> u;
+    u.setNavigationSpeedOverGround(4.2);
+    filter.updateReceived(u);
+    u.setNavigationSpeedOverGround(4.25);
+    filter.updateReceived(u);
+    u.setNavigationSpeedOverGround(4.15);
+    filter.updateReceived(u);
+
+    CHECK( sub.count == 1 );
+    CHECK( KBoxMetrics.countEvent(KBoxEventSKChangeFilterSuppressed) == suppressed + 2 );
+
+    // Differences are measured from the last value sent.
+    u.setNavigationSpeedOverGround(4.31);
+    filter.updateReceived(u);
+    CHECK( sub.count == 2 );
+  }
+
+  SECTION("exact repetitions are suppressed with an epsilon of 0") {
+    SKUpdateStatic<1> u;
+    u.setNavigationCourseOverGroundTrue(1.0);
+    filter.updateReceived(u);
+    filter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    u.setNavigationCourseOverGroundTrue(1.001);
+    filter.updateReceived(u);
+    CHECK( sub.count == 2 );
+  }
+
+  SECTION("values are sent again after maxAge") {
+    SKUpdateStatic<1> u;
+    u.setNavigationSpeedOverGround(4.2);
+    filter.updateReceived(u);
+
+    fakeMillis = 4999;
+    filter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    fakeMillis = 5000;
+    filter.updateReceived(u);
+    CHECK( sub.count == 2 );
+
+    // Paths without a rule use the default maxAge.
+    SKUpdateStatic<1> cog;
+    cog.setNavigationCourseOverGroundTrue(1.0);
+    filter.updateReceived(cog);
+    fakeMillis = 5999;
+    filter.updateReceived(cog);
+    CHECK( sub.count == 3 );
+    fakeMillis = 6000;
+    filter.updateReceived(cog);
+    CHECK( sub.count == 4 );
+  }
+
+  SECTION("the whole update is sent when one value changed") {
+    SKUpdateStatic<2> u;
+    u.setNavigationSpeedOverGround(4.2);
+    u.setNavigationCourseOverGroundTrue(1.0);
+    filter.updateReceived(u);
+    CHECK( sub.count == 1 );
+    CHECK( sub.lastSize == 2 );
+
+    u.setNavigationSpeedOverGround(4.21);
+    u.setNavigationCourseOverGroundTrue(1.1);
+    filter.updateReceived(u);
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastSize == 2 );
+    CHECK( sub.lastHadCOG );
+    CHECK( sub.lastHadSOG );
+
+    // SOG is compared to the last value sent (4.21), not to 4.2.
+    u.setNavigationSpeedOverGround(4.3);
+    filter.updateReceived(u);
+    CHECK( sub.count == 2 );
+  }
+
+  SECTION("wind is still converted when only the angle changes") {
+    SKNMEAConverterConfig converterConfig;
+    SKNMEAConverter converter(converterConfig);
+    ChangeFilterNMEAOutput nmea;
+    NMEAConverterSubscriber converterSubscriber(converter, nmea);
+    output.subscribe(&converterSubscriber);
+
+    SKUpdateStatic<2> u;
+    u.setEnvironmentWindAngleApparent(0.5);
+    u.setEnvironmentWindSpeedApparent(5);
+    filter.updateReceived(u);
+    CHECK( nmea.mwvCount == 1 );
+
+    u.setEnvironmentWindAngleApparent(0.6);
+    filter.updateReceived(u);
+    CHECK( nmea.mwvCount == 2 );
+  }
+
+  SECTION("indexed paths and sources are filtered separately") {
+    SKUpdateStatic<2> u;
+    u.setElectricalBatteriesVoltage("house", 12.5);
+    u.setElectricalBatteriesVoltage("engine", 12.5);
+    filter.updateReceived(u);
+    filter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    SKUpdateStatic<2> other;
+    other.setSource(SKSource::sourceForNMEA0183(SKSourceInputNMEA0183_1, "II", "XDR"));
+    other.setElectricalBatteriesVoltage("house", 12.5);
+    filter.updateReceived(other);
+    CHECK( sub.count == 2 );
+  }
+
+  SECTION("other vessels are not filtered and do not use the table") {
+    SKUpdateStatic<1> u;
+    u.setNavigationSpeedOverGround(4.2);
+    filter.updateReceived(u);
+
+    // More targets than the capacity of the table.
+    for (int i = 0; i < 32; i++) {
+      char urn[32];
+      snprintf(urn, sizeof(urn), "urn:mrn:imo:mmsi:%09d", 123456000 + i);
+      SKContext vessel(urn);
+      SKUpdateStatic<1> target(vessel);
+      target.setNavigationSpeedOverGround(4.2);
+      filter.updateReceived(target);
+      filter.updateReceived(target);
+    }
+    CHECK( sub.count == 65 );
+
+    filter.updateReceived(u);
+    CHECK( sub.count == 65 );
+  }
+
+  SECTION("disabled filter republishes everything") {
+    config.enabled = false;
+
+    SKUpdateStatic<1> u;
+    u.setNavigationSpeedOverGround(4.2);
+    filter.updateReceived(u);
+    filter.updateReceived(u);
+    CHECK( sub.count == 2 );
+  }
+
+  SECTION("distance") {
+    CHECK( SKChangeFilter::distance(SKValue(1.0), SKValue(1.5)) == 0.5 );
+    CHECK( SKChangeFilter::distance(SKValue(SKTypePosition(1, 2, 3)), SKValue(SKTypePosition(1.5, 1, 3))) == 1 );
+    CHECK( SKChangeFilter::distance(SKValue(SKTypeAttitude(0.1, 0.2, 0.3)), SKValue(SKTypeAttitude(0.1, 0.2, 0.3))) == 0 );
+    CHECK( SKChangeFilter::distance(SKValue(1.0), SKValue(SKTypeAttitude(0, 0, 0))) == INFINITY );
+    CHECK( SKChangeFilter::distance(SKValue(SKTime(42)), SKValue(SKTime(43))) == INFINITY );
+  }
+}
@@ -0,0 +1,167 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "common/signalk/SKDataStore.h"
+#include "common/signalk/SKUpdateStatic.h"
+#include "common/stats/KBoxMetrics.h"
+
+TEST_CASE("SKDataStore") {
+  SKDataStore store(8);
+  SKSource gps1 = SKSource::sourceForNMEA0183(SKSourceInputNMEA0183_1, "GP", "RMC");
+  SKSource gps2 = SKSource::sourceForNMEA0183(SKSourceInputNMEA0183_2, "GN", "RMC");
+
+  CHECK( store.getSize() == 0 );
+  CHECK( store.getLatest(SKContextSelf, SKPathNavigationSpeedOverGround) == 0 );
+  CHECK( store.getLatestValue(SKContextSelf, SKPathNavigationSpeedOverGround) == SKValueNone );
+
+  SECTION("stores the latest value") {
+    SKUpdateStatic<2> u;
+    u.setSource(gps1);
+    u.setTimestamp(SKTime(42));
+    u.setNavigationSpeedOverGround(4.2);
+    u.setNavigationCourseOverGroundTrue(1.1);
+    store.updateReceived(u);
+
+    CHECK( store.getSize() == 2 );
+    CHECK( store.getLatestValue(SKContextSelf, SKPathNavigationSpeedOverGround) == 4.2 );
+
+    u.setNavigationSpeedOverGround(5.1);
+    store.updateReceived(u);
+
+    CHECK( store.getSize() == 2 );
+    const SKDataStore::Entry *e = store.get(SKContextSelf, SKPathNavigationSpeedOverGround, gps1);
+    REQUIRE( e != 0 );
+    CHECK( e->value == 5.1 );
+    CHECK( e->source == gps1 );
+    CHECK( e->timestamp.getTime() == 42 );
+  }
+
+  SECTION("keeps one value per source") {
+    SKUpdateStatic<1> u1;
+    u1.setSource(gps1);
+    u1.setNavigationSpeedOverGround(1);
+    SKUpdateStatic<1> u2;
+    u2.setSource(gps2);
+    u2.setNavigationSpeedOverGround(2);
+
+    store.updateReceived(u1);
+    store.updateReceived(u2);
+
+    CHECK( store.getSize() == 2 );
+    CHECK( store.get(SKContextSelf, SKPathNavigationSpeedOverGround, gps1)->value == 1 );
+    CHECK( store.get(SKContextSelf, SKPathNavigationSpeedOverGround, gps2)->value == 2 );
+    CHECK( store.getLatestValue(SKContextSelf, SKPathNavigationSpeedOverGround) == 2 );
+
+    store.updateReceived(u1);
+    CHECK( store.getLatestValue(SKContextSelf, SKPathNavigationSpeedOverGround) == 1 );
+  }
+
+  SECTION("separates indexes and ignores other contexts") {
+    SKContext otherBoat("urn:mrn:imo:mmsi:230099999");
+    SKUpdateStatic<2> self;
+    self.setElectricalBatteriesVoltage("house", 12.1);
+    self.setElectricalBatteriesVoltage("engine", 12.9);
+    SKUpdateStatic<1> other(otherBoat);
+    other.setElectricalBatteriesVoltage("house", 24.2);
+
+    store.updateReceived(self);
+    store.updateReceived(other);
+
+    CHECK( store.getSize() == 2 );
+    CHECK( store.getLatestValue(SKContextSelf, SKPath(SKPathElectricalBatteriesVoltage, "house")) == 12.1 );
+    CHECK( store.getLatestValue(SKContextSelf, SKPath(SKPathElectricalBatteriesVoltage, "engine")) == 12.9 );
+    CHECK( store.getLatestValue(otherBoat, SKPath(SKPathElectricalBatteriesVoltage, "house")) == SKValueNone );
+  }
+
+  SECTION("other contexts do not take the place of our values") {
+    for (int i = 0; i < 20; i++) {
+      SKContext target(String("urn:mrn:imo:mmsi:2300000") + String(i));
+      SKUpdateStatic<1> u(target);
+      u.setNavigationSpeedOverGround(i);
+      store.updateReceived(u);
+    }
+    CHECK( store.getSize() == 0 );
+
+    SKUpdateStatic<1> self;
+    self.setNavigationSpeedOverGround(3);
+    store.updateReceived(self);
+    CHECK( store.getLatestValue(SKContextSelf, SKPathNavigationSpeedOverGround) == 3 );
+  }
+
+  SECTION("paths without an index are spread over the table") {
+    SKDataStore bigStore(64);
+    SKUpdateStatic<32> u;
+    for (int p = SKPathInvalidPath + 1; p < SKPathEnumIndexedPaths && u.getSize() < 32; p++) {
+      u.setValue(SKPath((SKPathEnum)p), SKValue(1.0));
+    }
+    REQUIRE( u.getSize() == 32 );
+    bigStore.updateReceived(u);
+    CHECK( bigStore.getSize() == 32 );
+
+    // With a good hash, half full tables only have short clusters.
+    uint16_t longestCluster = 0;
+    uint16_t cluster = 0;
+    for (uint16_t slot = 0; slot < bigStore.getCapacity(); slot++) {
+      cluster = bigStore.getEntry(slot) ? cluster + 1 : 0;
+      if (cluster > longestCluster) {
+        longestCluster = cluster;
+      }
+    }
+    CHECK( longestCluster <= 8 );
+  }
+
+  SECTION("capacity is rounded up to a power of two") {
+    SKDataStore roundedStore(20);
+    CHECK( roundedStore.getCapacity() == 32 );
+  }
+
+  SECTION("iteration and overflow") {
+    uint32_t fullEvents = KBoxMetrics.countEvent(KBoxEventSKDataStoreFull);
+    const char *batteries[] = { "b0", "b1", "b2", "b3", "b4", "b5", "b6", "b7", "b8", "b9" };
+
+    for (int i = 0; i < 10; i++) {
+      SKUpdateStatic<1> u;
+      u.setElectricalBatteriesVoltage(batteries[i], i);
+      store.updateReceived(u);
+    }
+
+    CHECK( store.getSize() == 8 );
+    CHECK( KBoxMetrics.countEvent(KBoxEventSKDataStoreFull) == fullEvents + 2 );
+
+    int count = 0;
+    for (uint16_t slot = 0; slot < store.getCapacity(); slot++) {
+      if (store.getEntry(slot)) {
+        count++;
+      }
+    }
+    CHECK( count == 8 );
+
+    // Updating an existing value still works when the store is full.
+    SKUpdateStatic<1> u;
+    u.setElectricalBatteriesVoltage("b3", 42);
+    store.updateReceived(u);
+    CHECK( store.getLatestValue(SKContextSelf, SKPath(SKPathElectricalBatteriesVoltage, "b3")) == 42 );
+  }
+}
@@ -0,0 +1,91 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "../KBoxBenchmark.h"
+#include "common/signalk/SKHub.h"
+#include "common/signalk/SKSubscriber.h"
+#include "common/signalk/SKUpdateStatic.h"
+
+class BenchmarkSubscriber : public SKSubscriber {
+  private:
+    SKPathEnum _path;
+
+  public:
+    int hits = 0;
+
+    BenchmarkSubscriber(SKPathEnum path) : _path(path) {};
+    virtual ~BenchmarkSubscriber() {};
+
+    void updateReceived(const SKUpdate& u) override {
+      // Same thing most subscribers do: look for the path they care about.
+      if (u.hasPath(_path)) {
+        hits++;
+      }
+    };
+};
+
+TEST_CASE("SKHub benchmark", "[.][benchmark]") {
+  // Roughly what is subscribed to the hub in KBox: outputs that only care
+  // about a few paths.
+  const SKPathEnum interests[] = {
+    SKPathNavigationDatetime, SKPathElectricalBatteriesVoltage,
+    SKPathEnvironmentOutsidePressure, SKPathNavigationHeadingMagnetic,
+    SKPathEnvironmentWindAngleApparent, SKPathSteeringRudderAngle,
+    SKPathNavigationPosition, SKPathEnvironmentDepthBelowTransducer
+  };
+  const int subscribersCount = sizeof(interests) / sizeof(interests[0]);
+
+  SKUpdateStatic<2> attitude;
+  attitude.setNavigationAttitude(SKTypeAttitude(0.1, 0.2, 0.3));
+
+  SKHub unfilteredHub;
+  SKHub filteredHub;
+  LinkedList<BenchmarkSubscriber*> subscribers;
+  for (int i = 0; i < subscribersCount; i++) {
+    BenchmarkSubscriber *unfiltered = new BenchmarkSubscriber(interests[i]);
+    BenchmarkSubscriber *filtered = new BenchmarkSubscriber(interests[i]);
+    subscribers.add(unfiltered);
+    subscribers.add(filtered);
+
+    unfilteredHub.subscribe(unfiltered);
+    filteredHub.subscribe(filtered, SKPathBitmask().set(interests[i]));
+  }
+
+  const int iterations = 100000;
+  double unfilteredNs = benchmarkNanoseconds(iterations, [&]() {
+    unfilteredHub.publish(attitude);
+  });
+  double filteredNs = benchmarkNanoseconds(iterations, [&]() {
+    filteredHub.publish(attitude);
+  });
+
+  benchmarkReport("SKHub publish attitude - unfiltered subscribers", unfilteredNs);
+  benchmarkReport("SKHub publish attitude - path filtered subscribers", filteredNs);
+
+  for (LinkedListIterator<BenchmarkSubscriber*> it = subscribers.begin(); it != subscribers.end(); it++) {
+    CHECK( (*it)->hits == 0 );
+    delete(*it);
+  }
+}
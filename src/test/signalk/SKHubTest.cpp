@@ -26,13 +26,20 @@
 #include "common/signalk/SKHub.h"
 #include "common/signalk/SKSubscriber.h"
 #include "common/signalk/SKUpdateStatic.h"
+#include "common/stats/KBoxMetrics.h"
 
 class TestSubscriber : public SKSubscriber {
   public:
     bool notified = false;
+    int count = 0;
+    double lastSOG = 0;
 
     void updateReceived(const SKUpdate& s) {
       notified = true;
+      count++;
+      if (s.hasNavigationSpeedOverGround()) {
+        lastSOG = s.getNavigationSpeedOverGround();
+      }
     };
 };
 
@@ -48,4 +55,124 @@ TEST_CASE("SKHub") {
 
     CHECK( sub.notified );
   }
+
+  SECTION("filtered subscription") {
+    TestSubscriber timeSub;
+    hub.subscribe(&timeSub, SKPathBitmask().set(SKPathNavigationDatetime));
+
+    TestSubscriber batterySub;
+    hub.subscribe(&batterySub, SKPathBitmask().set(SKPathElectricalBatteriesVoltage));
+
+    SKUpdateStatic<2> attitude;
+    attitude.setNavigationAttitude(SKTypeAttitude(0.1, 0.2, 0.3));
+    hub.publish(attitude);
+
+    CHECK( sub.count == 1 );
+    CHECK( timeSub.count == 0 );
+    CHECK( batterySub.count == 0 );
+
+    SKUpdateStatic<2> battery;
+    battery.setElectricalBatteriesVoltage("house", 12.4);
+    hub.publish(battery);
+
+    CHECK( sub.count == 2 );
+    CHECK( timeSub.count == 0 );
+    CHECK( batterySub.count == 1 );
+
+    SKUpdateStatic<2> rmc;
+    rmc.setNavigationDatetime(SKTime(1000));
+    rmc.setNavigationSpeedOverGround(4.2);
+    hub.publish(rmc);
+
+    CHECK( sub.count == 3 );
+    CHECK( timeSub.count == 1 );
+    CHECK( batterySub.count == 1 );
+  }
+
+  SECTION("empty updates only go to unfiltered subscribers") {
+    TestSubscriber filteredSub;
+    hub.subscribe(&filteredSub, SKPathBitmask::all());
+
+    SKUpdateStatic<0> update(SKContextSelf);
+    hub.publish(update);
+
+    CHECK( sub.notified );
+    CHECK( ! filteredSub.notified );
+  }
+
+  SECTION("queued delivery") {
+    hub.enableQueue(2);
+    REQUIRE( hub.isQueued() );
+
+    SKUpdateStatic<1> update;
+    update.setNavigationSpeedOverGround(4.2);
+    hub.publish(update);
+
+    // The update is copied so the publisher can reuse its own instance.
+    update.setNavigationSpeedOverGround(5.1);
+    hub.publish(update);
+
+    CHECK( !sub.notified );
+    CHECK( hub.getQueueSize() == 2 );
+
+    CHECK( hub.processQueue(1) == 1 );
+    CHECK( sub.count == 1 );
+    CHECK( sub.lastSOG == 4.2 );
+
+    CHECK( hub.processQueue(10) == 1 );
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastSOG == 5.1 );
+
+    CHECK( hub.processQueue(10) == 0 );
+  }
+
+  SECTION("queue overflow") {
+    hub.enableQueue(2);
+    uint32_t overflows = KBoxMetrics.countEvent(KBoxEventSKHubQueueOverflow);
+
+    SKUpdateStatic<1> update;
+    update.setNavigationSpeedOverGround(1);
+    hub.publish(update);
+    hub.publish(update);
+    hub.publish(update);
+
+    CHECK( hub.getQueueSize() == 2 );
+    CHECK( KBoxMetrics.countEvent(KBoxEventSKHubQueueOverflow) == overflows + 1 );
+    CHECK( hub.processQueue(10) == 2 );
+    CHECK( sub.count == 2 );
+  }
+
+  SECTION("updates larger than a queue slot are delivered synchronously") {
+    hub.enableQueue(2);
+
+    SKUpdateStatic<10> update;
+    const char *batteries[] = { "b0", "b1", "b2", "b3", "b4", "b5", "b6", "b7", "b8", "b9" };
+    for (int i = 0; i < 10; i++) {
+      update.setElectricalBatteriesVoltage(batteries[i], 12);
+    }
+    hub.publish(update);
+
+    CHECK( sub.count == 1 );
+    CHECK( hub.getQueueSize() == 0 );
+  }
+
+  SECTION("updates larger than a queue slot do not overtake queued updates") {
+    hub.enableQueue(2);
+
+    SKUpdateStatic<1> queued;
+    queued.setNavigationSpeedOverGround(4.2);
+    hub.publish(queued);
+
+    SKUpdateStatic<10> update;
+    const char *batteries[] = { "b0", "b1", "b2", "b3", "b4", "b5", "b6", "b7", "b8" };
+    for (int i = 0; i < 9; i++) {
+      update.setElectricalBatteriesVoltage(batteries[i], 12);
+    }
+    update.setNavigationSpeedOverGround(5.1);
+    hub.publish(update);
+
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastSOG == 5.1 );
+    CHECK( hub.getQueueSize() == 0 );
+  }
 }
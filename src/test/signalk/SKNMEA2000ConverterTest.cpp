@@ -43,9 +43,16 @@ class N2kQueue : public LinkedList<tN2kMsg>, public SKNMEA2000Output {
     };
 };
 
+static uint32_t converterMillis = 0;
+static uint32_t converterMillisProvider() {
+  return converterMillis;
+}
+
 TEST_CASE("NMEA2000Converter") {
   SKNMEA2000Converter converter;
   N2kQueue messages;
+  converterMillis = 0;
+  converter.setMillisecondsProvider(converterMillisProvider);
 
   SECTION("SOG/COG") {
     SKUpdateStatic<2> rmcUpdate;
@@ -54,6 +61,11 @@ TEST_CASE("NMEA2000Converter") {
 
     converter.convert(rmcUpdate, messages);
 
+    // COG and SOG are part of the GNSS fix which is sent when complete.
+    CHECK( messages.size() == 0 );
+    converterMillis = SKNMEA2000Converter::gnssCoalescingWindow;
+    converter.flush(messages);
+
     CHECK( messages.size() == 1 );
 
     const tN2kMsg *m129026 = findMessage(messages, 129026, 0);
@@ -72,6 +84,233 @@ TEST_CASE("NMEA2000Converter") {
     }
   }
 
+  SECTION("COG/SOG of other vessels are ignored") {
+    SKContext vessel("urn:mrn:imo:mmsi:123456789");
+    SKUpdateStatic<2> aisUpdate(vessel);
+    aisUpdate.setNavigationSpeedOverGround(3);
+    aisUpdate.setNavigationCourseOverGroundTrue(1);
+
+    converter.convert(aisUpdate, messages);
+    converterMillis = SKNMEA2000Converter::gnssCoalescingWindow;
+    converter.flush(messages);
+
+    CHECK( messages.size() == 0 );
+  }
+
+  SECTION("GNSS fix from RMC and GGA") {
+    // 2017-07-14T02:40:00.500Z
+    SKTime fixTime(1500000000, 500);
+    SKUpdateStatic<4> rmcUpdate;
+    rmcUpdate.setNavigationPosition(SKTypePosition(37.8, -122.4, SKDoubleNAN));
+    rmcUpdate.setNavigationSpeedOverGround(3);
+    rmcUpdate.setNavigationCourseOverGroundTrue(1);
+    rmcUpdate.setNavigationDatetime(fixTime);
+
+    SKUpdateStatic<4> ggaUpdate;
+    ggaUpdate.setNavigationPosition(SKTypePosition(37.8, -122.4, 12));
+    ggaUpdate.setNavigationGnssSatellites(8);
+    ggaUpdate.setNavigationGnssHorizontalDilution(1.2);
+    ggaUpdate.setNavigationGnssGeoidalSeparation(-30);
+
+    converter.convert(rmcUpdate, messages);
+    converterMillis = 100;
+    converter.convert(ggaUpdate, messages);
+    converterMillis = 300;
+    converter.flush(messages);
+    CHECK( messages.size() == 0 );
+
+    converterMillis = 350;
+    converter.flush(messages);
+    REQUIRE( messages.size() == 4 );
+
+    const tN2kMsg *m126992 = findMessage(messages, 126992, 0);
+    REQUIRE( m126992 );
+    unsigned char sid;
+    uint16_t date;
+    double time;
+    tN2kTimeSource timeSource;
+    CHECK( ParseN2kPGN126992(*m126992, sid, date, time, timeSource) );
+    CHECK( sid == 0 );
+    CHECK( date == 17361 );
+    CHECK( time == Approx(9600.5) );
+    CHECK( timeSource == N2ktimes_GPS );
+
+    const tN2kMsg *m129025 = findMessage(messages, 129025, 0);
+    REQUIRE( m129025 );
+    double latitude;
+    double longitude;
+    CHECK( ParseN2kPGN129025(*m129025, latitude, longitude) );
+    CHECK( latitude == Approx(37.8) );
+    CHECK( longitude == Approx(-122.4) );
+
+    const tN2kMsg *m129026 = findMessage(messages, 129026, 0);
+    REQUIRE( m129026 );
+    tN2kHeadingReference ref;
+    double cog;
+    double sog;
+    CHECK( ParseN2kPGN129026(*m129026, sid, ref, cog, sog) );
+    CHECK( sid == 0 );
+
+    const tN2kMsg *m129029 = findMessage(messages, 129029, 0);
+    REQUIRE( m129029 );
+    double altitude;
+    tN2kGNSStype gnssType;
+    tN2kGNSSmethod gnssMethod;
+    unsigned char satellites;
+    double hdop;
+    double pdop;
+    double geoidalSeparation;
+    unsigned char referenceStations;
+    tN2kGNSStype referenceStationType;
+    uint16_t referenceStationId;
+    double ageOfCorrection;
+    CHECK( ParseN2kPGN129029(*m129029, sid, date, time, latitude, longitude, altitude,
+                             gnssType, gnssMethod, satellites, hdop, pdop, geoidalSeparation,
+                             referenceStations, referenceStationType, referenceStationId,
+                             ageOfCorrection) );
+    CHECK( sid == 0 );
+    CHECK( date == 17361 );
+    CHECK( time == Approx(9600.5) );
+    CHECK( latitude == Approx(37.8) );
+    CHECK( longitude == Approx(-122.4) );
+    // Height above the ellipsoid.
+    CHECK( altitude == Approx(-18) );
+    CHECK( geoidalSeparation == Approx(-30) );
+    CHECK( gnssMethod == N2kGNSSm_GNSSfix );
+    CHECK( satellites == 8 );
+    CHECK( hdop == Approx(1.2) );
+  }
+
+  SECTION("AIS targets are not merged in our GNSS fix") {
+    SKUpdateStatic<4> rmcUpdate;
+    rmcUpdate.setNavigationPosition(SKTypePosition(37.8, -122.4, SKDoubleNAN));
+    rmcUpdate.setNavigationSpeedOverGround(3);
+    rmcUpdate.setNavigationCourseOverGroundTrue(1);
+    rmcUpdate.setNavigationDatetime(SKTime(1500000000, 500));
+
+    SKContext vessel("urn:mrn:imo:mmsi:477553000");
+    SKUpdateStatic<5> aisUpdate(vessel);
+    aisUpdate.setNavigationPosition(SKTypePosition(28.5, -73.4, SKDoubleNAN));
+    aisUpdate.setNavigationSpeedOverGround(7);
+    aisUpdate.setNavigationCourseOverGroundTrue(2);
+    aisUpdate.setNavigationHeadingTrue(2);
+    aisUpdate.setNavigationRateOfTurn(0.1);
+
+    // Alone, the AIS update does not produce anything.
+    converter.convert(aisUpdate, messages);
+    converterMillis = SKNMEA2000Converter::gnssCoalescingWindow;
+    converter.flush(messages);
+    CHECK( messages.size() == 0 );
+
+    converterMillis = 1000;
+    converter.convert(rmcUpdate, messages);
+    converterMillis = 1050;
+    converter.convert(aisUpdate, messages);
+    converterMillis = 1000 + SKNMEA2000Converter::gnssCoalescingWindow;
+    converter.flush(messages);
+
+    CHECK( findMessage(messages, 127250, 0) == 0 );
+    CHECK( findMessage(messages, 127251, 0) == 0 );
+
+    const tN2kMsg *m129025 = findMessage(messages, 129025, 0);
+    REQUIRE( m129025 );
+    CHECK( findMessage(messages, 129025, 1) == 0 );
+    double latitude;
+    double longitude;
+    CHECK( ParseN2kPGN129025(*m129025, latitude, longitude) );
+    CHECK( latitude == Approx(37.8) );
+    CHECK( longitude == Approx(-122.4) );
+
+    const tN2kMsg *m129026 = findMessage(messages, 129026, 0);
+    REQUIRE( m129026 );
+    CHECK( findMessage(messages, 129026, 1) == 0 );
+    unsigned char sid;
+    tN2kHeadingReference ref;
+    double cog;
+    double sog;
+    CHECK( ParseN2kPGN129026(*m129026, sid, ref, cog, sog) );
+    CHECK( sog == Approx(3) );
+    CHECK( cog == Approx(1) );
+  }
+
+  SECTION("GNSS altitude is not available without the geoidal separation") {
+    SKUpdateStatic<2> ggaUpdate;
+    ggaUpdate.setNavigationPosition(SKTypePosition(37.8, -122.4, 12));
+    ggaUpdate.setNavigationDatetime(SKTime(1500000000, 0));
+    converter.convert(ggaUpdate, messages);
+    converterMillis = 300;
+    converter.flush(messages);
+
+    const tN2kMsg *m129029 = findMessage(messages, 129029, 0);
+    REQUIRE( m129029 );
+    unsigned char sid;
+    uint16_t date;
+    double time;
+    double latitude;
+    double longitude;
+    double altitude;
+    tN2kGNSStype gnssType;
+    tN2kGNSSmethod gnssMethod;
+    unsigned char satellites;
+    double hdop;
+    double pdop;
+    double geoidalSeparation;
+    unsigned char referenceStations;
+    tN2kGNSStype referenceStationType;
+    uint16_t referenceStationId;
+    double ageOfCorrection;
+    CHECK( ParseN2kPGN129029(*m129029, sid, date, time, latitude, longitude, altitude,
+                             gnssType, gnssMethod, satellites, hdop, pdop, geoidalSeparation,
+                             referenceStations, referenceStationType, referenceStationId,
+                             ageOfCorrection) );
+    CHECK( N2kIsNA(altitude) );
+    CHECK( N2kIsNA(geoidalSeparation) );
+  }
+
+  SECTION("GNSS fixes are separated by their time") {
+    SKUpdateStatic<2> rmcUpdate;
+    rmcUpdate.setNavigationPosition(SKTypePosition(37.8, -122.4, SKDoubleNAN));
+    rmcUpdate.setNavigationDatetime(SKTime(1500000000, 0));
+    SKUpdateStatic<2> nextRmcUpdate;
+    nextRmcUpdate.setNavigationPosition(SKTypePosition(37.9, -122.4, SKDoubleNAN));
+    nextRmcUpdate.setNavigationDatetime(SKTime(1500000000, 200));
+
+    converter.convert(rmcUpdate, messages);
+    converterMillis = 200;
+    converter.convert(nextRmcUpdate, messages);
+    // The first fix is sent as soon as the next one starts.
+    CHECK( messages.size() == 3 );
+
+    converterMillis = 450;
+    converter.flush(messages);
+    REQUIRE( messages.size() == 6 );
+
+    unsigned char sid;
+    uint16_t date;
+    double time;
+    tN2kTimeSource timeSource;
+    const tN2kMsg *m126992 = findMessage(messages, 126992, 1);
+    REQUIRE( m126992 );
+    CHECK( ParseN2kPGN126992(*m126992, sid, date, time, timeSource) );
+    CHECK( sid == 1 );
+    CHECK( time == Approx(9600.2) );
+  }
+
+  SECTION("GNSS fixes are sent at least every second") {
+    SKUpdateStatic<1> ggaUpdate;
+    ggaUpdate.setNavigationPosition(SKTypePosition(37.8, -122.4, 12));
+
+    for (converterMillis = 0; converterMillis < SKNMEA2000Converter::gnssMaximumFixAge; converterMillis += 100) {
+      converter.convert(ggaUpdate, messages);
+      converter.flush(messages);
+    }
+    CHECK( messages.size() == 0 );
+
+    converter.flush(messages);
+    CHECK( messages.size() == 1 );
+    CHECK( findMessage(messages, 129025, 0) );
+  }
+
   SECTION("Electrical") {
     SKUpdateStatic<2> electricalUpdate;
     electricalUpdate.setElectricalBatteriesVoltage("engine", 13.0);
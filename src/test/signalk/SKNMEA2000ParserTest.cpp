@@ -25,8 +25,10 @@
 #include <N2kMsg.h>
 #include <N2kMessages.h>
 #include "../KBoxTest.h"
+#include "../KBoxAllocationCounter.h"
 #include "common/signalk/SKUnits.h"
 #include "common/signalk/SKNMEA2000Parser.h"
+#include "common/stats/KBoxMetrics.h"
 
 TEST_CASE("SKNMEA2000Parser: Basic tests") {
   SKNMEA2000Parser p;
@@ -193,4 +195,181 @@ TEST_CASE("SKNMEA2000Parser: Basic tests") {
     CHECK( update.getEnvironmentWindSpeedTrue() == 12.4 );
     CHECK( update.getEnvironmentWindAngleTrueWater() == Approx(SKDegToRad(-175)).epsilon(0.0001) );
   }
+
+  SECTION("Parsing does not allocate memory") {
+    KBOX_REQUIRE_ALLOCATION_COUNTER();
+    SetN2kWindSpeed(msg, 0, 12.4, SKDegToRad(29.8), N2kWind_Apparent);
+    const SKUpdate &wind = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+
+    tN2kMsg sogMsg;
+    SetN2kCOGSOGRapid(sogMsg, 0, N2khr_true, 1.2, 4.2);
+
+    KBoxAllocationCounter allocations;
+    const SKUpdate &sog = p.parse(SKSourceInputNMEA2000, sogMsg, SKTime(0));
+    // Catch allocates memory in CHECK() so we need to read the counter first.
+    uint32_t allocationCount = allocations.count();
+
+    CHECK( allocationCount == 0 );
+    CHECK( &sog == &wind );
+    CHECK( sog.getSize() == 2 );
+    CHECK( sog.getNavigationSpeedOverGround() == 4.2 );
+    CHECK( !sog.hasEnvironmentWindSpeedApparent() );
+  }
+  SECTION("Unknown PGNs are counted") {
+    uint32_t unknownEvents = KBoxMetrics.countEvent(KBoxEventNMEA2000UnknownPGN);
+    msg.SetPGN(65280L);
+    msg.AddByte(42);
+    CHECK( p.parse(SKSourceInputNMEA2000, msg, SKTime(0)).getSize() == 0 );
+    CHECK( p.parse(SKSourceInputNMEA2000, msg, SKTime(0)).getSize() == 0 );
+
+    CHECK( KBoxMetrics.countEvent(KBoxEventNMEA2000UnknownPGN) == unknownEvents + 2 );
+
+    CHECK( p.getUnknownPGNsCount() == 1 );
+    CHECK( p.getUnknownPGN(0) == 65280L );
+    CHECK( p.getUnknownPGNCount(65280L) == 2 );
+    CHECK( p.getUnknownPGNCount(130306L) == 0 );
+    CHECK( p.getUnknownPGNOverflow() == 0 );
+  }
+
+  SECTION("Unknown PGNs overflow") {
+    for (uint32_t pgn = 65280L; pgn < 65280L + SKNMEA2000Parser::unknownPGNCapacity + 2; pgn++) {
+      tN2kMsg unknown;
+      unknown.SetPGN(pgn);
+      unknown.AddByte(42);
+      p.parse(SKSourceInputNMEA2000, unknown, SKTime(0));
+    }
+    CHECK( p.getUnknownPGNsCount() == SKNMEA2000Parser::unknownPGNCapacity );
+    CHECK( p.getUnknownPGNOverflow() == 2 );
+  }
+
+  SECTION("127251: Rate of turn") {
+    SetN2kRateOfTurn(msg, 0, 0.1);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationRateOfTurn() == Approx(0.1).epsilon(0.0001) );
+  }
+
+  SECTION("127488: Engine parameters") {
+    SetN2kEngineParamRapid(msg, 1, 1800, 120000, 50);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getPropulsionRevolutions("1") == Approx(30) );
+    CHECK( update.getPropulsionBoostPressure("1") == Approx(120000) );
+    CHECK( update.getPropulsionDriveTrimState("1") == Approx(0.5) );
+  }
+
+  SECTION("127505: Fluid level") {
+    SetN2kFluidLevel(msg, 0, N2kft_Fuel, 75, 200);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 2 );
+    CHECK( update.getPath(0).toString() == "tanks.fuel.0.currentLevel" );
+    CHECK( update.getTanksCurrentLevel("fuel.0") == Approx(0.75) );
+    CHECK( update.getTanksCapacity("fuel.0") == Approx(0.2) );
+  }
+
+  SECTION("127508: Battery status") {
+    SetN2kDCBatStatus(msg, 2, 12.6, -4.2, SKCelsiusToKelvin(25));
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getElectricalBatteriesVoltage("2") == Approx(12.6) );
+    CHECK( update.getElectricalBatteriesCurrent("2") == Approx(-4.2) );
+    CHECK( update.getElectricalBatteriesTemperature("2") == Approx(SKCelsiusToKelvin(25)) );
+  }
+
+  SECTION("129029: GNSS position data") {
+    SetN2kGNSS(msg, 0, 17647, 3600 * 9, 42.1, -71.3, 12, N2kGNSSt_GPS, N2kGNSSm_GNSSfix, 9, 0.9, 1.5, 18.2);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 6 );
+    CHECK( update.getNavigationPosition().latitude == Approx(42.1) );
+    CHECK( update.getNavigationPosition().longitude == Approx(-71.3) );
+    CHECK( update.getNavigationPosition().altitude == Approx(12) );
+    CHECK( update.getNavigationDatetime().toString() == "2018-04-26T09:00:00.000Z" );
+    CHECK( update.getNavigationGnssSatellites() == 9 );
+    CHECK( update.getNavigationGnssHorizontalDilution() == Approx(0.9) );
+    CHECK( update.getNavigationGnssPositionDilution() == Approx(1.5) );
+    CHECK( update.getNavigationGnssGeoidalSeparation() == Approx(18.2) );
+  }
+
+  SECTION("129025: Position rapid update") {
+    SetN2kLatLonRapid(msg, 42.1, -71.3);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationPosition().latitude == Approx(42.1) );
+    CHECK( update.getNavigationPosition().longitude == Approx(-71.3) );
+    // Not at sea level: the altitude is not available.
+    CHECK( update.getNavigationPosition().altitude == SKDoubleNAN );
+  }
+
+  SECTION("129029: GNSS without altitude") {
+    SetN2kGNSS(msg, 0, 17647, 3600 * 9, 42.1, -71.3, N2kDoubleNA, N2kGNSSt_GPS, N2kGNSSm_GNSSfix, 9, 0.9, 1.5, 18.2);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.hasNavigationPosition() );
+    CHECK( update.getNavigationPosition().altitude == SKDoubleNAN );
+  }
+
+  SECTION("129029: GNSS without a fix") {
+    SetN2kGNSS(msg, 0, 17647, 3600 * 9, 42.1, -71.3, 12, N2kGNSSt_GPS, N2kGNSSm_noGNSS, 0, N2kDoubleNA, N2kDoubleNA, N2kDoubleNA);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( !update.hasNavigationPosition() );
+  }
+
+  SECTION("130312: Temperature") {
+    SetN2kTemperature(msg, 0, 0, N2kts_EngineRoomTemperature, SKCelsiusToKelvin(42));
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getEnvironmentInsideEngineRoomTemperature() == Approx(SKCelsiusToKelvin(42)) );
+  }
+
+  SECTION("130312: Temperature without a SignalK path") {
+    SetN2kTemperature(msg, 0, 0, N2kts_BaitWellTemperature, SKCelsiusToKelvin(12));
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 0 );
+    CHECK( p.getUnknownPGNsCount() == 0 );
+  }
+
+  SECTION("130577: Direction data") {
+    msg.SetPGN(130577L);
+    msg.AddByte(N2khr_true << 4);
+    msg.AddByte(0);
+    msg.Add2ByteUDouble(SKDegToRad(45), 0.0001);
+    msg.Add2ByteUDouble(3.2, 0.01);
+    msg.Add2ByteUDouble(SKDegToRad(40), 0.0001);
+    msg.Add2ByteUDouble(3.0, 0.01);
+    msg.Add2ByteUDouble(SKDegToRad(90), 0.0001);
+    msg.Add2ByteUDouble(0.4, 0.01);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 6 );
+    CHECK( update.getNavigationCourseOverGroundTrue() == Approx(SKDegToRad(45)).epsilon(0.0001) );
+    CHECK( update.getNavigationSpeedOverGround() == Approx(3.2) );
+    CHECK( update.getNavigationHeadingTrue() == Approx(SKDegToRad(40)).epsilon(0.0001) );
+    CHECK( update.getNavigationSpeedThroughWater() == Approx(3.0) );
+    CHECK( update.getEnvironmentCurrentSetTrue() == Approx(SKDegToRad(90)).epsilon(0.0001) );
+    CHECK( update.getEnvironmentCurrentDrift() == Approx(0.4) );
+  }
+
+  SECTION("130578: Vessel speed components") {
+    msg.SetPGN(130578L);
+    msg.Add2ByteDouble(3.1, 0.001);
+    msg.Add2ByteDouble(-0.2, 0.001);
+    const SKUpdate &update = p.parse(SKSourceInputNMEA2000, msg, SKTime(0));
+    CHECK( update.getSize() == 2 );
+    CHECK( update.getNavigationSpeedThroughWaterLongitudinal() == Approx(3.1) );
+    CHECK( update.getNavigationSpeedThroughWaterTransverse() == Approx(-0.2) );
+  }
+}
+
+TEST_CASE("SKNMEA2000Parser: PGN table") {
+  // A PGN missing here means the table is not sorted anymore.
+  const uint32_t pgns[] = { 126992L, 127245L, 127250L, 127251L, 127257L, 127258L,
+    127488L, 127493L, 127505L, 127508L, 128259L, 128267L, 128275L, 129025L,
+    129026L, 129029L, 129283L, 130306L, 130312L, 130314L, 130316L, 130577L,
+    130578L };
+
+  for (uint32_t pgn : pgns) {
+    INFO( pgn );
+    CHECK( SKNMEA2000Parser::isPGNSupported(pgn) );
+  }
+  CHECK( !SKNMEA2000Parser::isPGNSupported(0) );
+  CHECK( !SKNMEA2000Parser::isPGNSupported(126993L) );
+  CHECK( !SKNMEA2000Parser::isPGNSupported(130579L) );
 }
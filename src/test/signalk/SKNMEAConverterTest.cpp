@@ -28,10 +28,10 @@
 #include "common/signalk/SKUpdateStatic.h"
 #include "../KBoxTest.h"
 
-class NMEAOut : public LinkedList<SKNMEASentence>, public SKNMEAOutput {
+class NMEAOut : public LinkedList<String>, public SKNMEAOutput {
   public:
     bool write(const SKNMEASentence& s) override {
-      add(s);
+      add(String(s.c_str()));
       return true;
     };
 
@@ -42,6 +42,16 @@ TEST_CASE("SKNMEAConverterTest") {
   SKNMEAConverter converter(config);
   NMEAOut out;
 
+  SECTION("updates about other vessels are ignored") {
+    SKContext vessel("urn:mrn:imo:mmsi:123456789");
+    SKUpdateStatic<1> u(vessel);
+    u.setNavigationHeadingMagnetic(SKDegToRad(90));
+
+    converter.convert(u, out);
+
+    CHECK( out.size() == 0 );
+  }
+
   SECTION("ElectricalBatteriesVoltage") {
     SKUpdateStatic<3> u;
     u.setElectricalBatteriesVoltage("Supply", 12.42);
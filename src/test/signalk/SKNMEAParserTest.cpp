@@ -23,8 +23,10 @@
 */
 
 #include "../KBoxTest.h"
+#include "../KBoxAllocationCounter.h"
 #include "common/signalk/SKUnits.h"
 #include "common/signalk/SKNMEAParser.h"
+#include "util.h"
 
 TEST_CASE("SKNMEAParser: RMC") {
   SKNMEAParser p;
@@ -44,12 +46,23 @@ TEST_CASE("SKNMEAParser: RMC") {
     CHECK( update.getTimestamp().getTime() == 0 );
     CHECK( update.getNavigationSpeedOverGround() == SKKnotToMs(5.02) );
     CHECK( update.getNavigationCourseOverGroundTrue() == SKDegToRad(235.24) );
-    CHECK( update.getNavigationPosition().latitude == 37.85564166666666 );
-    CHECK( update.getNavigationPosition().longitude == -122.45818833333334 );
+    CHECK( update.getNavigationPosition().latitude == ApproxDegrees(37.85564166666666) );
+    CHECK( update.getNavigationPosition().longitude == ApproxDegrees(-122.45818833333334) );
     CHECK( update.getNavigationPosition().altitude == SKDoubleNAN );
     CHECK( update.getNavigationDatetime().toString() == "2016-11-14T00:41:19.000Z" );
   }
 
+  SECTION("RMC does not allocate memory") {
+    KBOX_REQUIRE_ALLOCATION_COUNTER();
+    String sentence("$GPRMC,004119.042,A,3751.3385,N,12227.4913,W,5.02,235.24,141116,,,D*73");
+    KBoxAllocationCounter allocations;
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, sentence, SKTime(0));
+    uint32_t allocationCount = allocations.count();
+
+    CHECK( allocationCount == 0 );
+    CHECK( update.getNavigationDatetime().toString() == "2016-11-14T00:41:19.042Z" );
+  }
+
   SECTION("RMC with invalid fix") {
     const SKUpdate& update = p.parse(SKSourceInputUnknown, "$IIRMC,,V,,,,,,,,009,W,N*2A", SKTime(0));
 
@@ -120,13 +133,222 @@ TEST_CASE("SKNMEAParser: MWV") {
   }
 }
 
-TEST_CASE("SKNMEAParser: XDR wind temperature") {
+TEST_CASE("SKNMEAParser: XDR") {
   SKNMEAParser p;
 
-  // From LCJ Wind sensor:
-  // $WIXDR,C,030.0,C,,*51
-  //
   SECTION("XDR with temperature in C") {
+    // From LCJ Wind sensor
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$WIXDR,C,030.0,C,,*51", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getEnvironmentOutsideTemperature() == Approx(303.15) );
+  }
+
+  SECTION("XDR with barometer") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$IIXDR,P,1.02481,B,Barometer*29", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getEnvironmentOutsidePressure() == Approx(102481) );
+  }
+
+  SECTION("XDR with pitch and roll") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$IIXDR,A,-2.5,D,PTCH,A,10.2,D,ROLL*45", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationAttitude().pitch == Approx(SKDegToRad(-2.5)) );
+    CHECK( update.getNavigationAttitude().roll == Approx(SKDegToRad(10.2)) );
+    CHECK( update.getNavigationAttitude().yaw == SKDoubleNAN );
+  }
+
+  SECTION("XDR with unknown transducers") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$IIXDR,U,12.6,V,Battery,H,62,P,Humidity*3E", SKTime(0));
+
+    CHECK( update.getSize() == 0 );
+  }
+}
+
+TEST_CASE("SKNMEAParser: GPS") {
+  SKNMEAParser p;
+
+  SECTION("GGA") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47", SKTime(0));
+
+    CHECK( update.getSize() == 4 );
+    CHECK( String(update.getSource().getTalker()) == "GP" );
+    CHECK( String(update.getSource().getSentence()) == "GGA" );
+    CHECK( update.getNavigationPosition().latitude == Approx(48.1173) );
+    CHECK( update.getNavigationPosition().longitude == Approx(11.516666) );
+    CHECK( update.getNavigationPosition().altitude == ApproxFloat(545.4) );
+    CHECK( update.getNavigationGnssSatellites() == 8 );
+    CHECK( update.getNavigationGnssHorizontalDilution() == 0.9 );
+    CHECK( update.getNavigationGnssGeoidalSeparation() == 46.9 );
+  }
+
+  SECTION("GGA without fix") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$GPGGA,123519,,,,,0,00,,,M,,M,,*6B", SKTime(0));
+
+    CHECK( update.getSize() == 0 );
+  }
+
+  SECTION("VTG") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48", SKTime(0));
+
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getNavigationCourseOverGroundTrue() == Approx(SKDegToRad(54.7)) );
+    CHECK( update.getNavigationCourseOverGroundMagnetic() == Approx(SKDegToRad(34.4)) );
+    CHECK( update.getNavigationSpeedOverGround() == Approx(SKKnotToMs(5.5)) );
+  }
+
+  SECTION("VTG with speed in km/h and invalid mode") {
+    CHECK( p.parse(SKSourceInputNMEA0183_1, "$GPVTG,,T,,M,,N,10.0,K,A*3C", SKTime(0)).getNavigationSpeedOverGround() == Approx(SKKmphToMs(10.0)) );
+    CHECK( p.parse(SKSourceInputNMEA0183_1, "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K,N*2A", SKTime(0)).getSize() == 0 );
+  }
+}
+
+TEST_CASE("SKNMEAParser: heading") {
+  SKNMEAParser p;
+
+  SECTION("HDG") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$HCHDG,101.1,,,7.1,W*3C", SKTime(0));
+
+    CHECK( update.getSize() == 2 );
+    CHECK( update.getNavigationHeadingMagnetic() == Approx(SKDegToRad(101.1)) );
+    CHECK( update.getNavigationMagneticVariation() == Approx(SKDegToRad(-7.1)) );
+  }
+
+  SECTION("HDG with deviation") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$HCHDG,359.0,2.0,E,,*24", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationHeadingMagnetic() == Approx(SKDegToRad(1)) );
+  }
+
+  SECTION("HDM") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$HCHDM,238.5,M*25", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationHeadingMagnetic() == Approx(SKDegToRad(238.5)) );
+  }
+
+  SECTION("HDT") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$HEHDT,274.07,T*19", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationHeadingTrue() == Approx(SKDegToRad(274.07)) );
+  }
+
+  SECTION("ROT") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$TIROT,-35.6,A*26", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationRateOfTurn() == Approx(SKDegToRad(-35.6) / 60) );
+    CHECK( p.parse(SKSourceInputNMEA0183_1, "$TIROT,-35.6,V*31", SKTime(0)).getSize() == 0 );
+  }
+
+  SECTION("RSA") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$IIRSA,10.5,A,,V*4D", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getSteeringRudderAngle() == Approx(SKDegToRad(10.5)) );
+    CHECK( p.parse(SKSourceInputNMEA0183_1, "$IIRSA,10.5,V,,V*5A", SKTime(0)).getSize() == 0 );
+  }
+}
+
+TEST_CASE("SKNMEAParser: depth") {
+  SKNMEAParser p;
+
+  SECTION("DPT with offset to keel") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$SDDPT,3.6,-1.0*7E", SKTime(0));
+
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getEnvironmentDepthBelowTransducer() == 3.6 );
+    CHECK( update.getEnvironmentDepthTransducerToKeel() == 1.0 );
+    CHECK( update.getEnvironmentDepthBelowKeel() == Approx(2.6) );
+  }
+
+  SECTION("DPT with offset to surface") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$SDDPT,3.6,0.5,100*4A", SKTime(0));
+
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getEnvironmentDepthSurfaceToTransducer() == 0.5 );
+    CHECK( update.getEnvironmentDepthBelowSurface() == Approx(4.1) );
+  }
+
+  SECTION("DBT") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$SDDBT,7.8,f,2.4,M,1.3,F*0D", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getEnvironmentDepthBelowTransducer() == 2.4 );
+  }
+
+  SECTION("DBT in feet only") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$SDDBT,10.0,f,,M,,F*37", SKTime(0));
+
+    CHECK( update.getEnvironmentDepthBelowTransducer() == Approx(3.048) );
   }
 }
 
+TEST_CASE("SKNMEAParser: water") {
+  SKNMEAParser p;
+
+  SECTION("VHW") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$VWVHW,,T,,M,5.5,N,10.2,K*67", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getNavigationSpeedThroughWater() == Approx(SKKnotToMs(5.5)) );
+  }
+
+  SECTION("VHW with headings") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$VWVHW,120.0,T,115.0,M,5.5,N,10.2,K*61", SKTime(0));
+
+    CHECK( update.getSize() == 3 );
+    CHECK( update.getNavigationHeadingTrue() == Approx(SKDegToRad(120)) );
+    CHECK( update.getNavigationHeadingMagnetic() == Approx(SKDegToRad(115)) );
+  }
+
+  SECTION("MTW") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$YXMTW,17.75,C*26", SKTime(0));
+
+    CHECK( update.getSize() == 1 );
+    CHECK( update.getEnvironmentWaterTemperature() == Approx(290.9) );
+  }
+
+  SECTION("VLW") {
+    const SKUpdate& update = p.parse(SKSourceInputNMEA0183_1, "$IIVLW,1234.5,N,12.3,N*4C", SKTime(0));
+
+    CHECK( update.getSize() == 2 );
+    CHECK( update.getNavigationLog() == Approx(1234.5 * 1852) );
+    CHECK( update.getNavigationTripLog() == Approx(12.3 * 1852) );
+  }
+}
+
+TEST_CASE("SKNMEAParser: unsupported sentences") {
+  SKNMEAParser p;
+
+  CHECK( p.parse(SKSourceInputNMEA0183_1, "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39", SKTime(0)).getSize() == 0 );
+  CHECK( p.parse(SKSourceInputNMEA0183_1, "$PGRMZ,93,f,3*21", SKTime(0)).getSize() == 0 );
+}
+
+TEST_CASE("SKNMEAParser: update reuse") {
+  SKNMEAParser p;
+
+  const SKUpdate& mwv = p.parse(SKSourceInputNMEA0183_1, "$IIMWV,056,R,5.19,N,A*1D", SKTime(42));
+  CHECK( mwv.getSize() == 2 );
+
+  String sentence("$GPRMC,004119.000,A,3751.3385,N,12227.4913,W,5.02,235.24,141116,,,D*75");
+  KBoxAllocationCounter allocations;
+  const SKUpdate& rmc = p.parse(SKSourceInputNMEA0183_2, sentence, SKTime(0));
+  // Catch allocates memory in CHECK() so we need to read the counter first.
+  uint32_t allocationCount = allocations.count();
+
+  if (KBoxAllocationCounter::countsAllAllocations()) {
+    CHECK( allocationCount == 0 );
+  }
+  else {
+    WARN("Allocation check skipped: malloc() allocations cannot be counted in this build");
+  }
+  CHECK( &rmc == &mwv );
+  CHECK( rmc.getSize() == 4 );
+  CHECK( !rmc.hasEnvironmentWindSpeedApparent() );
+  CHECK( rmc.getTimestamp().getTime() == 0 );
+}
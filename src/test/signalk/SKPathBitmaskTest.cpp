@@ -0,0 +1,70 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "common/signalk/SKPathBitmask.h"
+
+TEST_CASE("SKPathBitmask") {
+  SKPathBitmask mask;
+
+  SECTION("empty") {
+    CHECK( mask.isEmpty() );
+    CHECK( ! mask.test(SKPathNavigationPosition) );
+    CHECK( ! mask.intersects(SKPathBitmask::all()) );
+  }
+
+  SECTION("set and unset") {
+    mask.set(SKPathNavigationPosition).set(SKPathElectricalBatteriesVoltage);
+
+    CHECK( ! mask.isEmpty() );
+    CHECK( mask.test(SKPathNavigationPosition) );
+    CHECK( mask.test(SKPathElectricalBatteriesVoltage) );
+    CHECK( ! mask.test(SKPathNavigationAttitude) );
+
+    mask.unset(SKPathNavigationPosition);
+    CHECK( ! mask.test(SKPathNavigationPosition) );
+    CHECK( mask.test(SKPathElectricalBatteriesVoltage) );
+  }
+
+  SECTION("intersects") {
+    SKPathBitmask a = SKPathBitmask().set(SKPathNavigationPosition).set(SKPathNavigationAttitude);
+    SKPathBitmask b = SKPathBitmask().set(SKPathNavigationAttitude);
+    SKPathBitmask c = SKPathBitmask().set(SKPathElectricalBatteriesVoltage);
+
+    CHECK( a.intersects(b) );
+    CHECK( b.intersects(a) );
+    CHECK( ! a.intersects(c) );
+
+    a |= c;
+    CHECK( a.intersects(c) );
+  }
+
+  SECTION("all") {
+    SKPathBitmask all = SKPathBitmask::all();
+    for (int i = 0; i < SKPathEnumCount; i++) {
+      CHECK( all.test(static_cast<SKPathEnum>(i)) );
+    }
+    CHECK( ! all.test(SKPathEnumCount) );
+  }
+}
@@ -28,8 +28,10 @@
   THE SOFTWARE.
 */
 
+#include <stdio.h>
 #include "../KBoxTest.h"
 #include "common/signalk/SKPath.h"
+#include "common/signalk/SKUpdateStatic.h"
 
 TEST_CASE("SKPath") {
   SECTION("non-indexed paths") {
@@ -52,12 +54,150 @@ TEST_CASE("SKPath") {
     SKPath p2 = SKPath(SKPathElectricalBatteriesVoltage, "engine");
     CHECK( p != p2 );
     CHECK( p2.isIndexed() );
-    CHECK( p2.getIndex() == "engine" );
+    CHECK( String(p2.getIndex()) == "engine" );
     CHECK( p2.getStaticPath() == SKPathElectricalBatteriesVoltage );
     CHECK( p2.toString() == "electrical.batteries.engine.voltage" );
 
     SKPath p3 = SKPath(SKPathElectricalBatteriesVoltage, "starter");
     CHECK( p == p3 );
   }
+
+  SECTION("paths are small and do not own memory") {
+    CHECK( sizeof(SKPath) == 2 );
+
+    SKPath p = SKPath(SKPathElectricalBatteriesVoltage, "house");
+    SKPath copy = p;
+    CHECK( copy == p );
+    CHECK( String(copy.getIndex()) == "house" );
+  }
+
+  SECTION("indexes are interned") {
+    uint8_t size = SKPathIndexTable::size();
+    SKPath p1 = SKPath(SKPathElectricalBatteriesVoltage, "interned-test");
+    CHECK( SKPathIndexTable::size() == size + 1 );
+
+    SKPath p2 = SKPath(SKPathElectricalBatteriesVoltage, String("interned-test").c_str());
+    CHECK( SKPathIndexTable::size() == size + 1 );
+    CHECK( p1 == p2 );
+  }
+
+  SECTION("indexed path without index") {
+    SKPath p = SKPath(SKPathElectricalBatteriesVoltage, "");
+    CHECK( p == SKPathInvalid );
+    CHECK( String(p.getIndex()) == "" );
+  }
 }
 
+TEST_CASE("SKPathIndexTable") {
+  CHECK( SKPathIndexTable::intern(0) == SKPathIndexTable::noIndex );
+  CHECK( SKPathIndexTable::intern("") == SKPathIndexTable::noIndex );
+  CHECK( String(SKPathIndexTable::lookup(SKPathIndexTable::noIndex)) == "" );
+
+  uint8_t id = SKPathIndexTable::intern("starboard");
+  CHECK( id != SKPathIndexTable::noIndex );
+  CHECK( SKPathIndexTable::intern("starboard") == id );
+  CHECK( String(SKPathIndexTable::lookup(id)) == "starboard" );
+
+  SECTION("long indexes are rejected") {
+    uint8_t size = SKPathIndexTable::size();
+    CHECK( SKPathIndexTable::intern("a-very-long-battery-name-that-does-not-fit") == SKPathIndexTable::overflowIndex );
+    CHECK( SKPathIndexTable::intern("a-very-long-battery-name-that-is-different") == SKPathIndexTable::overflowIndex );
+    CHECK( SKPathIndexTable::find("a-very-long-battery-name-that-does-not-fit") == SKPathIndexTable::noIndex );
+    CHECK( SKPathIndexTable::size() == size );
+
+    SKPath p = SKPath(SKPathElectricalBatteriesVoltage, "a-very-long-battery-name-that-does-not-fit");
+    CHECK( p == SKPathInvalid );
+
+    // The longest index that fits is accepted.
+    uint8_t id = SKPathIndexTable::intern("twenty-three-chars-long");
+    CHECK( id != SKPathIndexTable::overflowIndex );
+    CHECK( String(SKPathIndexTable::lookup(id)) == "twenty-three-chars-long" );
+  }
+
+  SECTION("reading a value does not add its index") {
+    uint8_t size = SKPathIndexTable::size();
+    SKUpdateStatic<1> update;
+    CHECK( !update.hasElectricalBatteriesVoltage("never-stored") );
+    CHECK( update.getElectricalBatteriesVoltage("never-stored") == 0 );
+    CHECK( SKPath::find(SKPathElectricalBatteriesVoltage, "never-stored") == SKPathInvalid );
+    CHECK( SKPathIndexTable::size() == size );
+
+    update.setElectricalBatteriesVoltage("stored", 12.5);
+    CHECK( SKPath::find(SKPathElectricalBatteriesVoltage, "stored") == SKPath(SKPathElectricalBatteriesVoltage, "stored") );
+    CHECK( update.getElectricalBatteriesVoltage("stored") == 12.5 );
+  }
+
+  SECTION("indexes that do not fit are invalid") {
+    SKPathIndexTable::clear();
+    char name[8];
+    for (int i = 0; i < SKPathIndexTable::capacity; i++) {
+      snprintf(name, sizeof(name), "b%i", i);
+      SKPathIndexTable::intern(name);
+    }
+    CHECK( SKPathIndexTable::size() == SKPathIndexTable::capacity );
+
+    CHECK( SKPathIndexTable::intern("b40") == SKPathIndexTable::overflowIndex );
+    SKPath p40 = SKPath(SKPathElectricalBatteriesVoltage, "b40");
+    SKPath p41 = SKPath(SKPathElectricalBatteriesVoltage, "b41");
+    CHECK( p40 == SKPathInvalid );
+    CHECK( p41 == SKPathInvalid );
+
+    // Values with these paths are rejected instead of overwriting each other.
+    SKUpdateStatic<2> update;
+    CHECK( !update.setElectricalBatteriesVoltage("b40", 12.1) );
+    CHECK( !update.setElectricalBatteriesVoltage("b41", 12.2) );
+    CHECK( update.getSize() == 0 );
+    CHECK( update.setElectricalBatteriesVoltage("b1", 12.3) );
+    CHECK( update.getSize() == 1 );
+
+    SKPathIndexTable::clear();
+  }
+}
+
+TEST_CASE("SKPathInfo") {
+  SECTION("table follows the order of SKPathEnum") {
+    for (int i = 0; i < SKPathEnumCount; i++) {
+      CHECK( SKPathInfoTable[i].path == i );
+    }
+  }
+
+  SECTION("metadata") {
+    const SKPathInfo &info = SKPath(SKPathElectricalBatteriesVoltage, "house").getInfo();
+    CHECK( String(info.prefix) == "electrical.batteries." );
+    CHECK( String(info.suffix) == ".voltage" );
+    CHECK( info.prefixLength == strlen(info.prefix) );
+    CHECK( info.suffixLength == strlen(info.suffix) );
+    CHECK( String(info.unit) == "V" );
+    CHECK( info.type == SKValue::SKValueTypeNumber );
+
+    CHECK( SKPath(SKPathNavigationPosition).getInfo().type == SKValue::SKValueTypePosition );
+    CHECK( String(SKPath(SKPathNavigationPosition).getInfo().suffix) == "" );
+  }
+
+  SECTION("copyTo") {
+    SKPath p(SKPathElectricalBatteriesVoltage, "house");
+    char buffer[64];
+
+    CHECK( p.getLength() == strlen("electrical.batteries.house.voltage") );
+    CHECK( p.copyTo(buffer, sizeof(buffer)) == p.getLength() );
+    CHECK( String(buffer) == "electrical.batteries.house.voltage" );
+
+    // Truncated output is still terminated
+    CHECK( p.copyTo(buffer, 25) == p.getLength() );
+    CHECK( String(buffer) == "electrical.batteries.hou" );
+
+    SKPath sog(SKPathNavigationSpeedOverGround);
+    CHECK( sog.copyTo(buffer, sizeof(buffer)) == sog.getLength() );
+    CHECK( String(buffer) == "navigation.speedOverGround" );
+    CHECK( SKPathInvalid.toString() == "invalid" );
+  }
+
+  SECTION("staticPathFromString") {
+    CHECK( SKPath::staticPathFromString("navigation.attitude") == SKPathNavigationAttitude );
+    CHECK( SKPath::staticPathFromString("electrical.batteries.*.voltage") == SKPathElectricalBatteriesVoltage );
+    CHECK( SKPath::staticPathFromString("electrical.batteries.house.voltage") == SKPathInvalidPath );
+    CHECK( SKPath::staticPathFromString("electrical.batteries.*") == SKPathInvalidPath );
+    CHECK( SKPath::staticPathFromString("navigation") == SKPathInvalidPath );
+    CHECK( SKPath::staticPathFromString(0) == SKPathInvalidPath );
+  }
+}
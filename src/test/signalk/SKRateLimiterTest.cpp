@@ -0,0 +1,290 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include "../KBoxTest.h"
+#include "common/signalk/SKRateLimiter.h"
+#include "common/signalk/SKSubscriber.h"
+#include "common/signalk/SKUnits.h"
+#include "common/signalk/SKUpdateStatic.h"
+#include "util.h"
+
+class RateLimiterSubscriber : public SKSubscriber {
+  public:
+    int count = 0;
+    int lastSize = 0;
+    SKValue lastAttitude;
+    SKValue lastSOG;
+    SKValue lastCOG;
+    SKValue lastHeading;
+    SKValue lastPosition;
+
+    void updateReceived(const SKUpdate& u) {
+      count++;
+      lastSize = u.getSize();
+      if (u.hasNavigationAttitude()) {
+        lastAttitude = u[SKPathNavigationAttitude];
+      }
+      if (u.hasNavigationSpeedOverGround()) {
+        lastSOG = u[SKPathNavigationSpeedOverGround];
+      }
+      if (u.hasNavigationCourseOverGroundTrue()) {
+        lastCOG = u[SKPathNavigationCourseOverGroundTrue];
+      }
+      if (u.hasNavigationHeadingTrue()) {
+        lastHeading = u[SKPathNavigationHeadingTrue];
+      }
+      if (u.hasNavigationPosition()) {
+        lastPosition = u[SKPathNavigationPosition];
+      }
+    };
+};
+
+static uint32_t rateLimiterMillis = 0;
+static uint32_t rateLimiterMillisProvider() {
+  return rateLimiterMillis;
+}
+
+TEST_CASE("SKRateLimiter") {
+  SKRateLimiterConfig config;
+  config.rules[0] = { SKPathNavigationAttitude, 100, SKRateLimitMean };
+  config.rules[1] = { SKPathNavigationSpeedOverGround, 1000, SKRateLimitLatest };
+  config.rules[2] = { SKPathNavigationHeadingTrue, 100, SKRateLimitMean };
+  config.rules[3] = { SKPathNavigationPosition, 100, SKRateLimitMean };
+  config.rulesCount = 4;
+
+  RateLimiterSubscriber sub;
+  rateLimiterMillis = 1000;
+  SKRateLimiter limiter(config, sub, 8);
+  limiter.setMillisecondsProvider(rateLimiterMillisProvider);
+
+  SECTION("paths without a rule are not limited") {
+    SKUpdateStatic<1> u;
+    u.setNavigationCourseOverGroundTrue(1.0);
+    limiter.updateReceived(u);
+    limiter.updateReceived(u);
+    limiter.updateReceived(u);
+
+    CHECK( sub.count == 3 );
+  }
+
+  SECTION("other vessels are not limited") {
+    SKContext vessel("urn:mrn:imo:mmsi:123456789");
+    SKUpdateStatic<1> u(vessel);
+    u.setNavigationSpeedOverGround(1);
+    limiter.updateReceived(u);
+    limiter.updateReceived(u);
+    limiter.updateReceived(u);
+
+    CHECK( sub.count == 3 );
+  }
+
+  SECTION("latest value is sent at most once per interval") {
+    SKUpdateStatic<1> u;
+    u.setNavigationSpeedOverGround(1);
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+    CHECK( sub.lastSOG == 1 );
+
+    rateLimiterMillis += 200;
+    u.setNavigationSpeedOverGround(2);
+    limiter.updateReceived(u);
+    rateLimiterMillis += 200;
+    u.setNavigationSpeedOverGround(3);
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    limiter.flush();
+    CHECK( sub.count == 1 );
+
+    rateLimiterMillis += 600;
+    limiter.flush();
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastSOG == 3 );
+
+    // Nothing new to send.
+    rateLimiterMillis += 2000;
+    limiter.flush();
+    CHECK( sub.count == 2 );
+
+    u.setNavigationSpeedOverGround(4);
+    limiter.updateReceived(u);
+    CHECK( sub.count == 3 );
+    CHECK( sub.lastSOG == 4 );
+  }
+
+  SECTION("mean of the values is sent") {
+    SKUpdateStatic<1> u;
+    u.setNavigationAttitude(SKTypeAttitude(0.1, 0, 0));
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    rateLimiterMillis += 10;
+    u.setNavigationAttitude(SKTypeAttitude(0.2, 0, M_PI - 0.1));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 10;
+    u.setNavigationAttitude(SKTypeAttitude(0.4, 0, -M_PI + 0.1));
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    rateLimiterMillis += 100;
+    limiter.flush();
+    CHECK( sub.count == 2 );
+    SKTypeAttitude a = sub.lastAttitude.getAttitudeValue();
+    CHECK( a.roll == Approx(0.3) );
+    CHECK( a.pitch == Approx(0) );
+    // Yaw values on both sides of PI do not cancel each other.
+    CHECK( fabs(a.yaw) == Approx(M_PI) );
+  }
+
+  SECTION("mean of angles wraps around") {
+    SKUpdateStatic<1> u;
+    u.setNavigationHeadingTrue(SKDegToRad(180));
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    rateLimiterMillis += 10;
+    u.setNavigationHeadingTrue(SKDegToRad(358));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 10;
+    u.setNavigationHeadingTrue(SKDegToRad(4));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 100;
+    limiter.flush();
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastHeading.getNumberValue() == Approx(SKDegToRad(1)) );
+
+    rateLimiterMillis += 10;
+    u.setNavigationHeadingTrue(SKDegToRad(350));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 10;
+    u.setNavigationHeadingTrue(SKDegToRad(356));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 100;
+    limiter.flush();
+    CHECK( sub.count == 3 );
+    // Headings stay between 0 and 2*PI.
+    CHECK( sub.lastHeading.getNumberValue() == Approx(SKDegToRad(353)) );
+  }
+
+  SECTION("mean of positions wraps around the antimeridian") {
+    SKUpdateStatic<1> u;
+    u.setNavigationPosition(SKTypePosition(10, 0, 0));
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    rateLimiterMillis += 10;
+    u.setNavigationPosition(SKTypePosition(10, 179, 2));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 10;
+    u.setNavigationPosition(SKTypePosition(12, -177, 4));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 100;
+    limiter.flush();
+    CHECK( sub.count == 2 );
+    SKTypePosition p = sub.lastPosition.getPositionValue();
+    CHECK( p.latitude == ApproxDegrees(11) );
+    CHECK( p.longitude == ApproxDegrees(-179) );
+    CHECK( p.altitude == ApproxFloat(3) );
+
+    rateLimiterMillis += 10;
+    u.setNavigationPosition(SKTypePosition(10, 1, 0));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 10;
+    u.setNavigationPosition(SKTypePosition(10, 3, 0));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 100;
+    limiter.flush();
+    CHECK( sub.count == 3 );
+    CHECK( sub.lastPosition.getPositionValue().longitude == ApproxDegrees(2) );
+  }
+
+  SECTION("updates are held as a whole") {
+    SKUpdateStatic<2> u;
+    u.setNavigationSpeedOverGround(1);
+    u.setNavigationCourseOverGroundTrue(1);
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+    CHECK( sub.lastSize == 2 );
+
+    rateLimiterMillis += 10;
+    u.setNavigationSpeedOverGround(2);
+    u.setNavigationCourseOverGroundTrue(2);
+    limiter.updateReceived(u);
+    CHECK( sub.count == 1 );
+
+    rateLimiterMillis += 1000;
+    limiter.flush();
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastSize == 2 );
+    CHECK( sub.lastSOG == 2 );
+    CHECK( sub.lastCOG == 2 );
+  }
+
+  SECTION("held updates are flushed separately") {
+    SKUpdateStatic<2> u;
+    u.setNavigationSpeedOverGround(1);
+    u.setNavigationCourseOverGroundTrue(1);
+    limiter.updateReceived(u);
+    SKUpdateStatic<1> heading;
+    heading.setNavigationHeadingTrue(1);
+    limiter.updateReceived(heading);
+    CHECK( sub.count == 2 );
+
+    rateLimiterMillis += 10;
+    u.setNavigationSpeedOverGround(2);
+    u.setNavigationCourseOverGroundTrue(2);
+    limiter.updateReceived(u);
+    heading.setNavigationHeadingTrue(2);
+    limiter.updateReceived(heading);
+    CHECK( sub.count == 2 );
+
+    // Only the heading is due.
+    rateLimiterMillis += 100;
+    limiter.flush();
+    CHECK( sub.count == 3 );
+    CHECK( sub.lastSize == 1 );
+    CHECK( sub.lastHeading == 2 );
+
+    rateLimiterMillis += 1000;
+    limiter.flush();
+    CHECK( sub.count == 4 );
+    CHECK( sub.lastSize == 2 );
+    CHECK( sub.lastSOG == 2 );
+
+    limiter.flush();
+    CHECK( sub.count == 4 );
+  }
+
+  SECTION("values arriving after the interval are sent immediately") {
+    SKUpdateStatic<1> u;
+    u.setNavigationAttitude(SKTypeAttitude(0.1, 0, 0));
+    limiter.updateReceived(u);
+    rateLimiterMillis += 150;
+    u.setNavigationAttitude(SKTypeAttitude(0.2, 0, 0));
+    limiter.updateReceived(u);
+
+    CHECK( sub.count == 2 );
+    CHECK( sub.lastAttitude.getAttitudeValue().roll == Approx(0.2) );
+  }
+}
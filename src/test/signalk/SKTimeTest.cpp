@@ -132,6 +132,19 @@ TEST_CASE("SKTime") {
     }
   }
 
+  SECTION("timeFromNMEAFields") {
+    SECTION("Fields are not NUL-terminated") {
+      const char *sentence = "$GPRMC,004119.042,A,,,,,,,141116,,*00";
+      SKTime t = SKTime::timeFromNMEAFields(sentence + 26, 6, sentence + 7, 10);
+      CHECK( t.toString() == "2016-11-14T00:41:19.042Z" );
+    }
+
+    SECTION("Empty fields") {
+      SKTime t = SKTime::timeFromNMEAFields("", 0, "", 0);
+      CHECK( t.toString() == SKTime::timeFromNMEAStrings("", "").toString() );
+    }
+  }
+
   SECTION("timeFromNMEA2000") {
     SECTION("Without ms") {
       SKTime t = SKTime::timeFromNMEA2000(17647, 3600 * 9 + 30 * 60 + 42);
@@ -114,5 +114,37 @@ TEST_CASE("SKUpdateStatic") {
 
     CHECK( countingVisitor.counter == 3 );
   }
-};
 
+  SECTION("Path mask") {
+    SKUpdateStatic<3> u;
+    CHECK( u.getPathMask().isEmpty() );
+
+    u.setNavigationSpeedOverGround(1);
+    u.setElectricalBatteriesVoltage("house", 12.2);
+
+    CHECK( u.getPathMask().test(SKPathNavigationSpeedOverGround) );
+    CHECK( u.getPathMask().test(SKPathElectricalBatteriesVoltage) );
+    CHECK( ! u.getPathMask().test(SKPathNavigationCourseOverGroundTrue) );
+    CHECK( ! u.hasElectricalBatteriesVoltage("engine") );
+  }
+
+  SECTION("Clear") {
+    SKUpdateStatic<2> u;
+    u.setSource(SKSource::sourceForNMEA0183(SKSourceInputNMEA0183_1, "GP", "RMC"));
+    u.setNavigationSpeedOverGround(1);
+    u.setNavigationCourseOverGroundTrue(2);
+
+    u.clear();
+    CHECK( u.getSize() == 0 );
+    CHECK( u.getSource() == SKSourceUnknown );
+    CHECK( u.getPathMask().isEmpty() );
+    CHECK( ! u.hasNavigationSpeedOverGround() );
+
+    // Values are added in a different order after clear()
+    u.setNavigationCourseOverGroundTrue(3);
+    u.setNavigationSpeedOverGround(4);
+    CHECK( u.getNavigationSpeedOverGround() == 4 );
+    CHECK( u.getNavigationCourseOverGroundTrue() == 3 );
+    CHECK( u.getPath(0) == SKPathNavigationCourseOverGroundTrue );
+  }
+};
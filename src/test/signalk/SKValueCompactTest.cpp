@@ -0,0 +1,141 @@
+/*
+  The MIT License
+
+  Copyright (c) 2018 Thomas Sarlandie thomas@sarlandie.net
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+*/
+
+#include <math.h>
+#include "../KBoxTest.h"
+#include "common/signalk/SKUnits.h"
+#include "common/signalk/SKValue.h"
+
+// These tests use the compact types directly so that they run whether or not
+// SKVALUE_COMPACT is defined.
+
+TEST_CASE("SKCompactPosition") {
+  // Half of the 1e-7 degree resolution (about 5.6mm at the equator)
+  const double maxDegreesError = 0.5e-7;
+
+  SECTION("latitude and longitude round trip within 0.5e-7 degrees") {
+    double worst = 0;
+    for (double lat = -90; lat <= 90; lat += 0.7654321) {
+      for (double lon = -180; lon <= 180; lon += 1.23456789) {
+        SKTypePosition p = SKCompactPosition(SKTypePosition(lat, lon, 0));
+        worst = fmax(worst, fmax(fabs(p.latitude - lat), fabs(p.longitude - lon)));
+      }
+    }
+    CHECK( worst <= maxDegreesError );
+  }
+
+  SECTION("NMEA positions") {
+    SKTypePosition p = SKCompactPosition(SKTypePosition(37.85564166666666, -122.45818833333334, 0));
+    CHECK( fabs(p.latitude - 37.85564166666666) <= maxDegreesError );
+    CHECK( fabs(p.longitude - -122.45818833333334) <= maxDegreesError );
+  }
+
+  SECTION("exact values are preserved") {
+    SKTypePosition p = SKCompactPosition(SKTypePosition(-180, 180, 0));
+    CHECK( p.latitude == -180 );
+    CHECK( p.longitude == 180 );
+  }
+
+  SECTION("altitude round trip with float precision") {
+    double worst = 0;
+    for (double alt = -1000; alt < 10000; alt += 12.345) {
+      SKTypePosition p = SKCompactPosition(SKTypePosition(0, 0, alt));
+      worst = fmax(worst, fabs(p.altitude - alt));
+    }
+    CHECK( worst <= 0.001 );
+  }
+
+  SECTION("special values") {
+    SKTypePosition p = SKCompactPosition(SKTypePosition(NAN, 1000, SKDoubleNAN));
+    CHECK( isnan(p.latitude) );
+    CHECK( p.longitude == Approx(214.7483647) );
+    CHECK( p.altitude == SKDoubleNAN );
+
+    CHECK( SKCompactPosition::encodeDegrees(-1000) == -INT32_MAX );
+    CHECK( isnan(SKCompactPosition::decodeDegrees(SKCompactPosition::encodeDegrees(NAN))) );
+  }
+}
+
+TEST_CASE("SKCompactAttitude") {
+  SECTION("angles round trip with float precision") {
+    // A float has 24 bits of mantissa: the error is less than
+    // 2^-24 * |angle| <= 2.4e-7 radians for angles in [-2PI, 2PI].
+    double worst = 0;
+    for (double a = -2 * M_PI; a <= 2 * M_PI; a += 0.0123) {
+      SKTypeAttitude att = SKCompactAttitude(SKTypeAttitude(a, -a, a / 2));
+      worst = fmax(worst, fabs(att.roll - a));
+      worst = fmax(worst, fabs(att.pitch + a));
+      worst = fmax(worst, fabs(att.yaw - a / 2));
+    }
+    CHECK( worst <= 2.4e-7 );
+  }
+
+  SECTION("special values") {
+    SKTypeAttitude att = SKCompactAttitude(SKTypeAttitude(SKDoubleNAN, NAN, 0));
+    CHECK( att.roll == SKDoubleNAN );
+    CHECK( isnan(att.pitch) );
+    CHECK( att.yaw == 0 );
+  }
+}
+
+TEST_CASE("SKValue precision") {
+  // Bounds that hold with and without SKVALUE_COMPACT.
+  SECTION("numbers are not rounded") {
+    double values[] = { 12.34, 101325.12, 1852 * 1234.5678, 1e-9, -3.14159265358979 };
+    for (double v : values) {
+      CHECK( SKValue(v).getNumberValue() == v );
+    }
+  }
+
+  SECTION("positions") {
+    SKValue v(SKTypePosition(48.8583701, 2.2944813, 35.5));
+    CHECK( fabs(v.getPositionValue().latitude - 48.8583701) <= 0.5e-7 );
+    CHECK( fabs(v.getPositionValue().longitude - 2.2944813) <= 0.5e-7 );
+    CHECK( fabs(v.getPositionValue().altitude - 35.5) <= 0.001 );
+  }
+
+  SECTION("attitudes") {
+    SKValue v(SKTypeAttitude(0.1, -0.2, 3.1));
+    CHECK( fabs(v.getAttitudeValue().roll - 0.1) <= 2.4e-7 );
+    CHECK( fabs(v.getAttitudeValue().pitch + 0.2) <= 2.4e-7 );
+    CHECK( fabs(v.getAttitudeValue().yaw - 3.1) <= 2.4e-7 );
+  }
+
+  SECTION("timestamps are not rounded") {
+    SKValue v(SKTime(1524764848, 102));
+    CHECK( v.getTimestampValue() == SKTime(1524764848, 102) );
+  }
+
+  SECTION("equality") {
+    CHECK( SKValue(SKTypePosition(1, 2, 3)) == SKValue(SKTypePosition(1, 2, 3)) );
+    CHECK( SKValue(SKTypePosition(1, 2, 3)) != SKValue(SKTypePosition(1, 2.001, 3)) );
+    CHECK( SKValue(SKTypeAttitude(1, 2, 3)) == SKValue(SKTypeAttitude(1, 2, 3)) );
+  }
+
+#ifdef SKVALUE_COMPACT
+  SECTION("compact size") {
+    CHECK( sizeof(SKValue) == 16 );
+  }
+#endif
+}
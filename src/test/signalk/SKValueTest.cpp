@@ -24,6 +24,7 @@
 
 #include "../KBoxTest.h"
 #include "common/signalk/SKValue.h"
+#include "util.h"
 
 TEST_CASE("SKValue: Create a few values and make sure we can read their data back") {
   SECTION("Double Value") {
@@ -39,8 +40,8 @@ TEST_CASE("SKValue: Create a few values and make sure we can read their data bac
 
   SECTION("Position Value") {
     SKValue pos = SKValue(SKTypePosition(34.34, -178, 2));
-    CHECK( pos.getPositionValue().latitude == 34.34 );
-    CHECK( pos.getPositionValue().longitude == -178 );
+    CHECK( pos.getPositionValue().latitude == ApproxDegrees(34.34) );
+    CHECK( pos.getPositionValue().longitude == ApproxDegrees(-178) );
     CHECK( pos.getPositionValue().altitude == 2 );
 
     // Check that reading the wrong type will always return 0
@@ -51,7 +52,7 @@ TEST_CASE("SKValue: Create a few values and make sure we can read their data bac
     SKValue attitude = SKValue(SKTypeAttitude(33.0, 10.1, 0));
 
     CHECK( attitude.getAttitudeValue().roll == 33.0 );
-    CHECK( attitude.getAttitudeValue().pitch == 10.1 );
+    CHECK( attitude.getAttitudeValue().pitch == ApproxFloat(10.1) );
     CHECK( attitude.getAttitudeValue().yaw == 0 );
 
     CHECK( attitude.getNumberValue() == 0 );
@@ -26,7 +26,23 @@
 
 #include <stdint.h>
 #include "common/algo/List.h"
+#include "../KBoxTest.h"
 
 class tN2kMsg;
 
 const tN2kMsg* findMessage(const LinkedList<tN2kMsg>& messages, uint32_t pgn, int index);
+
+/*
+ * Comparisons of values read back from an SKValue. When SKVALUE_COMPACT is
+ * defined, latitudes and longitudes are rounded to 1e-7 degrees and
+ * altitudes and attitudes are stored as floats (24 bits of mantissa, a
+ * relative error below 6e-8). Without it, values are exact and both
+ * comparisons also pass.
+ */
+inline Approx ApproxDegrees(double degrees) {
+  return Approx(degrees).epsilon(0).margin(1e-7);
+}
+
+inline Approx ApproxFloat(double value) {
+  return Approx(value).epsilon(1e-7);
+}